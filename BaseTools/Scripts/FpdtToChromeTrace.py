@@ -0,0 +1,275 @@
+## @file
+# Convert the firmware boot performance records of the ACPI FPDT to a Chrome trace
+# event file, which chrome://tracing and Perfetto display as a timeline.
+#
+# The FPDT only holds the address of the Firmware Basic Boot Performance Table
+# (FBPT). The FBPT is read from that address in /dev/mem, or from a file that
+# holds a dump of it.
+#
+# Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+'''
+FpdtToChromeTrace
+'''
+
+import argparse
+import json
+import struct
+import sys
+import uuid
+
+#
+# Globals for help information
+#
+__prog__        = 'FpdtToChromeTrace'
+__copyright__   = 'Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.'
+__description__ = 'Convert the FPDT boot performance records to a Chrome trace event file.\n'
+
+#
+# Record types of the FPDT and the FBPT
+#
+FPDT_BOOT_PERFORMANCE_TABLE_POINTER = 0x0000
+FPDT_FIRMWARE_BASIC_BOOT            = 0x0002
+FPDT_GUID_EVENT_TYPE                = 0x1010
+FPDT_DYNAMIC_STRING_EVENT_TYPE      = 0x1011
+FPDT_DUAL_GUID_STRING_EVENT_TYPE    = 0x1012
+FPDT_GUID_QWORD_EVENT_TYPE          = 0x1013
+FPDT_GUID_QWORD_STRING_EVENT_TYPE   = 0x1014
+
+#
+# Progress IDs of MdePkg/Include/Library/PerformanceLib.h
+#
+MODULE_START_ID            = 0x01
+MODULE_END_ID              = 0x02
+MODULE_LOADIMAGE_START_ID  = 0x03
+MODULE_LOADIMAGE_END_ID    = 0x04
+MODULE_DB_START_ID         = 0x05
+MODULE_DB_END_ID           = 0x06
+MODULE_DB_SUPPORT_START_ID = 0x07
+MODULE_DB_SUPPORT_END_ID   = 0x08
+MODULE_DB_STOP_START_ID    = 0x09
+MODULE_DB_STOP_END_ID      = 0x0A
+PERF_EVENTSIGNAL_START_ID  = 0x10
+PERF_CROSSMODULE_START_ID  = 0x50
+PERF_CROSSMODULE_END_ID    = 0x51
+PERF_COUNTER_ID            = 0x60
+
+TokenOfId = {
+    MODULE_LOADIMAGE_START_ID:  'LoadImage:',
+    MODULE_LOADIMAGE_END_ID:    'LoadImage:',
+    MODULE_DB_START_ID:         'DB:Start:',
+    MODULE_DB_END_ID:           'DB:Start:',
+    MODULE_DB_SUPPORT_START_ID: 'DB:Support:',
+    MODULE_DB_SUPPORT_END_ID:   'DB:Support:',
+    MODULE_DB_STOP_START_ID:    'DB:Stop:',
+    MODULE_DB_STOP_END_ID:      'DB:Stop:',
+    }
+
+ACPI_TABLE_HEADER_SIZE = 36
+FBPT_HEADER_SIZE       = 8
+RECORD_HEADER_SIZE     = 4
+
+def CString (Buffer):
+    return Buffer.split (b'\0', 1)[0].decode ('ascii', 'replace')
+
+def IsStartId (ProgressId):
+    if ProgressId >= PERF_EVENTSIGNAL_START_ID:
+        return (ProgressId & 0x000F) == 0
+    return (ProgressId & 0x0001) != 0
+
+def ReadFbptAddress (Fpdt):
+    Offset = ACPI_TABLE_HEADER_SIZE
+    while Offset + RECORD_HEADER_SIZE <= len (Fpdt):
+        Type, Length = struct.unpack_from ('<HB', Fpdt, Offset)
+        if Length == 0:
+            break
+        if Type == FPDT_BOOT_PERFORMANCE_TABLE_POINTER:
+            return struct.unpack_from ('<Q', Fpdt, Offset + 8)[0]
+        Offset += Length
+    raise ValueError ('No Boot Performance Table Pointer record in the FPDT')
+
+def ReadFbpt (FbptFile, Address):
+    with open (FbptFile, 'rb') as File:
+        File.seek (Address)
+        Header = File.read (FBPT_HEADER_SIZE)
+        Signature, Length = struct.unpack ('<4sI', Header)
+        if Signature != b'FBPT':
+            raise ValueError ('No FBPT at 0x{Address:x} of {File}'.format (Address = Address, File = FbptFile))
+        return Header + File.read (Length - FBPT_HEADER_SIZE)
+
+class Measurement:
+    def __init__ (self, Name, Token, Guid, ProgressId, ApicId):
+        self.Name       = Name
+        self.Token      = Token
+        self.Guid       = Guid
+        self.ProgressId = ProgressId
+        self.ApicId     = ApicId
+        self.Start      = 0
+        self.End        = 0
+        self.Value      = None
+
+def ParseFbpt (Fbpt):
+    '''
+    Pair the start and end records the same way as the Shell dp command does.
+    '''
+    Measurements = []
+    BasicBoot    = None
+    PeiPhase     = False
+    Offset       = FBPT_HEADER_SIZE
+    while Offset + RECORD_HEADER_SIZE <= len (Fbpt):
+        Type, Length = struct.unpack_from ('<HB', Fbpt, Offset)
+        if Length == 0:
+            break
+        Record = Fbpt[Offset:Offset + Length]
+        Offset += Length
+
+        if Type == FPDT_FIRMWARE_BASIC_BOOT:
+            BasicBoot = struct.unpack_from ('<5Q', Record, 8)
+            continue
+        if Type not in (FPDT_GUID_EVENT_TYPE, FPDT_DYNAMIC_STRING_EVENT_TYPE, FPDT_DUAL_GUID_STRING_EVENT_TYPE,
+                        FPDT_GUID_QWORD_EVENT_TYPE, FPDT_GUID_QWORD_STRING_EVENT_TYPE):
+            continue
+
+        ProgressId, ApicId, Timestamp = struct.unpack_from ('<HIQ', Record, 4)
+        Guid = str (uuid.UUID (bytes_le = bytes (Record[18:34]))).upper ()
+        if Type == FPDT_DYNAMIC_STRING_EVENT_TYPE:
+            String = CString (Record[34:])
+        elif Type == FPDT_DUAL_GUID_STRING_EVENT_TYPE:
+            String = CString (Record[50:])
+        elif Type == FPDT_GUID_QWORD_STRING_EVENT_TYPE:
+            String = CString (Record[42:])
+        else:
+            String = ''
+
+        if ProgressId == PERF_CROSSMODULE_START_ID and String in ('PEI', 'DXE'):
+            PeiPhase = (String == 'PEI')
+        if ProgressId in (MODULE_START_ID, MODULE_END_ID):
+            Token = 'PEIM' if PeiPhase else 'StartImage:'
+        else:
+            Token = TokenOfId.get (ProgressId, String)
+        Name = String if String != '' else Guid
+
+        Current = Measurement (Name, Token, Guid, ProgressId, ApicId)
+        if ProgressId == PERF_COUNTER_ID:
+            Current.End = Timestamp
+            if Type == FPDT_GUID_QWORD_STRING_EVENT_TYPE:
+                Current.Value = struct.unpack_from ('<Q', Record, 34)[0]
+            Measurements.append (Current)
+        elif ProgressId == 0:
+            Current.End = Timestamp
+            Measurements.append (Current)
+        elif IsStartId (ProgressId):
+            Current.Start = Timestamp
+            Measurements.append (Current)
+        else:
+            for Started in reversed (Measurements):
+                if Started.End != 0 or Started.Token != Token or Started.Name != Name:
+                    continue
+                if ProgressId == PERF_CROSSMODULE_END_ID:
+                    if Started.ProgressId != PERF_CROSSMODULE_START_ID:
+                        continue
+                elif Started.Guid != Guid:
+                    continue
+                Started.End = Timestamp
+                break
+    return Measurements, BasicBoot
+
+def Microseconds (Nanoseconds):
+    return Nanoseconds / 1000.0
+
+def BuildTrace (Measurements, BasicBoot):
+    Events = [{'name': 'process_name', 'ph': 'M', 'pid': 0, 'args': {'name': 'Firmware boot'}}]
+    for Item in Measurements:
+        Event = {
+            'name': Item.Name,
+            'cat':  Item.Token,
+            'pid':  0,
+            'tid':  Item.ApicId,
+            'args': {'guid': Item.Guid, 'id': Item.ProgressId}
+            }
+        if Item.Value is not None:
+            Event['ph']   = 'C'
+            Event['ts']   = Microseconds (Item.End)
+            Event['args'] = {'value': Item.Value}
+        elif Item.Start != 0 and Item.End != 0:
+            Event['ph']  = 'X'
+            Event['ts']  = Microseconds (Item.Start)
+            Event['dur'] = Microseconds (max (Item.End - Item.Start, 0))
+        else:
+            Event['ph'] = 'i'
+            Event['s']  = 'g'
+            Event['ts'] = Microseconds (Item.Start if Item.Start != 0 else Item.End)
+        Events.append (Event)
+
+    if BasicBoot is not None:
+        ResetEnd, LoadImageStart, StartImageStart, ExitBootServicesEntry, ExitBootServicesExit = BasicBoot
+        for Name, Timestamp in (('ResetEnd', ResetEnd), ('OsLoaderLoadImageStart', LoadImageStart), ('OsLoaderStartImageStart', StartImageStart)):
+            if Timestamp != 0:
+                Events.append ({'name': Name, 'cat': 'BasicBoot', 'ph': 'i', 's': 'g', 'pid': 0, 'tid': 0, 'ts': Microseconds (Timestamp)})
+        if ExitBootServicesEntry != 0 and ExitBootServicesExit >= ExitBootServicesEntry:
+            Events.append ({
+                'name': 'ExitBootServices',
+                'cat':  'BasicBoot',
+                'ph':   'X',
+                'pid':  0,
+                'tid':  0,
+                'ts':   Microseconds (ExitBootServicesEntry),
+                'dur':  Microseconds (ExitBootServicesExit - ExitBootServicesEntry)
+                })
+    return {'displayTimeUnit': 'ms', 'traceEvents': Events}
+
+if __name__ == '__main__':
+    def ValidateUnsignedInteger (Argument):
+        try:
+            Value = int (Argument, 0)
+        except:
+            Message = '{Argument} is not a valid integer value.'.format (Argument = Argument)
+            raise argparse.ArgumentTypeError (Message)
+        if Value < 0:
+            Message = '{Argument} is a negative value.'.format (Argument = Argument)
+            raise argparse.ArgumentTypeError (Message)
+        return Value
+
+    #
+    # Create command line argument parser object
+    #
+    parser = argparse.ArgumentParser (prog = __prog__,
+                                      description = __description__ + __copyright__)
+    parser.add_argument ('Fpdt', nargs = '?', default = '/sys/firmware/acpi/tables/FPDT',
+                         help = 'FPDT ACPI table file. Default is %(default)s.')
+    parser.add_argument ('-f', '--fbpt', dest = 'Fbpt',
+                         help = 'File holding a dump of the FBPT. Default is to read the FBPT from --mem.')
+    parser.add_argument ('-m', '--mem', dest = 'Memory', default = '/dev/mem',
+                         help = 'Physical memory file to read the FBPT from. Default is %(default)s.')
+    parser.add_argument ('-a', '--address', dest = 'Address', type = ValidateUnsignedInteger,
+                         help = 'Address of the FBPT in physical memory, which overrides the address in the FPDT.')
+    parser.add_argument ('-o', '--output', dest = 'Output', default = 'fpdt-trace.json',
+                         help = 'Chrome trace event file to write. Default is %(default)s.')
+    parser.add_argument ('-v', '--verbose', dest = 'Verbose', action = 'store_true',
+                         help = 'Increase output messages')
+
+    #
+    # Parse command line arguments
+    #
+    args = parser.parse_args ()
+
+    try:
+        if args.Fbpt is not None:
+            Fbpt = ReadFbpt (args.Fbpt, 0)
+        else:
+            Address = args.Address
+            if Address is None:
+                with open (args.Fpdt, 'rb') as File:
+                    Address = ReadFbptAddress (File.read ())
+            Fbpt = ReadFbpt (args.Memory, Address)
+        Measurements, BasicBoot = ParseFbpt (Fbpt)
+        with open (args.Output, 'w') as File:
+            json.dump (BuildTrace (Measurements, BasicBoot), File, indent = 1)
+    except (IOError, OSError, ValueError, struct.error) as Error:
+        print ('{Prog}: error: {Error}'.format (Prog = __prog__, Error = Error), file = sys.stderr)
+        sys.exit (1)
+
+    if args.Verbose:
+        print ('{Count} measurements written to {File}'.format (Count = len (Measurements), File = args.Output))
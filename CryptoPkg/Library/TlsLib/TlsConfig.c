@@ -595,6 +595,59 @@ TlsSetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Sets a TLS session to be resumed when the TLS/SSL connection is established.
+
+  This function restores a session previously returned by TlsGetSession(), so
+  that the next handshake offers it to the server (session ID or session ticket
+  with TLS 1.2, pre-shared key with TLS 1.3). The server may still decline the
+  session, in which case a full handshake is performed.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Data            Pointer to the serialized session data.
+  @param[in]  DataSize        Size of the serialized session data in bytes.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session could not be set.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID         *Tls,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        DataSize
+  )
+{
+  TLS_CONNECTION       *TlsConn;
+  SSL_SESSION          *Session;
+  CONST unsigned char  *Ptr;
+  INTN                 Ret;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL) || (Data == NULL) ||
+      (DataSize == 0) || (DataSize > MAX_INT32))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Ptr     = (CONST unsigned char *)Data;
+  Session = d2i_SSL_SESSION (NULL, &Ptr, (long)DataSize);
+  if (Session == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // SSL_set_session() takes its own reference to the session.
+  //
+  Ret = SSL_set_session (TlsConn->Ssl, Session);
+  SSL_SESSION_free (Session);
+
+  return (Ret == 1) ? EFI_SUCCESS : EFI_ABORTED;
+}
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -1308,6 +1361,67 @@ TlsGetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Gets the resumable session used by the specified TLS connection.
+
+  This function serializes the TLS/SSL session currently used by the specified
+  TLS connection, so that another TLS connection to the same server can resume
+  it through TlsSetSession(). With TLS 1.3, the session only becomes resumable
+  once the server has sent a session ticket after the handshake.
+
+  @param[in]      Tls             Pointer to the TLS object.
+  @param[out]     Data            Buffer to contain the serialized session data.
+  @param[in,out]  DataSize        On input, the size of Data buffer in bytes.
+                                  On output, the size of the session data.
+
+  @retval  EFI_SUCCESS           The session was returned successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_NOT_FOUND         The TLS connection has no resumable session.
+  @retval  EFI_BUFFER_TOO_SMALL  The Data is too small to hold the session.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsGetSession (
+  IN     VOID   *Tls,
+  OUT    UINT8  *Data  OPTIONAL,
+  IN OUT UINTN  *DataSize
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+  SSL_SESSION     *Session;
+  unsigned char   *Ptr;
+  INTN            Length;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL) || (DataSize == NULL) ||
+      ((Data == NULL) && (*DataSize != 0)))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Session = SSL_get_session (TlsConn->Ssl);
+  if ((Session == NULL) || (SSL_SESSION_is_resumable (Session) != 1)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Length = i2d_SSL_SESSION (Session, NULL);
+  if (Length <= 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (*DataSize < (UINTN)Length) {
+    *DataSize = (UINTN)Length;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  Ptr       = Data;
+  *DataSize = (UINTN)i2d_SSL_SESSION (Session, &Ptr);
+
+  return EFI_SUCCESS;
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
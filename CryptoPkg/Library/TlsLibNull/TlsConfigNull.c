@@ -181,6 +181,35 @@ TlsSetSessionId (
   return EFI_UNSUPPORTED;
 }
 
+/**
+  Sets a TLS session to be resumed when the TLS/SSL connection is established.
+
+  This function restores a session previously returned by TlsGetSession(), so
+  that the next handshake offers it to the server (session ID or session ticket
+  with TLS 1.2, pre-shared key with TLS 1.3). The server may still decline the
+  session, in which case a full handshake is performed.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Data            Pointer to the serialized session data.
+  @param[in]  DataSize        Size of the serialized session data in bytes.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session could not be set.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID         *Tls,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        DataSize
+  )
+{
+  ASSERT (FALSE);
+  return EFI_UNSUPPORTED;
+}
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -526,6 +555,37 @@ TlsGetSessionId (
   return EFI_UNSUPPORTED;
 }
 
+/**
+  Gets the resumable session used by the specified TLS connection.
+
+  This function serializes the TLS/SSL session currently used by the specified
+  TLS connection, so that another TLS connection to the same server can resume
+  it through TlsSetSession(). With TLS 1.3, the session only becomes resumable
+  once the server has sent a session ticket after the handshake.
+
+  @param[in]      Tls             Pointer to the TLS object.
+  @param[out]     Data            Buffer to contain the serialized session data.
+  @param[in,out]  DataSize        On input, the size of Data buffer in bytes.
+                                  On output, the size of the session data.
+
+  @retval  EFI_SUCCESS           The session was returned successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_NOT_FOUND         The TLS connection has no resumable session.
+  @retval  EFI_BUFFER_TOO_SMALL  The Data is too small to hold the session.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsGetSession (
+  IN     VOID   *Tls,
+  OUT    UINT8  *Data  OPTIONAL,
+  IN OUT UINTN  *DataSize
+  )
+{
+  ASSERT (FALSE);
+  return EFI_UNSUPPORTED;
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -0,0 +1,174 @@
+/** @file
+  UEFI Application to measure the sequential read throughput of block devices.
+
+  The application reads up to BLOCK_IO_BENCHMARK_BYTES from the start of every
+  physical block device with EFI_BLOCK_IO_PROTOCOL.ReadBlocks(), once for each
+  transfer size of mTransferSize, and prints the throughput.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Protocol/BlockIo.h>
+#include <Protocol/DevicePath.h>
+
+#define BLOCK_IO_BENCHMARK_BYTES  SIZE_256MB
+
+UINTN  mTransferSize[] = { SIZE_4KB, SIZE_64KB, SIZE_1MB, SIZE_4MB, SIZE_16MB };
+
+/**
+  Read the start of a block device with one transfer size and print the throughput.
+
+  @param[in]  BlockIo        The block device.
+  @param[in]  Buffer         The buffer to read into, of at least TransferSize bytes.
+  @param[in]  TransferSize   The number of bytes of each ReadBlocks() call.
+
+  @retval EFI_SUCCESS        The throughput is printed.
+  @retval Others             ReadBlocks() failed.
+
+**/
+EFI_STATUS
+MeasureReadThroughput (
+  IN EFI_BLOCK_IO_PROTOCOL  *BlockIo,
+  IN VOID                   *Buffer,
+  IN UINTN                  TransferSize
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      DeviceSize;
+  UINT64      TotalSize;
+  UINT64      Offset;
+  UINT64      Start;
+  UINT64      End;
+  UINT64      Nanoseconds;
+
+  DeviceSize = MultU64x32 (BlockIo->Media->LastBlock + 1, BlockIo->Media->BlockSize);
+  TotalSize  = MIN (DeviceSize, BLOCK_IO_BENCHMARK_BYTES);
+  TotalSize -= ModU64x32 (TotalSize, (UINT32)TransferSize);
+  if (TotalSize == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Start = GetPerformanceCounter ();
+  for (Offset = 0; Offset < TotalSize; Offset += TransferSize) {
+    Status = BlockIo->ReadBlocks (
+                        BlockIo,
+                        BlockIo->Media->MediaId,
+                        DivU64x32 (Offset, BlockIo->Media->BlockSize),
+                        TransferSize,
+                        Buffer
+                        );
+    if (EFI_ERROR (Status)) {
+      Print (L"  ReadBlocks at 0x%Lx: %r\n", Offset, Status);
+      return Status;
+    }
+  }
+
+  End         = GetPerformanceCounter ();
+  Nanoseconds = GetTimeInNanoSecond (End - Start);
+  if (Nanoseconds == 0) {
+    Print (L"  %8d KB: no time elapsed, check the TimerLib instance\n", (UINT32)(TransferSize / SIZE_1KB));
+    return EFI_SUCCESS;
+  }
+
+  Print (
+    L"  %8d KB: %6Ld MB/s (%Ld MB in %Ld us)\n",
+    (UINT32)(TransferSize / SIZE_1KB),
+    RShiftU64 (DivU64x64Remainder (MultU64x32 (TotalSize, 1000000000), Nanoseconds, NULL), 20),
+    RShiftU64 (TotalSize, 20),
+    DivU64x32 (Nanoseconds, 1000)
+    );
+  return EFI_SUCCESS;
+}
+
+/**
+  The user Entry Point for Application. The user code starts with this function
+  as the real entry point for the application.
+
+  @param[in] ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in] SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS       The entry point is executed successfully.
+  @retval other             Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+UefiMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS             Status;
+  EFI_HANDLE             *Handles;
+  UINTN                  HandleCount;
+  UINTN                  HandleIndex;
+  UINTN                  SizeIndex;
+  EFI_BLOCK_IO_PROTOCOL  *BlockIo;
+  CHAR16                 *DevicePathText;
+  VOID                   *Buffer;
+  UINTN                  BufferPages;
+
+  Status = gBS->LocateHandleBuffer (ByProtocol, &gEfiBlockIoProtocolGuid, NULL, &HandleCount, &Handles);
+  if (EFI_ERROR (Status)) {
+    Print (L"No block device found: %r\n", Status);
+    return Status;
+  }
+
+  BufferPages = EFI_SIZE_TO_PAGES (mTransferSize[ARRAY_SIZE (mTransferSize) - 1]);
+  Buffer      = AllocatePages (BufferPages);
+  if (Buffer == NULL) {
+    FreePool (Handles);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (HandleIndex = 0; HandleIndex < HandleCount; HandleIndex++) {
+    Status = gBS->HandleProtocol (Handles[HandleIndex], &gEfiBlockIoProtocolGuid, (VOID **)&BlockIo);
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    //
+    // Partitions are read through the device that holds them.
+    //
+    if (BlockIo->Media->LogicalPartition || !BlockIo->Media->MediaPresent ||
+        (BlockIo->Media->IoAlign > EFI_PAGE_SIZE))
+    {
+      continue;
+    }
+
+    DevicePathText = ConvertDevicePathToText (DevicePathFromHandle (Handles[HandleIndex]), FALSE, FALSE);
+    Print (
+      L"%s\n  BlockSize %d, LastBlock 0x%Lx\n",
+      (DevicePathText != NULL) ? DevicePathText : L"(no device path)",
+      BlockIo->Media->BlockSize,
+      BlockIo->Media->LastBlock
+      );
+    if (DevicePathText != NULL) {
+      FreePool (DevicePathText);
+    }
+
+    for (SizeIndex = 0; SizeIndex < ARRAY_SIZE (mTransferSize); SizeIndex++) {
+      if ((mTransferSize[SizeIndex] % BlockIo->Media->BlockSize) != 0) {
+        continue;
+      }
+
+      if (EFI_ERROR (MeasureReadThroughput (BlockIo, Buffer, mTransferSize[SizeIndex]))) {
+        break;
+      }
+    }
+  }
+
+  FreePages (Buffer, BufferPages);
+  FreePool (Handles);
+
+  return EFI_SUCCESS;
+}
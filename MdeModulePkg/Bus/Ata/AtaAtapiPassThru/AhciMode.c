@@ -1563,28 +1563,24 @@ AhciStopCommand (
 }
 
 /**
-  Start command for give slot on specific port.
+  Start the command list processing of specific port.
 
   @param  PciIo              The PCI IO protocol instance.
   @param  Port               The number of port.
-  @param  CommandSlot        The number of Command Slot.
   @param  Timeout            The timeout value of start, uses 100ns as a unit.
 
-  @retval EFI_DEVICE_ERROR   The command start unsuccessfully.
+  @retval EFI_DEVICE_ERROR   The port start unsuccessfully.
   @retval EFI_TIMEOUT        The operation is time out.
-  @retval EFI_SUCCESS        The command start successfully.
+  @retval EFI_SUCCESS        The port start successfully.
 
 **/
 EFI_STATUS
-EFIAPI
-AhciStartCommand (
+AhciStartPort (
   IN  EFI_PCI_IO_PROTOCOL  *PciIo,
   IN  UINT8                Port,
-  IN  UINT8                CommandSlot,
   IN  UINT64               Timeout
   )
 {
-  UINT32      CmdSlotBit;
   EFI_STATUS  Status;
   UINT32      PortStatus;
   UINT32      StartCmd;
@@ -1597,8 +1593,6 @@ AhciStartCommand (
   //
   Capability = AhciReadReg (PciIo, EFI_AHCI_CAPABILITY_OFFSET);
 
-  CmdSlotBit = (UINT32)(1 << CommandSlot);
-
   AhciClearPortStatus (
     PciIo,
     Port
@@ -1645,6 +1639,42 @@ AhciStartCommand (
   Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
   AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_ST | StartCmd);
 
+  return EFI_SUCCESS;
+}
+
+/**
+  Start command for give slot on specific port.
+
+  @param  PciIo              The PCI IO protocol instance.
+  @param  Port               The number of port.
+  @param  CommandSlot        The number of Command Slot.
+  @param  Timeout            The timeout value of start, uses 100ns as a unit.
+
+  @retval EFI_DEVICE_ERROR   The command start unsuccessfully.
+  @retval EFI_TIMEOUT        The operation is time out.
+  @retval EFI_SUCCESS        The command start successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciStartCommand (
+  IN  EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN  UINT8                Port,
+  IN  UINT8                CommandSlot,
+  IN  UINT64               Timeout
+  )
+{
+  UINT32      CmdSlotBit;
+  EFI_STATUS  Status;
+  UINT32      Offset;
+
+  CmdSlotBit = (UINT32)(1 << CommandSlot);
+
+  Status = AhciStartPort (PciIo, Port, Timeout);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   //
   // Setting the command
   //
@@ -2200,6 +2230,85 @@ AhciPacketCommandExecute (
   return Status;
 }
 
+/**
+  Allocate the command tables of the command slots used for native command queuing.
+
+  Native command queuing is not used if they cannot be allocated.
+
+  @param  PciIo                 The PCI IO protocol instance.
+  @param  AhciRegisters         The pointer to the EFI_AHCI_REGISTERS.
+  @param  MaxCommandSlotNumber  The number of command slots per port supported by the HBA.
+  @param  Support64Bit          Whether the HBA supports 64-bit addressing.
+
+**/
+VOID
+AhciCreateNcqCommandTable (
+  IN     EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN OUT EFI_AHCI_REGISTERS   *AhciRegisters,
+  IN     UINT8                MaxCommandSlotNumber,
+  IN     BOOLEAN              Support64Bit
+  )
+{
+  EFI_STATUS            Status;
+  UINTN                 Bytes;
+  VOID                  *Buffer;
+  UINT64                MaxNcqCommandTableSize;
+  EFI_PHYSICAL_ADDRESS  AhciNcqCommandTablePciAddr;
+
+  Buffer                 = NULL;
+  MaxNcqCommandTableSize = MaxCommandSlotNumber * sizeof (EFI_AHCI_NCQ_COMMAND_TABLE);
+
+  Status = PciIo->AllocateBuffer (
+                    PciIo,
+                    AllocateAnyPages,
+                    EfiBootServicesData,
+                    EFI_SIZE_TO_PAGES ((UINTN)MaxNcqCommandTableSize),
+                    &Buffer,
+                    0
+                    );
+
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  ZeroMem (Buffer, (UINTN)MaxNcqCommandTableSize);
+
+  Bytes  = (UINTN)MaxNcqCommandTableSize;
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    Buffer,
+                    &Bytes,
+                    &AhciNcqCommandTablePciAddr,
+                    &AhciRegisters->MapNcqCommandTable
+                    );
+
+  if (EFI_ERROR (Status) || (Bytes != MaxNcqCommandTableSize) ||
+      ((!Support64Bit) && (AhciNcqCommandTablePciAddr > 0x100000000ULL)))
+  {
+    if (!EFI_ERROR (Status)) {
+      PciIo->Unmap (
+               PciIo,
+               AhciRegisters->MapNcqCommandTable
+               );
+    }
+
+    PciIo->FreeBuffer (
+             PciIo,
+             EFI_SIZE_TO_PAGES ((UINTN)MaxNcqCommandTableSize),
+             Buffer
+             );
+    return;
+  }
+
+  AhciRegisters->AhciNcqCommandTable        = Buffer;
+  AhciRegisters->AhciNcqCommandTablePciAddr = (EFI_AHCI_NCQ_COMMAND_TABLE *)(UINTN)AhciNcqCommandTablePciAddr;
+  AhciRegisters->MaxNcqCommandTableSize     = MaxNcqCommandTableSize;
+  AhciRegisters->NcqSlots                   = ((UINT32)LShiftU64 (1, MaxCommandSlotNumber) - 1) & ~(UINT32)BIT0;
+  AhciRegisters->NcqActiveSlots             = 0;
+  ZeroMem (AhciRegisters->NcqPortActiveSlots, sizeof (AhciRegisters->NcqPortActiveSlots));
+}
+
 /**
   Allocate transfer-related data struct which is used at AHCI mode.
 
@@ -2410,6 +2519,13 @@ AhciCreateTransferDescriptor (
 
   AhciRegisters->AhciCommandTablePciAddr = (EFI_AHCI_COMMAND_TABLE *)(UINTN)AhciCommandTablePciAddr;
 
+  //
+  // Native command queuing needs a command table for each command slot.
+  //
+  if (((Capability & EFI_AHCI_CAP_SNCQ) != 0) && (MaxCommandSlotNumber > 1) && PcdGetBool (PcdAhciNcqEnable)) {
+    AhciCreateNcqCommandTable (PciIo, AhciRegisters, MaxCommandSlotNumber, Support64Bit);
+  }
+
   return EFI_SUCCESS;
   //
   // Map error or unable to map the whole CmdList buffer into a contiguous region.
@@ -2513,113 +2629,704 @@ AhciReadLogExt (
 }
 
 /**
-  Enable DEVSLP of the disk if supported.
+  Get the command slots that can hold the queued commands of a device.
 
-  @param  PciIo               The PCI IO protocol instance.
-  @param  AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
-  @param  Port                The number of port.
-  @param  PortMultiplier      The multiplier of port.
-  @param  IdentifyData        A pointer to data buffer which is used to contain IDENTIFY data.
+  The tag of a queued command is the number of its command slot, and a device
+  only accepts tags up to its queue depth minus one (IDENTIFY word 75). Slot 0
+  is left to the commands that are not queued.
+
+  @param[in]  AhciRegisters    The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]  IdentifyData     The IDENTIFY data of the device.
+
+  @return  The bit mask of the command slots, or 0 if queued commands cannot be
+           issued to the device.
 
-  @retval EFI_SUCCESS         The DEVSLP is enabled per policy successfully.
-  @retval EFI_UNSUPPORTED     The DEVSLP isn't supported by the controller/device and policy requires to enable it.
 **/
-EFI_STATUS
-AhciEnableDevSlp (
-  IN EFI_PCI_IO_PROTOCOL  *PciIo,
-  IN EFI_AHCI_REGISTERS   *AhciRegisters,
-  IN UINT8                Port,
-  IN UINT8                PortMultiplier,
-  IN EFI_IDENTIFY_DATA    *IdentifyData
+UINT32
+AhciGetNcqDeviceSlots (
+  IN EFI_AHCI_REGISTERS  *AhciRegisters,
+  IN EFI_IDENTIFY_DATA   *IdentifyData
   )
 {
-  EFI_STATUS               Status;
-  UINT32                   Offset;
-  UINT32                   Capability2;
-  UINT8                    LogData[512];
-  DEVSLP_TIMING_VARIABLES  DevSlpTiming;
-  UINT32                   PortCmd;
-  UINT32                   PortDevSlp;
+  UINT32  QueueDepth;
 
-  if (mAtaAtapiPolicy->DeviceSleepEnable != 1) {
-    return EFI_SUCCESS;
+  QueueDepth = (IdentifyData->AtaData.queue_depth & 0x1F) + 1;
+  return AhciRegisters->NcqSlots & ((UINT32)LShiftU64 (1, QueueDepth) - 1);
+}
+
+/**
+  Wait until no queued command is in flight on a port.
+
+  The port keeps running while queued commands are in flight on it, and a
+  command that is not queued would abort them. So before such a command is
+  issued, the non-blocking tasks are run until the queued commands of the port
+  have completed and released their command slots.
+
+  @param[in]  Instance         The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]  Port             The number of port.
+
+**/
+VOID
+AhciWaitQueuedCommandsIdle (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN UINT8                         Port
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  while (Instance->AhciRegisters.NcqPortActiveSlots[Port] != 0) {
+    AsyncNonBlockingTransferRoutine (NULL, Instance);
+    //
+    // Stall for 100us.
+    //
+    MicroSecondDelay (100);
   }
 
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Issue a READ/WRITE FPDMA QUEUED command on specific port, in a free command slot.
+
+  @param[in]       Instance            The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in, out]  AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       PortMultiplier      The number of port multiplier.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in]       MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in, out]  Task                The ATA_NONBLOCK_TASK of the command. Its command
+                                       slot and buffer mapping are set if it is issued.
+
+  @retval EFI_SUCCESS         The command is issued.
+  @retval EFI_NOT_READY       No command slot is free, or the device has as many
+                              queued commands as it accepts.
+  @retval EFI_UNSUPPORTED     No command slot can carry a tag the device accepts.
+  @retval EFI_BAD_BUFFER_SIZE The data buffer cannot be mapped.
+  @retval Others              The port cannot be started.
+
+**/
+EFI_STATUS
+AhciIssueQueuedCommand (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN OUT EFI_AHCI_REGISTERS            *AhciRegisters,
+  IN     UINT8                         Port,
+  IN     UINT8                         PortMultiplier,
+  IN     BOOLEAN                       Read,
+  IN     EFI_ATA_COMMAND_BLOCK         *AtaCommandBlock,
+  IN     VOID                          *MemoryAddr,
+  IN     UINT32                        DataCount,
+  IN OUT ATA_NONBLOCK_TASK             *Task
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_PCI_IO_PROTOCOL            *PciIo;
+  LIST_ENTRY                     *Node;
+  EFI_ATA_DEVICE_INFO            *DeviceInfo;
+  UINT32                         DeviceSlots;
+  UINT32                         FreeSlots;
+  UINT8                          Slot;
+  UINT32                         SlotBit;
+  EFI_PCI_IO_PROTOCOL_OPERATION  Flag;
+  EFI_PHYSICAL_ADDRESS           PhyAddr;
+  UINTN                          MapLength;
+  VOID                           *Map;
+  EFI_AHCI_NCQ_COMMAND_TABLE     *CommandTable;
+  EFI_AHCI_COMMAND_LIST          *CommandList;
+  UINT32                         PrdtNumber;
+  UINT32                         PrdtIndex;
+  UINT32                         RemainedData;
+  DATA_64                        Data64;
+  UINT32                         Offset;
+
+  PciIo = Instance->PciIo;
+
   //
-  // Do not enable DevSlp if DevSlp is not supported.
+  // The tag of a queued command is its command slot, and it has to be within
+  // the queue depth of the device. Devices of AHCI mode are recorded without
+  // port multiplier port.
   //
-  Capability2 = AhciReadReg (PciIo, AHCI_CAPABILITY2_OFFSET);
-  DEBUG ((DEBUG_INFO, "AHCI CAPABILITY2 = %08x\n", Capability2));
-  if ((Capability2 & AHCI_CAP2_SDS) == 0) {
+  DeviceSlots = 0;
+  Node        = SearchDeviceInfoList (Instance, Port, 0xFFFF, EfiIdeHarddisk);
+  if (Node != NULL) {
+    DeviceInfo  = ATA_ATAPI_DEVICE_INFO_FROM_THIS (Node);
+    DeviceSlots = AhciGetNcqDeviceSlots (AhciRegisters, DeviceInfo->IdentifyData);
+  }
+
+  if (DeviceSlots == 0) {
     return EFI_UNSUPPORTED;
   }
 
-  //
-  // Do not enable DevSlp if DevSlp is not present
-  // Do not enable DevSlp if Hot Plug or Mechanical Presence Switch is supported
-  //
-  Offset     = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH;
-  PortCmd    = AhciReadReg (PciIo, Offset + EFI_AHCI_PORT_CMD);
-  PortDevSlp = AhciReadReg (PciIo, Offset + AHCI_PORT_DEVSLP);
-  DEBUG ((DEBUG_INFO, "Port CMD/DEVSLP = %08x / %08x\n", PortCmd, PortDevSlp));
-  if (((PortDevSlp & AHCI_PORT_DEVSLP_DSP) == 0) ||
-      ((PortCmd & (EFI_AHCI_PORT_CMD_HPCP | EFI_AHCI_PORT_CMD_MPSP)) != 0)
-      )
+  FreeSlots = DeviceSlots & ~AhciRegisters->NcqActiveSlots;
+  if ((FreeSlots == 0) ||
+      (BitFieldCountOnes32 (AhciRegisters->NcqPortActiveSlots[Port], 0, 31) >= BitFieldCountOnes32 (DeviceSlots, 0, 31)))
   {
-    return EFI_UNSUPPORTED;
+    return EFI_NOT_READY;
+  }
+
+  Slot    = (UINT8)LowBitSet32 (FreeSlots);
+  SlotBit = ((UINT32)BIT0) << Slot;
+
+  if (Read) {
+    Flag = EfiPciIoOperationBusMasterWrite;
+  } else {
+    Flag = EfiPciIoOperationBusMasterRead;
+  }
+
+  MapLength = DataCount;
+  Status    = PciIo->Map (
+                       PciIo,
+                       Flag,
+                       MemoryAddr,
+                       &MapLength,
+                       &PhyAddr,
+                       &Map
+                       );
+
+  if (EFI_ERROR (Status)) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  if (DataCount != MapLength) {
+    PciIo->Unmap (PciIo, Map);
+    return EFI_BAD_BUFFER_SIZE;
   }
 
   //
-  // Do not enable DevSlp if the device doesn't support DevSlp
+  // The tag of a queued command is the number of its command slot, which is
+  // put in bits 7:3 of the sector count. Bit 7 of the device register is the
+  // FUA bit and bit 6 is always set.
   //
-  DEBUG ((
-    DEBUG_INFO,
-    "IDENTIFY DEVICE: [77] = %04x, [78] = %04x, [79] = %04x\n",
-    IdentifyData->AtaData.reserved_77,
-    IdentifyData->AtaData.serial_ata_features_supported,
-    IdentifyData->AtaData.serial_ata_features_enabled
-    ));
-  if ((IdentifyData->AtaData.serial_ata_features_supported & BIT8) == 0) {
-    DEBUG ((
-      DEBUG_INFO,
-      "DevSlp feature is not supported for device at port [%d] PortMultiplier [%d]!\n",
-      Port,
-      PortMultiplier
-      ));
-    return EFI_UNSUPPORTED;
+  CommandTable = &AhciRegisters->AhciNcqCommandTable[Slot];
+  ZeroMem (CommandTable, sizeof (EFI_AHCI_NCQ_COMMAND_TABLE));
+  AhciBuildCommandFis (&CommandTable->CommandFis, AtaCommandBlock);
+  CommandTable->CommandFis.AhciCFisPmNum    = PortMultiplier;
+  CommandTable->CommandFis.AhciCFisSecCount = (UINT8)(Slot << 3);
+  CommandTable->CommandFis.AhciCFisDevHead  = (UINT8)((AtaCommandBlock->AtaDeviceHead & BIT7) | BIT6);
+
+  PrdtNumber = (DataCount + EFI_AHCI_MAX_DATA_PER_PRDT - 1) / EFI_AHCI_MAX_DATA_PER_PRDT;
+  ASSERT (PrdtNumber <= EFI_AHCI_NCQ_MAX_PRDT);
+
+  RemainedData = DataCount;
+  for (PrdtIndex = 0; PrdtIndex < PrdtNumber; PrdtIndex++) {
+    Data64.Uint64                                     = PhyAddr + MultU64x32 (PrdtIndex, EFI_AHCI_MAX_DATA_PER_PRDT);
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDba    = Data64.Uint32.Lower32;
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbau   = Data64.Uint32.Upper32;
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbc    = MIN (RemainedData, EFI_AHCI_MAX_DATA_PER_PRDT) - 1;
+    RemainedData                                     -= MIN (RemainedData, EFI_AHCI_MAX_DATA_PER_PRDT);
+  }
+
+  if (PrdtNumber > 0) {
+    CommandTable->PrdtTable[PrdtNumber - 1].AhciPrdtIoc = 1;
   }
 
+  CommandList = &AhciRegisters->AhciCmdList[Slot];
+  ZeroMem (CommandList, sizeof (EFI_AHCI_COMMAND_LIST));
+  CommandList->AhciCmdCfl   = EFI_AHCI_FIS_REGISTER_H2D_LENGTH / 4;
+  CommandList->AhciCmdW     = Read ? 0 : 1;
+  CommandList->AhciCmdPmp   = PortMultiplier;
+  CommandList->AhciCmdPrdtl = PrdtNumber;
+  Data64.Uint64             = (UINT64)(UINTN)&AhciRegisters->AhciNcqCommandTablePciAddr[Slot];
+  CommandList->AhciCmdCtba  = Data64.Uint32.Lower32;
+  CommandList->AhciCmdCtbau = Data64.Uint32.Upper32;
+
   //
-  // Enable DevSlp when it is not enabled.
+  // The first queued command of a port starts it. The port keeps running until
+  // the last queued command in flight on it completes.
   //
-  if ((IdentifyData->AtaData.serial_ata_features_enabled & BIT8) != 0) {
-    Status = AhciDeviceSetFeature (
-               PciIo,
-               AhciRegisters,
-               Port,
-               0,
-               ATA_SUB_CMD_ENABLE_SATA_FEATURE,
-               0x09,
-               ATA_ATAPI_TIMEOUT
-               );
-    DEBUG ((
-      DEBUG_INFO,
-      "DevSlp set feature for device at port [%d] PortMultiplier [%d] - %r\n",
-      Port,
-      PortMultiplier,
-      Status
-      ));
+  if (AhciRegisters->NcqPortActiveSlots[Port] == 0) {
+    Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
+    AhciAndReg (PciIo, Offset, (UINT32) ~(EFI_AHCI_PORT_CMD_DLAE | EFI_AHCI_PORT_CMD_ATAPI));
+
+    Status = AhciStartPort (PciIo, Port, ATA_ATAPI_TIMEOUT);
     if (EFI_ERROR (Status)) {
+      PciIo->Unmap (PciIo, Map);
       return Status;
     }
   }
 
-  Status = AhciReadLogExt (PciIo, AhciRegisters, Port, PortMultiplier, LogData, 0x30, 0x08);
+  DEBUG ((DEBUG_VERBOSE, "Starting command for queued DMA transfer in slot %d:\n", Slot));
+  AhciPrintCommandBlock (AtaCommandBlock, DEBUG_VERBOSE);
+
+  AhciRegisters->NcqActiveSlots           |= SlotBit;
+  AhciRegisters->NcqPortActiveSlots[Port] |= SlotBit;
 
   //
-  // Clear PxCMD.ST and PxDEVSLP.ADSE before updating PxDEVSLP.DITO and PxDEVSLP.MDAT.
+  // PxSACT has to be set before PxCI.
   //
-  AhciWriteReg (PciIo, Offset + EFI_AHCI_PORT_CMD, PortCmd & ~EFI_AHCI_PORT_CMD_ST);
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT;
+  AhciWriteReg (PciIo, Offset, SlotBit);
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CI;
+  AhciWriteReg (PciIo, Offset, SlotBit);
+
+  Task->Map         = Map;
+  Task->CommandSlot = Slot;
+  Task->IsStart     = TRUE;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check whether a queued command has completed.
+
+  @param[in]  PciIo          The PCI IO protocol instance.
+  @param[in]  Port           The number of port.
+  @param[in]  CommandSlot    The command slot of the command.
+
+  @retval EFI_SUCCESS        The command has completed.
+  @retval EFI_NOT_READY      The command is in flight.
+  @retval EFI_DEVICE_ERROR   An error is reported on the port. All queued commands
+                             of the port are aborted.
+
+**/
+EFI_STATUS
+AhciCheckQueuedCommand (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN UINT8                Port,
+  IN UINT8                CommandSlot
+  )
+{
+  UINT32  Offset;
+  UINT32  Outstanding;
+  UINT32  PortInterrupt;
+
+  //
+  // The device clears the bit of a command in PxSACT when it completes. Read it
+  // before PxIS, so that a command is not reported as completed when the bit is
+  // clear because of an error.
+  //
+  Offset       = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT;
+  Outstanding  = AhciReadReg (PciIo, Offset);
+  Offset       = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CI;
+  Outstanding |= AhciReadReg (PciIo, Offset);
+
+  Offset        = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_IS;
+  PortInterrupt = AhciReadReg (PciIo, Offset);
+  if ((PortInterrupt & EFI_AHCI_PORT_IS_ERROR_MASK) != 0) {
+    DEBUG ((DEBUG_ERROR, "AHCI: Error interrupt reported PxIS: %X\n", PortInterrupt));
+    return EFI_DEVICE_ERROR;
+  }
+
+  if ((Outstanding & (((UINT32)BIT0) << CommandSlot)) != 0) {
+    return EFI_NOT_READY;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Recover a port from the failure of a queued command.
+
+  All queued commands of the port are aborted.
+
+  @param[in]  PciIo            The PCI IO protocol instance.
+  @param[in]  AhciRegisters    The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]  Port             The number of port.
+  @param[in]  PortMultiplier   The number of port multiplier.
+  @param[in]  Failure          EFI_TIMEOUT if the command timed out, or
+                               EFI_DEVICE_ERROR if an error is reported.
+
+**/
+VOID
+AhciRecoverQueuedCommandError (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN EFI_AHCI_REGISTERS   *AhciRegisters,
+  IN UINT8                Port,
+  IN UINT8                PortMultiplier,
+  IN EFI_STATUS           Failure
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       LogData[512];
+
+  if (Failure == EFI_TIMEOUT) {
+    //
+    // The device may still work on the commands, so it has to be reset before
+    // their buffers are released.
+    //
+    AhciStopCommand (PciIo, Port, ATA_ATAPI_TIMEOUT);
+    Status = AhciResetPort (PciIo, Port);
+  } else {
+    Status = AhciRecoverPortError (PciIo, Port);
+    AhciStopCommand (PciIo, Port, ATA_ATAPI_TIMEOUT);
+    if (!EFI_ERROR (Status)) {
+      //
+      // After a queued command fails, the device aborts the other ones and only
+      // accepts new commands once the NCQ Command Error log is read.
+      //
+      Status = AhciReadLogExt (PciIo, AhciRegisters, Port, PortMultiplier, LogData, 0x10, 0);
+    }
+  }
+
+  AhciDisableFisReceive (PciIo, Port, ATA_ATAPI_TIMEOUT);
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to recover port %d from queued command error: %r\n", Port, Status));
+  }
+}
+
+/**
+  Release the command slot of a queued command, and stop the port when no other
+  queued command is in flight on it.
+
+  @param[in]       PciIo            The PCI IO protocol instance.
+  @param[in, out]  AhciRegisters    The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port             The number of port.
+  @param[in, out]  Task             The ATA_NONBLOCK_TASK that holds the command slot.
+
+**/
+VOID
+AhciReleaseQueuedCommand (
+  IN     EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN OUT EFI_AHCI_REGISTERS   *AhciRegisters,
+  IN     UINT8                Port,
+  IN OUT ATA_NONBLOCK_TASK    *Task
+  )
+{
+  UINT32  SlotBit;
+
+  SlotBit                                  = ((UINT32)BIT0) << Task->CommandSlot;
+  AhciRegisters->NcqActiveSlots           &= ~SlotBit;
+  AhciRegisters->NcqPortActiveSlots[Port] &= ~SlotBit;
+
+  if (AhciRegisters->NcqPortActiveSlots[Port] == 0) {
+    AhciStopCommand (PciIo, Port, ATA_ATAPI_TIMEOUT);
+    AhciDisableFisReceive (PciIo, Port, ATA_ATAPI_TIMEOUT);
+  }
+
+  PciIo->Unmap (PciIo, Task->Map);
+  Task->Map     = NULL;
+  Task->IsStart = FALSE;
+}
+
+/**
+  Start or check a READ/WRITE FPDMA QUEUED data transfer on specific port.
+
+  In non-blocking mode, each call issues the command if it is not issued yet,
+  and checks whether it has completed. Commands of other tasks may be in flight
+  in the other command slots at the same time.
+
+  @param[in]       Instance            The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       PortMultiplier      The number of port multiplier.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in, out]  MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in]       Timeout             The timeout value of data transfer, uses 100ns as a unit.
+  @param[in]       Task                Optional. Pointer to the ATA_NONBLOCK_TASK
+                                       used by non-blocking mode.
+
+  @retval EFI_DEVICE_ERROR    The data transfer abort with error occurs.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_UNSUPPORTED     Native command queuing is not supported.
+  @retval EFI_NOT_READY       The data transfer is not issued or not finished yet.
+  @retval EFI_SUCCESS         The data transfer executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciQueuedDmaTransfer (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN     EFI_AHCI_REGISTERS            *AhciRegisters,
+  IN     UINT8                         Port,
+  IN     UINT8                         PortMultiplier,
+  IN     BOOLEAN                       Read,
+  IN     EFI_ATA_COMMAND_BLOCK         *AtaCommandBlock,
+  IN OUT EFI_ATA_STATUS_BLOCK          *AtaStatusBlock,
+  IN OUT VOID                          *MemoryAddr,
+  IN     UINT32                        DataCount,
+  IN     UINT64                        Timeout,
+  IN     ATA_NONBLOCK_TASK             *Task
+  )
+{
+  EFI_STATUS           Status;
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  ATA_NONBLOCK_TASK    SyncTask;
+  ATA_NONBLOCK_TASK    *CurrentTask;
+  EFI_TPL              OldTpl;
+  UINT32               Offset;
+  UINT32               Data;
+
+  PciIo = Instance->PciIo;
+
+  if (PciIo == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (AhciRegisters->AhciNcqCommandTable == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // The command slots are shared with the non-blocking tasks, which are run
+  // from a timer event of TPL_NOTIFY.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  if (Task == NULL) {
+    //
+    // Before starting the blocking command, push to finish all non-blocking
+    // tasks. No new one is started until the command completes.
+    //
+    while (!IsListEmpty (&Instance->NonBlockingTaskList)) {
+      AsyncNonBlockingTransferRoutine (NULL, Instance);
+      //
+      // Stall for 100us.
+      //
+      MicroSecondDelay (100);
+    }
+
+    ZeroMem (&SyncTask, sizeof (SyncTask));
+    SyncTask.RetryTimes   = DivU64x32 (Timeout, 1000) + 1;
+    SyncTask.InfiniteWait = (BOOLEAN)(Timeout == 0);
+    CurrentTask           = &SyncTask;
+  } else {
+    CurrentTask = Task;
+  }
+
+  while (TRUE) {
+    Status = EFI_NOT_READY;
+    if (!CurrentTask->IsStart) {
+      Status = AhciIssueQueuedCommand (
+                 Instance,
+                 AhciRegisters,
+                 Port,
+                 PortMultiplier,
+                 Read,
+                 AtaCommandBlock,
+                 MemoryAddr,
+                 DataCount,
+                 CurrentTask
+                 );
+      if (EFI_ERROR (Status) && (Status != EFI_NOT_READY)) {
+        break;
+      }
+    }
+
+    if (CurrentTask->IsStart) {
+      Status = AhciCheckQueuedCommand (PciIo, Port, CurrentTask->CommandSlot);
+      if (Status == EFI_NOT_READY) {
+        if (!CurrentTask->InfiniteWait && (CurrentTask->RetryTimes == 0)) {
+          Status = EFI_TIMEOUT;
+        } else {
+          CurrentTask->RetryTimes--;
+        }
+      }
+    }
+
+    if ((Task != NULL) || (Status != EFI_NOT_READY)) {
+      break;
+    }
+
+    //
+    // Stall for 100us.
+    //
+    MicroSecondDelay (100);
+  }
+
+  if (CurrentTask->IsStart && (Status != EFI_NOT_READY)) {
+    //
+    // The task file of the port holds the status of the last completed command.
+    //
+    if (AtaStatusBlock != NULL) {
+      ZeroMem (AtaStatusBlock, sizeof (EFI_ATA_STATUS_BLOCK));
+      Offset                    = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
+      Data                      = AhciReadReg (PciIo, Offset);
+      AtaStatusBlock->AtaStatus = (UINT8)Data;
+      if ((AtaStatusBlock->AtaStatus & BIT0) != 0) {
+        AtaStatusBlock->AtaError = (UINT8)(Data >> 8);
+      }
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed to execute command for queued DMA transfer: %r\n", Status));
+      AhciPrintCommandBlock (AtaCommandBlock, DEBUG_ERROR);
+      AhciPrintStatusBlock (AtaStatusBlock, DEBUG_ERROR);
+      AhciRecoverQueuedCommandError (PciIo, AhciRegisters, Port, PortMultiplier, Status);
+    }
+
+    AhciReleaseQueuedCommand (PciIo, AhciRegisters, Port, CurrentTask);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
+}
+
+/**
+  Abort the queued commands of all non-blocking tasks.
+
+  The queued commands in flight are waited for before their ports are stopped,
+  so that no data is transferred to or from the buffers of the tasks afterwards.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+**/
+VOID
+EFIAPI
+AhciAbortQueuedDmaTransfers (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  )
+{
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  EFI_AHCI_REGISTERS   *AhciRegisters;
+  LIST_ENTRY           *Entry;
+  ATA_NONBLOCK_TASK    *Task;
+  UINT8                Port;
+  UINT32               Offset;
+  EFI_STATUS           Status;
+
+  PciIo         = Instance->PciIo;
+  AhciRegisters = &Instance->AhciRegisters;
+
+  if (AhciRegisters->NcqActiveSlots == 0) {
+    return;
+  }
+
+  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+    if (AhciRegisters->NcqPortActiveSlots[Port] == 0) {
+      continue;
+    }
+
+    Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT;
+    Status = AhciWaitMmioSet (PciIo, Offset, AhciRegisters->NcqPortActiveSlots[Port], 0, ATA_ATAPI_TIMEOUT);
+    AhciStopCommand (PciIo, Port, ATA_ATAPI_TIMEOUT);
+    if (EFI_ERROR (Status)) {
+      AhciResetPort (PciIo, Port);
+    }
+
+    AhciDisableFisReceive (PciIo, Port, ATA_ATAPI_TIMEOUT);
+    AhciRegisters->NcqPortActiveSlots[Port] = 0;
+  }
+
+  AhciRegisters->NcqActiveSlots = 0;
+
+  for (Entry = GetFirstNode (&Instance->NonBlockingTaskList);
+       !IsNull (&Instance->NonBlockingTaskList, Entry);
+       Entry = GetNextNode (&Instance->NonBlockingTaskList, Entry))
+  {
+    Task = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+    if ((Task->Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) && Task->IsStart) {
+      PciIo->Unmap (PciIo, Task->Map);
+      Task->Map     = NULL;
+      Task->IsStart = FALSE;
+    }
+  }
+}
+
+/**
+  Enable DEVSLP of the disk if supported.
+
+  @param  PciIo               The PCI IO protocol instance.
+  @param  AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param  Port                The number of port.
+  @param  PortMultiplier      The multiplier of port.
+  @param  IdentifyData        A pointer to data buffer which is used to contain IDENTIFY data.
+
+  @retval EFI_SUCCESS         The DEVSLP is enabled per policy successfully.
+  @retval EFI_UNSUPPORTED     The DEVSLP isn't supported by the controller/device and policy requires to enable it.
+**/
+EFI_STATUS
+AhciEnableDevSlp (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN EFI_AHCI_REGISTERS   *AhciRegisters,
+  IN UINT8                Port,
+  IN UINT8                PortMultiplier,
+  IN EFI_IDENTIFY_DATA    *IdentifyData
+  )
+{
+  EFI_STATUS               Status;
+  UINT32                   Offset;
+  UINT32                   Capability2;
+  UINT8                    LogData[512];
+  DEVSLP_TIMING_VARIABLES  DevSlpTiming;
+  UINT32                   PortCmd;
+  UINT32                   PortDevSlp;
+
+  if (mAtaAtapiPolicy->DeviceSleepEnable != 1) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Do not enable DevSlp if DevSlp is not supported.
+  //
+  Capability2 = AhciReadReg (PciIo, AHCI_CAPABILITY2_OFFSET);
+  DEBUG ((DEBUG_INFO, "AHCI CAPABILITY2 = %08x\n", Capability2));
+  if ((Capability2 & AHCI_CAP2_SDS) == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Do not enable DevSlp if DevSlp is not present
+  // Do not enable DevSlp if Hot Plug or Mechanical Presence Switch is supported
+  //
+  Offset     = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH;
+  PortCmd    = AhciReadReg (PciIo, Offset + EFI_AHCI_PORT_CMD);
+  PortDevSlp = AhciReadReg (PciIo, Offset + AHCI_PORT_DEVSLP);
+  DEBUG ((DEBUG_INFO, "Port CMD/DEVSLP = %08x / %08x\n", PortCmd, PortDevSlp));
+  if (((PortDevSlp & AHCI_PORT_DEVSLP_DSP) == 0) ||
+      ((PortCmd & (EFI_AHCI_PORT_CMD_HPCP | EFI_AHCI_PORT_CMD_MPSP)) != 0)
+      )
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Do not enable DevSlp if the device doesn't support DevSlp
+  //
+  DEBUG ((
+    DEBUG_INFO,
+    "IDENTIFY DEVICE: [77] = %04x, [78] = %04x, [79] = %04x\n",
+    IdentifyData->AtaData.reserved_77,
+    IdentifyData->AtaData.serial_ata_features_supported,
+    IdentifyData->AtaData.serial_ata_features_enabled
+    ));
+  if ((IdentifyData->AtaData.serial_ata_features_supported & BIT8) == 0) {
+    DEBUG ((
+      DEBUG_INFO,
+      "DevSlp feature is not supported for device at port [%d] PortMultiplier [%d]!\n",
+      Port,
+      PortMultiplier
+      ));
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Enable DevSlp when it is not enabled.
+  //
+  if ((IdentifyData->AtaData.serial_ata_features_enabled & BIT8) != 0) {
+    Status = AhciDeviceSetFeature (
+               PciIo,
+               AhciRegisters,
+               Port,
+               0,
+               ATA_SUB_CMD_ENABLE_SATA_FEATURE,
+               0x09,
+               ATA_ATAPI_TIMEOUT
+               );
+    DEBUG ((
+      DEBUG_INFO,
+      "DevSlp set feature for device at port [%d] PortMultiplier [%d] - %r\n",
+      Port,
+      PortMultiplier,
+      Status
+      ));
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Status = AhciReadLogExt (PciIo, AhciRegisters, Port, PortMultiplier, LogData, 0x30, 0x08);
+
+  //
+  // Clear PxCMD.ST and PxDEVSLP.ADSE before updating PxDEVSLP.DITO and PxDEVSLP.MDAT.
+  //
+  AhciWriteReg (PciIo, Offset + EFI_AHCI_PORT_CMD, PortCmd & ~EFI_AHCI_PORT_CMD_ST);
   PortDevSlp &= ~AHCI_PORT_DEVSLP_ADSE;
   AhciWriteReg (PciIo, Offset + AHCI_PORT_DEVSLP, PortDevSlp);
 
@@ -2851,165 +3558,408 @@ AhciPuisEnable (
 }
 
 /**
-  Initialize ATA host controller at AHCI mode.
+  Reset ATA host controller at AHCI mode and allocate the transfer descriptors,
+  and get the ports to initialize.
 
-  The function is designed to initialize ATA host controller.
+  @param[in]   Instance         A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[out]  PortBitMap       The bit map of the ports to initialize.
+
+  @retval EFI_SUCCESS           The controller is reset.
+  @retval EFI_DEVICE_ERROR      The controller cannot be reset.
+  @retval EFI_OUT_OF_RESOURCES  The transfer descriptors cannot be allocated.
+
+**/
+EFI_STATUS
+AhciModeInitController (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  OUT UINT32                        *PortBitMap
+  )
+{
+  EFI_STATUS           Status;
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  UINT32               Capability;
+  UINT8                MaxPortNumber;
+  UINT32               PortImplementBitMap;
+  UINT8                Port;
+  UINT32               Value;
+
+  PciIo       = Instance->PciIo;
+  *PortBitMap = 0;
+
+  Status = AhciReset (PciIo, EFI_AHCI_BUS_RESET_TIMEOUT);
+
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  //
+  // Collect AHCI controller information
+  //
+  Capability = AhciReadReg (PciIo, EFI_AHCI_CAPABILITY_OFFSET);
+
+  //
+  // Make sure that GHC.AE bit is set before accessing any AHCI registers.
+  //
+  Value = AhciReadReg (PciIo, EFI_AHCI_GHC_OFFSET);
+
+  if ((Value & EFI_AHCI_GHC_ENABLE) == 0) {
+    AhciOrReg (PciIo, EFI_AHCI_GHC_OFFSET, EFI_AHCI_GHC_ENABLE);
+  }
+
+  //
+  // Enable 64-bit DMA support in the PCI layer if this controller
+  // supports it.
+  //
+  if ((Capability & EFI_AHCI_CAP_S64A) != 0) {
+    Status = PciIo->Attributes (
+                      PciIo,
+                      EfiPciIoAttributeOperationEnable,
+                      EFI_PCI_IO_ATTRIBUTE_DUAL_ADDRESS_CYCLE,
+                      NULL
+                      );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_WARN,
+        "AhciModeInitialization: failed to enable 64-bit DMA on 64-bit capable controller (%r)\n",
+        Status
+        ));
+    }
+  }
+
+  //
+  // Get the number of command slots per port supported by this HBA.
+  //
+  MaxPortNumber = (UINT8)((Capability & 0x1F) + 1);
+
+  //
+  // Get the bit map of those ports exposed by this HBA.
+  // It indicates which ports that the HBA supports are available for software to use.
+  //
+  PortImplementBitMap = AhciReadReg (PciIo, EFI_AHCI_PI_OFFSET);
+
+  Status = AhciCreateTransferDescriptor (PciIo, &Instance->AhciRegisters);
+
+  if (EFI_ERROR (Status)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+    if ((PortImplementBitMap & (((UINT32)BIT0) << Port)) != 0) {
+      //
+      // According to AHCI spec, MaxPortNumber should be equal or greater than the number of implemented ports.
+      //
+      if ((MaxPortNumber--) == 0) {
+        //
+        // Should never be here.
+        //
+        ASSERT (FALSE);
+        break;
+      }
+
+      *PortBitMap |= ((UINT32)BIT0) << Port;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Set up a port of ATA host controller at AHCI mode, and start the detection of
+  the device attached to it.
 
   @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  Port              The port number.
+
+**/
+VOID
+AhciModeInitPort (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN  UINT8                         Port
+  )
+{
+  EFI_PCI_IO_PROTOCOL               *PciIo;
+  EFI_IDE_CONTROLLER_INIT_PROTOCOL  *IdeInit;
+  EFI_AHCI_REGISTERS                *AhciRegisters;
+  DATA_64                           Data64;
+  UINT32                            Offset;
+  UINT32                            Data;
+
+  PciIo         = Instance->PciIo;
+  IdeInit       = Instance->IdeControllerInit;
+  AhciRegisters = &Instance->AhciRegisters;
+
+  IdeInit->NotifyPhase (IdeInit, EfiIdeBeforeChannelEnumeration, Port);
+
+  //
+  // Initialize FIS Base Address Register and Command List Base Address Register for use.
+  //
+  Data64.Uint64 = (UINTN)(AhciRegisters->AhciRFisPciAddr) + sizeof (EFI_AHCI_RECEIVED_FIS) * Port;
+  Offset        = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_FB;
+  AhciWriteReg (PciIo, Offset, Data64.Uint32.Lower32);
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_FBU;
+  AhciWriteReg (PciIo, Offset, Data64.Uint32.Upper32);
+
+  Data64.Uint64 = (UINTN)(AhciRegisters->AhciCmdListPciAddr);
+  Offset        = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CLB;
+  AhciWriteReg (PciIo, Offset, Data64.Uint32.Lower32);
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CLBU;
+  AhciWriteReg (PciIo, Offset, Data64.Uint32.Upper32);
+
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
+  Data   = AhciReadReg (PciIo, Offset);
+  if ((Data & EFI_AHCI_PORT_CMD_CPD) != 0) {
+    AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_POD);
+  }
+
+  if ((AhciReadReg (PciIo, EFI_AHCI_CAPABILITY_OFFSET) & EFI_AHCI_CAP_SSS) != 0) {
+    AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_SUD);
+  }
+
+  //
+  // Disable aggressive power management.
+  //
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SCTL;
+  AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_SCTL_IPM_INIT);
+  //
+  // Disable the reporting of the corresponding interrupt to system software.
+  //
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_IE;
+  AhciAndReg (PciIo, Offset, 0);
+
+  //
+  // Now inform the IDE Controller Init Module.
+  //
+  IdeInit->NotifyPhase (IdeInit, EfiIdeBusBeforeDevicePresenceDetection, Port);
+
+  //
+  // Enable FIS Receive DMA engine for the first D2H FIS.
+  //
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
+  AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_FRE);
+}
+
+/**
+  Identify and configure the device attached to a port of ATA host controller at
+  AHCI mode once it reported its signature, and add it into the device list.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  Port              The port number.
+
+  @retval EFI_SUCCESS           The device is probed.
+  @retval Others                The device cannot be identified or configured.
 
 **/
 EFI_STATUS
-EFIAPI
-AhciModeInitialization (
-  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+AhciModeProbePort (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN  UINT8                         Port
   )
 {
   EFI_STATUS                        Status;
   EFI_PCI_IO_PROTOCOL               *PciIo;
   EFI_IDE_CONTROLLER_INIT_PROTOCOL  *IdeInit;
-  UINT32                            Capability;
-  UINT8                             MaxPortNumber;
-  UINT32                            PortImplementBitMap;
+  EFI_AHCI_REGISTERS                *AhciRegisters;
+  UINT32                            Offset;
+  UINT32                            Data;
+  EFI_IDENTIFY_DATA                 Buffer;
+  EFI_ATA_DEVICE_TYPE               DeviceType;
+  EFI_ATA_COLLECTIVE_MODE           *SupportedModes;
+  EFI_ATA_TRANSFER_MODE             TransferMode;
+
+  PciIo         = Instance->PciIo;
+  IdeInit       = Instance->IdeControllerInit;
+  AhciRegisters = &Instance->AhciRegisters;
 
-  EFI_AHCI_REGISTERS  *AhciRegisters;
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SIG;
+  Data   = AhciReadReg (PciIo, Offset);
+  if ((Data & EFI_AHCI_ATAPI_SIG_MASK) == EFI_AHCI_ATAPI_DEVICE_SIG) {
+    Status = AhciIdentifyPacket (PciIo, AhciRegisters, Port, 0, &Buffer);
 
-  UINT8                    Port;
-  DATA_64                  Data64;
-  UINT32                   Offset;
-  UINT32                   Data;
-  EFI_IDENTIFY_DATA        Buffer;
-  EFI_ATA_DEVICE_TYPE      DeviceType;
-  EFI_ATA_COLLECTIVE_MODE  *SupportedModes;
-  EFI_ATA_TRANSFER_MODE    TransferMode;
-  UINT32                   PhyDetectDelay;
-  UINT32                   Value;
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
 
-  if (Instance == NULL) {
-    return EFI_INVALID_PARAMETER;
-  }
+    DeviceType = EfiIdeCdrom;
+  } else if ((Data & EFI_AHCI_ATAPI_SIG_MASK) == EFI_AHCI_ATA_DEVICE_SIG) {
+    Status = AhciIdentify (PciIo, AhciRegisters, Port, 0, &Buffer);
 
-  PciIo   = Instance->PciIo;
-  IdeInit = Instance->IdeControllerInit;
+    if (EFI_ERROR (Status)) {
+      REPORT_STATUS_CODE (EFI_PROGRESS_CODE, (EFI_PERIPHERAL_FIXED_MEDIA | EFI_P_EC_NOT_DETECTED));
+      return Status;
+    }
 
-  Status = AhciReset (PciIo, EFI_AHCI_BUS_RESET_TIMEOUT);
+    DEBUG ((
+      DEBUG_INFO,
+      "IDENTIFY DEVICE: [0] = %016x, [2] = %016x, [83] = %016x, [86] = %016x\n",
+      Buffer.AtaData.config,
+      Buffer.AtaData.specific_config,
+      Buffer.AtaData.command_set_supported_83,
+      Buffer.AtaData.command_set_feature_enb_86
+      ));
+    if ((Buffer.AtaData.config & BIT2) != 0) {
+      //
+      // SpinUp disk if device reported incomplete IDENTIFY DEVICE.
+      //
+      Status = AhciSpinUpDisk (
+                 PciIo,
+                 AhciRegisters,
+                 Port,
+                 0,
+                 &Buffer
+                 );
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "Spin up standby device failed - %r\n", Status));
+        return Status;
+      }
+    }
 
-  if (EFI_ERROR (Status)) {
-    return EFI_DEVICE_ERROR;
+    DeviceType = EfiIdeHarddisk;
+  } else {
+    return EFI_UNSUPPORTED;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "port [%d] port multitplier [%d] has a [%a]\n",
+    Port,
+    0,
+    DeviceType == EfiIdeCdrom ? "cdrom" : "harddisk"
+    ));
+
+  //
+  // If the device is a hard disk, then try to enable S.M.A.R.T feature
+  //
+  if ((DeviceType == EfiIdeHarddisk) && PcdGetBool (PcdAtaSmartEnable)) {
+    AhciAtaSmartSupport (
+      PciIo,
+      AhciRegisters,
+      Port,
+      0,
+      &Buffer,
+      NULL
+      );
   }
 
   //
-  // Collect AHCI controller information
+  // Submit identify data to IDE controller init driver
   //
-  Capability = AhciReadReg (PciIo, EFI_AHCI_CAPABILITY_OFFSET);
+  IdeInit->SubmitData (IdeInit, Port, 0, &Buffer);
 
   //
-  // Make sure that GHC.AE bit is set before accessing any AHCI registers.
+  // Now start to config ide device parameter and transfer mode.
   //
-  Value = AhciReadReg (PciIo, EFI_AHCI_GHC_OFFSET);
-
-  if ((Value & EFI_AHCI_GHC_ENABLE) == 0) {
-    AhciOrReg (PciIo, EFI_AHCI_GHC_OFFSET, EFI_AHCI_GHC_ENABLE);
+  Status = IdeInit->CalculateMode (
+                      IdeInit,
+                      Port,
+                      0,
+                      &SupportedModes
+                      );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Calculate Mode Fail, Status = %r\n", Status));
+    return Status;
   }
 
   //
-  // Enable 64-bit DMA support in the PCI layer if this controller
-  // supports it.
+  // Set best supported PIO mode on this IDE device
   //
-  if ((Capability & EFI_AHCI_CAP_S64A) != 0) {
-    Status = PciIo->Attributes (
-                      PciIo,
-                      EfiPciIoAttributeOperationEnable,
-                      EFI_PCI_IO_ATTRIBUTE_DUAL_ADDRESS_CYCLE,
-                      NULL
-                      );
-    if (EFI_ERROR (Status)) {
-      DEBUG ((
-        DEBUG_WARN,
-        "AhciModeInitialization: failed to enable 64-bit DMA on 64-bit capable controller (%r)\n",
-        Status
-        ));
-    }
+  if (SupportedModes->PioMode.Mode <= EfiAtaPioMode2) {
+    TransferMode.ModeCategory = EFI_ATA_MODE_DEFAULT_PIO;
+  } else {
+    TransferMode.ModeCategory = EFI_ATA_MODE_FLOW_PIO;
   }
 
+  TransferMode.ModeNumber = (UINT8)(SupportedModes->PioMode.Mode);
+
   //
-  // Get the number of command slots per port supported by this HBA.
+  // Set supported DMA mode on this IDE device. Note that UDMA & MDMA can't
+  // be set together. Only one DMA mode can be set to a device. If setting
+  // DMA mode operation fails, we can continue moving on because we only use
+  // PIO mode at boot time. DMA modes are used by certain kind of OS booting
   //
-  MaxPortNumber = (UINT8)((Capability & 0x1F) + 1);
+  if (SupportedModes->UdmaMode.Valid) {
+    TransferMode.ModeCategory = EFI_ATA_MODE_UDMA;
+    TransferMode.ModeNumber   = (UINT8)(SupportedModes->UdmaMode.Mode);
+  } else if (SupportedModes->MultiWordDmaMode.Valid) {
+    TransferMode.ModeCategory = EFI_ATA_MODE_MDMA;
+    TransferMode.ModeNumber   = (UINT8)SupportedModes->MultiWordDmaMode.Mode;
+  }
+
+  Status = AhciDeviceSetFeature (PciIo, AhciRegisters, Port, 0, 0x03, (UINT32)(*(UINT8 *)&TransferMode), ATA_ATAPI_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Set transfer Mode Fail, Status = %r\n", Status));
+    return Status;
+  }
 
   //
-  // Get the bit map of those ports exposed by this HBA.
-  // It indicates which ports that the HBA supports are available for software to use.
+  // Found a ATA or ATAPI device, add it into the device list.
   //
-  PortImplementBitMap = AhciReadReg (PciIo, EFI_AHCI_PI_OFFSET);
-
-  AhciRegisters = &Instance->AhciRegisters;
-  Status        = AhciCreateTransferDescriptor (PciIo, AhciRegisters);
+  CreateNewDeviceInfo (Instance, Port, 0xFFFF, DeviceType, &Buffer);
+  if (DeviceType == EfiIdeHarddisk) {
+    REPORT_STATUS_CODE (EFI_PROGRESS_CODE, (EFI_PERIPHERAL_FIXED_MEDIA | EFI_P_PC_ENABLE));
+    AhciEnableDevSlp (
+      PciIo,
+      AhciRegisters,
+      Port,
+      0,
+      &Buffer
+      );
+  }
 
-  if (EFI_ERROR (Status)) {
-    return EFI_OUT_OF_RESOURCES;
+  //
+  // Enable/disable PUIS according to policy setting if PUIS is capable (Word[83].BIT5 is set).
+  //
+  if ((Buffer.AtaData.command_set_supported_83 & BIT5) != 0) {
+    Status = AhciPuisEnable (
+               PciIo,
+               AhciRegisters,
+               Port,
+               0
+               );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "PUIS enable/disable failed, Status = %r\n", Status));
+      return Status;
+    }
   }
 
-  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
-    if ((PortImplementBitMap & (((UINT32)BIT0) << Port)) != 0) {
-      //
-      // According to AHCI spec, MaxPortNumber should be equal or greater than the number of implemented ports.
-      //
-      if ((MaxPortNumber--) == 0) {
-        //
-        // Should never be here.
-        //
-        ASSERT (FALSE);
-        return EFI_SUCCESS;
-      }
+  return EFI_SUCCESS;
+}
 
-      IdeInit->NotifyPhase (IdeInit, EfiIdeBeforeChannelEnumeration, Port);
+/**
+  Initialize ATA host controller at AHCI mode.
 
-      //
-      // Initialize FIS Base Address Register and Command List Base Address Register for use.
-      //
-      Data64.Uint64 = (UINTN)(AhciRegisters->AhciRFisPciAddr) + sizeof (EFI_AHCI_RECEIVED_FIS) * Port;
-      Offset        = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_FB;
-      AhciWriteReg (PciIo, Offset, Data64.Uint32.Lower32);
-      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_FBU;
-      AhciWriteReg (PciIo, Offset, Data64.Uint32.Upper32);
-
-      Data64.Uint64 = (UINTN)(AhciRegisters->AhciCmdListPciAddr);
-      Offset        = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CLB;
-      AhciWriteReg (PciIo, Offset, Data64.Uint32.Lower32);
-      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CLBU;
-      AhciWriteReg (PciIo, Offset, Data64.Uint32.Upper32);
+  The function is designed to initialize ATA host controller.
 
-      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
-      Data   = AhciReadReg (PciIo, Offset);
-      if ((Data & EFI_AHCI_PORT_CMD_CPD) != 0) {
-        AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_POD);
-      }
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
 
-      if ((Capability & EFI_AHCI_CAP_SSS) != 0) {
-        AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_SUD);
-      }
+**/
+EFI_STATUS
+EFIAPI
+AhciModeInitialization (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  )
+{
+  EFI_STATUS           Status;
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  UINT32               PortBitMap;
+  UINT8                Port;
+  UINT32               Offset;
+  UINT32               Data;
+  UINT32               PhyDetectDelay;
 
-      //
-      // Disable aggressive power management.
-      //
-      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SCTL;
-      AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_SCTL_IPM_INIT);
-      //
-      // Disable the reporting of the corresponding interrupt to system software.
-      //
-      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_IE;
-      AhciAndReg (PciIo, Offset, 0);
+  if (Instance == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
 
-      //
-      // Now inform the IDE Controller Init Module.
-      //
-      IdeInit->NotifyPhase (IdeInit, EfiIdeBusBeforeDevicePresenceDetection, Port);
+  PciIo = Instance->PciIo;
 
-      //
-      // Enable FIS Receive DMA engine for the first D2H FIS.
-      //
-      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
-      AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_FRE);
+  Status = AhciModeInitController (Instance, &PortBitMap);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+    if ((PortBitMap & (((UINT32)BIT0) << Port)) != 0) {
+      AhciModeInitPort (Instance, Port);
 
       //
       // Wait for the Phy to detect the presence of a device.
@@ -3056,157 +4006,266 @@ AhciModeInitialization (
         continue;
       }
 
-      Data = AhciReadReg (PciIo, Offset);
-      if ((Data & EFI_AHCI_ATAPI_SIG_MASK) == EFI_AHCI_ATAPI_DEVICE_SIG) {
-        Status = AhciIdentifyPacket (PciIo, AhciRegisters, Port, 0, &Buffer);
+      AhciModeProbePort (Instance, Port);
+    }
+  }
 
-        if (EFI_ERROR (Status)) {
-          continue;
-        }
+  return EFI_SUCCESS;
+}
 
-        DeviceType = EfiIdeCdrom;
-      } else if ((Data & EFI_AHCI_ATAPI_SIG_MASK) == EFI_AHCI_ATA_DEVICE_SIG) {
-        Status = AhciIdentify (PciIo, AhciRegisters, Port, 0, &Buffer);
+/**
+  Move a port to the next phase of the device detection started by
+  AhciModeStartInitialization(), and restart its timeout.
 
-        if (EFI_ERROR (Status)) {
-          REPORT_STATUS_CODE (EFI_PROGRESS_CODE, (EFI_PERIPHERAL_FIXED_MEDIA | EFI_P_EC_NOT_DETECTED));
-          continue;
-        }
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  Port              The port number.
+  @param[in]  Phase             The phase of the device detection.
+  @param[in]  Timeout           The timeout of the phase, uses 100ns as a unit.
 
-        DEBUG ((
-          DEBUG_INFO,
-          "IDENTIFY DEVICE: [0] = %016x, [2] = %016x, [83] = %016x, [86] = %016x\n",
-          Buffer.AtaData.config,
-          Buffer.AtaData.specific_config,
-          Buffer.AtaData.command_set_supported_83,
-          Buffer.AtaData.command_set_feature_enb_86
-          ));
-        if ((Buffer.AtaData.config & BIT2) != 0) {
-          //
-          // SpinUp disk if device reported incomplete IDENTIFY DEVICE.
-          //
-          Status = AhciSpinUpDisk (
-                     PciIo,
-                     AhciRegisters,
-                     Port,
-                     0,
-                     &Buffer
-                     );
-          if (EFI_ERROR (Status)) {
-            DEBUG ((DEBUG_ERROR, "Spin up standby device failed - %r\n", Status));
-            continue;
-          }
-        }
+**/
+VOID
+AhciSetPortInitPhase (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN  UINT8                         Port,
+  IN  UINT8                         Phase,
+  IN  UINT64                        Timeout
+  )
+{
+  Instance->PortInitPhase[Port] = Phase;
+  gBS->SetTimer (Instance->PortInitTimeoutEvent[Port], TimerRelative, Timeout);
 
-        DeviceType = EfiIdeHarddisk;
-      } else {
-        continue;
-      }
+  //
+  // Clear the timeout of the previous phase, in case it expired meanwhile.
+  //
+  gBS->CheckEvent (Instance->PortInitTimeoutEvent[Port]);
+}
 
-      DEBUG ((
-        DEBUG_INFO,
-        "port [%d] port multitplier [%d] has a [%a]\n",
-        Port,
-        0,
-        DeviceType == EfiIdeCdrom ? "cdrom" : "harddisk"
-        ));
+/**
+  Check the progress of the device detection on a port, without waiting.
 
-      //
-      // If the device is a hard disk, then try to enable S.M.A.R.T feature
-      //
-      if ((DeviceType == EfiIdeHarddisk) && PcdGetBool (PcdAtaSmartEnable)) {
-        AhciAtaSmartSupport (
-          PciIo,
-          AhciRegisters,
-          Port,
-          0,
-          &Buffer,
-          NULL
-          );
-      }
+  The phases follow the waits of AhciModeInitialization(): the Phy detects the
+  presence of a device, then the device clears PxTFD.BSY, PxTFD.DRQ and PxTFD.ERR,
+  then the device reports its signature.
 
-      //
-      // Submit identify data to IDE controller init driver
-      //
-      IdeInit->SubmitData (IdeInit, Port, 0, &Buffer);
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  Port              The port number.
 
-      //
-      // Now start to config ide device parameter and transfer mode.
-      //
-      Status = IdeInit->CalculateMode (
-                          IdeInit,
-                          Port,
-                          0,
-                          &SupportedModes
-                          );
-      if (EFI_ERROR (Status)) {
-        DEBUG ((DEBUG_ERROR, "Calculate Mode Fail, Status = %r\n", Status));
-        continue;
+  @retval EFI_SUCCESS           The device reported its signature, and can be probed
+                                by AhciModeProbePort().
+  @retval EFI_NOT_READY         The device detection is in progress.
+  @retval EFI_NOT_FOUND         No device is detected at the port.
+
+**/
+EFI_STATUS
+AhciModePollPort (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN  UINT8                         Port
+  )
+{
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  BOOLEAN              TimedOut;
+  UINT32               Offset;
+  UINT32               Data;
+
+  PciIo    = Instance->PciIo;
+  TimedOut = (BOOLEAN) !EFI_ERROR (gBS->CheckEvent (Instance->PortInitTimeoutEvent[Port]));
+
+  switch (Instance->PortInitPhase[Port]) {
+    case AHCI_PORT_INIT_PHY_DETECT:
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SSTS;
+      Data   = AhciReadReg (PciIo, Offset) & EFI_AHCI_PORT_SSTS_DET_MASK;
+      if ((Data == EFI_AHCI_PORT_SSTS_DET_PCE) || (Data == EFI_AHCI_PORT_SSTS_DET)) {
+        AhciSetPortInitPhase (Instance, Port, AHCI_PORT_INIT_DEVICE_READY, EFI_TIMER_PERIOD_SECONDS (16));
+        return EFI_NOT_READY;
       }
 
-      //
-      // Set best supported PIO mode on this IDE device
-      //
-      if (SupportedModes->PioMode.Mode <= EfiAtaPioMode2) {
-        TransferMode.ModeCategory = EFI_ATA_MODE_DEFAULT_PIO;
-      } else {
-        TransferMode.ModeCategory = EFI_ATA_MODE_FLOW_PIO;
+      if (TimedOut) {
+        //
+        // No device detected at this port.
+        // Clear PxCMD.SUD for those ports at which there are no device present.
+        //
+        Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
+        AhciAndReg (PciIo, Offset, (UINT32) ~(EFI_AHCI_PORT_CMD_SUD));
+        return EFI_NOT_FOUND;
       }
 
-      TransferMode.ModeNumber = (UINT8)(SupportedModes->PioMode.Mode);
+      break;
 
-      //
-      // Set supported DMA mode on this IDE device. Note that UDMA & MDMA can't
-      // be set together. Only one DMA mode can be set to a device. If setting
-      // DMA mode operation fails, we can continue moving on because we only use
-      // PIO mode at boot time. DMA modes are used by certain kind of OS booting
-      //
-      if (SupportedModes->UdmaMode.Valid) {
-        TransferMode.ModeCategory = EFI_ATA_MODE_UDMA;
-        TransferMode.ModeNumber   = (UINT8)(SupportedModes->UdmaMode.Mode);
-      } else if (SupportedModes->MultiWordDmaMode.Valid) {
-        TransferMode.ModeCategory = EFI_ATA_MODE_MDMA;
-        TransferMode.ModeNumber   = (UINT8)SupportedModes->MultiWordDmaMode.Mode;
+    case AHCI_PORT_INIT_DEVICE_READY:
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SERR;
+      if (AhciReadReg (PciIo, Offset) != 0) {
+        AhciWriteReg (PciIo, Offset, AhciReadReg (PciIo, Offset));
       }
 
-      Status = AhciDeviceSetFeature (PciIo, AhciRegisters, Port, 0, 0x03, (UINT32)(*(UINT8 *)&TransferMode), ATA_ATAPI_TIMEOUT);
-      if (EFI_ERROR (Status)) {
-        DEBUG ((DEBUG_ERROR, "Set transfer Mode Fail, Status = %r\n", Status));
-        continue;
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
+      Data   = AhciReadReg (PciIo, Offset) & EFI_AHCI_PORT_TFD_MASK;
+      if (Data == 0) {
+        AhciSetPortInitPhase (Instance, Port, AHCI_PORT_INIT_SIGNATURE, EFI_TIMER_PERIOD_SECONDS (16));
+        return EFI_NOT_READY;
       }
 
-      //
-      // Found a ATA or ATAPI device, add it into the device list.
-      //
-      CreateNewDeviceInfo (Instance, Port, 0xFFFF, DeviceType, &Buffer);
-      if (DeviceType == EfiIdeHarddisk) {
-        REPORT_STATUS_CODE (EFI_PROGRESS_CODE, (EFI_PERIPHERAL_FIXED_MEDIA | EFI_P_PC_ENABLE));
-        AhciEnableDevSlp (
-          PciIo,
-          AhciRegisters,
-          Port,
-          0,
-          &Buffer
-          );
+      if (TimedOut) {
+        DEBUG ((DEBUG_ERROR, "Port %d Device not ready (TFD=0x%X)\n", Port, Data));
+        return EFI_NOT_FOUND;
       }
 
+      break;
+
+    default:
       //
-      // Enable/disable PUIS according to policy setting if PUIS is capable (Word[83].BIT5 is set).
+      // When the first D2H register FIS is received, the content of PxSIG register is updated.
       //
-      if ((Buffer.AtaData.command_set_supported_83 & BIT5) != 0) {
-        Status = AhciPuisEnable (
-                   PciIo,
-                   AhciRegisters,
-                   Port,
-                   0
-                   );
-        if (EFI_ERROR (Status)) {
-          DEBUG ((DEBUG_ERROR, "PUIS enable/disable failed, Status = %r\n", Status));
-          continue;
-        }
+      Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SIG;
+      if ((AhciReadReg (PciIo, Offset) & 0x0000FFFF) == 0x00000101) {
+        return EFI_SUCCESS;
+      }
+
+      if (TimedOut) {
+        return EFI_NOT_FOUND;
+      }
+
+      break;
+  }
+
+  return EFI_NOT_READY;
+}
+
+/**
+  Stop the device detection started by AhciModeStartInitialization().
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+**/
+VOID
+EFIAPI
+AhciModeCancelInitialization (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  )
+{
+  UINT8  Port;
+
+  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+    if (Instance->PortInitTimeoutEvent[Port] != NULL) {
+      gBS->CloseEvent (Instance->PortInitTimeoutEvent[Port]);
+      Instance->PortInitTimeoutEvent[Port] = NULL;
+    }
+  }
+
+  Instance->PendingPorts = 0;
+  Instance->ReadyPorts   = 0;
+}
+
+/**
+  Start to initialize ATA host controller at AHCI mode, without waiting for the
+  devices attached to its ports.
+
+  All the ports are set up at once, and the devices attached to them are detected
+  together by AhciModePollInitialization(), instead of one port after another.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+  @retval EFI_SUCCESS           The initialization is started.
+  @retval Others                The initialization cannot be started.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciModeStartInitialization (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      PortBitMap;
+  UINT8       Port;
+
+  Status = AhciModeInitController (Instance, &PortBitMap);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Instance->PendingPorts = 0;
+  Instance->ReadyPorts   = 0;
+  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+    if ((PortBitMap & (((UINT32)BIT0) << Port)) != 0) {
+      Status = gBS->CreateEvent (
+                      EVT_TIMER,
+                      TPL_CALLBACK,
+                      NULL,
+                      NULL,
+                      &Instance->PortInitTimeoutEvent[Port]
+                      );
+      if (EFI_ERROR (Status)) {
+        AhciModeCancelInitialization (Instance);
+        return Status;
       }
+
+      Instance->PendingPorts |= ((UINT32)BIT0) << Port;
+    }
+  }
+
+  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+    if ((Instance->PendingPorts & (((UINT32)BIT0) << Port)) != 0) {
+      AhciModeInitPort (Instance, Port);
+      AhciSetPortInitPhase (
+        Instance,
+        Port,
+        AHCI_PORT_INIT_PHY_DETECT,
+        EFI_TIMER_PERIOD_MILLISECONDS (EFI_AHCI_BUS_PHY_DETECT_TIMEOUT)
+        );
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check the progress of the initialization started by AhciModeStartInitialization(),
+  without waiting. Once no device detection is in progress, the detected devices
+  are probed and added into the device list.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+  @retval EFI_SUCCESS           The initialization is finished.
+  @retval EFI_NOT_READY         The device detection is in progress on some ports.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciModePollInitialization (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       Port;
+
+  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+    if ((Instance->PendingPorts & (((UINT32)BIT0) << Port)) == 0) {
+      continue;
+    }
+
+    Status = AhciModePollPort (Instance, Port);
+    if (Status == EFI_NOT_READY) {
+      continue;
+    }
+
+    gBS->CloseEvent (Instance->PortInitTimeoutEvent[Port]);
+    Instance->PortInitTimeoutEvent[Port] = NULL;
+    Instance->PendingPorts              &= ~(((UINT32)BIT0) << Port);
+    if (!EFI_ERROR (Status)) {
+      Instance->ReadyPorts |= ((UINT32)BIT0) << Port;
+    }
+  }
+
+  if (Instance->PendingPorts != 0) {
+    return EFI_NOT_READY;
+  }
+
+  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+    if ((Instance->ReadyPorts & (((UINT32)BIT0) << Port)) != 0) {
+      AhciModeProbePort (Instance, Port);
     }
   }
 
+  Instance->ReadyPorts = 0;
   return EFI_SUCCESS;
 }
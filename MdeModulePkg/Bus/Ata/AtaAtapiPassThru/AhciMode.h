@@ -14,6 +14,7 @@
 #define EFI_AHCI_CAPABILITY_OFFSET  0x0000
 #define   EFI_AHCI_CAP_SAM          BIT18
 #define   EFI_AHCI_CAP_SSS          BIT27
+#define   EFI_AHCI_CAP_SNCQ         BIT30
 #define   EFI_AHCI_CAP_S64A         BIT31
 #define EFI_AHCI_GHC_OFFSET         0x0004
 #define   EFI_AHCI_GHC_RESET        BIT0
@@ -44,6 +45,14 @@ typedef union {
 //
 #define  EFI_AHCI_BUS_PHY_DETECT_TIMEOUT  15
 //
+// The phases of the device detection on a port, when the ports are polled from
+// a timer event, and the period of the timer event.
+//
+#define  AHCI_PORT_INIT_PHY_DETECT    0
+#define  AHCI_PORT_INIT_DEVICE_READY  1
+#define  AHCI_PORT_INIT_SIGNATURE     2
+#define  AHCI_INIT_POLL_INTERVAL      EFI_TIMER_PERIOD_MILLISECONDS(1)
+//
 // Refer SATA1.0a spec, the FIS enable time should be less than 500ms.
 //
 #define  EFI_AHCI_PORT_CMD_FR_CLEAR_TIMEOUT  EFI_TIMER_PERIOD_MILLISECONDS(500)
@@ -286,6 +295,20 @@ typedef struct {
   EFI_AHCI_COMMAND_PRDT     PrdtTable[65535];     // The scatter/gather list for data transfer
 } EFI_AHCI_COMMAND_TABLE;
 
+//
+// Each command slot used for native command queuing has its own command table,
+// with a scatter/gather list that is limited to EFI_AHCI_NCQ_MAX_PRDT entries.
+//
+#define EFI_AHCI_NCQ_MAX_PRDT           8
+#define EFI_AHCI_NCQ_MAX_TRANSFER_SIZE  (EFI_AHCI_NCQ_MAX_PRDT * EFI_AHCI_MAX_DATA_PER_PRDT)
+
+typedef struct {
+  EFI_AHCI_COMMAND_FIS      CommandFis;
+  EFI_AHCI_ATAPI_COMMAND    AtapiCmd;
+  UINT8                     Reserved[0x30];
+  EFI_AHCI_COMMAND_PRDT     PrdtTable[EFI_AHCI_NCQ_MAX_PRDT];
+} EFI_AHCI_NCQ_COMMAND_TABLE;
+
 //
 // Received FIS structure
 //
@@ -313,18 +336,32 @@ typedef struct {
 #pragma pack()
 
 typedef struct {
-  EFI_AHCI_RECEIVED_FIS     *AhciRFis;
-  EFI_AHCI_COMMAND_LIST     *AhciCmdList;
-  EFI_AHCI_COMMAND_TABLE    *AhciCommandTable;
-  EFI_AHCI_RECEIVED_FIS     *AhciRFisPciAddr;
-  EFI_AHCI_COMMAND_LIST     *AhciCmdListPciAddr;
-  EFI_AHCI_COMMAND_TABLE    *AhciCommandTablePciAddr;
-  UINT64                    MaxCommandListSize;
-  UINT64                    MaxCommandTableSize;
-  UINT64                    MaxReceiveFisSize;
-  VOID                      *MapRFis;
-  VOID                      *MapCmdList;
-  VOID                      *MapCommandTable;
+  EFI_AHCI_RECEIVED_FIS         *AhciRFis;
+  EFI_AHCI_COMMAND_LIST         *AhciCmdList;
+  EFI_AHCI_COMMAND_TABLE        *AhciCommandTable;
+  EFI_AHCI_RECEIVED_FIS         *AhciRFisPciAddr;
+  EFI_AHCI_COMMAND_LIST         *AhciCmdListPciAddr;
+  EFI_AHCI_COMMAND_TABLE        *AhciCommandTablePciAddr;
+  UINT64                        MaxCommandListSize;
+  UINT64                        MaxCommandTableSize;
+  UINT64                        MaxReceiveFisSize;
+  VOID                          *MapRFis;
+  VOID                          *MapCmdList;
+  VOID                          *MapCommandTable;
+
+  //
+  // For native command queuing. AhciNcqCommandTable is NULL if it is not supported.
+  // Slot 0 is left to the commands that are not queued, so NcqSlots holds the other
+  // command slots. NcqActiveSlots holds the slots with a queued command in flight,
+  // and NcqPortActiveSlots holds the ones of each port.
+  //
+  EFI_AHCI_NCQ_COMMAND_TABLE    *AhciNcqCommandTable;
+  EFI_AHCI_NCQ_COMMAND_TABLE    *AhciNcqCommandTablePciAddr;
+  UINT64                        MaxNcqCommandTableSize;
+  VOID                          *MapNcqCommandTable;
+  UINT32                        NcqSlots;
+  UINT32                        NcqActiveSlots;
+  UINT32                        NcqPortActiveSlots[EFI_AHCI_MAX_PORTS];
 } EFI_AHCI_REGISTERS;
 
 /**
@@ -98,7 +98,13 @@ ATA_ATAPI_PASS_THRU_INSTANCE  gAtaAtapiPassThruInstanceTemplate = {
   {                   // NonBlocking TaskList
     NULL,
     NULL
-  }
+  },
+  NULL,               // DriverBindingHandle
+  NULL,               // InitEvent
+  0,                  // PendingPorts
+  0,                  // ReadyPorts
+  { 0 },              // PortInitPhase
+  { NULL }            // PortInitTimeoutEvent
 };
 
 ATAPI_DEVICE_PATH  mAtapiDevicePathTemplate = {
@@ -286,6 +292,15 @@ AtaPassThruPassThruExecute (
         PortMultiplierPort = 0;
       }
 
+      //
+      // A blocking command that is not queued must not be issued while queued
+      // commands are in flight on the port. Non-blocking tasks are ordered by
+      // AsyncNonBlockingTransferRoutine().
+      //
+      if ((Task == NULL) && (Protocol != EFI_ATA_PASS_THRU_PROTOCOL_FPDMA)) {
+        AhciWaitQueuedCommandsIdle (Instance, (UINT8)Port);
+      }
+
       switch (Protocol) {
         case EFI_ATA_PASS_THRU_PROTOCOL_ATA_NON_DATA:
           Status = AhciNonDataTransfer (
@@ -369,6 +384,21 @@ AtaPassThruPassThruExecute (
                      Task
                      );
           break;
+        case EFI_ATA_PASS_THRU_PROTOCOL_FPDMA:
+          Status = AhciQueuedDmaTransfer (
+                     Instance,
+                     &Instance->AhciRegisters,
+                     (UINT8)Port,
+                     (UINT8)PortMultiplierPort,
+                     (BOOLEAN)(Packet->InTransferLength != 0),
+                     Packet->Acb,
+                     Packet->Asb,
+                     (Packet->InTransferLength != 0) ? Packet->InDataBuffer : Packet->OutDataBuffer,
+                     (Packet->InTransferLength != 0) ? Packet->InTransferLength : Packet->OutTransferLength,
+                     Packet->Timeout,
+                     Task
+                     );
+          break;
         default:
           return EFI_UNSUPPORTED;
       }
@@ -399,10 +429,12 @@ AsyncNonBlockingTransferRoutine (
   )
 {
   LIST_ENTRY                    *Entry;
+  LIST_ENTRY                    *NextEntry;
   LIST_ENTRY                    *EntryHeader;
   ATA_NONBLOCK_TASK             *Task;
   EFI_STATUS                    Status;
   ATA_ATAPI_PASS_THRU_INSTANCE  *Instance;
+  BOOLEAN                       Queued;
 
   Instance    = (ATA_ATAPI_PASS_THRU_INSTANCE *)Context;
   EntryHeader = &Instance->NonBlockingTaskList;
@@ -410,12 +442,16 @@ AsyncNonBlockingTransferRoutine (
   // Get the Tasks from the Tasks List and execute it, until there is
   // no task in the list or the device is busy with task (EFI_NOT_READY).
   //
-  while (TRUE) {
-    if (!IsListEmpty (EntryHeader)) {
-      Entry = GetFirstNode (EntryHeader);
-      Task  = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
-    } else {
-      return;
+  // Queued (FPDMA) tasks run side by side in their own command slots. Any
+  // other task only runs once all tasks in front of it have completed, and
+  // the tasks behind it wait for it.
+  //
+  for (Entry = GetFirstNode (EntryHeader); !IsNull (EntryHeader, Entry); Entry = NextEntry) {
+    NextEntry = GetNextNode (EntryHeader, Entry);
+    Task      = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+    Queued    = (BOOLEAN)(Task->Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA);
+    if (!Queued && (Entry != GetFirstNode (EntryHeader))) {
+      break;
     }
 
     Status = AtaPassThruPassThruExecute (
@@ -440,6 +476,10 @@ AsyncNonBlockingTransferRoutine (
     // is not finished yet. Otherwise the operation is successful.
     //
     if (Status == EFI_NOT_READY) {
+      if (Queued) {
+        continue;
+      }
+
       break;
     } else {
       RemoveEntryList (&Task->Link);
@@ -580,8 +620,24 @@ AtaAtapiPassThruSupported (
 
   if (EFI_ERROR (Status)) {
     //
-    // EFI_ALREADY_STARTED is also an error
+    // EFI_ALREADY_STARTED is also an error, unless a device is asked for while the
+    // controller is still being initialized. Start() then waits for the controller.
     //
+    if ((Status == EFI_ALREADY_STARTED) && (RemainingDevicePath != NULL) &&
+        !EFI_ERROR (
+           gBS->OpenProtocol (
+                  Controller,
+                  &gEfiCallerIdGuid,
+                  NULL,
+                  This->DriverBindingHandle,
+                  Controller,
+                  EFI_OPEN_PROTOCOL_TEST_PROTOCOL
+                  )
+           ))
+    {
+      return EFI_SUCCESS;
+    }
+
     return Status;
   }
 
@@ -632,6 +688,355 @@ AtaAtapiPassThruSupported (
   return EFI_UNSUPPORTED;
 }
 
+/**
+  Release the resources of a controller started by AtaAtapiPassThruStart(), after
+  the ATA Pass Thru and Extended SCSI Pass Thru Protocols are uninstalled.
+
+  @param[in]  Instance             A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  DriverBindingHandle  The driver binding handle of this driver.
+
+  @retval EFI_SUCCESS           The resources are released.
+  @retval Others                The original PCI attributes cannot be restored.
+
+**/
+EFI_STATUS
+AtaAtapiPassThruReleaseInstance (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN  EFI_HANDLE                    DriverBindingHandle
+  )
+{
+  EFI_STATUS           Status;
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  EFI_AHCI_REGISTERS   *AhciRegisters;
+
+  //
+  // Close protocols opened by AtaAtapiPassThru controller driver
+  //
+  gBS->CloseProtocol (
+         Instance->ControllerHandle,
+         &gEfiIdeControllerInitProtocolGuid,
+         DriverBindingHandle,
+         Instance->ControllerHandle
+         );
+
+  //
+  // Close Non-Blocking timer and free Task list.
+  //
+  if (Instance->TimerEvent != NULL) {
+    gBS->CloseEvent (Instance->TimerEvent);
+    Instance->TimerEvent = NULL;
+  }
+
+  DestroyAsynTaskList (Instance, FALSE);
+  //
+  // Free allocated resource
+  //
+  DestroyDeviceInfoList (Instance);
+
+  PciIo = Instance->PciIo;
+
+  //
+  // Disable this ATA host controller.
+  //
+  PciIo->Attributes (
+           PciIo,
+           EfiPciIoAttributeOperationDisable,
+           Instance->EnabledPciAttributes,
+           NULL
+           );
+
+  //
+  // If the current working mode is AHCI mode, then pre-allocated resource
+  // for AHCI initialization should be released.
+  //
+  if (Instance->Mode == EfiAtaAhciMode) {
+    AhciRegisters = &Instance->AhciRegisters;
+    PciIo->Unmap (
+             PciIo,
+             AhciRegisters->MapCommandTable
+             );
+    PciIo->FreeBuffer (
+             PciIo,
+             EFI_SIZE_TO_PAGES ((UINTN)AhciRegisters->MaxCommandTableSize),
+             AhciRegisters->AhciCommandTable
+             );
+    PciIo->Unmap (
+             PciIo,
+             AhciRegisters->MapCmdList
+             );
+    PciIo->FreeBuffer (
+             PciIo,
+             EFI_SIZE_TO_PAGES ((UINTN)AhciRegisters->MaxCommandListSize),
+             AhciRegisters->AhciCmdList
+             );
+    PciIo->Unmap (
+             PciIo,
+             AhciRegisters->MapRFis
+             );
+    PciIo->FreeBuffer (
+             PciIo,
+             EFI_SIZE_TO_PAGES ((UINTN)AhciRegisters->MaxReceiveFisSize),
+             AhciRegisters->AhciRFis
+             );
+    if (AhciRegisters->AhciNcqCommandTable != NULL) {
+      PciIo->Unmap (
+               PciIo,
+               AhciRegisters->MapNcqCommandTable
+               );
+      PciIo->FreeBuffer (
+               PciIo,
+               EFI_SIZE_TO_PAGES ((UINTN)AhciRegisters->MaxNcqCommandTableSize),
+               AhciRegisters->AhciNcqCommandTable
+               );
+    }
+  }
+
+  //
+  // Restore original PCI attributes
+  //
+  Status = PciIo->Attributes (
+                    PciIo,
+                    EfiPciIoAttributeOperationSet,
+                    Instance->OriginalPciAttributes,
+                    NULL
+                    );
+  ASSERT_EFI_ERROR (Status);
+
+  FreePool (Instance);
+
+  return Status;
+}
+
+/**
+  Release a controller whose initialization is not finished by Start(), because
+  the initialization is cancelled or the protocols cannot be installed.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+**/
+VOID
+AtaAtapiPassThruAbortInitialization (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  )
+{
+  //
+  // The ports are still being polled if the timer event is not closed yet.
+  //
+  if (Instance->InitEvent != NULL) {
+    gBS->CloseEvent (Instance->InitEvent);
+    Instance->InitEvent = NULL;
+    AhciModeCancelInitialization (Instance);
+  }
+
+  gBS->UninstallMultipleProtocolInterfaces (
+         Instance->ControllerHandle,
+         &gEfiCallerIdGuid,
+         Instance,
+         &gEdkiiControllerInitPendingProtocolGuid,
+         NULL,
+         NULL
+         );
+
+  AtaAtapiPassThruReleaseInstance (Instance, Instance->DriverBindingHandle);
+
+  EfiEventGroupSignal (&gEdkiiControllerInitDoneEventGroupGuid);
+}
+
+/**
+  Finish the initialization of a controller at AHCI mode once the devices attached
+  to its ports are detected, and install the ATA Pass Thru and Extended SCSI Pass
+  Thru Protocols. It is called periodically after AtaAtapiPassThruStartInitialization().
+
+  @param[in]  Event             The timer event.
+  @param[in]  Context           A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+**/
+VOID
+EFIAPI
+AtaAtapiPassThruInitializationNotify (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  EFI_STATUS                    Status;
+  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance;
+
+  Instance = (ATA_ATAPI_PASS_THRU_INSTANCE *)Context;
+
+  if (AhciModePollInitialization (Instance) == EFI_NOT_READY) {
+    return;
+  }
+
+  gBS->CloseEvent (Instance->InitEvent);
+  Instance->InitEvent = NULL;
+
+  Status = gBS->InstallMultipleProtocolInterfaces (
+                  &Instance->ControllerHandle,
+                  &gEfiAtaPassThruProtocolGuid,
+                  &(Instance->AtaPassThru),
+                  &gEfiExtScsiPassThruProtocolGuid,
+                  &(Instance->ExtScsiPassThru),
+                  NULL
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "AtaAtapiPassThruInitializationNotify: failed to install the protocols - %r\n", Status));
+    AtaAtapiPassThruAbortInitialization (Instance);
+    return;
+  }
+
+  gBS->UninstallMultipleProtocolInterfaces (
+         Instance->ControllerHandle,
+         &gEfiCallerIdGuid,
+         Instance,
+         &gEdkiiControllerInitPendingProtocolGuid,
+         NULL,
+         NULL
+         );
+  EfiEventGroupSignal (&gEdkiiControllerInitDoneEventGroupGuid);
+}
+
+/**
+  Start the initialization of a controller at AHCI mode, and finish it from a timer
+  event once the devices attached to its ports are detected, so that Start() does
+  not wait for the devices.
+
+  Until the initialization is finished, the Controller Init Pending Protocol and
+  the instance of the controller are installed on the controller handle.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+  @retval EFI_SUCCESS           The initialization is started.
+  @retval EFI_UNSUPPORTED       The controller is not working at AHCI mode.
+  @retval Others                The initialization cannot be started.
+
+**/
+EFI_STATUS
+AtaAtapiPassThruStartInitialization (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  )
+{
+  EFI_STATUS  Status;
+  PCI_TYPE00  PciData;
+
+  Status = Instance->PciIo->Pci.Read (
+                                  Instance->PciIo,
+                                  EfiPciIoWidthUint8,
+                                  PCI_CLASSCODE_OFFSET,
+                                  sizeof (PciData.Hdr.ClassCode),
+                                  PciData.Hdr.ClassCode
+                                  );
+  if (EFI_ERROR (Status) || (PciData.Hdr.ClassCode[1] != PCI_CLASS_MASS_STORAGE_SATADPA)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Instance->Mode = EfiAtaAhciMode;
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  AtaAtapiPassThruInitializationNotify,
+                  Instance,
+                  &Instance->InitEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = AhciModeStartInitialization (Instance);
+  if (EFI_ERROR (Status)) {
+    goto ErrorExit;
+  }
+
+  Status = gBS->InstallMultipleProtocolInterfaces (
+                  &Instance->ControllerHandle,
+                  &gEfiCallerIdGuid,
+                  Instance,
+                  &gEdkiiControllerInitPendingProtocolGuid,
+                  NULL,
+                  NULL
+                  );
+  if (EFI_ERROR (Status)) {
+    AhciModeCancelInitialization (Instance);
+    goto ErrorExit;
+  }
+
+  Status = gBS->SetTimer (Instance->InitEvent, TimerPeriodic, AHCI_INIT_POLL_INTERVAL);
+  if (EFI_ERROR (Status)) {
+    gBS->UninstallMultipleProtocolInterfaces (
+           Instance->ControllerHandle,
+           &gEfiCallerIdGuid,
+           Instance,
+           &gEdkiiControllerInitPendingProtocolGuid,
+           NULL,
+           NULL
+           );
+    AhciModeCancelInitialization (Instance);
+    goto ErrorExit;
+  }
+
+  return EFI_SUCCESS;
+
+ErrorExit:
+  gBS->CloseEvent (Instance->InitEvent);
+  Instance->InitEvent = NULL;
+  return Status;
+}
+
+/**
+  Wait until the initialization of a controller started by
+  AtaAtapiPassThruStartInitialization() is finished.
+
+  @param[in]  Controller           The controller handle.
+  @param[in]  DriverBindingHandle  The driver binding handle of this driver.
+
+  @retval EFI_SUCCESS           The initialization is finished.
+  @retval Others                The initialization cannot be waited for, for
+                                example when the caller is not at TPL_APPLICATION.
+
+**/
+EFI_STATUS
+AtaAtapiPassThruWaitForInitialization (
+  IN  EFI_HANDLE  Controller,
+  IN  EFI_HANDLE  DriverBindingHandle
+  )
+{
+  EFI_STATUS  Status;
+  EFI_EVENT   DoneEvent;
+  UINTN       Index;
+
+  Status = gBS->CreateEventEx (
+                  0,
+                  TPL_CALLBACK,
+                  NULL,
+                  NULL,
+                  &gEdkiiControllerInitDoneEventGroupGuid,
+                  &DoneEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  while (!EFI_ERROR (
+            gBS->OpenProtocol (
+                   Controller,
+                   &gEfiCallerIdGuid,
+                   NULL,
+                   DriverBindingHandle,
+                   Controller,
+                   EFI_OPEN_PROTOCOL_TEST_PROTOCOL
+                   )
+            ))
+  {
+    Status = gBS->WaitForEvent (1, &DoneEvent, &Index);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  gBS->CloseEvent (DoneEvent);
+  return Status;
+}
+
 /**
   Starts a device controller or a bus controller.
 
@@ -689,6 +1094,22 @@ AtaAtapiPassThruStart (
 
   DEBUG ((DEBUG_INFO, "==AtaAtapiPassThru Start== Controller = %x\n", Controller));
 
+  //
+  // Wait for a controller that is still being initialized, see AtaAtapiPassThruSupported().
+  //
+  Status = gBS->OpenProtocol (
+                  Controller,
+                  &gEfiCallerIdGuid,
+                  NULL,
+                  This->DriverBindingHandle,
+                  Controller,
+                  EFI_OPEN_PROTOCOL_TEST_PROTOCOL
+                  );
+  if (!EFI_ERROR (Status)) {
+    Status = AtaAtapiPassThruWaitForInitialization (Controller, This->DriverBindingHandle);
+    return EFI_ERROR (Status) ? EFI_NOT_READY : EFI_SUCCESS;
+  }
+
   Status = gBS->OpenProtocol (
                   Controller,
                   &gEfiIdeControllerInitProtocolGuid,
@@ -764,6 +1185,7 @@ AtaAtapiPassThruStart (
   }
 
   Instance->ControllerHandle      = Controller;
+  Instance->DriverBindingHandle   = This->DriverBindingHandle;
   Instance->IdeControllerInit     = IdeControllerInit;
   Instance->PciIo                 = PciIo;
   Instance->EnabledPciAttributes  = EnabledPciAttributes;
@@ -794,6 +1216,23 @@ AtaAtapiPassThruStart (
     goto ErrorExit;
   }
 
+  //
+  // When all devices are asked for, the devices attached to an AHCI controller
+  // may be detected from a timer event, so that other controllers are started
+  // while the devices become ready.
+  //
+  if (FeaturePcdGet (PcdAsyncControllerInit) && (RemainingDevicePath == NULL)) {
+    Status = AtaAtapiPassThruStartInitialization (Instance);
+    if (!EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_INFO, "==AtaAtapiPassThru Start== the devices are detected in the background\n"));
+      return EFI_SUCCESS;
+    }
+
+    if (Status != EFI_UNSUPPORTED) {
+      goto ErrorExit;
+    }
+  }
+
   //
   // Enumerate all inserted ATA devices.
   //
@@ -877,11 +1316,32 @@ AtaAtapiPassThruStop (
   EFI_STATUS                    Status;
   ATA_ATAPI_PASS_THRU_INSTANCE  *Instance;
   EFI_ATA_PASS_THRU_PROTOCOL    *AtaPassThru;
-  EFI_PCI_IO_PROTOCOL           *PciIo;
-  EFI_AHCI_REGISTERS            *AhciRegisters;
+  EFI_TPL                       OldTpl;
 
   DEBUG ((DEBUG_INFO, "==AtaAtapiPassThru Stop== Controller = %x\n", Controller));
 
+  //
+  // Cancel the initialization of the controller if it is not finished yet.
+  // The timer event that finishes it runs at TPL_CALLBACK.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  Status = gBS->OpenProtocol (
+                  Controller,
+                  &gEfiCallerIdGuid,
+                  (VOID **)&Instance,
+                  This->DriverBindingHandle,
+                  Controller,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (!EFI_ERROR (Status)) {
+    AtaAtapiPassThruAbortInitialization (Instance);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  if (!EFI_ERROR (Status)) {
+    return EFI_SUCCESS;
+  }
+
   Status = gBS->OpenProtocol (
                   Controller,
                   &gEfiAtaPassThruProtocolGuid,
@@ -910,91 +1370,7 @@ AtaAtapiPassThruStop (
     return EFI_DEVICE_ERROR;
   }
 
-  //
-  // Close protocols opened by AtaAtapiPassThru controller driver
-  //
-  gBS->CloseProtocol (
-         Controller,
-         &gEfiIdeControllerInitProtocolGuid,
-         This->DriverBindingHandle,
-         Controller
-         );
-
-  //
-  // Close Non-Blocking timer and free Task list.
-  //
-  if (Instance->TimerEvent != NULL) {
-    gBS->CloseEvent (Instance->TimerEvent);
-    Instance->TimerEvent = NULL;
-  }
-
-  DestroyAsynTaskList (Instance, FALSE);
-  //
-  // Free allocated resource
-  //
-  DestroyDeviceInfoList (Instance);
-
-  PciIo = Instance->PciIo;
-
-  //
-  // Disable this ATA host controller.
-  //
-  PciIo->Attributes (
-           PciIo,
-           EfiPciIoAttributeOperationDisable,
-           Instance->EnabledPciAttributes,
-           NULL
-           );
-
-  //
-  // If the current working mode is AHCI mode, then pre-allocated resource
-  // for AHCI initialization should be released.
-  //
-  if (Instance->Mode == EfiAtaAhciMode) {
-    AhciRegisters = &Instance->AhciRegisters;
-    PciIo->Unmap (
-             PciIo,
-             AhciRegisters->MapCommandTable
-             );
-    PciIo->FreeBuffer (
-             PciIo,
-             EFI_SIZE_TO_PAGES ((UINTN)AhciRegisters->MaxCommandTableSize),
-             AhciRegisters->AhciCommandTable
-             );
-    PciIo->Unmap (
-             PciIo,
-             AhciRegisters->MapCmdList
-             );
-    PciIo->FreeBuffer (
-             PciIo,
-             EFI_SIZE_TO_PAGES ((UINTN)AhciRegisters->MaxCommandListSize),
-             AhciRegisters->AhciCmdList
-             );
-    PciIo->Unmap (
-             PciIo,
-             AhciRegisters->MapRFis
-             );
-    PciIo->FreeBuffer (
-             PciIo,
-             EFI_SIZE_TO_PAGES ((UINTN)AhciRegisters->MaxReceiveFisSize),
-             AhciRegisters->AhciRFis
-             );
-  }
-
-  //
-  // Restore original PCI attributes
-  //
-  Status = PciIo->Attributes (
-                    PciIo,
-                    EfiPciIoAttributeOperationSet,
-                    Instance->OriginalPciAttributes,
-                    NULL
-                    );
-  ASSERT_EFI_ERROR (Status);
-
-  FreePool (Instance);
-
-  return Status;
+  return AtaAtapiPassThruReleaseInstance (Instance, This->DriverBindingHandle);
 }
 
 /**
@@ -1154,6 +1530,14 @@ DestroyAsynTaskList (
 
   OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
   if (!IsListEmpty (&Instance->NonBlockingTaskList)) {
+    //
+    // The queued commands in flight have to be stopped before their tasks
+    // are freed.
+    //
+    if (Instance->Mode == EfiAtaAhciMode) {
+      AhciAbortQueuedDmaTransfers (Instance);
+    }
+
     //
     // Free the Subtask list.
     //
@@ -1328,7 +1712,25 @@ AtaPassThruPassThru (
   DeviceInfo     = ATA_ATAPI_DEVICE_INFO_FROM_THIS (Node);
   IdentifyData   = DeviceInfo->IdentifyData;
   MaxSectorCount = 0x100;
-  if ((IdentifyData->AtaData.command_set_supported_83 & (BIT10 | BIT15 | BIT14)) == 0x4400) {
+  if (Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) {
+    //
+    // Queued commands are only issued in the command slots set up for them,
+    // to devices that report support of native command queuing with a queue
+    // depth that leaves them a command slot. They always use 48-bit addressing.
+    //
+    if ((Instance->Mode != EfiAtaAhciMode) ||
+        (Instance->AhciRegisters.AhciNcqCommandTable == NULL) ||
+        (PortMultiplierPort != 0xFFFF) ||
+        (IdentifyData->AtaData.serial_ata_capabilities == 0) ||
+        (IdentifyData->AtaData.serial_ata_capabilities == 0xFFFF) ||
+        ((IdentifyData->AtaData.serial_ata_capabilities & BIT8) == 0) ||
+        (AhciGetNcqDeviceSlots (&Instance->AhciRegisters, IdentifyData) == 0))
+    {
+      return EFI_UNSUPPORTED;
+    }
+
+    MaxSectorCount = 0x10000;
+  } else if ((IdentifyData->AtaData.command_set_supported_83 & (BIT10 | BIT15 | BIT14)) == 0x4400) {
     Capacity = *((UINT64 *)IdentifyData->AtaData.maximum_lba_for_48bit_addressing);
     if (Capacity > 0xFFFFFFF) {
       //
@@ -1378,6 +1780,18 @@ AtaPassThruPassThru (
     return EFI_BAD_BUFFER_SIZE;
   }
 
+  if (Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) {
+    if ((Packet->InTransferLength > EFI_AHCI_NCQ_MAX_TRANSFER_SIZE) ||
+        (Packet->OutTransferLength > EFI_AHCI_NCQ_MAX_TRANSFER_SIZE))
+    {
+      return EFI_BAD_BUFFER_SIZE;
+    }
+
+    if ((Packet->InTransferLength == 0) && (Packet->OutTransferLength == 0)) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
   //
   // For non-blocking mode, queue the Task into the list.
   //
@@ -20,6 +20,7 @@
 #include <Protocol/AtaPassThru.h>
 #include <Protocol/ScsiPassThruExt.h>
 #include <Protocol/AtaAtapiPolicy.h>
+#include <Protocol/ControllerInitPending.h>
 
 #include <Library/DebugLib.h>
 #include <Library/BaseLib.h>
@@ -119,6 +120,16 @@ typedef struct {
   //
   EFI_EVENT                           TimerEvent;
   LIST_ENTRY                          NonBlockingTaskList;
+
+  //
+  // For the AHCI mode initialization that is finished from a timer event.
+  //
+  EFI_HANDLE                          DriverBindingHandle;
+  EFI_EVENT                           InitEvent;
+  UINT32                              PendingPorts;
+  UINT32                              ReadyPorts;
+  UINT8                               PortInitPhase[EFI_AHCI_MAX_PORTS];
+  EFI_EVENT                           PortInitTimeoutEvent[EFI_AHCI_MAX_PORTS];
 } ATA_ATAPI_PASS_THRU_INSTANCE;
 
 //
@@ -139,6 +150,7 @@ struct _ATA_NONBLOCK_TASK {
   VOID                                *TableMap;       // Pointer to PRD table map.
   EFI_ATA_DMA_PRD                     *MapBaseAddress; //  Pointer to range Base address for Map.
   UINTN                               PageCount;       //  The page numbers used by PCIO freebuffer.
+  UINT8                               CommandSlot;     // The command slot of a queued command.
 };
 
 //
@@ -1068,6 +1080,54 @@ AhciModeInitialization (
   IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
   );
 
+/**
+  Start to initialize ATA host controller at AHCI mode, without waiting for the
+  devices attached to its ports.
+
+  All the ports are set up at once, and the devices attached to them are detected
+  together by AhciModePollInitialization(), instead of one port after another.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+  @retval EFI_SUCCESS           The initialization is started.
+  @retval Others                The initialization cannot be started.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciModeStartInitialization (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  );
+
+/**
+  Check the progress of the initialization started by AhciModeStartInitialization(),
+  without waiting. Once no device detection is in progress, the detected devices
+  are probed and added into the device list.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+  @retval EFI_SUCCESS           The initialization is finished.
+  @retval EFI_NOT_READY         The device detection is in progress on some ports.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciModePollInitialization (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  );
+
+/**
+  Stop the device detection started by AhciModeStartInitialization().
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+**/
+VOID
+EFIAPI
+AhciModeCancelInitialization (
+  IN  ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  );
+
 /**
   Start a non data transfer on specific port.
 
@@ -1148,6 +1208,99 @@ AhciDmaTransfer (
   IN     ATA_NONBLOCK_TASK             *Task
   );
 
+/**
+  Start or check a READ/WRITE FPDMA QUEUED data transfer on specific port.
+
+  In non-blocking mode, each call issues the command if it is not issued yet,
+  and checks whether it has completed. Commands of other tasks may be in flight
+  in the other command slots at the same time.
+
+  @param[in]       Instance            The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       PortMultiplier      The number of port multiplier.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in, out]  MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in]       Timeout             The timeout value of data transfer, uses 100ns as a unit.
+  @param[in]       Task                Optional. Pointer to the ATA_NONBLOCK_TASK
+                                       used by non-blocking mode.
+
+  @retval EFI_DEVICE_ERROR    The data transfer abort with error occurs.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_UNSUPPORTED     Native command queuing is not supported.
+  @retval EFI_NOT_READY       The data transfer is not issued or not finished yet.
+  @retval EFI_SUCCESS         The data transfer executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciQueuedDmaTransfer (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN     EFI_AHCI_REGISTERS            *AhciRegisters,
+  IN     UINT8                         Port,
+  IN     UINT8                         PortMultiplier,
+  IN     BOOLEAN                       Read,
+  IN     EFI_ATA_COMMAND_BLOCK         *AtaCommandBlock,
+  IN OUT EFI_ATA_STATUS_BLOCK          *AtaStatusBlock,
+  IN OUT VOID                          *MemoryAddr,
+  IN     UINT32                        DataCount,
+  IN     UINT64                        Timeout,
+  IN     ATA_NONBLOCK_TASK             *Task
+  );
+
+/**
+  Get the command slots that can hold the queued commands of a device.
+
+  The tag of a queued command is the number of its command slot, and a device
+  only accepts tags up to its queue depth minus one (IDENTIFY word 75). Slot 0
+  is left to the commands that are not queued.
+
+  @param[in]  AhciRegisters    The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]  IdentifyData     The IDENTIFY data of the device.
+
+  @return  The bit mask of the command slots, or 0 if queued commands cannot be
+           issued to the device.
+
+**/
+UINT32
+AhciGetNcqDeviceSlots (
+  IN EFI_AHCI_REGISTERS  *AhciRegisters,
+  IN EFI_IDENTIFY_DATA   *IdentifyData
+  );
+
+/**
+  Wait until no queued command is in flight on a port.
+
+  The port keeps running while queued commands are in flight on it, and a
+  command that is not queued would abort them. So before such a command is
+  issued, the non-blocking tasks are run until the queued commands of the port
+  have completed and released their command slots.
+
+  @param[in]  Instance         The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]  Port             The number of port.
+
+**/
+VOID
+AhciWaitQueuedCommandsIdle (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN UINT8                         Port
+  );
+
+/**
+  Abort the queued commands of all non-blocking tasks.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+**/
+VOID
+EFIAPI
+AhciAbortQueuedDmaTransfers (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  );
+
 /**
   Start a PIO data transfer on specific port.
 
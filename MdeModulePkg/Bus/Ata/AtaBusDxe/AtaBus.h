@@ -68,6 +68,12 @@
 //
 #define MAX_48BIT_TRANSFER_BLOCK_NUM  0xFFFF
 
+//
+// The maximum transfer size of a queued (FPDMA) sub task. Smaller sub tasks
+// keep more of them in flight on the device at the same time.
+//
+#define MAX_NCQ_TRANSFER_SIZE  SIZE_1MB
+
 //
 // The maximum model name in ATA identify data
 //
@@ -114,6 +120,7 @@ typedef struct {
 
   BOOLEAN                                  UdmaValid;
   BOOLEAN                                  Lba48Bit;
+  BOOLEAN                                  NcqValid;
 
   //
   // Cached data for ATA identify data
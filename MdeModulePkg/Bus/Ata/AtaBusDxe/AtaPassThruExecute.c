@@ -25,6 +25,9 @@
 #define ATA_CMD_TRUST_SEND         0x5E
 #define ATA_CMD_TRUST_SEND_DMA     0x5F
 
+#define ATA_CMD_READ_FPDMA_QUEUED   0x60
+#define ATA_CMD_WRITE_FPDMA_QUEUED  0x61
+
 //
 // Look up table (UdmaValid, IsWrite) for EFI_ATA_PASS_THRU_CMD_PROTOCOL
 //
@@ -319,6 +322,19 @@ IdentifyAtaDevice (
     }
   }
 
+  //
+  // Check whether the WORD 76 (Serial ATA capabilities) reports support of native
+  // command queuing. The queue depth is in WORD 75.
+  //
+  if (AtaDevice->UdmaValid &&
+      (IdentifyData->serial_ata_capabilities != 0) &&
+      (IdentifyData->serial_ata_capabilities != 0xFFFF) &&
+      ((IdentifyData->serial_ata_capabilities & BIT8) != 0))
+  {
+    AtaDevice->NcqValid = TRUE;
+    DEBUG ((DEBUG_INFO, "AtaBus - NCQ supported, queue depth %d\n", (IdentifyData->queue_depth & 0x1F) + 1));
+  }
+
   Capacity = GetAtapi6Capacity (AtaDevice);
   if (Capacity > MAX_28BIT_ADDRESSING_CAPACITY) {
     //
@@ -469,9 +485,59 @@ TransferAtaDevice (
   IN EFI_EVENT                             Event OPTIONAL
   )
 {
+  EFI_STATUS                        Status;
   EFI_ATA_COMMAND_BLOCK             *Acb;
   EFI_ATA_PASS_THRU_COMMAND_PACKET  *Packet;
 
+  //
+  // Non-blocking reads and writes are queued when the device supports it, so
+  // that the sub tasks are in flight on the device at the same time. The ATA
+  // pass through driver rejects them if it cannot queue commands, and the
+  // regular DMA commands are used from then on.
+  //
+  if ((TaskPacket != NULL) && AtaDevice->NcqValid) {
+    Acb                     = ZeroMem (&AtaDevice->Acb, sizeof (EFI_ATA_COMMAND_BLOCK));
+    Acb->AtaCommand         = IsWrite ? ATA_CMD_WRITE_FPDMA_QUEUED : ATA_CMD_READ_FPDMA_QUEUED;
+    Acb->AtaSectorNumber    = (UINT8)StartLba;
+    Acb->AtaCylinderLow     = (UINT8)RShiftU64 (StartLba, 8);
+    Acb->AtaCylinderHigh    = (UINT8)RShiftU64 (StartLba, 16);
+    Acb->AtaSectorNumberExp = (UINT8)RShiftU64 (StartLba, 24);
+    Acb->AtaCylinderLowExp  = (UINT8)RShiftU64 (StartLba, 32);
+    Acb->AtaCylinderHighExp = (UINT8)RShiftU64 (StartLba, 40);
+    Acb->AtaFeatures        = (UINT8)TransferLength;
+    Acb->AtaFeaturesExp     = (UINT8)(TransferLength >> 8);
+    Acb->AtaDeviceHead      = BIT6;
+
+    Packet = ZeroMem (TaskPacket, sizeof (EFI_ATA_PASS_THRU_COMMAND_PACKET));
+    if (IsWrite) {
+      Packet->OutDataBuffer     = Buffer;
+      Packet->OutTransferLength = TransferLength;
+    } else {
+      Packet->InDataBuffer     = Buffer;
+      Packet->InTransferLength = TransferLength;
+    }
+
+    Packet->Protocol = EFI_ATA_PASS_THRU_PROTOCOL_FPDMA;
+    Packet->Length   = EFI_ATA_PASS_THRU_LENGTH_SECTOR_COUNT;
+    Packet->Timeout  = EFI_TIMER_PERIOD_SECONDS (DivU64x32 (MultU64x32 (TransferLength, AtaDevice->BlockMedia.BlockSize), 2100000) + 31);
+
+    Status = AtaDevicePassThru (AtaDevice, TaskPacket, Event);
+    if (Status != EFI_UNSUPPORTED) {
+      return Status;
+    }
+
+    if (Packet->Asb != NULL) {
+      FreeAlignedBuffer (Packet->Asb, sizeof (EFI_ATA_STATUS_BLOCK));
+    }
+
+    if (Packet->Acb != NULL) {
+      FreePool (Packet->Acb);
+    }
+
+    DEBUG ((DEBUG_INFO, "AtaBus - NCQ not available on Port %x, using DMA commands\n", AtaDevice->Port));
+    AtaDevice->NcqValid = FALSE;
+  }
+
   //
   // Ensure AtaDevice->UdmaValid, AtaDevice->Lba48Bit and IsWrite are valid boolean values
   //
@@ -799,6 +865,9 @@ AccessAtaDevice (
   ASSERT ((UINTN)AtaDevice->Lba48Bit < 2);
   MaxTransferBlockNumber = mMaxTransferBlockNumber[AtaDevice->Lba48Bit];
   BlockSize              = AtaDevice->BlockMedia.BlockSize;
+  if ((Token != NULL) && (Token->Event != NULL) && AtaDevice->NcqValid) {
+    MaxTransferBlockNumber = MIN (MaxTransferBlockNumber, MAX_NCQ_TRANSFER_SIZE / BlockSize);
+  }
 
   //
   // Initial the return status and shared account for Non Blocking.
@@ -806,7 +875,11 @@ AccessAtaDevice (
   if ((Token != NULL) && (Token->Event != NULL)) {
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
 
-    if (!IsListEmpty (&AtaDevice->AtaSubTaskList)) {
+    //
+    // The sub tasks of queued requests are in flight together, so only the
+    // requests of devices without NCQ wait for the previous one to complete.
+    //
+    if (!AtaDevice->NcqValid && !IsListEmpty (&AtaDevice->AtaSubTaskList)) {
       AtaTask = AllocateZeroPool (sizeof (ATA_BUS_ASYN_TASK));
       if (AtaTask == NULL) {
         gBS->RestoreTPL (OldTpl);
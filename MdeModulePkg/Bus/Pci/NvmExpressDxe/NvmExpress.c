@@ -906,6 +906,353 @@ Done:
   return Status;
 }
 
+/**
+  Start the timer event that processes asynchronous I/O and install the NVM Express
+  Pass Thru Protocol, after the controller is initialized.
+
+  @param[in]  Private           The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @retval EFI_SUCCESS           The NVM Express Pass Thru Protocol is installed.
+  @retval Others                Errors from gBS->CreateEvent(), gBS->SetTimer() or
+                                gBS->InstallMultipleProtocolInterfaces().
+
+**/
+EFI_STATUS
+NvmeInstallPassThru (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  //
+  // Start the asynchronous I/O completion monitor
+  //
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  ProcessAsyncTaskList,
+                  Private,
+                  &Private->TimerEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->SetTimer (
+                  Private->TimerEvent,
+                  TimerPeriodic,
+                  NVME_HC_ASYNC_TIMER
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->InstallMultipleProtocolInterfaces (
+                  &Private->ControllerHandle,
+                  &gEfiNvmExpressPassThruProtocolGuid,
+                  &Private->Passthru,
+                  NULL
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  NvmeRegisterShutdownNotification ();
+  return EFI_SUCCESS;
+}
+
+/**
+  Release a controller whose initialization is not finished by Start(), because
+  the initialization failed or is cancelled, and close the protocols opened by Start().
+
+  @param[in]  Private           The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+**/
+VOID
+NvmeAbortControllerInit (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  EFI_HANDLE           Controller;
+  EFI_HANDLE           DriverBindingHandle;
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+
+  Controller          = Private->ControllerHandle;
+  DriverBindingHandle = Private->DriverBindingHandle;
+  PciIo               = Private->PciIo;
+
+  //
+  // The controller is still being enabled if the timer event is not closed yet.
+  //
+  if (Private->InitEvent != NULL) {
+    gBS->CloseEvent (Private->InitEvent);
+    gBS->CloseEvent (Private->InitTimeoutEvent);
+    NvmeCompleteEnableController (Private, EFI_ABORTED);
+  }
+
+  //
+  // Stop the controller before its queues are freed.
+  //
+  NvmeDisableController (Private);
+
+  gBS->UninstallMultipleProtocolInterfaces (
+         Controller,
+         &gEfiCallerIdGuid,
+         Private,
+         &gEdkiiControllerInitPendingProtocolGuid,
+         NULL,
+         NULL
+         );
+
+  if (Private->TimerEvent != NULL) {
+    gBS->CloseEvent (Private->TimerEvent);
+  }
+
+  if (Private->Mapping != NULL) {
+    PciIo->Unmap (PciIo, Private->Mapping);
+  }
+
+  if (Private->Buffer != NULL) {
+    PciIo->FreeBuffer (PciIo, NVME_BUFFER_PAGES, Private->Buffer);
+  }
+
+  if (Private->ControllerData != NULL) {
+    FreePool (Private->ControllerData);
+  }
+
+  FreePool (Private);
+
+  gBS->CloseProtocol (
+         Controller,
+         &gEfiPciIoProtocolGuid,
+         DriverBindingHandle,
+         Controller
+         );
+
+  gBS->CloseProtocol (
+         Controller,
+         &gEfiDevicePathProtocolGuid,
+         DriverBindingHandle,
+         Controller
+         );
+
+  EfiEventGroupSignal (&gEdkiiControllerInitDoneEventGroupGuid);
+}
+
+/**
+  Finish the initialization of a controller once it is ready, and enumerate its
+  namespaces. It is called periodically after NvmeStartControllerInit().
+
+  @param[in]  Event             The timer event.
+  @param[in]  Context           The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+**/
+VOID
+EFIAPI
+NvmeControllerInitNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  NVME_CONTROLLER_PRIVATE_DATA  *Private;
+  EFI_STATUS                    Status;
+
+  Private = (NVME_CONTROLLER_PRIVATE_DATA *)Context;
+
+  Status = NvmeCheckControllerReady (Private);
+  if (Status == EFI_NOT_READY) {
+    if (EFI_ERROR (gBS->CheckEvent (Private->InitTimeoutEvent))) {
+      return;
+    }
+
+    Status = EFI_TIMEOUT;
+  }
+
+  gBS->CloseEvent (Private->InitEvent);
+  gBS->CloseEvent (Private->InitTimeoutEvent);
+  Private->InitEvent        = NULL;
+  Private->InitTimeoutEvent = NULL;
+
+  Status = NvmeCompleteEnableController (Private, Status);
+  if (!EFI_ERROR (Status)) {
+    Status = NvmeControllerInitFinish (Private);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = NvmeInstallPassThru (Private);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "NvmeControllerInitNotify: failed to initialize the controller - %r\n", Status));
+    NvmeAbortControllerInit (Private);
+    return;
+  }
+
+  DiscoverAllNamespaces (Private);
+
+  gBS->UninstallMultipleProtocolInterfaces (
+         Private->ControllerHandle,
+         &gEfiCallerIdGuid,
+         Private,
+         &gEdkiiControllerInitPendingProtocolGuid,
+         NULL,
+         NULL
+         );
+  EfiEventGroupSignal (&gEdkiiControllerInitDoneEventGroupGuid);
+
+  DEBUG ((DEBUG_INFO, "NvmeControllerInitNotify: end successfully\n"));
+}
+
+/**
+  Start the initialization of a controller, and finish it from a timer event once
+  the controller is ready, so that Start() does not wait for the controller.
+
+  Until the initialization is finished, the Controller Init Pending Protocol and
+  the private data of the controller are installed on the controller handle.
+
+  @param[in]  Private           The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @retval EFI_SUCCESS           The controller initialization is started.
+  @retval Others                The controller initialization cannot be started.
+
+**/
+EFI_STATUS
+NvmeStartControllerInit (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = NvmeControllerInitPrepare (Private);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  NvmeControllerInitNotify,
+                  Private,
+                  &Private->InitEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &Private->InitTimeoutEvent);
+  if (EFI_ERROR (Status)) {
+    goto ErrorExit;
+  }
+
+  Status = gBS->InstallMultipleProtocolInterfaces (
+                  &Private->ControllerHandle,
+                  &gEfiCallerIdGuid,
+                  Private,
+                  &gEdkiiControllerInitPendingProtocolGuid,
+                  NULL,
+                  NULL
+                  );
+  if (EFI_ERROR (Status)) {
+    goto ErrorExit;
+  }
+
+  Status = NvmeStartEnableController (Private);
+  if (EFI_ERROR (Status)) {
+    goto Uninstall;
+  }
+
+  Status = gBS->SetTimer (
+                  Private->InitTimeoutEvent,
+                  TimerRelative,
+                  EFI_TIMER_PERIOD_MILLISECONDS (NvmeGetReadyTimeout (Private))
+                  );
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->SetTimer (Private->InitEvent, TimerPeriodic, NVME_INIT_POLL_INTERVAL);
+  }
+
+  if (EFI_ERROR (Status)) {
+    NvmeCompleteEnableController (Private, Status);
+    goto Uninstall;
+  }
+
+  return EFI_SUCCESS;
+
+Uninstall:
+  gBS->UninstallMultipleProtocolInterfaces (
+         Private->ControllerHandle,
+         &gEfiCallerIdGuid,
+         Private,
+         &gEdkiiControllerInitPendingProtocolGuid,
+         NULL,
+         NULL
+         );
+
+ErrorExit:
+  if (Private->InitTimeoutEvent != NULL) {
+    gBS->CloseEvent (Private->InitTimeoutEvent);
+    Private->InitTimeoutEvent = NULL;
+  }
+
+  gBS->CloseEvent (Private->InitEvent);
+  Private->InitEvent = NULL;
+  return Status;
+}
+
+/**
+  Wait until the initialization of a controller started by NvmeStartControllerInit()
+  is finished.
+
+  @param[in]  Controller           The controller handle.
+  @param[in]  DriverBindingHandle  The driver binding handle of this driver.
+
+  @retval EFI_SUCCESS           The controller initialization is finished.
+  @retval Others                The controller initialization cannot be waited for,
+                                for example when the caller is not at TPL_APPLICATION.
+
+**/
+EFI_STATUS
+NvmeWaitForControllerInit (
+  IN EFI_HANDLE  Controller,
+  IN EFI_HANDLE  DriverBindingHandle
+  )
+{
+  EFI_STATUS  Status;
+  EFI_EVENT   DoneEvent;
+  UINTN       Index;
+
+  Status = gBS->CreateEventEx (
+                  0,
+                  TPL_CALLBACK,
+                  NULL,
+                  NULL,
+                  &gEdkiiControllerInitDoneEventGroupGuid,
+                  &DoneEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  while (!EFI_ERROR (
+            gBS->OpenProtocol (
+                   Controller,
+                   &gEfiCallerIdGuid,
+                   NULL,
+                   DriverBindingHandle,
+                   Controller,
+                   EFI_OPEN_PROTOCOL_TEST_PROTOCOL
+                   )
+            ))
+  {
+    Status = gBS->WaitForEvent (1, &DoneEvent, &Index);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  gBS->CloseEvent (DoneEvent);
+  return Status;
+}
+
 /**
   Starts a device controller or a bus controller.
 
@@ -1029,21 +1376,22 @@ NvmExpressDriverBindingStart (
     }
 
     //
-    // 6 x 4kB aligned buffers will be carved out of this buffer.
+    // NVME_BUFFER_PAGES x 4kB aligned buffers will be carved out of this buffer.
     // 1st 4kB boundary is the start of the admin submission queue.
     // 2nd 4kB boundary is the start of the admin completion queue.
     // 3rd 4kB boundary is the start of I/O submission queue #1.
     // 4th 4kB boundary is the start of I/O completion queue #1.
     // 5th 4kB boundary is the start of I/O submission queue #2.
     // 6th 4kB boundary is the start of I/O completion queue #2.
+    // The remaining 4kB boundaries are the PRP lists of I/O submission queue #1.
     //
-    // Allocate 6 pages of memory, then map it for bus master read and write.
+    // Allocate NVME_BUFFER_PAGES pages of memory, then map it for bus master read and write.
     //
     Status = PciIo->AllocateBuffer (
                       PciIo,
                       AllocateAnyPages,
                       EfiBootServicesData,
-                      6,
+                      NVME_BUFFER_PAGES,
                       (VOID **)&Private->Buffer,
                       0
                       );
@@ -1051,7 +1399,7 @@ NvmExpressDriverBindingStart (
       goto Exit;
     }
 
-    Bytes  = EFI_PAGES_TO_SIZE (6);
+    Bytes  = EFI_PAGES_TO_SIZE (NVME_BUFFER_PAGES);
     Status = PciIo->Map (
                       PciIo,
                       EfiPciIoOperationBusMasterCommonBuffer,
@@ -1061,7 +1409,7 @@ NvmExpressDriverBindingStart (
                       &Private->Mapping
                       );
 
-    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (6))) {
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (NVME_BUFFER_PAGES))) {
       goto Exit;
     }
 
@@ -1082,46 +1430,54 @@ NvmExpressDriverBindingStart (
     InitializeListHead (&Private->AsyncPassThruQueue);
     InitializeListHead (&Private->UnsubmittedSubtasks);
 
-    Status = NvmeControllerInit (Private);
-    if (EFI_ERROR (Status)) {
-      goto Exit;
-    }
-
     //
-    // Start the asynchronous I/O completion monitor
+    // When all namespaces are asked for, the controller may be initialized and
+    // its namespaces enumerated from a timer event, so that other controllers
+    // are started while this one becomes ready.
     //
-    Status = gBS->CreateEvent (
-                    EVT_TIMER | EVT_NOTIFY_SIGNAL,
-                    TPL_NOTIFY,
-                    ProcessAsyncTaskList,
-                    Private,
-                    &Private->TimerEvent
-                    );
-    if (EFI_ERROR (Status)) {
-      goto Exit;
+    if (FeaturePcdGet (PcdAsyncControllerInit) && (RemainingDevicePath == NULL)) {
+      Status = NvmeStartControllerInit (Private);
+      if (EFI_ERROR (Status)) {
+        goto Exit;
+      }
+
+      DEBUG ((DEBUG_INFO, "NvmExpressDriverBindingStart: end, the controller becomes ready in the background\n"));
+      return EFI_SUCCESS;
     }
 
-    Status = gBS->SetTimer (
-                    Private->TimerEvent,
-                    TimerPeriodic,
-                    NVME_HC_ASYNC_TIMER
-                    );
+    Status = NvmeControllerInit (Private);
     if (EFI_ERROR (Status)) {
       goto Exit;
     }
 
-    Status = gBS->InstallMultipleProtocolInterfaces (
-                    &Controller,
-                    &gEfiNvmExpressPassThruProtocolGuid,
-                    &Private->Passthru,
-                    NULL
-                    );
+    Status = NvmeInstallPassThru (Private);
     if (EFI_ERROR (Status)) {
       goto Exit;
     }
-
-    NvmeRegisterShutdownNotification ();
   } else {
+    //
+    // The namespaces of a controller that is still being initialized are
+    // enumerated when it becomes ready. Wait for it if one namespace is asked for.
+    //
+    Status = gBS->OpenProtocol (
+                    Controller,
+                    &gEfiCallerIdGuid,
+                    NULL,
+                    This->DriverBindingHandle,
+                    Controller,
+                    EFI_OPEN_PROTOCOL_TEST_PROTOCOL
+                    );
+    if (!EFI_ERROR (Status)) {
+      if (RemainingDevicePath == NULL) {
+        return EFI_SUCCESS;
+      }
+
+      Status = NvmeWaitForControllerInit (Controller, This->DriverBindingHandle);
+      if (EFI_ERROR (Status)) {
+        return EFI_NOT_READY;
+      }
+    }
+
     Status = gBS->OpenProtocol (
                     Controller,
                     &gEfiNvmExpressPassThruProtocolGuid,
@@ -1171,7 +1527,7 @@ Exit:
   }
 
   if ((Private != NULL) && (Private->Buffer != NULL)) {
-    PciIo->FreeBuffer (PciIo, 6, Private->Buffer);
+    PciIo->FreeBuffer (PciIo, NVME_BUFFER_PAGES, Private->Buffer);
   }
 
   if ((Private != NULL) && (Private->ControllerData != NULL)) {
@@ -1249,6 +1605,28 @@ NvmExpressDriverBindingStop (
   EFI_TPL                             OldTpl;
 
   if (NumberOfChildren == 0) {
+    //
+    // Cancel the initialization of the controller if it is not finished yet.
+    // The timer event that finishes it runs at TPL_CALLBACK.
+    //
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    Status = gBS->OpenProtocol (
+                    Controller,
+                    &gEfiCallerIdGuid,
+                    (VOID **)&Private,
+                    This->DriverBindingHandle,
+                    Controller,
+                    EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                    );
+    if (!EFI_ERROR (Status)) {
+      NvmeAbortControllerInit (Private);
+    }
+
+    gBS->RestoreTPL (OldTpl);
+    if (!EFI_ERROR (Status)) {
+      return EFI_SUCCESS;
+    }
+
     Status = gBS->OpenProtocol (
                     Controller,
                     &gEfiNvmExpressPassThruProtocolGuid,
@@ -1293,7 +1671,7 @@ NvmExpressDriverBindingStop (
       }
 
       if (Private->Buffer != NULL) {
-        Private->PciIo->FreeBuffer (Private->PciIo, 6, Private->Buffer);
+        Private->PciIo->FreeBuffer (Private->PciIo, NVME_BUFFER_PAGES, Private->Buffer);
       }
 
       FreePool (Private->ControllerData);
@@ -1366,13 +1744,40 @@ NvmExpressUnload (
   // those protocols installed at image handle.
   //
   DeviceHandleBuffer = NULL;
-  Status             = gBS->LocateHandleBuffer (
-                              ByProtocol,
-                              &gEfiNvmExpressPassThruProtocolGuid,
-                              NULL,
-                              &DeviceHandleCount,
-                              &DeviceHandleBuffer
-                              );
+
+  //
+  // Cancel the controller initializations that are not finished yet.
+  //
+  Status = gBS->LocateHandleBuffer (
+                  ByProtocol,
+                  &gEfiCallerIdGuid,
+                  NULL,
+                  &DeviceHandleCount,
+                  &DeviceHandleBuffer
+                  );
+  if (!EFI_ERROR (Status)) {
+    for (Index = 0; Index < DeviceHandleCount; Index++) {
+      Status = gBS->DisconnectController (
+                      DeviceHandleBuffer[Index],
+                      ImageHandle,
+                      NULL
+                      );
+      if (EFI_ERROR (Status)) {
+        goto EXIT;
+      }
+    }
+
+    gBS->FreePool (DeviceHandleBuffer);
+    DeviceHandleBuffer = NULL;
+  }
+
+  Status = gBS->LocateHandleBuffer (
+                  ByProtocol,
+                  &gEfiNvmExpressPassThruProtocolGuid,
+                  NULL,
+                  &DeviceHandleCount,
+                  &DeviceHandleBuffer
+                  );
 
   if (!EFI_ERROR (Status)) {
     //
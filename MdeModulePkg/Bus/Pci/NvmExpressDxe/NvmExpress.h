@@ -31,6 +31,7 @@
 #include <Protocol/StorageSecurityCommand.h>
 #include <Protocol/ResetNotification.h>
 #include <Protocol/MediaSanitize.h>
+#include <Protocol/ControllerInitPending.h>
 
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -42,6 +43,7 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/PcdLib.h>
 
 #include <Guid/NVMeEventGroup.h>
 
@@ -64,8 +66,12 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 #define NVME_ASQ_SIZE  1                                // Number of admin submission queue entries, which is 0-based
 #define NVME_ACQ_SIZE  1                                // Number of admin completion queue entries, which is 0-based
 
-#define NVME_CSQ_SIZE  1                                // Number of I/O submission queue entries, which is 0-based
-#define NVME_CCQ_SIZE  1                                // Number of I/O completion queue entries, which is 0-based
+//
+// Number of synchronous I/O submission and completion queue entries, which is 0-based.
+// Large BlockIo transfers keep up to NVME_CSQ_SIZE commands in flight in these queues.
+//
+#define NVME_CSQ_SIZE  31
+#define NVME_CCQ_SIZE  31
 
 //
 // Number of asynchronous I/O submission queue entries, which is 0-based.
@@ -80,6 +86,13 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 
 #define NVME_MAX_QUEUES  3                              // Number of queues supported by the driver
 
+//
+// Pages of the queue buffer: the admin and the two I/O queue pairs, followed by
+// one PRP list page for each command in flight in the synchronous I/O queue.
+//
+#define NVME_SYNC_PRP_LIST_OFFSET  6
+#define NVME_BUFFER_PAGES          (NVME_SYNC_PRP_LIST_OFFSET + NVME_CSQ_SIZE)
+
 //
 // FormatNVM Admin Command LBA Format (LBAF) Mask
 //
@@ -116,6 +129,12 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 //
 #define NVME_HC_ASYNC_TIMER  EFI_TIMER_PERIOD_MILLISECONDS (1)
 
+//
+// Interval of polling CSTS.RDY when the controller initialization is finished
+// from a timer event.
+//
+#define NVME_INIT_POLL_INTERVAL  EFI_TIMER_PERIOD_MILLISECONDS (1)
+
 //
 // Unique signature for private data structure.
 //
@@ -145,13 +164,15 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   NVME_ADMIN_CONTROLLER_DATA            *ControllerData;
 
   //
-  // 6 x 4kB aligned buffers will be carved out of this buffer.
+  // NVME_BUFFER_PAGES x 4kB aligned buffers will be carved out of this buffer.
   // 1st 4kB boundary is the start of the admin submission queue.
   // 2nd 4kB boundary is the start of the admin completion queue.
   // 3rd 4kB boundary is the start of I/O submission queue #1.
   // 4th 4kB boundary is the start of I/O completion queue #1.
   // 5th 4kB boundary is the start of I/O submission queue #2.
   // 6th 4kB boundary is the start of I/O completion queue #2.
+  // The remaining 4kB boundaries are the start of the PRP lists of the
+  // commands in flight in I/O submission queue #1.
   //
   UINT8          *Buffer;
   UINT8          *BufferPciAddr;
@@ -192,6 +213,12 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   EFI_EVENT      TimerEvent;
   LIST_ENTRY     AsyncPassThruQueue;
   LIST_ENTRY     UnsubmittedSubtasks;
+
+  //
+  // For the controller initialization that is finished from a timer event.
+  //
+  EFI_EVENT      InitEvent;
+  EFI_EVENT      InitTimeoutEvent;
 };
 
 #define NVME_CONTROLLER_PRIVATE_DATA_FROM_PASS_THRU(a) \
@@ -748,6 +775,32 @@ NvmExpressBuildDevicePath (
   IN OUT EFI_DEVICE_PATH_PROTOCOL            **DevicePath
   );
 
+/**
+  Read or write blocks with several commands in flight in the synchronous I/O queue.
+
+  @param[in]  Device             The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param[in]  Opcode             NVME_IO_READ_OPC or NVME_IO_WRITE_OPC.
+  @param[in]  Buffer             The buffer to transfer the data to or from.
+  @param[in]  Lba                The start block number.
+  @param[in]  Blocks             Total block number to be transferred.
+  @param[in]  MaxTransferBlocks  The maximum block number of one command.
+
+  @retval EFI_SUCCESS            All the blocks are transferred.
+  @retval EFI_OUT_OF_RESOURCES   The buffer could not be mapped.
+  @retval EFI_TIMEOUT            The controller stopped completing the commands.
+  @retval Others                 Fail to transfer all the blocks.
+
+**/
+EFI_STATUS
+NvmeSyncIoPipeline (
+  IN NVME_DEVICE_PRIVATE_DATA  *Device,
+  IN UINT8                     Opcode,
+  IN VOID                      *Buffer,
+  IN UINT64                    Lba,
+  IN UINTN                     Blocks,
+  IN UINT32                    MaxTransferBlocks
+  );
+
 /**
   Dump the execution status from a given completion queue entry.
 
@@ -380,25 +380,24 @@ NvmeDisableController (
 }
 
 /**
-  Enable the Nvm Express controller.
+  Start to enable the Nvm Express controller, without waiting for it to become ready.
+
+  If EFI_SUCCESS is returned, the caller must poll NvmeCheckControllerReady() and
+  then call NvmeCompleteEnableController().
 
   @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
 
-  @return EFI_SUCCESS      Successfully enable the controller.
+  @return EFI_SUCCESS      Successfully start to enable the controller.
   @return EFI_DEVICE_ERROR Fail to enable the controller.
-  @return EFI_TIMEOUT      Fail to enable the controller in given time slot.
 
 **/
 EFI_STATUS
-NvmeEnableController (
+NvmeStartEnableController (
   IN NVME_CONTROLLER_PRIVATE_DATA  *Private
   )
 {
   NVME_CC     Cc;
-  NVME_CSTS   Csts;
   EFI_STATUS  Status;
-  UINT32      Index;
-  UINT8       Timeout;
 
   EfiEventGroupSignal (&gNVMeEnableStartEventGroupGuid);
 
@@ -413,49 +412,134 @@ NvmeEnableController (
 
   Status = WriteNvmeControllerConfiguration (Private, &Cc);
   if (EFI_ERROR (Status)) {
-    goto Cleanup;
+    EfiEventGroupSignal (&gNVMeEnableCompleteEventGroupGuid);
+  }
+
+  return Status;
+}
+
+/**
+  Check if the Nvm Express controller became ready after NvmeStartEnableController().
+
+  @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @return EFI_SUCCESS      The controller is ready.
+  @return EFI_NOT_READY    The controller is not ready yet.
+  @return EFI_DEVICE_ERROR Fail to read the controller status.
+
+**/
+EFI_STATUS
+NvmeCheckControllerReady (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  NVME_CSTS   Csts;
+  EFI_STATUS  Status;
+
+  Status = ReadNvmeControllerStatus (Private, &Csts);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return Csts.Rdy ? EFI_SUCCESS : EFI_NOT_READY;
+}
+
+/**
+  Complete the enabling of the Nvm Express controller started by NvmeStartEnableController().
+
+  @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param  Status           The result of polling NvmeCheckControllerReady(). EFI_TIMEOUT if
+                           the controller did not become ready in time.
+
+  @return Status.
+
+**/
+EFI_STATUS
+NvmeCompleteEnableController (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN EFI_STATUS                    Status
+  )
+{
+  if (Status == EFI_TIMEOUT) {
+    REPORT_STATUS_CODE (
+      (EFI_ERROR_CODE | EFI_ERROR_MAJOR),
+      (EFI_IO_BUS_SCSI | EFI_IOB_EC_INTERFACE_ERROR)
+      );
   }
 
+  DEBUG ((DEBUG_INFO, "NVMe controller is enabled with status [%r].\n", Status));
+
+  EfiEventGroupSignal (&gNVMeEnableCompleteEventGroupGuid);
+  return Status;
+}
+
+/**
+  Get the number of milliseconds the Nvm Express controller may take to become ready.
+
+  @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @return The timeout in milliseconds.
+
+**/
+UINT32
+NvmeGetReadyTimeout (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
   //
   // Cap.To specifies max delay time in 500ms increments for Csts.Rdy to set after
-  // Cc.Enable. Loop produces a 1 millisecond delay per itteration, up to 500 * Cap.To.
+  // Cc.Enable.
   //
   if (Private->Cap.To == 0) {
-    Timeout = 1;
-  } else {
-    Timeout = Private->Cap.To;
+    return 500;
   }
 
-  for (Index = (Timeout * 500); Index != 0; --Index) {
+  return Private->Cap.To * 500;
+}
+
+/**
+  Enable the Nvm Express controller.
+
+  @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @return EFI_SUCCESS      Successfully enable the controller.
+  @return EFI_DEVICE_ERROR Fail to enable the controller.
+  @return EFI_TIMEOUT      Fail to enable the controller in given time slot.
+
+**/
+EFI_STATUS
+NvmeEnableController (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Index;
+
+  Status = NvmeStartEnableController (Private);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Loop produces a 1 millisecond delay per itteration.
+  //
+  for (Index = NvmeGetReadyTimeout (Private); Index != 0; --Index) {
     gBS->Stall (1000);
 
     //
     // Check if the controller is initialized
     //
-    Status = ReadNvmeControllerStatus (Private, &Csts);
-
-    if (EFI_ERROR (Status)) {
-      goto Cleanup;
-    }
-
-    if (Csts.Rdy) {
+    Status = NvmeCheckControllerReady (Private);
+    if (Status != EFI_NOT_READY) {
       break;
     }
   }
 
   if (Index == 0) {
     Status = EFI_TIMEOUT;
-    REPORT_STATUS_CODE (
-      (EFI_ERROR_CODE | EFI_ERROR_MAJOR),
-      (EFI_IO_BUS_SCSI | EFI_IOB_EC_INTERFACE_ERROR)
-      );
   }
 
-  DEBUG ((DEBUG_INFO, "NVMe controller is enabled with status [%r].\n", Status));
-
-Cleanup:
-  EfiEventGroupSignal (&gNVMeEnableCompleteEventGroupGuid);
-  return Status;
+  return NvmeCompleteEnableController (Private, Status);
 }
 
 /**
@@ -605,7 +689,11 @@ NvmeCreateIoCompletionQueue (
     CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
 
     if (Index == 1) {
-      QueueSize = NVME_CCQ_SIZE;
+      if (Private->Cap.Mqes > NVME_CCQ_SIZE) {
+        QueueSize = NVME_CCQ_SIZE;
+      } else {
+        QueueSize = Private->Cap.Mqes;
+      }
     } else {
       if (Private->Cap.Mqes > NVME_ASYNC_CCQ_SIZE) {
         QueueSize = NVME_ASYNC_CCQ_SIZE;
@@ -677,7 +765,11 @@ NvmeCreateIoSubmissionQueue (
     CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
 
     if (Index == 1) {
-      QueueSize = NVME_CSQ_SIZE;
+      if (Private->Cap.Mqes > NVME_CSQ_SIZE) {
+        QueueSize = NVME_CSQ_SIZE;
+      } else {
+        QueueSize = Private->Cap.Mqes;
+      }
     } else {
       if (Private->Cap.Mqes > NVME_ASYNC_CSQ_SIZE) {
         QueueSize = NVME_ASYNC_CSQ_SIZE;
@@ -711,16 +803,17 @@ NvmeCreateIoSubmissionQueue (
 }
 
 /**
-  Initialize the Nvm Express controller.
+  Prepare the Nvm Express controller to be enabled: reset it and program the
+  admin queues.
 
   @param[in] Private                 The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
 
-  @retval EFI_SUCCESS                The NVM Express Controller is initialized successfully.
-  @retval Others                     A device error occurred while initializing the controller.
+  @retval EFI_SUCCESS                The NVM Express Controller is ready to be enabled.
+  @retval Others                     A device error occurred while resetting the controller.
 
 **/
 EFI_STATUS
-NvmeControllerInit (
+NvmeControllerInitPrepare (
   IN NVME_CONTROLLER_PRIVATE_DATA  *Private
   )
 {
@@ -730,8 +823,6 @@ NvmeControllerInit (
   NVME_AQA             Aqa;
   NVME_ASQ             Asq;
   NVME_ACQ             Acq;
-  UINT8                Sn[21];
-  UINT8                Mn[41];
 
   //
   // Enable this controller.
@@ -818,7 +909,7 @@ NvmeControllerInit (
   //
   // Address of I/O submission & completion queue.
   //
-  ZeroMem (Private->Buffer, EFI_PAGES_TO_SIZE (6));
+  ZeroMem (Private->Buffer, EFI_PAGES_TO_SIZE (NVME_BUFFER_PAGES));
   Private->SqBuffer[0]        = (NVME_SQ *)(UINTN)(Private->Buffer);
   Private->SqBufferPciAddr[0] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr);
   Private->CqBuffer[0]        = (NVME_CQ *)(UINTN)(Private->Buffer + 1 * EFI_PAGE_SIZE);
@@ -865,14 +956,27 @@ NvmeControllerInit (
   //
   Status = WriteNvmeAdminCompletionQueueBaseAddress (Private, &Acq);
 
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
+  return Status;
+}
 
-  Status = NvmeEnableController (Private);
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
+/**
+  Finish the initialization of the Nvm Express controller after it is enabled:
+  identify it and create the I/O queues.
+
+  @param[in] Private                 The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @retval EFI_SUCCESS                The NVM Express Controller is initialized successfully.
+  @retval Others                     A device error occurred while initializing the controller.
+
+**/
+EFI_STATUS
+NvmeControllerInitFinish (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       Sn[21];
+  UINT8       Mn[41];
 
   //
   // Allocate buffer for Identify Controller data
@@ -936,6 +1040,35 @@ NvmeControllerInit (
   return Status;
 }
 
+/**
+  Initialize the Nvm Express controller.
+
+  @param[in] Private                 The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @retval EFI_SUCCESS                The NVM Express Controller is initialized successfully.
+  @retval Others                     A device error occurred while initializing the controller.
+
+**/
+EFI_STATUS
+NvmeControllerInit (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = NvmeControllerInitPrepare (Private);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = NvmeEnableController (Private);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return NvmeControllerInitFinish (Private);
+}
+
 /**
  This routine is called to properly shutdown the Nvm Express controller per NVMe spec.
 
@@ -32,6 +32,111 @@ NvmeControllerInit (
   IN NVME_CONTROLLER_PRIVATE_DATA  *Private
   );
 
+/**
+  Prepare the Nvm Express controller to be enabled: reset it and program the
+  admin queues.
+
+  @param[in] Private                 The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @retval EFI_SUCCESS                The NVM Express Controller is ready to be enabled.
+  @retval Others                     A device error occurred while resetting the controller.
+
+**/
+EFI_STATUS
+NvmeControllerInitPrepare (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
+/**
+  Finish the initialization of the Nvm Express controller after it is enabled:
+  identify it and create the I/O queues.
+
+  @param[in] Private                 The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @retval EFI_SUCCESS                The NVM Express Controller is initialized successfully.
+  @retval Others                     A device error occurred while initializing the controller.
+
+**/
+EFI_STATUS
+NvmeControllerInitFinish (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
+/**
+  Disable the Nvm Express controller.
+
+  @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @return EFI_SUCCESS      Successfully disable the controller.
+  @return EFI_DEVICE_ERROR Fail to disable the controller.
+
+**/
+EFI_STATUS
+NvmeDisableController (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
+/**
+  Start to enable the Nvm Express controller, without waiting for it to become ready.
+
+  If EFI_SUCCESS is returned, the caller must poll NvmeCheckControllerReady() and
+  then call NvmeCompleteEnableController().
+
+  @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @return EFI_SUCCESS      Successfully start to enable the controller.
+  @return EFI_DEVICE_ERROR Fail to enable the controller.
+
+**/
+EFI_STATUS
+NvmeStartEnableController (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
+/**
+  Check if the Nvm Express controller became ready after NvmeStartEnableController().
+
+  @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @return EFI_SUCCESS      The controller is ready.
+  @return EFI_NOT_READY    The controller is not ready yet.
+  @return EFI_DEVICE_ERROR Fail to read the controller status.
+
+**/
+EFI_STATUS
+NvmeCheckControllerReady (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
+/**
+  Complete the enabling of the Nvm Express controller started by NvmeStartEnableController().
+
+  @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param  Status           The result of polling NvmeCheckControllerReady(). EFI_TIMEOUT if
+                           the controller did not become ready in time.
+
+  @return Status.
+
+**/
+EFI_STATUS
+NvmeCompleteEnableController (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN EFI_STATUS                    Status
+  );
+
+/**
+  Get the number of milliseconds the Nvm Express controller may take to become ready.
+
+  @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @return The timeout in milliseconds.
+
+**/
+UINT32
+NvmeGetReadyTimeout (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
 /**
   Get identify controller data.
 
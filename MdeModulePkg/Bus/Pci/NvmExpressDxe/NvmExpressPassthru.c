@@ -414,6 +414,67 @@ AbortAsyncPassThruTasks (
   return Status;
 }
 
+/**
+  Reset the NVMe controller after a timeout to abort the outstanding commands.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+  @retval EFI_TIMEOUT       The controller is reset, and the asynchronous
+                            PassThru requests have been aborted.
+  @return Others            Fail to reset the controller.
+
+**/
+EFI_STATUS
+NvmeResetControllerOnTimeout (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  ReportStatusCode ((EFI_ERROR_MAJOR | EFI_ERROR_CODE), (EFI_IO_BUS_SCSI | EFI_IOB_EC_INTERFACE_ERROR));
+
+  //
+  // Timeout occurs for an NVMe command. Reset the controller to abort the
+  // outstanding commands.
+  //
+  DEBUG ((DEBUG_ERROR, "NvmExpressPassThru: Timeout occurs for an NVMe command.\n"));
+
+  //
+  // Disable the timer to trigger the process of async transfers temporarily.
+  //
+  Status = gBS->SetTimer (Private->TimerEvent, TimerCancel, 0);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Reset the NVMe controller.
+  //
+  Status = NvmeControllerInit (Private);
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Status = AbortAsyncPassThruTasks (Private);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Re-enable the timer to trigger the process of async transfers.
+  //
+  Status = gBS->SetTimer (Private->TimerEvent, TimerPeriodic, NVME_HC_ASYNC_TIMER);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Return EFI_TIMEOUT to indicate a timeout occurs for NVMe PassThru command.
+  //
+  return EFI_TIMEOUT;
+}
+
 /**
   Sends an NVM Express Command Packet to an NVM Express controller or namespace. This function supports
   both blocking I/O and non-blocking I/O. The blocking I/O functionality is required, and the non-blocking
@@ -553,15 +614,21 @@ NvmExpressPassThru (
   Prp         = NULL;
   TimerEvent  = NULL;
   Status      = EFI_SUCCESS;
-  QueueSize   = MIN (NVME_ASYNC_CSQ_SIZE, Private->Cap.Mqes) + 1;
 
+  //
+  // The completion queues of the admin and synchronous I/O queues have as
+  // many entries as their submission queues.
+  //
   if (Packet->QueueType == NVME_ADMIN_QUEUE) {
-    QueueId = 0;
+    QueueId   = 0;
+    QueueSize = NVME_ASQ_SIZE + 1;
   } else {
     if (Event == NULL) {
-      QueueId = 1;
+      QueueId   = 1;
+      QueueSize = MIN (NVME_CSQ_SIZE, Private->Cap.Mqes) + 1;
     } else {
-      QueueId = 2;
+      QueueId   = 2;
+      QueueSize = MIN (NVME_ASYNC_CSQ_SIZE, Private->Cap.Mqes) + 1;
 
       //
       // Submission queue full check.
@@ -726,12 +793,8 @@ NvmExpressPassThru (
   //
   // Ring the submission queue doorbell.
   //
-  if ((Event != NULL) && (QueueId != 0)) {
-    Private->SqTdbl[QueueId].Sqt =
-      (Private->SqTdbl[QueueId].Sqt + 1) % QueueSize;
-  } else {
-    Private->SqTdbl[QueueId].Sqt ^= 1;
-  }
+  Private->SqTdbl[QueueId].Sqt =
+    (Private->SqTdbl[QueueId].Sqt + 1) % QueueSize;
 
   Data   = ReadUnaligned32 ((UINT32 *)&Private->SqTdbl[QueueId]);
   Status = PciIo->Mem.Write (
@@ -824,48 +887,13 @@ NvmExpressPassThru (
     //
     CopyMem (Packet->NvmeCompletion, (VOID *)Cq, sizeof (EFI_NVM_EXPRESS_COMPLETION));
   } else {
-    ReportStatusCode ((EFI_ERROR_MAJOR | EFI_ERROR_CODE), (EFI_IO_BUS_SCSI | EFI_IOB_EC_INTERFACE_ERROR));
-
-    //
-    // Timeout occurs for an NVMe command. Reset the controller to abort the
-    // outstanding commands.
-    //
-    DEBUG ((DEBUG_ERROR, "NvmExpressPassThru: Timeout occurs for an NVMe command.\n"));
-
-    //
-    // Disable the timer to trigger the process of async transfers temporarily.
-    //
-    Status = gBS->SetTimer (Private->TimerEvent, TimerCancel, 0);
-    if (EFI_ERROR (Status)) {
-      goto EXIT;
-    }
-
-    //
-    // Reset the NVMe controller.
-    //
-    Status = NvmeControllerInit (Private);
-    if (!EFI_ERROR (Status)) {
-      Status = AbortAsyncPassThruTasks (Private);
-      if (!EFI_ERROR (Status)) {
-        //
-        // Re-enable the timer to trigger the process of async transfers.
-        //
-        Status = gBS->SetTimer (Private->TimerEvent, TimerPeriodic, NVME_HC_ASYNC_TIMER);
-        if (!EFI_ERROR (Status)) {
-          //
-          // Return EFI_TIMEOUT to indicate a timeout occurs for NVMe PassThru command.
-          //
-          Status = EFI_TIMEOUT;
-        }
-      }
-    } else {
-      Status = EFI_DEVICE_ERROR;
-    }
-
+    Status = NvmeResetControllerOnTimeout (Private);
     goto EXIT;
   }
 
-  if ((Private->CqHdbl[QueueId].Cqh ^= 1) == 0) {
+  Private->CqHdbl[QueueId].Cqh =
+    (Private->CqHdbl[QueueId].Cqh + 1) % QueueSize;
+  if (Private->CqHdbl[QueueId].Cqh == 0) {
     Private->Pt[QueueId] ^= 1;
   }
 
@@ -925,6 +953,267 @@ EXIT:
   return Status;
 }
 
+/**
+  Read or write blocks with several commands in flight in the synchronous I/O queue.
+
+  The blocks are split at MaxTransferBlocks. Commands are placed in the free
+  entries of the submission queue and the tail doorbell is rung once for all of
+  them. The completion queue is then polled, and the head doorbell is rung once
+  for all the completions found, before the freed entries are filled again.
+
+  Each command in flight uses the PRP list page of the queue buffer that matches
+  its command identifier, so no PRP list is allocated during the transfer.
+
+  If the buffer cannot be mapped while commands are in flight, no more commands
+  are submitted until one of them completes and releases its mapping, and the
+  mapping is then tried again.
+
+  @param[in]  Device             The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param[in]  Opcode             NVME_IO_READ_OPC or NVME_IO_WRITE_OPC.
+  @param[in]  Buffer             The buffer to transfer the data to or from.
+  @param[in]  Lba                The start block number.
+  @param[in]  Blocks             Total block number to be transferred.
+  @param[in]  MaxTransferBlocks  The maximum block number of one command.
+
+  @retval EFI_SUCCESS            All the blocks are transferred.
+  @retval EFI_OUT_OF_RESOURCES   The buffer could not be mapped with no command in flight.
+  @retval EFI_TIMEOUT            The controller stopped completing the commands.
+  @retval Others                 Fail to transfer all the blocks.
+
+**/
+EFI_STATUS
+NvmeSyncIoPipeline (
+  IN NVME_DEVICE_PRIVATE_DATA  *Device,
+  IN UINT8                     Opcode,
+  IN VOID                      *Buffer,
+  IN UINT64                    Lba,
+  IN UINTN                     Blocks,
+  IN UINT32                    MaxTransferBlocks
+  )
+{
+  NVME_CONTROLLER_PRIVATE_DATA   *Private;
+  EFI_PCI_IO_PROTOCOL            *PciIo;
+  EFI_PCI_IO_PROTOCOL_OPERATION  Flag;
+  EFI_STATUS                     Status;
+  EFI_STATUS                     DoorbellStatus;
+  EFI_EVENT                      TimerEvent;
+  NVME_SQ                        *Sq;
+  volatile NVME_CQ               *Cq;
+  VOID                           *MapData[NVME_CSQ_SIZE];
+  UINT16                         FreeCid[NVME_CSQ_SIZE];
+  UINT16                         FreeCidCount;
+  UINT16                         QueueSize;
+  UINT16                         Cid;
+  UINTN                          InFlight;
+  BOOLEAN                        MapWait;
+  UINTN                          Submitted;
+  UINTN                          Completed;
+  UINT32                         BlockSize;
+  UINT32                         TransferBlocks;
+  UINT32                         Bytes;
+  UINTN                          MapLength;
+  EFI_PHYSICAL_ADDRESS           PhyAddr;
+  UINT64                         *PrpList;
+  UINTN                          PrpEntryNo;
+  UINTN                          PrpEntryIndex;
+  UINT32                         Data;
+
+  Private   = Device->Controller;
+  PciIo     = Private->PciIo;
+  BlockSize = Device->Media.BlockSize;
+  QueueSize = MIN (NVME_CSQ_SIZE, Private->Cap.Mqes) + 1;
+
+  if (Opcode == NVME_IO_READ_OPC) {
+    Flag = EfiPciIoOperationBusMasterWrite;
+  } else {
+    Flag = EfiPciIoOperationBusMasterRead;
+  }
+
+  //
+  // One PRP list page describes up to (EFI_PAGE_SIZE / sizeof (UINT64)) pages
+  // after the first one.
+  //
+  MaxTransferBlocks = (UINT32)MIN (MaxTransferBlocks, EFI_PAGE_SIZE / sizeof (UINT64) * EFI_PAGE_SIZE / BlockSize);
+
+  //
+  // Keep one submission queue entry unused so that the queue is never full.
+  //
+  for (FreeCidCount = 0; FreeCidCount < QueueSize - 1; FreeCidCount++) {
+    FreeCid[FreeCidCount] = FreeCidCount;
+    MapData[FreeCidCount] = NULL;
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &TimerEvent);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->SetTimer (TimerEvent, TimerRelative, NVME_GENERIC_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (TimerEvent);
+    return Status;
+  }
+
+  InFlight = 0;
+  MapWait  = FALSE;
+  while (((Blocks > 0) && !EFI_ERROR (Status)) || (InFlight > 0)) {
+    //
+    // Fill the free submission queue entries.
+    //
+    Submitted = 0;
+    while ((Blocks > 0) && (FreeCidCount > 0) && !MapWait && !EFI_ERROR (Status)) {
+      TransferBlocks = (UINT32)MIN (Blocks, MaxTransferBlocks);
+      Bytes          = TransferBlocks * BlockSize;
+      Cid            = FreeCid[FreeCidCount - 1];
+
+      MapLength = Bytes;
+      Status    = PciIo->Map (PciIo, Flag, Buffer, &MapLength, &PhyAddr, &MapData[Cid]);
+      if (EFI_ERROR (Status) || (MapLength != Bytes)) {
+        if (!EFI_ERROR (Status)) {
+          PciIo->Unmap (PciIo, MapData[Cid]);
+        }
+
+        MapData[Cid] = NULL;
+
+        //
+        // The commands in flight release their mappings when they complete, so
+        // map again after a completion. Fail only if nothing is in flight.
+        //
+        if (InFlight > 0) {
+          Status  = EFI_SUCCESS;
+          MapWait = TRUE;
+        } else {
+          Status = EFI_OUT_OF_RESOURCES;
+        }
+
+        break;
+      }
+
+      FreeCidCount--;
+
+      Sq = Private->SqBuffer[1] + Private->SqTdbl[1].Sqt;
+      ZeroMem (Sq, sizeof (NVME_SQ));
+      Sq->Opc    = Opcode;
+      Sq->Cid    = Cid;
+      Sq->Nsid   = Device->NamespaceId;
+      Sq->Prp[0] = PhyAddr;
+
+      PrpEntryNo = EFI_SIZE_TO_PAGES ((PhyAddr & (EFI_PAGE_SIZE - 1)) + Bytes) - 1;
+      if (PrpEntryNo > 1) {
+        PrpList = (UINT64 *)(Private->Buffer + EFI_PAGES_TO_SIZE (NVME_SYNC_PRP_LIST_OFFSET + Cid));
+        for (PrpEntryIndex = 0; PrpEntryIndex < PrpEntryNo; PrpEntryIndex++) {
+          PrpList[PrpEntryIndex] = (PhyAddr & ~(EFI_PAGE_SIZE - 1)) + EFI_PAGES_TO_SIZE (PrpEntryIndex + 1);
+        }
+
+        Sq->Prp[1] = (UINT64)(UINTN)(Private->BufferPciAddr + EFI_PAGES_TO_SIZE (NVME_SYNC_PRP_LIST_OFFSET + Cid));
+      } else if (PrpEntryNo == 1) {
+        Sq->Prp[1] = (PhyAddr + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
+      }
+
+      Sq->Payload.Raw.Cdw10 = (UINT32)Lba;
+      Sq->Payload.Raw.Cdw11 = (UINT32)RShiftU64 (Lba, 32);
+      Sq->Payload.Raw.Cdw12 = (TransferBlocks - 1) & 0xFFFF;
+      if (Opcode == NVME_IO_WRITE_OPC) {
+        //
+        // Set Force Unit Access bit (bit 30) to use write-through behaviour
+        //
+        Sq->Payload.Raw.Cdw12 |= BIT30;
+      }
+
+      Private->SqTdbl[1].Sqt = (Private->SqTdbl[1].Sqt + 1) % QueueSize;
+
+      Blocks -= TransferBlocks;
+      Buffer  = (UINT8 *)Buffer + Bytes;
+      Lba    += TransferBlocks;
+      InFlight++;
+      Submitted++;
+    }
+
+    //
+    // Ring the submission queue doorbell once for the whole batch.
+    //
+    if (Submitted > 0) {
+      Data           = ReadUnaligned32 ((UINT32 *)&Private->SqTdbl[1]);
+      DoorbellStatus = PciIo->Mem.Write (
+                                    PciIo,
+                                    EfiPciIoWidthUint32,
+                                    NVME_BAR,
+                                    NVME_SQTDBL_OFFSET (1, Private->Cap.Dstrd),
+                                    1,
+                                    &Data
+                                    );
+      if (EFI_ERROR (DoorbellStatus)) {
+        Status = DoorbellStatus;
+      }
+    }
+
+    //
+    // Reap all the completions posted so far.
+    //
+    Completed = 0;
+    Cq        = Private->CqBuffer[1] + Private->CqHdbl[1].Cqh;
+    while (Cq->Pt != Private->Pt[1]) {
+      Cid = Cq->Cid;
+      ASSERT ((Cid < QueueSize - 1) && (MapData[Cid] != NULL));
+      if ((Cq->Sct != 0) || (Cq->Sc != 0)) {
+        DEBUG_CODE_BEGIN ();
+        NvmeDumpStatus ((NVME_CQ *)Cq);
+        DEBUG_CODE_END ();
+        Status = EFI_DEVICE_ERROR;
+      }
+
+      if ((Cid < QueueSize - 1) && (MapData[Cid] != NULL)) {
+        PciIo->Unmap (PciIo, MapData[Cid]);
+        MapData[Cid]            = NULL;
+        FreeCid[FreeCidCount++] = Cid;
+        InFlight--;
+      }
+
+      Private->CqHdbl[1].Cqh = (Private->CqHdbl[1].Cqh + 1) % QueueSize;
+      if (Private->CqHdbl[1].Cqh == 0) {
+        Private->Pt[1] ^= 1;
+      }
+
+      Cq = Private->CqBuffer[1] + Private->CqHdbl[1].Cqh;
+      Completed++;
+    }
+
+    if (Completed > 0) {
+      Data           = ReadUnaligned32 ((UINT32 *)&Private->CqHdbl[1]);
+      DoorbellStatus = PciIo->Mem.Write (
+                                    PciIo,
+                                    EfiPciIoWidthUint32,
+                                    NVME_BAR,
+                                    NVME_CQHDBL_OFFSET (1, Private->Cap.Dstrd),
+                                    1,
+                                    &Data
+                                    );
+      if (EFI_ERROR (DoorbellStatus)) {
+        Status = DoorbellStatus;
+      }
+
+      //
+      // The timeout applies to the oldest command still in flight.
+      //
+      gBS->SetTimer (TimerEvent, TimerRelative, NVME_GENERIC_TIMEOUT);
+      MapWait = FALSE;
+    } else if ((InFlight > 0) && !EFI_ERROR (gBS->CheckEvent (TimerEvent))) {
+      Status = NvmeResetControllerOnTimeout (Private);
+      for (Cid = 0; Cid < QueueSize - 1; Cid++) {
+        if (MapData[Cid] != NULL) {
+          PciIo->Unmap (PciIo, MapData[Cid]);
+        }
+      }
+
+      break;
+    }
+  }
+
+  gBS->CloseEvent (TimerEvent);
+
+  return Status;
+}
+
 /**
   Used to retrieve the next namespace ID for this NVM Express controller.
 
@@ -431,3 +431,60 @@ CoreIsSchedulable (
 Done:
   return FALSE;
 }
+
+/**
+  Add DriverEntry to the protocol database entry of every protocol pushed by its
+  dependency expression, and mark the dependency expression for evaluation.
+  If the dependency expression is malformed or out of resources,
+  DriverEntry->DepexIndexed stays FALSE and the dependency expression is evaluated
+  on every pass of the dispatcher.
+
+  @param  DriverEntry           DriverEntry element to update.
+
+**/
+VOID
+CoreIndexDepexProtocols (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  UINT8     *Iterator;
+  UINT8     *End;
+  EFI_GUID  ProtocolGuid;
+  BOOLEAN   Indexed;
+
+  DriverEntry->DepexReevaluate = TRUE;
+  if (DriverEntry->Depex == NULL) {
+    return;
+  }
+
+  Indexed  = FALSE;
+  Iterator = DriverEntry->Depex;
+  End      = Iterator + DriverEntry->DepexSize;
+  while (Iterator < End) {
+    if (*Iterator == EFI_DEP_END) {
+      Indexed = TRUE;
+      break;
+    }
+
+    if ((*Iterator == EFI_DEP_PUSH) || (*Iterator == EFI_DEP_BEFORE) ||
+        (*Iterator == EFI_DEP_AFTER) || (*Iterator == EFI_DEP_REPLACE_TRUE))
+    {
+      if ((UINTN)(End - Iterator) <= sizeof (EFI_GUID)) {
+        break;
+      }
+
+      if (*Iterator == EFI_DEP_PUSH) {
+        CopyMem (&ProtocolGuid, Iterator + 1, sizeof (EFI_GUID));
+        if (EFI_ERROR (CoreAddDepexProtocolDriver (&ProtocolGuid, DriverEntry))) {
+          break;
+        }
+      }
+
+      Iterator += sizeof (EFI_GUID);
+    }
+
+    Iterator++;
+  }
+
+  DriverEntry->DepexIndexed = Indexed;
+}
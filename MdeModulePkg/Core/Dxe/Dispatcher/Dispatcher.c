@@ -269,6 +269,7 @@ CoreGetDepexSectionAndPreProccess (
       DriverEntry->Depex              = NULL;
       DriverEntry->Dependent          = TRUE;
       DriverEntry->DepexProtocolError = FALSE;
+      CoreIndexDepexProtocols (DriverEntry);
     }
   } else {
     //
@@ -277,6 +278,7 @@ CoreGetDepexSectionAndPreProccess (
     //
     CorePreProcessDepex (DriverEntry);
     DriverEntry->DepexProtocolError = FALSE;
+    CoreIndexDepexProtocols (DriverEntry);
   }
 
   return Status;
@@ -319,8 +321,9 @@ CoreSchedule (
       // Move the driver from the Unrequested to the Dependent state
       //
       CoreAcquireDispatcherLock ();
-      DriverEntry->Unrequested = FALSE;
-      DriverEntry->Dependent   = TRUE;
+      DriverEntry->Unrequested     = FALSE;
+      DriverEntry->Dependent       = TRUE;
+      DriverEntry->DepexReevaluate = TRUE;
       CoreReleaseDispatcherLock ();
 
       DEBUG ((DEBUG_DISPATCH, "Schedule FFS(%g) - EFI_SUCCESS\n", DriverName));
@@ -407,6 +410,8 @@ CoreDispatcher (
   EFI_CORE_DRIVER_ENTRY  *DriverEntry;
   BOOLEAN                ReadyToRun;
   EFI_EVENT              DxeDispatchEvent;
+  UINTN                  DepexEvaluated;
+  UINTN                  DepexSkipped;
 
   PERF_FUNCTION_BEGIN ();
 
@@ -431,7 +436,9 @@ CoreDispatcher (
     return Status;
   }
 
-  ReturnStatus = EFI_NOT_FOUND;
+  DepexEvaluated = 0;
+  DepexSkipped   = 0;
+  ReturnStatus   = EFI_NOT_FOUND;
   do {
     //
     // Drain the Scheduled Queue
@@ -540,6 +547,7 @@ CoreDispatcher (
     //
     // Search DriverList for items to place on Scheduled Queue
     //
+    PERF_INMODULE_BEGIN ("DxeDepexEvaluation");
     ReadyToRun = FALSE;
     for (Link = mDiscoveredList.ForwardLink; Link != &mDiscoveredList; Link = Link->ForwardLink) {
       DriverEntry = CR (Link, EFI_CORE_DRIVER_ENTRY, Link, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
@@ -552,6 +560,17 @@ CoreDispatcher (
       }
 
       if (DriverEntry->Dependent) {
+        //
+        // The result of an indexed Depex can only change after one of the protocols
+        // it pushes has been installed.
+        //
+        if (DriverEntry->DepexIndexed && !DriverEntry->DepexReevaluate) {
+          DepexSkipped++;
+          continue;
+        }
+
+        DriverEntry->DepexReevaluate = FALSE;
+        DepexEvaluated++;
         if (CoreIsSchedulable (DriverEntry)) {
           CoreInsertOnScheduledQueueWhileProcessingBeforeAndAfter (DriverEntry);
           ReadyToRun = TRUE;
@@ -564,8 +583,12 @@ CoreDispatcher (
         }
       }
     }
+
+    PERF_INMODULE_END ("DxeDepexEvaluation");
   } while (ReadyToRun);
 
+  DEBUG ((DEBUG_DISPATCH, "DXE Dispatcher: %Lu DEPEX evaluated, %Lu DEPEX evaluations skipped\n", (UINT64)DepexEvaluated, (UINT64)DepexSkipped));
+
   //
   // Close DXE dispatch Event
   //
@@ -628,6 +651,8 @@ CoreInsertOnScheduledQueueWhileProcessingBeforeAndAfter (
 
   CoreReleaseDispatcherLock ();
 
+  CoreRemoveDepexProtocolDriver (InsertedDriverEntry);
+
   //
   // Process After Dependency
   //
@@ -873,6 +898,7 @@ CoreAddToDriverList (
   }
 
   DriverEntry->Signature = EFI_CORE_DRIVER_ENTRY_SIGNATURE;
+  InitializeListHead (&DriverEntry->DepexLinks);
   CopyGuid (&DriverEntry->FileName, DriverName);
   DriverEntry->FvHandle         = FvHandle;
   DriverEntry->Fv               = Fv;
@@ -1421,6 +1447,7 @@ CoreFwVolEventProtocolNotify (
           DriverEntry->Scheduled = TRUE;
           InsertTailList (&mScheduledQueue, &DriverEntry->ScheduledLink);
           CoreReleaseDispatcherLock ();
+          CoreRemoveDepexProtocolDriver (DriverEntry);
           DEBUG ((DEBUG_DISPATCH, "Evaluate DXE DEPEX for FFS(%g)\n", &DriverEntry->FileName));
           DEBUG ((DEBUG_DISPATCH, "  RESULT = TRUE (Apriori)\n"));
           break;
@@ -49,6 +49,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/FirmwareFileSystem2.h>
 #include <Guid/FirmwareFileSystem3.h>
 #include <Guid/HobList.h>
+#include <Guid/HobIndex.h>
 #include <Guid/DebugImageInfoTable.h>
 #include <Guid/FileInfo.h>
 #include <Guid/Apriori.h>
@@ -158,11 +159,27 @@ typedef struct {
   BOOLEAN                          Untrusted;
   BOOLEAN                          Initialized;
   BOOLEAN                          DepexProtocolError;
+  //
+  // DepexIndexed is TRUE if DriverEntry is on the DepexDrivers list of the protocol
+  // database entry of every protocol pushed by Depex. Such a Depex is only evaluated
+  // again when DepexReevaluate is set by the installation of one of these protocols.
+  //
+  BOOLEAN                          DepexIndexed;
+  BOOLEAN                          DepexReevaluate;
+  LIST_ENTRY                       DepexLinks;      // DEPEX_DRIVER_LINK.DriverLink
 
   EFI_HANDLE                       ImageHandle;
   BOOLEAN                          IsFvImage;
 } EFI_CORE_DRIVER_ENTRY;
 
+#define DEPEX_DRIVER_LINK_SIGNATURE  SIGNATURE_32('d','p','x','d')
+typedef struct {
+  UINTN                    Signature;
+  LIST_ENTRY               Link;        // PROTOCOL_ENTRY.DepexDrivers
+  LIST_ENTRY               DriverLink;  // EFI_CORE_DRIVER_ENTRY.DepexLinks
+  EFI_CORE_DRIVER_ENTRY    *DriverEntry;
+} DEPEX_DRIVER_LINK;
+
 //
 // The data structure of GCD memory map entry
 //
@@ -484,6 +501,53 @@ CorePreProcessDepex (
   IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
   );
 
+/**
+  Add DriverEntry to the protocol database entry of every protocol pushed by its
+  dependency expression, and mark the dependency expression for evaluation.
+  If the dependency expression is malformed or out of resources,
+  DriverEntry->DepexIndexed stays FALSE and the dependency expression is evaluated
+  on every pass of the dispatcher.
+
+  @param  DriverEntry           DriverEntry element to update.
+
+**/
+VOID
+CoreIndexDepexProtocols (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  );
+
+/**
+  Add a driver to the drivers whose dependency expression pushes a protocol, so
+  that the installation of the protocol marks the dependency expression for
+  evaluation.
+
+  @param  Protocol               The ID of the protocol.
+  @param  DriverEntry            The driver.
+
+  @retval EFI_SUCCESS            The driver is added, or was already the last
+                                 driver added for the protocol.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory to add the driver.
+
+**/
+EFI_STATUS
+CoreAddDepexProtocolDriver (
+  IN EFI_GUID               *Protocol,
+  IN EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  );
+
+/**
+  Remove a driver from the drivers whose dependency expression pushes a protocol,
+  for all the protocols it was added for, and free its links. This is done once the
+  driver is scheduled, since its dependency expression is not evaluated anymore.
+
+  @param  DriverEntry            The driver.
+
+**/
+VOID
+CoreRemoveDepexProtocolDriver (
+  IN EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  );
+
 /**
   Terminates all boot services.
 
@@ -550,6 +614,20 @@ CoreInstallConfigurationTable (
   IN VOID      *Table
   );
 
+/**
+  Build the index of the GUID HOBs in the HOB list and install it into the
+  EFI System Configuration Table.
+
+  The HOB list is read-only in DXE, so the index covers the whole list.
+
+  @param  HobStart       Pointer to the HOB list.
+
+**/
+VOID
+CoreInstallHobIndex (
+  IN VOID  *HobStart
+  );
+
 /**
   Raise the task priority level to the new level.
   High level is implemented by disabling processor interrupts.
@@ -2342,6 +2420,20 @@ CloseSectionStream (
   IN  BOOLEAN  FreeStreamBuffer
   );
 
+/**
+  SEP member function.  Returns the size of the buffers of all section streams
+  encapsulated in a section stream, which are freed when it is closed.
+
+  @param  SectionStreamHandle    Indicates the section stream
+
+  @return The size in bytes of the encapsulated section streams.
+
+**/
+UINTN
+GetEncapsulatedStreamSize (
+  IN  UINTN  SectionStreamHandle
+  );
+
 /**
   Creates and initializes the DebugImageInfo Table.  Also creates the configuration
   table and registers it into the system table.
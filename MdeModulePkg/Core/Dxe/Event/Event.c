@@ -450,6 +450,14 @@ CoreCreateEventInternal (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  if ((Type & EVT_TIMER) != 0) {
+    Status = CoreReserveTimerHeapEntry ();
+    if (EFI_ERROR (Status)) {
+      CoreFreePool (IEvent);
+      return Status;
+    }
+  }
+
   IEvent->Signature = EVENT_SIGNATURE;
   IEvent->Type      = Type;
 
@@ -719,6 +727,7 @@ CoreCloseEvent (
   //
   if ((Event->Type & EVT_TIMER) != 0) {
     CoreSetTimer (Event, TimerCancel, 0);
+    CoreReleaseTimerHeapEntry ();
   }
 
   CoreAcquireEventLock ();
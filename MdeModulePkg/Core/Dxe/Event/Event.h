@@ -30,9 +30,17 @@ extern  UINTN  gEventPending;
 /// Timer event information
 ///
 typedef struct {
-  LIST_ENTRY    Link;
-  UINT64        TriggerTime;
-  UINT64        Period;
+  ///
+  /// 1 + the index of the event in the timer heap if the timer is queued,
+  /// otherwise 0.
+  ///
+  UINTN     HeapIndex;
+  ///
+  /// Orders the timers with the same TriggerTime by the time they were queued.
+  ///
+  UINT64    Sequence;
+  UINT64    TriggerTime;
+  UINT64    Period;
 } TIMER_EVENT_INFO;
 
 #define EVENT_SIGNATURE  SIGNATURE_32('e','v','n','t')
@@ -85,4 +93,26 @@ CoreInitializeTimer (
   VOID
   );
 
+/**
+  Reserves an entry in the timer heap for a new timer event, so that the
+  timer can be queued without allocating memory at TPL_HIGH_LEVEL - 1.
+
+  @retval EFI_SUCCESS            The entry was reserved.
+  @retval EFI_OUT_OF_RESOURCES   The timer heap could not be grown.
+
+**/
+EFI_STATUS
+CoreReserveTimerHeapEntry (
+  VOID
+  );
+
+/**
+  Releases the timer heap entry reserved for a closed timer event.
+
+**/
+VOID
+CoreReleaseTimerHeapEntry (
+  VOID
+  );
+
 #endif
@@ -13,17 +13,216 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 // Internal data
 //
 
-LIST_ENTRY  mEfiTimerList       = INITIALIZE_LIST_HEAD_VARIABLE (mEfiTimerList);
-EFI_LOCK    mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
-EFI_EVENT   mEfiCheckTimerEvent = NULL;
+//
+// Minimum number of entries the timer heap grows to
+//
+#define TIMER_HEAP_MIN_COUNT  64
+
+//
+// The queued timers are kept in a binary min-heap ordered by trigger time.
+// The heap has an entry for every timer event that is not closed, so that
+// queuing a timer never allocates memory.
+//
+IEVENT     **mEfiTimerHeap       = NULL;
+UINTN      mEfiTimerHeapCount    = 0;
+UINTN      mEfiTimerHeapMaxCount = 0;
+UINTN      mEfiTimerEventCount   = 0;
+UINT64     mEfiTimerSequence     = 0;
+EFI_LOCK   mEfiTimerLock         = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
+EFI_EVENT  mEfiCheckTimerEvent   = NULL;
 
 EFI_LOCK  mEfiSystemTimeLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 UINT64    mEfiSystemTime     = 0;
 
+//
+// The longest time in nanoseconds CoreCheckTimers() held the timer lock.
+// Only measured in DEBUG builds, with the timer of the CPU Architectural Protocol.
+//
+UINT64  mEfiTimerCheckMaxTime = 0;
+
 //
 // Timer functions
 //
 
+/**
+  Checks if a timer expires before another one.
+
+  @param  Event1                 The first timer event
+  @param  Event2                 The second timer event
+
+  @retval TRUE                   Event1 expires before Event2, or at the same
+                                 time but was queued first
+  @retval FALSE                  Event1 expires after Event2
+
+**/
+BOOLEAN
+CoreTimerBefore (
+  IN IEVENT  *Event1,
+  IN IEVENT  *Event2
+  )
+{
+  if (Event1->Timer.TriggerTime != Event2->Timer.TriggerTime) {
+    return (BOOLEAN)(Event1->Timer.TriggerTime < Event2->Timer.TriggerTime);
+  }
+
+  return (BOOLEAN)(Event1->Timer.Sequence < Event2->Timer.Sequence);
+}
+
+/**
+  Stores a timer event in an entry of the timer heap.
+
+  @param  Index                  The index of the entry
+  @param  Event                  The timer event
+
+**/
+VOID
+CoreSetTimerHeapEntry (
+  IN UINTN   Index,
+  IN IEVENT  *Event
+  )
+{
+  mEfiTimerHeap[Index]   = Event;
+  Event->Timer.HeapIndex = Index + 1;
+}
+
+/**
+  Moves the timer event in an entry of the timer heap towards the root
+  until its parent expires first.
+
+  @param  Index                  The index of the entry
+
+**/
+VOID
+CoreSiftUpTimerHeap (
+  IN UINTN  Index
+  )
+{
+  IEVENT  *Event;
+  UINTN   Parent;
+
+  Event = mEfiTimerHeap[Index];
+  while (Index > 0) {
+    Parent = (Index - 1) / 2;
+    if (!CoreTimerBefore (Event, mEfiTimerHeap[Parent])) {
+      break;
+    }
+
+    CoreSetTimerHeapEntry (Index, mEfiTimerHeap[Parent]);
+    Index = Parent;
+  }
+
+  CoreSetTimerHeapEntry (Index, Event);
+}
+
+/**
+  Moves the timer event in an entry of the timer heap towards the leaves
+  until it expires before its children.
+
+  @param  Index                  The index of the entry
+
+**/
+VOID
+CoreSiftDownTimerHeap (
+  IN UINTN  Index
+  )
+{
+  IEVENT  *Event;
+  UINTN   Child;
+
+  Event = mEfiTimerHeap[Index];
+  while (TRUE) {
+    Child = 2 * Index + 1;
+    if (Child >= mEfiTimerHeapCount) {
+      break;
+    }
+
+    if ((Child + 1 < mEfiTimerHeapCount) && CoreTimerBefore (mEfiTimerHeap[Child + 1], mEfiTimerHeap[Child])) {
+      Child++;
+    }
+
+    if (!CoreTimerBefore (mEfiTimerHeap[Child], Event)) {
+      break;
+    }
+
+    CoreSetTimerHeapEntry (Index, mEfiTimerHeap[Child]);
+    Index = Child;
+  }
+
+  CoreSetTimerHeapEntry (Index, Event);
+}
+
+/**
+  Reserves an entry in the timer heap for a new timer event, so that the
+  timer can be queued without allocating memory at TPL_HIGH_LEVEL - 1.
+
+  @retval EFI_SUCCESS            The entry was reserved.
+  @retval EFI_OUT_OF_RESOURCES   The timer heap could not be grown.
+
+**/
+EFI_STATUS
+CoreReserveTimerHeapEntry (
+  VOID
+  )
+{
+  IEVENT  **NewHeap;
+  IEVENT  **OldHeap;
+  UINTN   NewMaxCount;
+
+  CoreAcquireLock (&mEfiTimerLock);
+
+  while (mEfiTimerEventCount >= mEfiTimerHeapMaxCount) {
+    //
+    // Memory can not be allocated while holding the timer lock. Another
+    // event may be created meanwhile, so check the size again afterwards.
+    //
+    NewMaxCount = MAX (mEfiTimerHeapMaxCount * 2, TIMER_HEAP_MIN_COUNT);
+    CoreReleaseLock (&mEfiTimerLock);
+
+    NewHeap = AllocatePool (NewMaxCount * sizeof (IEVENT *));
+    if (NewHeap == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    CoreAcquireLock (&mEfiTimerLock);
+    if (NewMaxCount > mEfiTimerHeapMaxCount) {
+      CopyMem (NewHeap, mEfiTimerHeap, mEfiTimerHeapCount * sizeof (IEVENT *));
+      OldHeap               = mEfiTimerHeap;
+      mEfiTimerHeap         = NewHeap;
+      mEfiTimerHeapMaxCount = NewMaxCount;
+    } else {
+      OldHeap = NewHeap;
+    }
+
+    CoreReleaseLock (&mEfiTimerLock);
+    if (OldHeap != NULL) {
+      FreePool (OldHeap);
+    }
+
+    CoreAcquireLock (&mEfiTimerLock);
+  }
+
+  mEfiTimerEventCount++;
+
+  CoreReleaseLock (&mEfiTimerLock);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Releases the timer heap entry reserved for a closed timer event.
+
+**/
+VOID
+CoreReleaseTimerHeapEntry (
+  VOID
+  )
+{
+  CoreAcquireLock (&mEfiTimerLock);
+  ASSERT (mEfiTimerEventCount > mEfiTimerHeapCount);
+  mEfiTimerEventCount--;
+  CoreReleaseLock (&mEfiTimerLock);
+}
+
 /**
   Inserts the timer event.
 
@@ -36,29 +235,55 @@ CoreInsertEventTimer (
   IN IEVENT  *Event
   )
 {
-  UINT64      TriggerTime;
-  LIST_ENTRY  *Link;
-  IEVENT      *Event2;
-
   ASSERT_LOCKED (&mEfiTimerLock);
+  ASSERT (Event->Timer.HeapIndex == 0);
+  ASSERT (mEfiTimerHeapCount < mEfiTimerHeapMaxCount);
 
   //
-  // Get the timer's trigger time
+  // Insert the timer into the timer heap after the queued timers with the
+  // same trigger time
   //
-  TriggerTime = Event->Timer.TriggerTime;
+  Event->Timer.Sequence = mEfiTimerSequence++;
+  CoreSetTimerHeapEntry (mEfiTimerHeapCount, Event);
+  mEfiTimerHeapCount++;
+  CoreSiftUpTimerHeap (mEfiTimerHeapCount - 1);
+}
 
-  //
-  // Insert the timer into the timer database in assending sorted order
-  //
-  for (Link = mEfiTimerList.ForwardLink; Link != &mEfiTimerList; Link = Link->ForwardLink) {
-    Event2 = CR (Link, IEVENT, Timer.Link, EVENT_SIGNATURE);
+/**
+  Removes the timer event from the timer heap.
 
-    if (Event2->Timer.TriggerTime > TriggerTime) {
-      break;
-    }
+  @param  Event                  Points to the internal structure of the
+                                 queued timer event
+
+**/
+VOID
+CoreRemoveEventTimer (
+  IN IEVENT  *Event
+  )
+{
+  UINTN   Index;
+  IEVENT  *Last;
+
+  ASSERT_LOCKED (&mEfiTimerLock);
+  ASSERT (Event->Timer.HeapIndex != 0);
+
+  Index                  = Event->Timer.HeapIndex - 1;
+  Event->Timer.HeapIndex = 0;
+  mEfiTimerHeapCount--;
+  if (Index == mEfiTimerHeapCount) {
+    return;
   }
 
-  InsertTailList (Link, &Event->Timer.Link);
+  //
+  // Move the last timer into the hole and restore the heap order
+  //
+  Last = mEfiTimerHeap[mEfiTimerHeapCount];
+  CoreSetTimerHeapEntry (Index, Last);
+  if ((Index > 0) && CoreTimerBefore (Last, mEfiTimerHeap[(Index - 1) / 2])) {
+    CoreSiftUpTimerHeap (Index);
+  } else {
+    CoreSiftDownTimerHeap (Index);
+  }
 }
 
 /**
@@ -82,7 +307,7 @@ CoreCurrentSystemTime (
 }
 
 /**
-  Checks the sorted timer list against the current system time.
+  Checks the timer heap against the current system time.
   Signals any expired event timer.
 
   @param  CheckEvent             Not used
@@ -96,17 +321,35 @@ CoreCheckTimers (
   IN VOID       *Context
   )
 {
-  UINT64  SystemTime;
-  IEVENT  *Event;
+  UINT64      SystemTime;
+  IEVENT      *Event;
+  EFI_STATUS  Status;
+  UINT64      StartTicks;
+  UINT64      EndTicks;
+  UINT64      TimerPeriod;
+  UINT64      Duration;
+
+  Status      = EFI_NOT_READY;
+  StartTicks  = 0;
+  EndTicks    = 0;
+  TimerPeriod = 0;
 
   //
   // Check the timer database for expired timers
   //
   CoreAcquireLock (&mEfiTimerLock);
+
+  DEBUG_CODE_BEGIN ();
+  if (gCpu != NULL) {
+    Status = gCpu->GetTimerValue (gCpu, 0, &StartTicks, &TimerPeriod);
+  }
+
+  DEBUG_CODE_END ();
+
   SystemTime = CoreCurrentSystemTime ();
 
-  while (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  while (mEfiTimerHeapCount != 0) {
+    Event = mEfiTimerHeap[0];
 
     //
     // If this timer is not expired, then we're done
@@ -119,8 +362,7 @@ CoreCheckTimers (
     // Remove this timer from the timer queue
     //
 
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+    CoreRemoveEventTimer (Event);
 
     //
     // Signal it
@@ -151,7 +393,28 @@ CoreCheckTimers (
     }
   }
 
+  DEBUG_CODE_BEGIN ();
+  if (!EFI_ERROR (Status)) {
+    Status = gCpu->GetTimerValue (gCpu, 0, &EndTicks, NULL);
+  }
+
+  DEBUG_CODE_END ();
+
   CoreReleaseLock (&mEfiTimerLock);
+
+  DEBUG_CODE_BEGIN ();
+  if (!EFI_ERROR (Status)) {
+    //
+    // TimerPeriod is in femtoseconds
+    //
+    Duration = DivU64x32 (MultU64x64 (EndTicks - StartTicks, TimerPeriod), 1000000);
+    if (Duration > mEfiTimerCheckMaxTime) {
+      mEfiTimerCheckMaxTime = Duration;
+      DEBUG ((DEBUG_VERBOSE, "CoreCheckTimers: new maximum of %Lu ns with %Lu timers queued\n", Duration, (UINT64)mEfiTimerHeapCount));
+    }
+  }
+
+  DEBUG_CODE_END ();
 }
 
 /**
@@ -202,11 +465,11 @@ CoreTimerTick (
   mEfiSystemTime += Duration;
 
   //
-  // If the head of the list is expired, fire the timer event
+  // If the root of the heap is expired, fire the timer event
   // to process it
   //
-  if (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  if (mEfiTimerHeapCount != 0) {
+    Event = mEfiTimerHeap[0];
 
     if (Event->Timer.TriggerTime <= mEfiSystemTime) {
       CoreSignalEvent (mEfiCheckTimerEvent);
@@ -260,9 +523,8 @@ CoreSetTimer (
   //
   // If the timer is queued to the timer database, remove it
   //
-  if (Event->Timer.Link.ForwardLink != NULL) {
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+  if (Event->Timer.HeapIndex != 0) {
+    CoreRemoveEventTimer (Event);
   }
 
   Event->Timer.TriggerTime = 0;
@@ -17,6 +17,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 VOID       *gEfiFwVolBlockNotifyReg;
 EFI_EVENT  gEfiFwVolBlockEvent;
 
+//
+// Section stream cache related globals
+//
+LIST_ENTRY  mFvSectionCacheList      = INITIALIZE_LIST_HEAD_VARIABLE (mFvSectionCacheList);
+UINTN       mFvSectionCacheSize      = 0;
+UINTN       mFvSectionCacheHitCount  = 0;
+UINTN       mFvSectionCacheMissCount = 0;
+
 FV_DEVICE  mFvDevice = {
   FV2_DEVICE_SIGNATURE,
   NULL,
@@ -241,6 +249,100 @@ GetFwVolHeader (
   return Status;
 }
 
+/**
+  Close the section stream of a file, which frees the sections extracted from it.
+
+  @param  FfsFileEntry   The file.
+
+**/
+VOID
+FvReleaseSectionStream (
+  IN FFS_FILE_LIST_ENTRY  *FfsFileEntry
+  )
+{
+  if (FfsFileEntry->StreamHandle == 0) {
+    return;
+  }
+
+  CloseSectionStream (FfsFileEntry->StreamHandle, FALSE);
+  FfsFileEntry->StreamHandle = 0;
+
+  RemoveEntryList (&FfsFileEntry->CacheLink);
+  mFvSectionCacheSize    -= FfsFileEntry->CacheSize;
+  FfsFileEntry->CacheSize = 0;
+}
+
+/**
+  Mark the section stream of a file as most recently read, and release the
+  section streams of the least recently read files if the size of the sections
+  extracted from all files exceeds PcdFwVolDxeSectionCacheSize.
+
+  @param  FfsFileEntry   The file that has just been read.
+
+**/
+VOID
+FvUpdateSectionCache (
+  IN FFS_FILE_LIST_ENTRY  *FfsFileEntry
+  )
+{
+  FFS_FILE_LIST_ENTRY  *OldestEntry;
+  UINTN                MaxSize;
+
+  RemoveEntryList (&FfsFileEntry->CacheLink);
+  InsertTailList (&mFvSectionCacheList, &FfsFileEntry->CacheLink);
+
+  mFvSectionCacheSize    -= FfsFileEntry->CacheSize;
+  FfsFileEntry->CacheSize = GetEncapsulatedStreamSize (FfsFileEntry->StreamHandle);
+  mFvSectionCacheSize    += FfsFileEntry->CacheSize;
+
+  MaxSize = PcdGet32 (PcdFwVolDxeSectionCacheSize);
+  if (MaxSize == 0) {
+    return;
+  }
+
+  //
+  // The file that has just been read is kept, even if it is larger than the cache.
+  //
+  while (mFvSectionCacheSize > MaxSize) {
+    OldestEntry = BASE_CR (GetFirstNode (&mFvSectionCacheList), FFS_FILE_LIST_ENTRY, CacheLink);
+    if (OldestEntry == FfsFileEntry) {
+      break;
+    }
+
+    FvReleaseSectionStream (OldestEntry);
+  }
+}
+
+/**
+  Release the sections extracted from all files at EndOfDxe, when the drivers
+  in the firmware volumes have been dispatched.
+
+  @param  Event         The EndOfDxe event.
+  @param  Context       Not used.
+
+**/
+VOID
+EFIAPI
+FvReleaseSectionCacheAtEndOfDxe (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  DEBUG ((
+    DEBUG_INFO,
+    "FwVol: Section cache %ld hits, %ld misses, release 0x%lx bytes\n",
+    (UINT64)mFvSectionCacheHitCount,
+    (UINT64)mFvSectionCacheMissCount,
+    (UINT64)mFvSectionCacheSize
+    ));
+
+  while (!IsListEmpty (&mFvSectionCacheList)) {
+    FvReleaseSectionStream (BASE_CR (GetFirstNode (&mFvSectionCacheList), FFS_FILE_LIST_ENTRY, CacheLink));
+  }
+
+  CoreCloseEvent (Event);
+}
+
 /**
   Free FvDevice resource when error happens
 
@@ -266,7 +368,7 @@ FreeFvDeviceResource (
       //
       // Close stream and free resources from SEP
       //
-      CloseSectionStream (FfsFileEntry->StreamHandle, FALSE);
+      FvReleaseSectionStream (FfsFileEntry);
     }
 
     if (FfsFileEntry->FileCached) {
@@ -714,6 +816,9 @@ FwVolDriverInit (
   IN EFI_SYSTEM_TABLE  *SystemTable
   )
 {
+  EFI_STATUS  Status;
+  EFI_EVENT   EndOfDxeEvent;
+
   gEfiFwVolBlockEvent = EfiCreateProtocolNotifyEvent (
                           &gEfiFirmwareVolumeBlockProtocolGuid,
                           TPL_CALLBACK,
@@ -721,5 +826,16 @@ FwVolDriverInit (
                           NULL,
                           &gEfiFwVolBlockNotifyReg
                           );
+
+  Status = CoreCreateEventEx (
+             EVT_NOTIFY_SIGNAL,
+             TPL_CALLBACK,
+             FvReleaseSectionCacheAtEndOfDxe,
+             NULL,
+             &gEfiEndOfDxeEventGroupGuid,
+             &EndOfDxeEvent
+             );
+  ASSERT_EFI_ERROR (Status);
+
   return EFI_SUCCESS;
 }
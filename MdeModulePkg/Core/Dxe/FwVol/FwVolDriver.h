@@ -20,6 +20,12 @@ typedef struct {
   EFI_FFS_FILE_HEADER    *FfsHeader;
   UINTN                  StreamHandle;
   BOOLEAN                FileCached;
+  //
+  // Links the files that have a section stream, least recently read first,
+  // and the size of the sections extracted in the stream.
+  //
+  LIST_ENTRY             CacheLink;
+  UINTN                  CacheSize;
 } FFS_FILE_LIST_ENTRY;
 
 typedef struct {
@@ -44,6 +50,10 @@ typedef struct {
 
 #define FV_DEVICE_FROM_THIS(a)  CR(a, FV_DEVICE, Fv, FV2_DEVICE_SIGNATURE)
 
+extern LIST_ENTRY  mFvSectionCacheList;
+extern UINTN       mFvSectionCacheHitCount;
+extern UINTN       mFvSectionCacheMissCount;
+
 /**
   Retrieves attributes, insures positive polarity of attribute bits, returns
   resulting attributes in output parameter.
@@ -384,4 +394,28 @@ IsValidFfsFile (
   IN EFI_FFS_FILE_HEADER  *FfsHeader
   );
 
+/**
+  Close the section stream of a file, which frees the sections extracted from it.
+
+  @param  FfsFileEntry   The file.
+
+**/
+VOID
+FvReleaseSectionStream (
+  IN FFS_FILE_LIST_ENTRY  *FfsFileEntry
+  );
+
+/**
+  Mark the section stream of a file as most recently read, and release the
+  section streams of the least recently read files if the size of the sections
+  extracted from all files exceeds PcdFwVolDxeSectionCacheSize.
+
+  @param  FfsFileEntry   The file that has just been read.
+
+**/
+VOID
+FvUpdateSectionCache (
+  IN FFS_FILE_LIST_ENTRY  *FfsFileEntry
+  );
+
 #endif
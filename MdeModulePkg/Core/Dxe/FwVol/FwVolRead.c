@@ -500,6 +500,11 @@ FvReadFileSection (
     if (EFI_ERROR (Status)) {
       goto Done;
     }
+
+    InsertTailList (&mFvSectionCacheList, &FfsEntry->CacheLink);
+    mFvSectionCacheMissCount++;
+  } else {
+    mFvSectionCacheHitCount++;
   }
 
   //
@@ -524,8 +529,10 @@ FvReadFileSection (
   }
 
   //
-  // Close of stream defered to close of FfsHeader list to allow SEP to cache data
+  // Close of stream defered to close of FfsHeader list to allow SEP to cache data,
+  // or until the stream is the least recently read one when the cache is full.
   //
+  FvUpdateSectionCache (FfsEntry);
 
 Done:
   return Status;
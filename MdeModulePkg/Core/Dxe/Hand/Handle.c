@@ -187,6 +187,7 @@ CoreFindProtocolEntry (
       CopyGuid ((VOID *)&ProtEntry->ProtocolID, Protocol);
       InitializeListHead (&ProtEntry->Protocols);
       InitializeListHead (&ProtEntry->Notify);
+      InitializeListHead (&ProtEntry->DepexDrivers);
 
       //
       // Add it to protocol database
@@ -198,6 +199,93 @@ CoreFindProtocolEntry (
   return ProtEntry;
 }
 
+/**
+  Add a driver to the drivers whose dependency expression pushes a protocol, so
+  that the installation of the protocol marks the dependency expression for
+  evaluation.
+
+  @param  Protocol               The ID of the protocol.
+  @param  DriverEntry            The driver.
+
+  @retval EFI_SUCCESS            The driver is added, or was already the last
+                                 driver added for the protocol.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory to add the driver.
+
+**/
+EFI_STATUS
+CoreAddDepexProtocolDriver (
+  IN EFI_GUID               *Protocol,
+  IN EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  EFI_STATUS         Status;
+  PROTOCOL_ENTRY     *ProtEntry;
+  DEPEX_DRIVER_LINK  *DriverLink;
+
+  CoreAcquireProtocolLock ();
+
+  Status    = EFI_OUT_OF_RESOURCES;
+  ProtEntry = CoreFindProtocolEntry (Protocol, TRUE);
+  if (ProtEntry == NULL) {
+    goto Done;
+  }
+
+  //
+  // The same protocol may be pushed more than once by one expression.
+  //
+  if (!IsListEmpty (&ProtEntry->DepexDrivers)) {
+    DriverLink = CR (ProtEntry->DepexDrivers.BackLink, DEPEX_DRIVER_LINK, Link, DEPEX_DRIVER_LINK_SIGNATURE);
+    if (DriverLink->DriverEntry == DriverEntry) {
+      Status = EFI_SUCCESS;
+      goto Done;
+    }
+  }
+
+  DriverLink = AllocatePool (sizeof (DEPEX_DRIVER_LINK));
+  if (DriverLink == NULL) {
+    goto Done;
+  }
+
+  DriverLink->Signature   = DEPEX_DRIVER_LINK_SIGNATURE;
+  DriverLink->DriverEntry = DriverEntry;
+  InsertTailList (&ProtEntry->DepexDrivers, &DriverLink->Link);
+  InsertTailList (&DriverEntry->DepexLinks, &DriverLink->DriverLink);
+  Status = EFI_SUCCESS;
+
+Done:
+  CoreReleaseProtocolLock ();
+  return Status;
+}
+
+/**
+  Remove a driver from the drivers whose dependency expression pushes a protocol,
+  for all the protocols it was added for, and free its links. This is done once the
+  driver is scheduled, since its dependency expression is not evaluated anymore.
+
+  @param  DriverEntry            The driver.
+
+**/
+VOID
+CoreRemoveDepexProtocolDriver (
+  IN EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  DEPEX_DRIVER_LINK  *DriverLink;
+
+  CoreAcquireProtocolLock ();
+
+  while (!IsListEmpty (&DriverEntry->DepexLinks)) {
+    DriverLink = CR (DriverEntry->DepexLinks.ForwardLink, DEPEX_DRIVER_LINK, DriverLink, DEPEX_DRIVER_LINK_SIGNATURE);
+    RemoveEntryList (&DriverLink->Link);
+    RemoveEntryList (&DriverLink->DriverLink);
+    FreePool (DriverLink);
+  }
+
+  DriverEntry->DepexIndexed = FALSE;
+
+  CoreReleaseProtocolLock ();
+}
+
 /**
   Finds the protocol instance for the requested handle and protocol.
   Note: This function doesn't do parameters checking, it's caller's responsibility
@@ -442,6 +530,8 @@ CoreInstallProtocolInterfaceNotify (
   IHANDLE             *Handle;
   EFI_STATUS          Status;
   VOID                *ExistingInterface;
+  LIST_ENTRY          *Link;
+  DEPEX_DRIVER_LINK   *DriverLink;
 
   //
   // returns EFI_INVALID_PARAMETER if InterfaceType is invalid.
@@ -570,6 +660,14 @@ CoreInstallProtocolInterfaceNotify (
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
 
+  //
+  // Let the dispatcher evaluate again the DEPEX that push this protocol
+  //
+  for (Link = ProtEntry->DepexDrivers.ForwardLink; Link != &ProtEntry->DepexDrivers; Link = Link->ForwardLink) {
+    DriverLink                               = CR (Link, DEPEX_DRIVER_LINK, Link, DEPEX_DRIVER_LINK_SIGNATURE);
+    DriverLink->DriverEntry->DepexReevaluate = TRUE;
+  }
+
   //
   // Notify the notification list for this protocol
   //
@@ -44,6 +44,8 @@ typedef struct {
   LIST_ENTRY    Protocols;
   /// Registerd notification handlers
   LIST_ENTRY    Notify;
+  /// Drivers whose DEPEX pushes this protocol, list of DEPEX_DRIVER_LINK
+  LIST_ENTRY    DepexDrivers;
 } PROTOCOL_ENTRY;
 
 #define PROTOCOL_INTERFACE_SIGNATURE  SIGNATURE_32('p','i','f','c')
@@ -550,6 +550,136 @@ CoreIsImageTypeSupported (
          EFI_IMAGE_MACHINE_CROSS_TYPE_SUPPORTED (Image->ImageContext.Machine);
 }
 
+/**
+  Read the PE32 section of an image in a firmware volume into pages of
+  EfiBootServicesCode memory, so that a boot service driver can be loaded in
+  the same pages.
+
+  @param  DeviceHandle          The handle of the firmware volume.
+  @param  FilePath              The firmware volume file device path node of the image.
+  @param  SourceSize            Return the size of the PE32 section.
+  @param  SourcePages           Return the number of pages allocated.
+  @param  AuthenticationStatus  Return the authentication status of the PE32 section.
+
+  @return The buffer of the PE32 section, or NULL if it cannot be read.
+
+**/
+VOID *
+CoreReadImageFromFv (
+  IN  EFI_HANDLE                DeviceHandle,
+  IN  EFI_DEVICE_PATH_PROTOCOL  *FilePath,
+  OUT UINTN                     *SourceSize,
+  OUT UINTN                     *SourcePages,
+  OUT UINT32                    *AuthenticationStatus
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_FIRMWARE_VOLUME2_PROTOCOL  *Fv;
+  EFI_GUID                       *NameGuid;
+  EFI_PHYSICAL_ADDRESS           Buffer;
+  VOID                           *SectionBuffer;
+  UINT8                          Probe;
+  UINTN                          Size;
+  UINTN                          Pages;
+
+  NameGuid = EfiGetNameGuidFromFwVolDevicePathNode ((CONST MEDIA_FW_VOL_FILEPATH_DEVICE_PATH *)FilePath);
+  if (NameGuid == NULL) {
+    return NULL;
+  }
+
+  Status = CoreHandleProtocol (DeviceHandle, &gEfiFirmwareVolume2ProtocolGuid, (VOID **)&Fv);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  //
+  // Get the size of the PE32 section with an empty caller allocated buffer.
+  //
+  SectionBuffer = &Probe;
+  Size          = 0;
+  Status        = Fv->ReadSection (Fv, NameGuid, EFI_SECTION_PE32, 0, &SectionBuffer, &Size, AuthenticationStatus);
+  if (Status != EFI_WARN_BUFFER_TOO_SMALL) {
+    return NULL;
+  }
+
+  Pages  = EFI_SIZE_TO_PAGES (Size);
+  Status = CoreAllocatePages (AllocateAnyPages, EfiBootServicesCode, Pages, &Buffer);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  SectionBuffer = (VOID *)(UINTN)Buffer;
+  Status        = Fv->ReadSection (Fv, NameGuid, EFI_SECTION_PE32, 0, &SectionBuffer, &Size, AuthenticationStatus);
+  if (Status != EFI_SUCCESS) {
+    CoreFreePages (Buffer, Pages);
+    return NULL;
+  }
+
+  *SourceSize  = Size;
+  *SourcePages = Pages;
+  return SectionBuffer;
+}
+
+/**
+  Check whether an image can be loaded in the pages it has been read into.
+
+  The image must be a relocatable boot service driver, read by CoreReadImageFromFv(),
+  and the sections must have the same offsets in the file as in memory.
+
+  @param  FHand                   The image file handle.
+  @param  Image                   The image, whose ImageContext is filled by
+                                  PeCoffLoaderGetImageInfo().
+
+  @retval TRUE                    The image can be loaded in place.
+  @retval FALSE                   The image must be copied to new pages.
+
+**/
+BOOLEAN
+CoreIsImageLoadableInPlace (
+  IN IMAGE_FILE_HANDLE          *FHand,
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image
+  )
+{
+  EFI_IMAGE_OPTIONAL_HEADER_PTR_UNION  Hdr;
+  EFI_IMAGE_SECTION_HEADER             *Section;
+  UINTN                                SectionTableOffset;
+  UINTN                                NumberOfSections;
+  UINTN                                Index;
+
+  if ((FHand->SourcePages == 0) ||
+      (Image->ImageContext.ImageType != EFI_IMAGE_SUBSYSTEM_EFI_BOOT_SERVICE_DRIVER) ||
+      Image->ImageContext.IsTeImage ||
+      Image->ImageContext.RelocationsStripped ||
+      (PcdGet64 (PcdLoadModuleAtFixAddressEnable) != 0))
+  {
+    return FALSE;
+  }
+
+  if ((Image->ImageContext.SectionAlignment == 0) ||
+      (((UINTN)FHand->Source & (Image->ImageContext.SectionAlignment - 1)) != 0) ||
+      (Image->ImageContext.ImageSize > EFI_PAGES_TO_SIZE (FHand->SourcePages)))
+  {
+    return FALSE;
+  }
+
+  Hdr.Union          = (EFI_IMAGE_OPTIONAL_HEADER_UNION *)((UINT8 *)FHand->Source + Image->ImageContext.PeCoffHeaderOffset);
+  SectionTableOffset = Image->ImageContext.PeCoffHeaderOffset + sizeof (UINT32) + sizeof (EFI_IMAGE_FILE_HEADER) +
+                       Hdr.Pe32->FileHeader.SizeOfOptionalHeader;
+  NumberOfSections = Hdr.Pe32->FileHeader.NumberOfSections;
+  if (SectionTableOffset + NumberOfSections * sizeof (EFI_IMAGE_SECTION_HEADER) > FHand->SourceSize) {
+    return FALSE;
+  }
+
+  Section = (EFI_IMAGE_SECTION_HEADER *)((UINT8 *)FHand->Source + SectionTableOffset);
+  for (Index = 0; Index < NumberOfSections; Index++) {
+    if ((Section[Index].SizeOfRawData != 0) && (Section[Index].PointerToRawData != Section[Index].VirtualAddress)) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
 /**
   Loads, relocates, and invokes a PE/COFF image
 
@@ -581,9 +711,10 @@ CoreLoadPeImage (
   IN  UINT32                    Attribute
   )
 {
-  EFI_STATUS  Status;
-  BOOLEAN     DstBufAlocated;
-  UINTN       Size;
+  EFI_STATUS         Status;
+  BOOLEAN            DstBufAlocated;
+  UINTN              Size;
+  IMAGE_FILE_HANDLE  *FHand;
 
   ZeroMem (&Image->ImageContext, sizeof (Image->ImageContext));
 
@@ -638,7 +769,18 @@ CoreLoadPeImage (
   // Allocate memory of the correct memory type aligned on the required image boundary
   //
   DstBufAlocated = FALSE;
-  if (DstBuffer == 0) {
+  FHand          = (IMAGE_FILE_HANDLE *)Pe32Handle;
+  if ((DstBuffer == 0) && FeaturePcdGet (PcdImageLoadInPlace) && CoreIsImageLoadableInPlace (FHand, Image)) {
+    //
+    // Take over the pages the image has been read into, so that loading the
+    // sections does not copy them.
+    //
+    Image->ImageContext.ImageAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)FHand->Source;
+    Image->NumberOfPages             = FHand->SourcePages;
+    FHand->SourcePages               = 0;
+
+    DstBufAlocated = TRUE;
+  } else if (DstBuffer == 0) {
     //
     // Allocate Destination Buffer as caller did not pass it in
     //
@@ -1243,24 +1385,36 @@ CoreLoadImageCommon (
     }
 
     //
-    // Get the source file buffer by its device path.
+    // Get the source file buffer by its device path, in pages the image may
+    // be loaded in if it is in a firmware volume.
     //
-    FHand.Source = GetFileBufferByFilePath (
-                     BootPolicy,
-                     FilePath,
-                     &FHand.SourceSize,
-                     &AuthenticationStatus
-                     );
+    if (ImageIsFromFv && FeaturePcdGet (PcdImageLoadInPlace)) {
+      FHand.Source = CoreReadImageFromFv (
+                       DeviceHandle,
+                       HandleFilePath,
+                       &FHand.SourceSize,
+                       &FHand.SourcePages,
+                       &AuthenticationStatus
+                       );
+    }
+
+    if (FHand.Source == NULL) {
+      FHand.Source = GetFileBufferByFilePath (
+                       BootPolicy,
+                       FilePath,
+                       &FHand.SourceSize,
+                       &AuthenticationStatus
+                       );
+      FHand.FreeBuffer = (BOOLEAN)(FHand.Source != NULL);
+    }
+
     if (FHand.Source == NULL) {
       Status = EFI_NOT_FOUND;
-    } else {
-      FHand.FreeBuffer = TRUE;
-      if (ImageIsFromLoadFile) {
-        //
-        // LoadFile () may cause the device path of the Handle be updated.
-        //
-        OriginalFilePath = AppendDevicePath (DevicePathFromHandle (DeviceHandle), Node);
-      }
+    } else if (ImageIsFromLoadFile) {
+      //
+      // LoadFile () may cause the device path of the Handle be updated.
+      //
+      OriginalFilePath = AppendDevicePath (DevicePathFromHandle (DeviceHandle), Node);
     }
   }
 
@@ -1474,6 +1628,8 @@ Done:
   //
   if (FHand.FreeBuffer) {
     CoreFreePool (FHand.Source);
+  } else if (FHand.SourcePages != 0) {
+    CoreFreePages ((EFI_PHYSICAL_ADDRESS)(UINTN)FHand.Source, FHand.SourcePages);
   }
 
   if (OriginalFilePath != InputFilePath) {
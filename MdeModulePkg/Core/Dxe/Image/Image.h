@@ -18,6 +18,11 @@ typedef struct {
   BOOLEAN    FreeBuffer;
   VOID       *Source;
   UINTN      SourceSize;
+  //
+  // Not 0 if Source is allocated in pages of EfiBootServicesCode memory, until
+  // the image is loaded in place in these pages.
+  //
+  UINTN      SourcePages;
 } IMAGE_FILE_HANDLE;
 
 #endif
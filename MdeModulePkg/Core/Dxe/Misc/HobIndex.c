@@ -0,0 +1,104 @@
+/** @file
+  Index of the GUID HOBs in the HOB list, installed in the EFI System Table
+  so that the HOB library of the DXE drivers does not walk the whole HOB list
+  to find a GUID HOB.
+
+Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+
+/**
+  Compare two entries of the GUID HOB index.
+
+  @param  Buffer1        The first EDKII_HOB_INDEX_ENTRY.
+  @param  Buffer2        The second EDKII_HOB_INDEX_ENTRY.
+
+  @retval 0              Buffer1 is equal to Buffer2.
+  @retval <0             Buffer1 is less than Buffer2.
+  @retval >0             Buffer1 is greater than Buffer2.
+
+**/
+STATIC
+INTN
+EFIAPI
+CompareHobIndexEntry (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST EDKII_HOB_INDEX_ENTRY  *Entry1;
+  CONST EDKII_HOB_INDEX_ENTRY  *Entry2;
+  INTN                         Result;
+
+  Entry1 = (CONST EDKII_HOB_INDEX_ENTRY *)Buffer1;
+  Entry2 = (CONST EDKII_HOB_INDEX_ENTRY *)Buffer2;
+
+  Result = CompareMem (&Entry1->Name, &Entry2->Name, sizeof (EFI_GUID));
+  if (Result != 0) {
+    return Result;
+  }
+
+  if (Entry1->Hob == Entry2->Hob) {
+    return 0;
+  }
+
+  return (Entry1->Hob < Entry2->Hob) ? -1 : 1;
+}
+
+/**
+  Build the index of the GUID HOBs in the HOB list and install it into the
+  EFI System Configuration Table.
+
+  The HOB list is read-only in DXE, so the index covers the whole list.
+
+  @param  HobStart       Pointer to the HOB list.
+
+**/
+VOID
+CoreInstallHobIndex (
+  IN VOID  *HobStart
+  )
+{
+  EFI_STATUS             Status;
+  EFI_PEI_HOB_POINTERS   Hob;
+  EDKII_HOB_INDEX        *HobIndex;
+  EDKII_HOB_INDEX_ENTRY  *Entry;
+  EDKII_HOB_INDEX_ENTRY  Buffer;
+  UINTN                  Count;
+
+  Count = 0;
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (Hob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) {
+      Count++;
+    }
+  }
+
+  HobIndex = AllocatePool (sizeof (EDKII_HOB_INDEX) + Count * sizeof (EDKII_HOB_INDEX_ENTRY));
+  if (HobIndex == NULL) {
+    return;
+  }
+
+  Entry                = (EDKII_HOB_INDEX_ENTRY *)(HobIndex + 1);
+  HobIndex->EntryCount = Count;
+  Count                = 0;
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (Hob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) {
+      CopyGuid (&Entry[Count].Name, &Hob.Guid->Name);
+      Entry[Count].Hob = (EFI_PHYSICAL_ADDRESS)(UINTN)Hob.Raw;
+      Count++;
+    }
+  }
+
+  HobIndex->HobList    = (EFI_PHYSICAL_ADDRESS)(UINTN)HobStart;
+  HobIndex->IndexedEnd = (EFI_PHYSICAL_ADDRESS)(UINTN)Hob.Raw;
+  QuickSort (Entry, Count, sizeof (*Entry), CompareHobIndexEntry, &Buffer);
+
+  Status = CoreInstallConfigurationTable (&gEdkiiHobIndexGuid, HobIndex);
+  ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    FreePool (HobIndex);
+  }
+}
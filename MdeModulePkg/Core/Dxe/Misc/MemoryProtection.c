@@ -38,6 +38,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/MemoryAttributesTable.h>
 
 #include <Protocol/FirmwareVolume2.h>
+#include <Protocol/MemoryAttributeBatch.h>
 #include <Protocol/SimpleFileSystem.h>
 
 #include "DxeMain.h"
@@ -775,19 +776,32 @@ MemoryProtectionCpuArchProtocolNotify (
   IN VOID       *Context
   )
 {
-  EFI_STATUS                 Status;
-  EFI_LOADED_IMAGE_PROTOCOL  *LoadedImage;
-  EFI_DEVICE_PATH_PROTOCOL   *LoadedImageDevicePath;
-  UINTN                      NoHandles;
-  EFI_HANDLE                 *HandleBuffer;
-  UINTN                      Index;
+  EFI_STATUS                             Status;
+  EFI_LOADED_IMAGE_PROTOCOL              *LoadedImage;
+  EFI_DEVICE_PATH_PROTOCOL               *LoadedImageDevicePath;
+  UINTN                                  NoHandles;
+  EFI_HANDLE                             *HandleBuffer;
+  UINTN                                  Index;
+  EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL  *MemoryAttributeBatch;
 
   DEBUG ((DEBUG_INFO, "MemoryProtectionCpuArchProtocolNotify:\n"));
-  Status = CoreLocateProtocol (&gEfiCpuArchProtocolGuid, NULL, (VOID **)&gCpu);
+  MemoryAttributeBatch = NULL;
+  Status               = CoreLocateProtocol (&gEfiCpuArchProtocolGuid, NULL, (VOID **)&gCpu);
   if (EFI_ERROR (Status)) {
     goto Done;
   }
 
+  //
+  // The updates below only take access rights away from memory that is not in
+  // use yet, so let the CPU driver flush the TLB once for all of them.
+  //
+  Status = CoreLocateProtocol (&gEdkiiMemoryAttributeBatchProtocolGuid, NULL, (VOID **)&MemoryAttributeBatch);
+  if (EFI_ERROR (Status)) {
+    MemoryAttributeBatch = NULL;
+  } else {
+    MemoryAttributeBatch->Begin (MemoryAttributeBatch);
+  }
+
   //
   // Apply the memory protection policy on non-BScode/RTcode regions.
   //
@@ -840,6 +854,10 @@ MemoryProtectionCpuArchProtocolNotify (
   FreePool (HandleBuffer);
 
 Done:
+  if (MemoryAttributeBatch != NULL) {
+    MemoryAttributeBatch->Commit (MemoryAttributeBatch);
+  }
+
   CoreCloseEvent (Event);
 }
 
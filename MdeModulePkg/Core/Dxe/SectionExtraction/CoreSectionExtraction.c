@@ -1456,6 +1456,48 @@ CloseSectionStream (
   return Status;
 }
 
+/**
+  SEP member function.  Returns the size of the buffers of all section streams
+  encapsulated in a section stream, which are freed when it is closed.
+
+  @param  SectionStreamHandle    Indicates the section stream
+
+  @return The size in bytes of the encapsulated section streams.
+
+**/
+UINTN
+GetEncapsulatedStreamSize (
+  IN  UINTN  SectionStreamHandle
+  )
+{
+  CORE_SECTION_STREAM_NODE  *StreamNode;
+  CORE_SECTION_STREAM_NODE  *ChildStreamNode;
+  CORE_SECTION_CHILD_NODE   *ChildNode;
+  LIST_ENTRY                *Link;
+  EFI_TPL                   OldTpl;
+  UINTN                     Size;
+
+  Size   = 0;
+  OldTpl = CoreRaiseTpl (TPL_NOTIFY);
+
+  if (!EFI_ERROR (FindStreamNode (SectionStreamHandle, &StreamNode))) {
+    for (Link = GetFirstNode (&StreamNode->Children);
+         !IsNull (&StreamNode->Children, Link);
+         Link = GetNextNode (&StreamNode->Children, Link))
+    {
+      ChildNode = CHILD_SECTION_NODE_FROM_LINK (Link);
+      if ((ChildNode->EncapsulatedStreamHandle != NULL_STREAM_HANDLE) &&
+          !EFI_ERROR (FindStreamNode (ChildNode->EncapsulatedStreamHandle, &ChildStreamNode)))
+      {
+        Size += ChildStreamNode->StreamLength + GetEncapsulatedStreamSize (ChildNode->EncapsulatedStreamHandle);
+      }
+    }
+  }
+
+  CoreRestoreTpl (OldTpl);
+  return Size;
+}
+
 /**
   The ExtractSection() function processes the input section and
   allocates a buffer from the pool in which it returns the section
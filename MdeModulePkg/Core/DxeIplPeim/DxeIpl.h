@@ -23,6 +23,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Ppi/RecoveryModule.h>
 #include <Ppi/CapsuleOnDisk.h>
 #include <Ppi/VectorHandoffInfo.h>
+#include <Ppi/MpServices.h>
 
 #include <Guid/MemoryTypeInformation.h>
 #include <Guid/MemoryAllocationHob.h>
@@ -42,10 +43,26 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DebugAgentLib.h>
 #include <Library/PeiServicesTablePointerLib.h>
 #include <Library/PerformanceLib.h>
+#include <Library/SynchronizationLib.h>
 
 #define STACK_SIZE      0x20000
 #define BSP_STORE_SIZE  0x4000
 
+//
+// A GUIDed section of a firmware volume image file decoded in parallel
+//
+typedef struct {
+  CONST VOID                                 *InputSection;
+  EXTRACT_GUIDED_SECTION_GET_INFO_HANDLER    GetInfo;
+  EXTRACT_GUIDED_SECTION_DECODE_HANDLER      Decode;
+  VOID                                       *OutputBuffer;
+  UINT32                                     OutputBufferSize;
+  UINT32                                     AuthenticationStatus;
+  VOID                                       *ScratchBuffer;
+  UINTN                                      ScratchBufferPages;
+  RETURN_STATUS                              Status;
+} DXE_IPL_EXTRACT_JOB;
+
 //
 // This PPI is installed to indicate the end of the PEI usage of memory
 //
@@ -70,6 +87,49 @@ InstallIplPermanentMemoryPpis (
   IN VOID                       *Ppi
   );
 
+/**
+  Decode the GUIDed sections of the firmware volume image files that have not
+  been processed yet on the APs.
+
+  This is done once, after the PEI MP Services PPI is installed, on the normal
+  boot paths of a system with more than one enabled processor.
+
+**/
+VOID
+DxeIplExtractInParallel (
+  VOID
+  );
+
+/**
+  Return the result of a GUIDed section decoded by DxeIplExtractInParallel().
+
+  @param  InputSection          The GUIDed section.
+  @param  OutputBuffer          Return the section stream in the GUIDed section.
+  @param  OutputSize            Return the size of the section stream.
+  @param  AuthenticationStatus  Return the authentication status of the section stream.
+
+  @retval TRUE                  The GUIDed section has been decoded successfully.
+  @retval FALSE                 The GUIDed section must be extracted by the caller.
+
+**/
+BOOLEAN
+DxeIplGetExtractedSection (
+  IN  CONST VOID  *InputSection,
+  OUT VOID        **OutputBuffer,
+  OUT UINTN       *OutputSize,
+  OUT UINT32      *AuthenticationStatus
+  );
+
+/**
+  Free the GUIDed sections decoded by DxeIplExtractInParallel() that PEI Core
+  has not extracted.
+
+**/
+VOID
+DxeIplFreeExtractedSections (
+  VOID
+  );
+
 /**
    Searches DxeCore in all firmware Volumes and loads the first
    instance that contains DxeCore.
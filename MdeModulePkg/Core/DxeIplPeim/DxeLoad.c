@@ -399,6 +399,13 @@ DxeLoadCore (
   //
   FileHandle = DxeIplFindDxeCore ();
 
+  //
+  // Free the sections decoded in parallel that PEI Core has not used.
+  //
+  if (FeaturePcdGet (PcdDxeIplParallelExtraction)) {
+    DxeIplFreeExtractedSections ();
+  }
+
   //
   // Load the DXE Core from a Firmware Volume.
   //
@@ -593,6 +600,17 @@ CustomGuidedSectionExtract (
   //
   ScratchBuffer = NULL;
 
+  //
+  // Return the section if it has been decoded with the sections of the other
+  // firmware volume image files.
+  //
+  if (FeaturePcdGet (PcdDxeIplParallelExtraction)) {
+    DxeIplExtractInParallel ();
+    if (DxeIplGetExtractedSection (InputSection, OutputBuffer, OutputSize, AuthenticationStatus)) {
+      return EFI_SUCCESS;
+    }
+  }
+
   //
   // Call GetInfo to get the size and attribute of input guided section data.
   //
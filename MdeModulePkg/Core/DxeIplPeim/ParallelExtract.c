@@ -0,0 +1,362 @@
+/** @file
+  Extract the GUIDed sections of the firmware volume image files in parallel.
+
+  When the first GUIDed section is extracted, the GUIDed sections of the firmware
+  volume image files that PEI Core will process unconditionally are decoded on
+  the APs, and the results are returned when PEI Core extracts these sections
+  later. The results that PEI Core has not used are freed before DXE Core is
+  loaded.
+
+Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeIpl.h"
+
+DXE_IPL_EXTRACT_JOB  *mExtractJobs      = NULL;
+UINTN                mExtractJobCount   = 0;
+volatile UINT32      mExtractJobNext    = 0;
+BOOLEAN              mExtractJobStarted = FALSE;
+
+/**
+  Check whether a firmware volume image file has been processed by PEI Core.
+
+  @param  FileName  The name of the firmware volume image file.
+
+  @retval TRUE      A FV2 HOB of the file exists.
+  @retval FALSE     The file has not been processed.
+
+**/
+BOOLEAN
+IsFvFileProcessed (
+  IN CONST EFI_GUID  *FileName
+  )
+{
+  EFI_PEI_HOB_POINTERS  Hob;
+
+  Hob.Raw = GetHobList ();
+  while ((Hob.Raw = GetNextHob (EFI_HOB_TYPE_FV2, Hob.Raw)) != NULL) {
+    if (CompareGuid (FileName, &Hob.FirmwareVolume2->FileName)) {
+      return TRUE;
+    }
+
+    Hob.Raw = GET_NEXT_HOB (Hob);
+  }
+
+  return FALSE;
+}
+
+/**
+  Find the GUIDed sections that require processing in the firmware volume image
+  files that have not been processed yet.
+
+  A file with a PEI DEPEX section is only processed by PEI Core once its DEPEX
+  is satisfied, which cannot be told here, so it is left to be extracted when
+  PEI Core processes it.
+
+  @param  Jobs      The jobs to fill in for the GUIDed sections, or NULL to count them.
+
+  @return The number of GUIDed sections found.
+
+**/
+UINTN
+CollectExtractJobs (
+  OUT DXE_IPL_EXTRACT_JOB  *Jobs OPTIONAL
+  )
+{
+  EFI_STATUS                               Status;
+  UINTN                                    Instance;
+  UINTN                                    Count;
+  EFI_PEI_FV_HANDLE                        VolumeHandle;
+  EFI_PEI_FILE_HANDLE                      FileHandle;
+  EFI_FV_FILE_INFO                         FileInfo;
+  UINT8                                    *Section;
+  UINT8                                    *SectionEnd;
+  UINT32                                   SectionLength;
+  EFI_GUID                                 *SectionGuid;
+  UINT16                                   Attributes;
+  EXTRACT_GUIDED_SECTION_GET_INFO_HANDLER  GetInfo;
+  EXTRACT_GUIDED_SECTION_DECODE_HANDLER    Decode;
+  VOID                                     *Depex;
+
+  Count = 0;
+  for (Instance = 0; !EFI_ERROR (PeiServicesFfsFindNextVolume (Instance, &VolumeHandle)); Instance++) {
+    FileHandle = NULL;
+    while (!EFI_ERROR (PeiServicesFfsFindNextFile (EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE, VolumeHandle, &FileHandle))) {
+      Status = PeiServicesFfsGetFileInfo (FileHandle, &FileInfo);
+      if (EFI_ERROR (Status) || IsFvFileProcessed (&FileInfo.FileName)) {
+        continue;
+      }
+
+      Status = PeiServicesFfsFindSectionData (EFI_SECTION_PEI_DEPEX, FileHandle, &Depex);
+      if (!EFI_ERROR (Status)) {
+        continue;
+      }
+
+      //
+      // Only the sections at the top level of the file are decoded in parallel.
+      //
+      Section    = FileInfo.Buffer;
+      SectionEnd = Section + FileInfo.BufferSize;
+      while (Section + sizeof (EFI_COMMON_SECTION_HEADER) <= SectionEnd) {
+        if (IS_SECTION2 (Section)) {
+          SectionLength = SECTION2_SIZE (Section);
+          SectionGuid   = &((EFI_GUID_DEFINED_SECTION2 *)Section)->SectionDefinitionGuid;
+          Attributes    = ((EFI_GUID_DEFINED_SECTION2 *)Section)->Attributes;
+        } else {
+          SectionLength = SECTION_SIZE (Section);
+          SectionGuid   = &((EFI_GUID_DEFINED_SECTION *)Section)->SectionDefinitionGuid;
+          Attributes    = ((EFI_GUID_DEFINED_SECTION *)Section)->Attributes;
+        }
+
+        if ((SectionLength < sizeof (EFI_COMMON_SECTION_HEADER)) || (SectionLength > (UINTN)(SectionEnd - Section))) {
+          break;
+        }
+
+        if ((((EFI_COMMON_SECTION_HEADER *)Section)->Type == EFI_SECTION_GUID_DEFINED) &&
+            ((Attributes & EFI_GUIDED_SECTION_PROCESSING_REQUIRED) != 0))
+        {
+          Status = ExtractGuidedSectionGetHandlers (SectionGuid, &GetInfo, &Decode);
+          if (!EFI_ERROR (Status)) {
+            if (Jobs != NULL) {
+              Jobs[Count].InputSection = Section;
+              Jobs[Count].GetInfo      = GetInfo;
+              Jobs[Count].Decode       = Decode;
+            }
+
+            Count++;
+          }
+        }
+
+        Section += ALIGN_VALUE (SectionLength, 4);
+      }
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Decode the GUIDed sections of the jobs that are not taken by other processors.
+
+  @param  Buffer    Not used.
+
+**/
+VOID
+EFIAPI
+ExtractJobProcedure (
+  IN OUT VOID  *Buffer
+  )
+{
+  DXE_IPL_EXTRACT_JOB  *Job;
+  UINTN                Index;
+
+  while (TRUE) {
+    Index = InterlockedIncrement (&mExtractJobNext) - 1;
+    if (Index >= mExtractJobCount) {
+      break;
+    }
+
+    Job = &mExtractJobs[Index];
+    if (Job->Decode != NULL) {
+      Job->Status = Job->Decode (
+                           Job->InputSection,
+                           &Job->OutputBuffer,
+                           Job->ScratchBuffer,
+                           &Job->AuthenticationStatus
+                           );
+    }
+  }
+}
+
+/**
+  Decode the GUIDed sections of the firmware volume image files that have not
+  been processed yet on the APs.
+
+  This is done once, after the PEI MP Services PPI is installed, on the normal
+  boot paths of a system with more than one enabled processor.
+
+**/
+VOID
+DxeIplExtractInParallel (
+  VOID
+  )
+{
+  EFI_STATUS               Status;
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+  DXE_IPL_EXTRACT_JOB      *Job;
+  EFI_BOOT_MODE            BootMode;
+  UINTN                    NumberOfProcessors;
+  UINTN                    NumberOfEnabledProcessors;
+  UINT32                   ScratchBufferSize;
+  UINT16                   SectionAttribute;
+  UINTN                    Index;
+
+  if (mExtractJobStarted) {
+    return;
+  }
+
+  Status = PeiServicesLocatePpi (&gEfiPeiMpServicesPpiGuid, 0, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  mExtractJobStarted = TRUE;
+
+  //
+  // The S3 resume and recovery paths do not load the firmware volumes of DXE.
+  //
+  BootMode = GetBootModeHob ();
+  if ((BootMode == BOOT_ON_S3_RESUME) || (BootMode == BOOT_IN_RECOVERY_MODE)) {
+    return;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (
+                         (CONST EFI_PEI_SERVICES **)GetPeiServicesTablePointer (),
+                         MpServices,
+                         &NumberOfProcessors,
+                         &NumberOfEnabledProcessors
+                         );
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors < 2)) {
+    return;
+  }
+
+  mExtractJobCount = CollectExtractJobs (NULL);
+  if (mExtractJobCount == 0) {
+    return;
+  }
+
+  mExtractJobs = AllocateZeroPool (mExtractJobCount * sizeof (DXE_IPL_EXTRACT_JOB));
+  if (mExtractJobs == NULL) {
+    mExtractJobCount = 0;
+    return;
+  }
+
+  mExtractJobCount = CollectExtractJobs (mExtractJobs);
+
+  //
+  // The buffers are allocated on the BSP, since the APs cannot use PEI services.
+  //
+  for (Index = 0; Index < mExtractJobCount; Index++) {
+    Job         = &mExtractJobs[Index];
+    Job->Status = EFI_NOT_STARTED;
+    Status      = Job->GetInfo (Job->InputSection, &Job->OutputBufferSize, &ScratchBufferSize, &SectionAttribute);
+    if (EFI_ERROR (Status) || ((SectionAttribute & EFI_GUIDED_SECTION_PROCESSING_REQUIRED) == 0) || (Job->OutputBufferSize == 0)) {
+      Job->Decode = NULL;
+      continue;
+    }
+
+    Job->OutputBuffer = AllocatePages (EFI_SIZE_TO_PAGES (Job->OutputBufferSize));
+    if (ScratchBufferSize != 0) {
+      Job->ScratchBufferPages = EFI_SIZE_TO_PAGES (ScratchBufferSize);
+      Job->ScratchBuffer      = AllocatePages (Job->ScratchBufferPages);
+    }
+
+    if ((Job->OutputBuffer == NULL) || ((ScratchBufferSize != 0) && (Job->ScratchBuffer == NULL))) {
+      Job->Decode = NULL;
+    }
+  }
+
+  //
+  // StartupAllAPs() of the PEI MP Services PPI returns only after all APs have
+  // finished, so the BSP cannot decode a share of the sections meanwhile. The
+  // APs take the sections until none is left. If they cannot be started, the
+  // jobs stay EFI_NOT_STARTED and the sections are extracted one by one later.
+  //
+  PERF_INMODULE_BEGIN ("DxeIplExtractInParallel");
+
+  MpServices->StartupAllAPs (
+                (CONST EFI_PEI_SERVICES **)GetPeiServicesTablePointer (),
+                MpServices,
+                ExtractJobProcedure,
+                FALSE,
+                0,
+                NULL
+                );
+
+  PERF_INMODULE_END ("DxeIplExtractInParallel");
+
+  for (Index = 0; Index < mExtractJobCount; Index++) {
+    Job = &mExtractJobs[Index];
+    if (Job->ScratchBuffer != NULL) {
+      FreePages (Job->ScratchBuffer, Job->ScratchBufferPages);
+      Job->ScratchBuffer = NULL;
+    }
+
+    if (EFI_ERROR (Job->Status)) {
+      if (Job->OutputBuffer != NULL) {
+        FreePages (Job->OutputBuffer, EFI_SIZE_TO_PAGES (Job->OutputBufferSize));
+        Job->OutputBuffer = NULL;
+      }
+
+      Job->InputSection = NULL;
+    }
+
+    DEBUG ((DEBUG_INFO, "DxeIpl: Extracted GUIDed section %Lu of %Lu in parallel - %r\n", (UINT64)Index, (UINT64)mExtractJobCount, Job->Status));
+  }
+}
+
+/**
+  Return the result of a GUIDed section decoded by DxeIplExtractInParallel().
+
+  @param  InputSection          The GUIDed section.
+  @param  OutputBuffer          Return the section stream in the GUIDed section.
+  @param  OutputSize            Return the size of the section stream.
+  @param  AuthenticationStatus  Return the authentication status of the section stream.
+
+  @retval TRUE                  The GUIDed section has been decoded successfully.
+  @retval FALSE                 The GUIDed section must be extracted by the caller.
+
+**/
+BOOLEAN
+DxeIplGetExtractedSection (
+  IN  CONST VOID  *InputSection,
+  OUT VOID        **OutputBuffer,
+  OUT UINTN       *OutputSize,
+  OUT UINT32      *AuthenticationStatus
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < mExtractJobCount; Index++) {
+    if (mExtractJobs[Index].InputSection == InputSection) {
+      *OutputBuffer         = mExtractJobs[Index].OutputBuffer;
+      *OutputSize           = (UINTN)mExtractJobs[Index].OutputBufferSize;
+      *AuthenticationStatus = mExtractJobs[Index].AuthenticationStatus;
+
+      //
+      // The output buffer belongs to the caller now.
+      //
+      mExtractJobs[Index].InputSection = NULL;
+      mExtractJobs[Index].OutputBuffer = NULL;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Free the GUIDed sections decoded by DxeIplExtractInParallel() that PEI Core
+  has not extracted.
+
+**/
+VOID
+DxeIplFreeExtractedSections (
+  VOID
+  )
+{
+  DXE_IPL_EXTRACT_JOB  *Job;
+  UINTN                Index;
+
+  for (Index = 0; Index < mExtractJobCount; Index++) {
+    Job = &mExtractJobs[Index];
+    if (Job->OutputBuffer != NULL) {
+      FreePages (Job->OutputBuffer, EFI_SIZE_TO_PAGES (Job->OutputBufferSize));
+      Job->OutputBuffer = NULL;
+    }
+
+    Job->InputSection = NULL;
+  }
+}
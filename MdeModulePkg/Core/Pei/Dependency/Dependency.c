@@ -250,3 +250,50 @@ PeimDispatchReadiness (
     }
   }
 }
+
+/**
+  Get the DEPEX wait buckets of all PPI GUIDs pushed by a dependency expression.
+
+  The result of the dependency expression can only change after a PPI with one
+  of these GUIDs is installed, or is replaced by a PPI with another GUID through
+  ReInstallPpi(). Both are recorded in the buckets of the GUIDs involved.
+
+  @param DependencyExpression   Pointer to a dependency expression.
+
+  @return The bit mask of the DEPEX wait buckets. MAX_UINT32 if the dependency
+          expression is not a well-formed Grammar.
+
+**/
+UINT32
+GetDepexWaitBucketMask (
+  IN VOID  *DependencyExpression
+  )
+{
+  DEPENDENCY_EXPRESSION_OPERAND  *Iterator;
+  UINT32                         BucketMask;
+
+  Iterator   = DependencyExpression;
+  BucketMask = 0;
+
+  while (TRUE) {
+    switch (*(Iterator++)) {
+      case (EFI_DEP_PUSH):
+        BucketMask |= 1U << DEPEX_WAIT_BUCKET (PeiPpiGuidHash ((EFI_GUID *)Iterator));
+        Iterator    = Iterator + sizeof (EFI_GUID);
+        break;
+
+      case (EFI_DEP_AND):
+      case (EFI_DEP_OR):
+      case (EFI_DEP_NOT):
+      case (EFI_DEP_TRUE):
+      case (EFI_DEP_FALSE):
+        break;
+
+      case (EFI_DEP_END):
+        return BucketMask;
+
+      default:
+        return MAX_UINT32;
+    }
+  }
+}
@@ -490,6 +490,10 @@ DiscoverPeimsAndOrderWithApriori (
   ASSERT (CoreFileHandle->PeimState != NULL);
   CoreFileHandle->FvFileHandles = AllocateZeroPool (sizeof (EFI_PEI_FILE_HANDLE) * PeimCount);
   ASSERT (CoreFileHandle->FvFileHandles != NULL);
+  //
+  // DepexWait is optional, every DEPEX is evaluated on every pass without it.
+  //
+  CoreFileHandle->DepexWait = AllocateZeroPool (sizeof (PEI_DEPEX_WAIT) * PeimCount);
 
   //
   // Get Apriori File handle
@@ -1898,6 +1902,8 @@ PeiDispatcher (
     if (!Private->PeimDispatcherReenter) {
       Private->PeimNeedingDispatch    = FALSE;
       Private->PeimDispatchOnThisPass = FALSE;
+      Private->DispatchPassCount++;
+      PERF_INMODULE_BEGIN ("PeiDispatchPass");
     } else {
       Private->PeimDispatcherReenter = FALSE;
     }
@@ -2100,6 +2106,7 @@ PeiDispatcher (
     // go through all the FVs.
     //
     Private->CurrentPeimFvCount = 0;
+    PERF_INMODULE_END ("PeiDispatchPass");
 
     //
     // PeimNeedingDispatch being TRUE means we found a PEIM/FV that did not get
@@ -2113,6 +2120,14 @@ PeiDispatcher (
     // dispatch registrations still running.
   } while ((Private->PeimNeedingDispatch && Private->PeimDispatchOnThisPass) ||
            (Private->DelayedDispatchTable->Count > 0));
+
+  DEBUG ((
+    DEBUG_DISPATCH,
+    "PeiDispatcher: %Lu passes, %Lu DEPEX evaluated, %Lu DEPEX skipped\n",
+    (UINT64)Private->DispatchPassCount,
+    (UINT64)Private->DepexEvaluatedCount,
+    (UINT64)Private->DepexSkippedCount
+    ));
 }
 
 /**
@@ -2149,6 +2164,8 @@ InitializeDispatcherData (
   This routine parses the Dependency Expression, if available, and
   decides if the module can be executed.
 
+  A Dependency Expression that evaluated to FALSE is not evaluated again
+  until a PPI with a GUID that it pushes may have been installed.
 
   @param Private         PeiCore's private data structure
   @param FileHandle      PEIM's file handle
@@ -2168,6 +2185,28 @@ DepexSatisfied (
   EFI_STATUS        Status;
   VOID              *DepexData;
   EFI_FV_FILE_INFO  FileInfo;
+  PEI_DEPEX_WAIT    *DepexWait;
+  UINT32            BucketMask;
+  BOOLEAN           Result;
+
+  DepexWait = NULL;
+  if (Private->Fv[Private->CurrentPeimFvCount].DepexWait != NULL) {
+    DepexWait = &Private->Fv[Private->CurrentPeimFvCount].DepexWait[PeimCount];
+    if (DepexWait->Sequence != 0) {
+      for (BucketMask = DepexWait->BucketMask; BucketMask != 0; BucketMask &= BucketMask - 1) {
+        if (Private->PpiData.PpiList.BucketSequence[LowBitSet32 (BucketMask)] >= DepexWait->Sequence) {
+          break;
+        }
+      }
+
+      if (BucketMask == 0) {
+        Private->DepexSkippedCount++;
+        return FALSE;
+      }
+    }
+  }
+
+  Private->DepexEvaluatedCount++;
 
   Status = PeiServicesFfsGetFileInfo (FileHandle, &FileInfo);
   if (EFI_ERROR (Status)) {
@@ -2204,7 +2243,20 @@ DepexSatisfied (
   //
   // Evaluate a given DEPEX
   //
-  return PeimDispatchReadiness (&Private->Ps, DepexData);
+  Result = PeimDispatchReadiness (&Private->Ps, DepexData);
+  if (DepexWait != NULL) {
+    if (Result) {
+      DepexWait->Sequence = 0;
+    } else {
+      if (DepexWait->Sequence == 0) {
+        DepexWait->BucketMask = GetDepexWaitBucketMask (DepexData);
+      }
+
+      DepexWait->Sequence = Private->PpiData.PpiList.InstallSequence + 1;
+    }
+  }
+
+  return Result;
 }
 
 /**
@@ -235,3 +235,117 @@ PeiCoreBuildHobHandoffInfoTable (
 
   return EFI_SUCCESS;
 }
+
+/**
+  Compare two entries of the GUID HOB index.
+
+  @param Buffer1         The first EDKII_HOB_INDEX_ENTRY.
+  @param Buffer2         The second EDKII_HOB_INDEX_ENTRY.
+
+  @retval 0              Buffer1 is equal to Buffer2.
+  @retval <0             Buffer1 is less than Buffer2.
+  @retval >0             Buffer1 is greater than Buffer2.
+
+**/
+STATIC
+INTN
+EFIAPI
+CompareHobIndexEntry (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST EDKII_HOB_INDEX_ENTRY  *Entry1;
+  CONST EDKII_HOB_INDEX_ENTRY  *Entry2;
+  INTN                         Result;
+
+  Entry1 = (CONST EDKII_HOB_INDEX_ENTRY *)Buffer1;
+  Entry2 = (CONST EDKII_HOB_INDEX_ENTRY *)Buffer2;
+
+  Result = CompareMem (&Entry1->Name, &Entry2->Name, sizeof (EFI_GUID));
+  if (Result != 0) {
+    return Result;
+  }
+
+  if (Entry1->Hob == Entry2->Hob) {
+    return 0;
+  }
+
+  return (Entry1->Hob < Entry2->Hob) ? -1 : 1;
+}
+
+/**
+  Build the index of the GUID HOBs in the HOB list and install it as a PPI,
+  so that the HOB libraries do not need to walk the whole HOB list.
+
+  The HOB list must already be in permanent memory, since the index holds the
+  addresses of the HOBs.
+
+  @param PrivateData     Pointer to the PEI Core data.
+
+**/
+VOID
+PeiBuildHobIndex (
+  IN PEI_CORE_INSTANCE  *PrivateData
+  )
+{
+  EFI_STATUS              Status;
+  EFI_PEI_HOB_POINTERS    Hob;
+  EFI_PHYSICAL_ADDRESS    Memory;
+  EDKII_HOB_INDEX         *HobIndex;
+  EDKII_HOB_INDEX_ENTRY   *Entry;
+  EDKII_HOB_INDEX_ENTRY   Buffer;
+  EFI_PEI_PPI_DESCRIPTOR  *PpiDescriptor;
+  UINTN                   Count;
+  UINTN                   Size;
+
+  Count = 0;
+  for (Hob.Raw = PrivateData->HobList.Raw; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (Hob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) {
+      Count++;
+    }
+  }
+
+  //
+  // The entries follow the index, and the PPI descriptor follows the entries.
+  //
+  Size   = sizeof (EDKII_HOB_INDEX) + Count * sizeof (EDKII_HOB_INDEX_ENTRY) + sizeof (EFI_PEI_PPI_DESCRIPTOR);
+  Status = PeiAllocatePages (
+             (CONST EFI_PEI_SERVICES **)&PrivateData->Ps,
+             EfiBootServicesData,
+             EFI_SIZE_TO_PAGES (Size),
+             &Memory
+             );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  HobIndex      = (EDKII_HOB_INDEX *)(UINTN)Memory;
+  Entry         = (EDKII_HOB_INDEX_ENTRY *)(HobIndex + 1);
+  PpiDescriptor = (EFI_PEI_PPI_DESCRIPTOR *)(Entry + Count);
+
+  //
+  // The allocation has added a memory allocation HOB, so IndexedEnd is only
+  // known after walking the list again.
+  //
+  HobIndex->EntryCount = 0;
+  for (Hob.Raw = PrivateData->HobList.Raw; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if ((Hob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) && (HobIndex->EntryCount < Count)) {
+      CopyGuid (&Entry[HobIndex->EntryCount].Name, &Hob.Guid->Name);
+      Entry[HobIndex->EntryCount].Hob = (EFI_PHYSICAL_ADDRESS)(UINTN)Hob.Raw;
+      HobIndex->EntryCount++;
+    }
+  }
+
+  HobIndex->HobList    = (EFI_PHYSICAL_ADDRESS)(UINTN)PrivateData->HobList.Raw;
+  HobIndex->IndexedEnd = (EFI_PHYSICAL_ADDRESS)(UINTN)Hob.Raw;
+  QuickSort (Entry, (UINTN)HobIndex->EntryCount, sizeof (*Entry), CompareHobIndexEntry, &Buffer);
+
+  PpiDescriptor->Flags = EFI_PEI_PPI_DESCRIPTOR_PPI | EFI_PEI_PPI_DESCRIPTOR_TERMINATE_LIST;
+  PpiDescriptor->Guid  = &gEdkiiHobIndexGuid;
+  PpiDescriptor->Ppi   = HobIndex;
+  Status               = PeiServicesInstallPpi (PpiDescriptor);
+  ASSERT_EFI_ERROR (Status);
+
+  DEBUG ((DEBUG_INFO, "PEI HOB index: %Lu GUID HOBs\n", (UINT64)Count));
+}
@@ -51,6 +51,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/AprioriFileName.h>
 #include <Guid/MigratedFvInfo.h>
 #include <Guid/DelayedDispatch.h>
+#include <Guid/HobIndex.h>
 
 ///
 /// It is an FFS type extension used for PeiFindFileEx. It indicates current
@@ -74,6 +75,13 @@ typedef union {
 #define CALLBACK_NOTIFY_GROWTH_STEP  32
 #define DISPATCH_NOTIFY_GROWTH_STEP  8
 
+///
+/// Number of buckets the PPI GUIDs are hashed into to track which PEIMs
+/// have to evaluate their DEPEX again after a PPI is installed.
+///
+#define DEPEX_WAIT_BUCKET_COUNT  32
+#define DEPEX_WAIT_BUCKET(Hash)  ((Hash) >> 27)
+
 typedef struct {
   UINTN                    CurrentCount;
   UINTN                    MaxCount;
@@ -82,6 +90,22 @@ typedef struct {
   /// MaxCount number of entries.
   ///
   PEI_PPI_LIST_POINTERS    *PpiPtrs;
+  ///
+  /// Open addressing hash table of the PPI GUIDs with PpiHashCount entries.
+  /// An entry is 0 if free, otherwise it is 1 + the index in PpiPtrs.
+  /// NULL if there is no memory for the table, in which case PPIs are
+  /// located by a linear search.
+  ///
+  UINT16                   *PpiHash;
+  UINTN                    PpiHashCount;
+  ///
+  /// Incremented for every PPI GUID installed or removed by InstallPpi() or ReInstallPpi().
+  ///
+  UINT32                   InstallSequence;
+  ///
+  /// The InstallSequence of the last PPI GUID installed or removed in each DEPEX wait bucket.
+  ///
+  UINT32                   BucketSequence[DEPEX_WAIT_BUCKET_COUNT];
 } PEI_PPI_LIST;
 
 typedef struct {
@@ -137,6 +161,21 @@ typedef struct {
 //
 #define FV_GROWTH_STEP  8
 
+///
+/// The PPIs a PEIM waits for after its DEPEX evaluated to FALSE.
+///
+typedef struct {
+  ///
+  /// Bit N is set if the DEPEX pushes a PPI GUID in DEPEX wait bucket N.
+  ///
+  UINT32    BucketMask;
+  ///
+  /// 1 + PpiList.InstallSequence when the DEPEX evaluated to FALSE, or 0 if
+  /// the DEPEX must be evaluated.
+  ///
+  UINT32    Sequence;
+} PEI_DEPEX_WAIT;
+
 typedef struct {
   EFI_FIRMWARE_VOLUME_HEADER     *FvHeader;
   EFI_PEI_FIRMWARE_VOLUME_PPI    *FvPpi;
@@ -150,6 +189,10 @@ typedef struct {
   // Pointer to the buffer with the PeimCount number of Entries.
   //
   EFI_PEI_FILE_HANDLE            *FvFileHandles;
+  //
+  // Pointer to the buffer with the PeimCount number of Entries.
+  //
+  PEI_DEPEX_WAIT                 *DepexWait;
   BOOLEAN                        ScanFv;
   UINT32                         AuthenticationStatus;
 } PEI_CORE_FV_HANDLE;
@@ -277,6 +320,12 @@ struct _PEI_CORE_INSTANCE {
   BOOLEAN                           PeimNeedingDispatch;
   BOOLEAN                           PeimDispatchOnThisPass;
   BOOLEAN                           PeimDispatcherReenter;
+  ///
+  /// Statistics of the dispatcher passes, reported when the dispatcher ends.
+  ///
+  UINTN                             DispatchPassCount;
+  UINTN                             DepexEvaluatedCount;
+  UINTN                             DepexSkippedCount;
   EFI_PEI_HOB_POINTERS              HobList;
   BOOLEAN                           SwitchStackSignal;
   BOOLEAN                           PeiMemoryInstalled;
@@ -423,6 +472,20 @@ PeimDispatchReadiness (
   IN VOID              *DependencyExpression
   );
 
+/**
+  Get the DEPEX wait buckets of all PPI GUIDs pushed by a dependency expression.
+
+  @param DependencyExpression   Pointer to a dependency expression.
+
+  @return The bit mask of the DEPEX wait buckets. MAX_UINT32 if the dependency
+          expression is not a well-formed Grammar.
+
+**/
+UINT32
+GetDepexWaitBucketMask (
+  IN VOID  *DependencyExpression
+  );
+
 /**
   Migrate a PEIM from temporary RAM to permanent memory.
 
@@ -527,6 +590,19 @@ InitializePpiServices (
   IN PEI_CORE_INSTANCE  *OldCoreData
   );
 
+/**
+  Hash a PPI GUID.
+
+  @param Guid            The PPI GUID. It does not need to be aligned.
+
+  @return The hash value.
+
+**/
+UINT32
+PeiPpiGuidHash (
+  IN CONST EFI_GUID  *Guid
+  );
+
 /**
 
   Migrate the Hob list from the temporary memory to PEI installed memory.
@@ -890,6 +966,21 @@ PeiInstallSecHobData (
   IN EFI_HOB_GENERIC_HEADER  *SecHobList
   );
 
+/**
+  Build the index of the GUID HOBs in the HOB list and install it as a PPI,
+  so that the HOB libraries do not need to walk the whole HOB list.
+
+  The HOB list must already be in permanent memory, since the index holds the
+  addresses of the HOBs.
+
+  @param PrivateData     Pointer to the PEI Core data.
+
+**/
+VOID
+PeiBuildHobIndex (
+  IN PEI_CORE_INSTANCE  *PrivateData
+  );
+
 //
 // FFS Fw Volume support functions
 //
@@ -224,6 +224,10 @@ PeiCore (
           OldCoreData->PpiData.PpiList.PpiPtrs = (PEI_PPI_LIST_POINTERS *)((UINT8 *)OldCoreData->PpiData.PpiList.PpiPtrs + OldCoreData->HeapOffset);
         }
 
+        if (OldCoreData->PpiData.PpiList.PpiHash != NULL) {
+          OldCoreData->PpiData.PpiList.PpiHash = (UINT16 *)((UINT8 *)OldCoreData->PpiData.PpiList.PpiHash + OldCoreData->HeapOffset);
+        }
+
         if (OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs != NULL) {
           OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs = (PEI_PPI_LIST_POINTERS *)((UINT8 *)OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs + OldCoreData->HeapOffset);
         }
@@ -241,6 +245,10 @@ PeiCore (
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *)((UINT8 *)OldCoreData->Fv[Index].FvFileHandles + OldCoreData->HeapOffset);
           }
+
+          if (OldCoreData->Fv[Index].DepexWait != NULL) {
+            OldCoreData->Fv[Index].DepexWait = (PEI_DEPEX_WAIT *)((UINT8 *)OldCoreData->Fv[Index].DepexWait + OldCoreData->HeapOffset);
+          }
         }
 
         OldCoreData->TempFileGuid    = (EFI_GUID *)((UINT8 *)OldCoreData->TempFileGuid + OldCoreData->HeapOffset);
@@ -259,6 +267,10 @@ PeiCore (
           OldCoreData->PpiData.PpiList.PpiPtrs = (PEI_PPI_LIST_POINTERS *)((UINT8 *)OldCoreData->PpiData.PpiList.PpiPtrs - OldCoreData->HeapOffset);
         }
 
+        if (OldCoreData->PpiData.PpiList.PpiHash != NULL) {
+          OldCoreData->PpiData.PpiList.PpiHash = (UINT16 *)((UINT8 *)OldCoreData->PpiData.PpiList.PpiHash - OldCoreData->HeapOffset);
+        }
+
         if (OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs != NULL) {
           OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs = (PEI_PPI_LIST_POINTERS *)((UINT8 *)OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs - OldCoreData->HeapOffset);
         }
@@ -276,6 +288,10 @@ PeiCore (
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *)((UINT8 *)OldCoreData->Fv[Index].FvFileHandles - OldCoreData->HeapOffset);
           }
+
+          if (OldCoreData->Fv[Index].DepexWait != NULL) {
+            OldCoreData->Fv[Index].DepexWait = (PEI_DEPEX_WAIT *)((UINT8 *)OldCoreData->Fv[Index].DepexWait - OldCoreData->HeapOffset);
+          }
         }
 
         OldCoreData->TempFileGuid    = (EFI_GUID *)((UINT8 *)OldCoreData->TempFileGuid - OldCoreData->HeapOffset);
@@ -496,6 +512,11 @@ PeiCore (
       TemporaryRamDonePpi->TemporaryRamDone ();
     }
 
+    //
+    // The HOB list is in permanent memory now and does not move any more.
+    //
+    PeiBuildHobIndex (&PrivateData);
+
     //
     // Alert any listeners that there is permanent memory available
     //
@@ -427,6 +427,125 @@ DumpPpiList (
   DEBUG_CODE_END ();
 }
 
+/**
+  Hash a PPI GUID.
+
+  @param Guid            The PPI GUID. It does not need to be aligned.
+
+  @return The hash value.
+
+**/
+UINT32
+PeiPpiGuidHash (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINT32  Hash;
+
+  Hash = ReadUnaligned32 ((CONST UINT32 *)Guid) ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid + 1) ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid + 2) ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid + 3);
+
+  //
+  // Mix the bits so that both the low bits used by the PPI hash table and the
+  // high bits used by the DEPEX wait buckets depend on the whole GUID.
+  //
+  Hash ^= Hash >> 16;
+  Hash *= 0x7FEB352D;
+  Hash ^= Hash >> 15;
+  return Hash;
+}
+
+/**
+  Add a PPI to the hash table of the PPI database.
+
+  @param PpiListPointer  Pointer to the PPI database.
+  @param Index           Index of the PPI in PpiPtrs.
+
+**/
+VOID
+PeiPpiHashInsert (
+  IN PEI_PPI_LIST  *PpiListPointer,
+  IN UINTN         Index
+  )
+{
+  UINTN  Mask;
+  UINTN  Slot;
+
+  if (PpiListPointer->PpiHash == NULL) {
+    return;
+  }
+
+  //
+  // Linear probing keeps the instances of a GUID in the order they were installed.
+  //
+  Mask = PpiListPointer->PpiHashCount - 1;
+  Slot = PeiPpiGuidHash (PpiListPointer->PpiPtrs[Index].Ppi->Guid) & Mask;
+  while (PpiListPointer->PpiHash[Slot] != 0) {
+    Slot = (Slot + 1) & Mask;
+  }
+
+  PpiListPointer->PpiHash[Slot] = (UINT16)(Index + 1);
+}
+
+/**
+  Rebuild the hash table of the PPI database after PpiPtrs was grown or changed.
+
+  The table has at least twice as many entries as PpiPtrs, so that it always
+  has free entries. Without memory for the table, it is dropped and PeiLocatePpi()
+  falls back to a linear search.
+
+  @param PpiListPointer  Pointer to the PPI database.
+
+**/
+VOID
+PeiPpiHashRebuild (
+  IN PEI_PPI_LIST  *PpiListPointer
+  )
+{
+  UINTN  Count;
+  UINTN  Index;
+
+  Count = GetPowerOfTwo32 ((UINT32)(PpiListPointer->MaxCount * 4 - 1));
+  if ((PpiListPointer->PpiHash == NULL) || (Count > PpiListPointer->PpiHashCount)) {
+    PpiListPointer->PpiHash      = NULL;
+    PpiListPointer->PpiHashCount = 0;
+    if (PpiListPointer->MaxCount < MAX_UINT16) {
+      PpiListPointer->PpiHash = AllocatePool (Count * sizeof (UINT16));
+    }
+
+    if (PpiListPointer->PpiHash == NULL) {
+      return;
+    }
+
+    PpiListPointer->PpiHashCount = Count;
+  }
+
+  ZeroMem (PpiListPointer->PpiHash, PpiListPointer->PpiHashCount * sizeof (UINT16));
+  for (Index = 0; Index < PpiListPointer->CurrentCount; Index++) {
+    PeiPpiHashInsert (PpiListPointer, Index);
+  }
+}
+
+/**
+  Record that a PPI with a GUID was installed or removed, so that the PEIMs
+  whose DEPEX pushes the GUID evaluate the DEPEX again.
+
+  @param PpiListPointer  Pointer to the PPI database.
+  @param Guid            The GUID of the PPI.
+
+**/
+VOID
+PeiPpiRecordInstall (
+  IN PEI_PPI_LIST    *PpiListPointer,
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  PpiListPointer->InstallSequence++;
+  PpiListPointer->BucketSequence[DEPEX_WAIT_BUCKET (PeiPpiGuidHash (Guid))] = PpiListPointer->InstallSequence;
+}
+
 /**
 
   This function installs an interface in the PEI PPI database by GUID.
@@ -482,6 +601,7 @@ InternalPeiInstallPpi (
     //
     if ((PpiList->Flags & EFI_PEI_PPI_DESCRIPTOR_PPI) == 0) {
       PpiListPointer->CurrentCount = LastCount;
+      PeiPpiHashRebuild (PpiListPointer);
       DEBUG ((DEBUG_ERROR, "ERROR -> InstallPpi: %g %p\n", PpiList->Guid, PpiList->Ppi));
       return EFI_INVALID_PARAMETER;
     }
@@ -501,10 +621,13 @@ InternalPeiInstallPpi (
         );
       PpiListPointer->PpiPtrs  = TempPtr;
       PpiListPointer->MaxCount = PpiListPointer->MaxCount + PPI_GROWTH_STEP;
+      PeiPpiHashRebuild (PpiListPointer);
     }
 
     DEBUG ((DEBUG_INFO, "Install PPI: %g\n", PpiList->Guid));
     PpiListPointer->PpiPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *)PpiList;
+    PeiPpiHashInsert (PpiListPointer, Index);
+    PeiPpiRecordInstall (PpiListPointer, PpiList->Guid);
     Index++;
     PpiListPointer->CurrentCount++;
 
@@ -594,6 +717,7 @@ PeiReInstallPpi (
   )
 {
   PEI_CORE_INSTANCE  *PrivateData;
+  PEI_PPI_LIST       *PpiListPointer;
   UINTN              Index;
 
   if ((OldPpi == NULL) || (NewPpi == NULL)) {
@@ -604,19 +728,20 @@ PeiReInstallPpi (
     return EFI_INVALID_PARAMETER;
   }
 
-  PrivateData = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
+  PrivateData    = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
+  PpiListPointer = &PrivateData->PpiData.PpiList;
 
   //
   // Find the old PPI instance in the database.  If we can not find it,
   // return the EFI_NOT_FOUND error.
   //
-  for (Index = 0; Index < PrivateData->PpiData.PpiList.CurrentCount; Index++) {
-    if (OldPpi == PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi) {
+  for (Index = 0; Index < PpiListPointer->CurrentCount; Index++) {
+    if (OldPpi == PpiListPointer->PpiPtrs[Index].Ppi) {
       break;
     }
   }
 
-  if (Index == PrivateData->PpiData.PpiList.CurrentCount) {
+  if (Index == PpiListPointer->CurrentCount) {
     return EFI_NOT_FOUND;
   }
 
@@ -624,7 +749,21 @@ PeiReInstallPpi (
   // Replace the old PPI with the new one.
   //
   DEBUG ((DEBUG_INFO, "Reinstall PPI: %g\n", NewPpi->Guid));
-  PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *)NewPpi;
+  PpiListPointer->PpiPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *)NewPpi;
+  if (!CompareGuid (OldPpi->Guid, NewPpi->Guid)) {
+    //
+    // The entry of the old PPI is in the hash chain of the old GUID.
+    //
+    PeiPpiHashRebuild (PpiListPointer);
+
+    //
+    // The old GUID may be gone from the database now, which can make a
+    // NOT (OldGuid) DEPEX TRUE.
+    //
+    PeiPpiRecordInstall (PpiListPointer, OldPpi->Guid);
+  }
+
+  PeiPpiRecordInstall (PpiListPointer, NewPpi->Guid);
 
   //
   // Process any callback level notifies for the newly installed PPI.
@@ -668,17 +807,41 @@ PeiLocatePpi (
   )
 {
   PEI_CORE_INSTANCE       *PrivateData;
+  PEI_PPI_LIST            *PpiListPointer;
   UINTN                   Index;
+  UINTN                   Mask;
+  UINTN                   Slot;
   EFI_GUID                *CheckGuid;
   EFI_PEI_PPI_DESCRIPTOR  *TempPtr;
 
-  PrivateData = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
+  PrivateData    = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
+  PpiListPointer = &PrivateData->PpiData.PpiList;
+
+  Mask = 0;
+  Slot = 0;
+  if (PpiListPointer->PpiHash != NULL) {
+    Mask = PpiListPointer->PpiHashCount - 1;
+    Slot = PeiPpiGuidHash (Guid) & Mask;
+  }
 
   //
   // Search the data base for the matching instance of the GUIDed PPI.
+  // With the hash table, only the PPIs in the hash chain of the GUID are
+  // checked, which are in the order they were installed and never more
+  // than CurrentCount.
   //
-  for (Index = 0; Index < PrivateData->PpiData.PpiList.CurrentCount; Index++) {
-    TempPtr   = PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi;
+  for (Index = 0; Index < PpiListPointer->CurrentCount; Index++) {
+    if (PpiListPointer->PpiHash != NULL) {
+      if (PpiListPointer->PpiHash[Slot] == 0) {
+        break;
+      }
+
+      TempPtr = PpiListPointer->PpiPtrs[PpiListPointer->PpiHash[Slot] - 1].Ppi;
+      Slot    = (Slot + 1) & Mask;
+    } else {
+      TempPtr = PpiListPointer->PpiPtrs[Index].Ppi;
+    }
+
     CheckGuid = TempPtr->Guid;
 
     //
@@ -0,0 +1,43 @@
+/** @file
+  GUID used to identify the debug log of the status code handlers, in a GUID'ed
+  HOB in PEI phase and in a configuration table in DXE phase.
+
+Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef STATUS_CODE_DEBUG_LOG_H_
+#define STATUS_CODE_DEBUG_LOG_H_
+
+///
+/// The debug log starts with a structure of type STATUS_CODE_DEBUG_LOG_HEADER,
+/// followed by a ring buffer of Size bytes that holds the text the status code
+/// handlers would have written to the serial port.
+///
+#define STATUS_CODE_DEBUG_LOG_GUID \
+  { \
+    0x1eacfc2f, 0x5fdf, 0x4782, {0xa2, 0x20, 0x71, 0x0c, 0xd5, 0x76, 0x79, 0xa6} \
+  }
+
+typedef struct {
+  ///
+  /// The size in bytes of the ring buffer.
+  ///
+  UINT32    Size;
+  UINT32    Reserved;
+  ///
+  /// The total number of bytes written to the debug log. Byte N of the text is
+  /// at offset (N % Size) in the ring buffer, so the ring buffer holds the last
+  /// MIN (WriteCount, Size) bytes of the text.
+  ///
+  UINT64    WriteCount;
+  ///
+  /// The total number of bytes of the text written to the serial port.
+  ///
+  UINT64    DrainCount;
+} STATUS_CODE_DEBUG_LOG_HEADER;
+
+extern EFI_GUID  gStatusCodeDebugLogGuid;
+
+#endif
@@ -0,0 +1,36 @@
+/** @file
+  The Controller Init Pending Protocol is installed with a NULL interface on a
+  controller handle by a driver whose Start() returned before the initialization
+  of the controller finished. The driver finishes the initialization from a timer
+  event, creates the child handles of the controller, uninstalls the protocol,
+  and then signals the event group gEdkiiControllerInitDoneEventGroupGuid.
+
+  Until the protocol is uninstalled, connecting the controller again does not
+  create more child handles. A caller that needs the children, such as the boot
+  manager when it connects all controllers, waits for the event group and
+  connects the controller again.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __CONTROLLER_INIT_PENDING_H__
+#define __CONTROLLER_INIT_PENDING_H__
+
+// {984DBB2A-1205-4415-9402-8740B5D40C6E}
+#define EDKII_CONTROLLER_INIT_PENDING_PROTOCOL_GUID \
+  { \
+    0x984dbb2a, 0x1205, 0x4415, { 0x94, 0x02, 0x87, 0x40, 0xb5, 0xd4, 0x0c, 0x6e } \
+  }
+
+// {0442A48A-6FAD-476B-AE5C-2FAB9F0A9DA5}
+#define EDKII_CONTROLLER_INIT_DONE_EVENT_GROUP_GUID \
+  { \
+    0x0442a48a, 0x6fad, 0x476b, { 0xae, 0x5c, 0x2f, 0xab, 0x9f, 0x0a, 0x9d, 0xa5 } \
+  }
+
+extern EFI_GUID  gEdkiiControllerInitPendingProtocolGuid;
+extern EFI_GUID  gEdkiiControllerInitDoneEventGroupGuid;
+
+#endif
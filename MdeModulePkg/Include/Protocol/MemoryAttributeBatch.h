@@ -0,0 +1,102 @@
+/** @file
+  Memory Attribute Batch Protocol lets the DXE core group many calls of
+  EFI_CPU_ARCH_PROTOCOL.SetMemoryAttributes() into one batch, so that the
+  producer of the CPU Arch Protocol can defer the TLB flush to the end of the
+  batch and compact the page tables once.
+
+  Within a batch, a change that only removes access rights may not take effect
+  until the batch is committed. A change that grants access rights always takes
+  effect before SetMemoryAttributes() returns.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __MEMORY_ATTRIBUTE_BATCH_H__
+#define __MEMORY_ATTRIBUTE_BATCH_H__
+
+// {3EDBD3E4-61A8-4708-AAF1-42F3E0D501C9}
+#define EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL_GUID \
+  { \
+    0x3edbd3e4, 0x61a8, 0x4708, { 0xaa, 0xf1, 0x42, 0xf3, 0xe0, 0xd5, 0x01, 0xc9 } \
+  }
+
+typedef struct _EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL;
+
+///
+/// Counters of the page table updates done by the producer since boot.
+///
+typedef struct {
+  UINT64    SetAttributeCalls;    ///< Calls that updated the page table.
+  UINT64    UpdateTimeInNs;       ///< Time spent in these calls.
+  UINT64    TlbFlushes;           ///< TLB flushes done.
+  UINT64    DeferredTlbFlushes;   ///< Updates whose TLB flush was deferred to the end of a batch.
+  UINT64    PageSplits;           ///< Large pages split into smaller pages.
+  UINT64    PageMerges;           ///< Page tables merged back into large pages.
+  UINT64    PageTablePages;       ///< Pages taken from memory for new page tables.
+  UINT64    FreePageTablePages;   ///< Page tables freed by merges and kept for reuse.
+} EDKII_MEMORY_ATTRIBUTE_BATCH_STATISTICS;
+
+/**
+  Start a batch of memory attribute updates. Batches may be nested; only the
+  outermost EDKII_MEMORY_ATTRIBUTE_BATCH_COMMIT ends the batch.
+
+  @param  This              The EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL instance.
+
+  @retval EFI_SUCCESS       The batch is started.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MEMORY_ATTRIBUTE_BATCH_BEGIN)(
+  IN  EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL  *This
+  );
+
+/**
+  End a batch of memory attribute updates. When the outermost batch ends, the
+  page tables touched by the batch are compacted into large pages where
+  possible, and the TLB is flushed once if any update was deferred.
+
+  @param  This              The EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL instance.
+
+  @retval EFI_SUCCESS       The batch is committed.
+  @retval EFI_NOT_STARTED   No batch is in progress.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MEMORY_ATTRIBUTE_BATCH_COMMIT)(
+  IN  EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL  *This
+  );
+
+/**
+  Get the page table update counters.
+
+  @param  This              The EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL instance.
+  @param  Statistics        Returns the counters.
+
+  @retval EFI_SUCCESS           The counters are returned.
+  @retval EFI_INVALID_PARAMETER Statistics is NULL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MEMORY_ATTRIBUTE_BATCH_GET_STATISTICS)(
+  IN  EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL    *This,
+  OUT EDKII_MEMORY_ATTRIBUTE_BATCH_STATISTICS  *Statistics
+  );
+
+///
+/// Memory Attribute Batch Protocol provides batching of the updates done by
+/// EFI_CPU_ARCH_PROTOCOL.SetMemoryAttributes().
+///
+struct _EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL {
+  EDKII_MEMORY_ATTRIBUTE_BATCH_BEGIN             Begin;
+  EDKII_MEMORY_ATTRIBUTE_BATCH_COMMIT            Commit;
+  EDKII_MEMORY_ATTRIBUTE_BATCH_GET_STATISTICS    GetStatistics;
+};
+
+extern EFI_GUID  gEdkiiMemoryAttributeBatchProtocolGuid;
+
+#endif
@@ -166,7 +166,8 @@ IsKnownID (
       (Identifier == MODULE_DB_SUPPORT_START_ID) ||
       (Identifier == MODULE_DB_SUPPORT_END_ID) ||
       (Identifier == MODULE_DB_STOP_START_ID) ||
-      (Identifier == MODULE_DB_STOP_END_ID))
+      (Identifier == MODULE_DB_STOP_END_ID) ||
+      (Identifier == PERF_COUNTER_ID))
   {
     return TRUE;
   } else {
@@ -449,6 +450,25 @@ InsertFpdtRecord (
 
       break;
 
+    case PERF_COUNTER_ID:
+      if ((String == NULL) || (AsciiStrLen (String) == 0)) {
+        return EFI_INVALID_PARAMETER;
+      }
+
+      StringPtr = String;
+      if (!PcdGetBool (PcdEdkiiFpdtStringRecordEnableOnly)) {
+        FpdtRecordPtr.GuidQwordStringEvent->Header.Type     = FPDT_GUID_QWORD_STRING_EVENT_TYPE;
+        FpdtRecordPtr.GuidQwordStringEvent->Header.Length   = sizeof (FPDT_GUID_QWORD_STRING_EVENT_RECORD);
+        FpdtRecordPtr.GuidQwordStringEvent->Header.Revision = FPDT_RECORD_REVISION_1;
+        FpdtRecordPtr.GuidQwordStringEvent->ProgressID      = PerfId;
+        FpdtRecordPtr.GuidQwordStringEvent->Timestamp       = TimeStamp;
+        FpdtRecordPtr.GuidQwordStringEvent->Qword           = Address;
+        CopyMem (&FpdtRecordPtr.GuidQwordStringEvent->Guid, ModuleGuid, sizeof (EFI_GUID));
+        CopyStringIntoPerfRecordAndUpdateLength (FpdtRecordPtr.GuidQwordStringEvent->String, StringPtr, &FpdtRecordPtr.GuidQwordStringEvent->Header.Length);
+      }
+
+      break;
+
     case PERF_EVENT_ID:
     case PERF_FUNCTION_START_ID:
     case PERF_FUNCTION_END_ID:
@@ -8,6 +8,72 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "InternalBm.h"
 
+/**
+  Wait until no driver finishes the initialization of a controller after its
+  Start() returned.
+
+  Such controllers carry the Controller Init Pending Protocol until they are
+  initialized, and have no child handles before then.
+
+  @retval TRUE   Some controllers were initialized while waiting, so they need to
+                 be connected again to connect their children.
+  @retval FALSE  No controller initialization was pending.
+**/
+BOOLEAN
+BmWaitForPendingControllers (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  EFI_EVENT   DoneEvent;
+  UINTN       HandleCount;
+  EFI_HANDLE  *HandleBuffer;
+  UINTN       Index;
+  BOOLEAN     Waited;
+
+  //
+  // The event is created before the pending controllers are looked up, so that
+  // a controller that finishes in between still signals it.
+  //
+  Status = gBS->CreateEventEx (
+                  0,
+                  TPL_CALLBACK,
+                  NULL,
+                  NULL,
+                  &gEdkiiControllerInitDoneEventGroupGuid,
+                  &DoneEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  Waited = FALSE;
+  while (TRUE) {
+    Status = gBS->LocateHandleBuffer (
+                    ByProtocol,
+                    &gEdkiiControllerInitPendingProtocolGuid,
+                    NULL,
+                    &HandleCount,
+                    &HandleBuffer
+                    );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    FreePool (HandleBuffer);
+    DEBUG ((DEBUG_INFO, "[Bds]Waiting for %Lu controllers to be initialized\n", (UINT64)HandleCount));
+    Waited = TRUE;
+
+    Status = gBS->WaitForEvent (1, &DoneEvent, &Index);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  gBS->CloseEvent (DoneEvent);
+  return Waited;
+}
+
 /**
   Connect all the drivers to all the controllers.
 
@@ -24,6 +90,7 @@ BmConnectAllDriversToAllControllers (
   UINTN       HandleCount;
   EFI_HANDLE  *HandleBuffer;
   UINTN       Index;
+  BOOLEAN     Waited;
 
   do {
     //
@@ -38,13 +105,25 @@ BmConnectAllDriversToAllControllers (
            );
 
     for (Index = 0; Index < HandleCount; Index++) {
+      PERF_START_EX (HandleBuffer[Index], "BdsConnect", NULL, 0, 0);
       gBS->ConnectController (HandleBuffer[Index], NULL, NULL, TRUE);
+      PERF_END_EX (HandleBuffer[Index], "BdsConnect", NULL, 0, 0);
     }
 
     if (HandleBuffer != NULL) {
       FreePool (HandleBuffer);
     }
 
+    //
+    // Drivers may finish the initialization of a controller after Start()
+    // returned, so that the controllers are initialized in parallel. Their
+    // children only show up then, and need another connect.
+    //
+    Waited = FALSE;
+    if (FeaturePcdGet (PcdAsyncControllerInit)) {
+      Waited = BmWaitForPendingControllers ();
+    }
+
     //
     // Check to see if it's possible to dispatch an more DXE drivers.
     // The above code may have made new DXE drivers show up.
@@ -52,7 +131,7 @@ BmConnectAllDriversToAllControllers (
     // the connect again.
     //
     Status = gDS->Dispatch ();
-  } while (!EFI_ERROR (Status));
+  } while (!EFI_ERROR (Status) || Waited);
 }
 
 /**
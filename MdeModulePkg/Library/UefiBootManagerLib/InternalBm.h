@@ -44,6 +44,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/RamDisk.h>
 #include <Protocol/DeferredImageLoad.h>
 #include <Protocol/PlatformBootManager.h>
+#include <Protocol/ControllerInitPending.h>
 
 #include <Guid/MemoryTypeInformation.h>
 #include <Guid/FileInfo.h>
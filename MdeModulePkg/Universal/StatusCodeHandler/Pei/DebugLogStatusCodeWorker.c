@@ -0,0 +1,179 @@
+/** @file
+  PEI debug log status code worker.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "StatusCodeHandlerPei.h"
+
+EFI_PEI_NOTIFY_DESCRIPTOR  mDebugLogEndOfPeiNotifyList = {
+  (EFI_PEI_PPI_DESCRIPTOR_NOTIFY_CALLBACK | EFI_PEI_PPI_DESCRIPTOR_TERMINATE_LIST),
+  &gEfiEndOfPeiSignalPpiGuid,
+  DebugLogEndOfPeiNotify
+};
+
+/**
+  Create the debug log GUID'ed HOB as initialization for debug log status code worker.
+
+  @retval EFI_SUCCESS           The GUID'ed HOB is created successfully.
+  @retval EFI_OUT_OF_RESOURCES  There is no memory for the GUID'ed HOB.
+  @retval others                Errors from PeiServicesNotifyPpi().
+
+**/
+EFI_STATUS
+DebugLogStatusCodeInitializeWorker (
+  VOID
+  )
+{
+  STATUS_CODE_DEBUG_LOG_HEADER  *DebugLog;
+  UINT32                        Size;
+
+  //
+  // The size of a HOB is limited to 64 KBytes.
+  //
+  Size     = MIN (PcdGet16 (PcdStatusCodeDebugLogSize), MAX_PEI_DEBUG_LOG_SIZE) * 1024;
+  DebugLog = BuildGuidHob (&gStatusCodeDebugLogGuid, sizeof (STATUS_CODE_DEBUG_LOG_HEADER) + Size);
+  if (DebugLog == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (DebugLog, sizeof (STATUS_CODE_DEBUG_LOG_HEADER));
+  DebugLog->Size = Size;
+
+  //
+  // Nothing drains the debug log until the DXE handler takes it over. There is
+  // no DXE phase on S3 resume, so the debug log is written out at the end of PEI
+  // then. The boot mode is checked by the notification, because it may not be
+  // known yet.
+  //
+  return PeiServicesNotifyPpi (&mDebugLogEndOfPeiNotifyList);
+}
+
+/**
+  Write the oldest text of the debug log that is not written yet to the serial port.
+
+  @param  DebugLog         The debug log.
+  @param  NumberOfBytes    The maximum number of bytes to write.
+
+**/
+VOID
+DebugLogDrain (
+  IN OUT STATUS_CODE_DEBUG_LOG_HEADER  *DebugLog,
+  IN     UINTN                         NumberOfBytes
+  )
+{
+  UINT8  *Ring;
+  UINTN  Offset;
+  UINTN  Count;
+
+  Ring          = (UINT8 *)(DebugLog + 1);
+  NumberOfBytes = (UINTN)MIN (NumberOfBytes, DebugLog->WriteCount - DebugLog->DrainCount);
+  while (NumberOfBytes > 0) {
+    Offset = (UINTN)ModU64x32 (DebugLog->DrainCount, DebugLog->Size);
+    Count  = MIN (NumberOfBytes, DebugLog->Size - Offset);
+    SerialPortWrite (&Ring[Offset], Count);
+    DebugLog->DrainCount += Count;
+    NumberOfBytes        -= Count;
+  }
+}
+
+/**
+  Write text to the debug log in the GUID'ed HOB.
+
+  If the debug log is full, the oldest text is written to the serial port to
+  make room. If there is no debug log, the text is written to the serial port.
+
+  @param  Buffer           The text.
+  @param  NumberOfBytes    The number of bytes of the text.
+
+**/
+VOID
+DebugLogWrite (
+  IN UINT8  *Buffer,
+  IN UINTN  NumberOfBytes
+  )
+{
+  EFI_HOB_GUID_TYPE             *GuidHob;
+  STATUS_CODE_DEBUG_LOG_HEADER  *DebugLog;
+  UINT8                         *Ring;
+  UINTN                         Offset;
+  UINTN                         Count;
+
+  //
+  // The GUID'ed HOB moves when the HOB list is migrated to permanent memory.
+  //
+  GuidHob = GetFirstGuidHob (&gStatusCodeDebugLogGuid);
+  if (GuidHob == NULL) {
+    SerialPortWrite (Buffer, NumberOfBytes);
+    return;
+  }
+
+  DebugLog = GET_GUID_HOB_DATA (GuidHob);
+  Ring     = (UINT8 *)(DebugLog + 1);
+
+  if (DebugLog->WriteCount - DebugLog->DrainCount + NumberOfBytes > DebugLog->Size) {
+    DebugLogDrain (DebugLog, (UINTN)(DebugLog->WriteCount - DebugLog->DrainCount + NumberOfBytes - DebugLog->Size));
+  }
+
+  while (NumberOfBytes > 0) {
+    Offset = (UINTN)ModU64x32 (DebugLog->WriteCount, DebugLog->Size);
+    Count  = MIN (NumberOfBytes, DebugLog->Size - Offset);
+    CopyMem (&Ring[Offset], Buffer, Count);
+    DebugLog->WriteCount += Count;
+    Buffer               += Count;
+    NumberOfBytes        -= Count;
+  }
+}
+
+/**
+  Write all text of the debug log in the GUID'ed HOB to the serial port.
+
+**/
+VOID
+DebugLogFlush (
+  VOID
+  )
+{
+  EFI_HOB_GUID_TYPE             *GuidHob;
+  STATUS_CODE_DEBUG_LOG_HEADER  *DebugLog;
+
+  GuidHob = GetFirstGuidHob (&gStatusCodeDebugLogGuid);
+  if (GuidHob == NULL) {
+    return;
+  }
+
+  DebugLog = GET_GUID_HOB_DATA (GuidHob);
+  DebugLogDrain (DebugLog, (UINTN)(DebugLog->WriteCount - DebugLog->DrainCount));
+}
+
+/**
+  Write all text of the debug log to the serial port at the end of PEI on S3
+  resume. On other boot paths, the DXE handler takes over the debug log.
+
+  @param  PeiServices       An indirect pointer to the EFI_PEI_SERVICES table published by the PEI Foundation.
+  @param  NotifyDescriptor  Address of the notification descriptor data structure.
+  @param  Ppi               Address of the PPI that was installed.
+
+  @retval EFI_SUCCESS       The debug log is written, or is left to the DXE handler.
+
+**/
+EFI_STATUS
+EFIAPI
+DebugLogEndOfPeiNotify (
+  IN EFI_PEI_SERVICES           **PeiServices,
+  IN EFI_PEI_NOTIFY_DESCRIPTOR  *NotifyDescriptor,
+  IN VOID                       *Ppi
+  )
+{
+  EFI_STATUS     Status;
+  EFI_BOOT_MODE  BootMode;
+
+  Status = PeiServicesGetBootMode (&BootMode);
+  if (EFI_ERROR (Status) || (BootMode == BOOT_ON_S3_RESUME)) {
+    DebugLogFlush ();
+  }
+
+  return EFI_SUCCESS;
+}
@@ -42,12 +42,17 @@ StatusCodeHandlerPeiEntry (
 
   //
   // Dispatch initialization request to sub-statuscode-devices.
-  // If enable UseSerial, then initialize serial port.
+  // If enable UseSerial, then initialize serial port, and the debug log if it has a size.
   // if enable UseMemory, then initialize memory status code worker.
   //
   if (PcdGetBool (PcdStatusCodeUseSerial)) {
     Status = SerialPortInitialize ();
     ASSERT_EFI_ERROR (Status);
+    if (PcdGet16 (PcdStatusCodeDebugLogSize) != 0) {
+      Status = DebugLogStatusCodeInitializeWorker ();
+      ASSERT_EFI_ERROR (Status);
+    }
+
     Status = RscHandlerPpi->Register (SerialStatusCodeReportWorker);
     ASSERT_EFI_ERROR (Status);
   }
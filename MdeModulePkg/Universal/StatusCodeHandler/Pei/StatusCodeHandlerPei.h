@@ -10,8 +10,10 @@
 #define __STATUS_CODE_HANDLER_PEI_H__
 
 #include <Ppi/ReportStatusCodeHandler.h>
+#include <Ppi/EndOfPeiPhase.h>
 
 #include <Guid/MemoryStatusCodeRecord.h>
+#include <Guid/StatusCodeDebugLog.h>
 #include <Guid/StatusCodeDataTypeId.h>
 #include <Guid/StatusCodeDataTypeDebug.h>
 
@@ -24,12 +26,18 @@
 #include <Library/PeiServicesLib.h>
 #include <Library/PeimEntryPoint.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
 
 //
 // Define the maximum message length
 //
 #define MAX_DEBUG_MESSAGE_LENGTH  0x100
 
+//
+// Define the maximum size of the debug log in KBytes
+//
+#define MAX_PEI_DEBUG_LOG_SIZE  63
+
 /**
   Convert status code value and extended data to readable ASCII string, send string to serial I/O device.
 
@@ -112,4 +120,61 @@ MemoryStatusCodeReportWorker (
   IN CONST EFI_STATUS_CODE_DATA  *Data OPTIONAL
   );
 
+/**
+  Create the debug log GUID'ed HOB as initialization for debug log status code worker.
+
+  @retval EFI_SUCCESS           The GUID'ed HOB is created successfully.
+  @retval EFI_OUT_OF_RESOURCES  There is no memory for the GUID'ed HOB.
+  @retval others                Errors from PeiServicesNotifyPpi().
+
+**/
+EFI_STATUS
+DebugLogStatusCodeInitializeWorker (
+  VOID
+  );
+
+/**
+  Write all text of the debug log in the GUID'ed HOB to the serial port.
+
+**/
+VOID
+DebugLogFlush (
+  VOID
+  );
+
+/**
+  Write all text of the debug log to the serial port at the end of PEI on S3
+  resume. On other boot paths, the DXE handler takes over the debug log.
+
+  @param  PeiServices       An indirect pointer to the EFI_PEI_SERVICES table published by the PEI Foundation.
+  @param  NotifyDescriptor  Address of the notification descriptor data structure.
+  @param  Ppi               Address of the PPI that was installed.
+
+  @retval EFI_SUCCESS       The debug log is written, or is left to the DXE handler.
+
+**/
+EFI_STATUS
+EFIAPI
+DebugLogEndOfPeiNotify (
+  IN EFI_PEI_SERVICES           **PeiServices,
+  IN EFI_PEI_NOTIFY_DESCRIPTOR  *NotifyDescriptor,
+  IN VOID                       *Ppi
+  );
+
+/**
+  Write text to the debug log in the GUID'ed HOB.
+
+  If the debug log is full, the oldest text is written to the serial port to
+  make room. If there is no debug log, the text is written to the serial port.
+
+  @param  Buffer           The text.
+  @param  NumberOfBytes    The number of bytes of the text.
+
+**/
+VOID
+DebugLogWrite (
+  IN UINT8  *Buffer,
+  IN UINTN  NumberOfBytes
+  );
+
 #endif
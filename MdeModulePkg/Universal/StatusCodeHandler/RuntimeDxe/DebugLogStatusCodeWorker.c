@@ -0,0 +1,288 @@
+/** @file
+  Debug log status code worker.
+
+  The text of the serial status code worker is buffered in a ring, which is
+  written to the serial port from a timer event and from the idle loop.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "StatusCodeHandlerRuntimeDxe.h"
+
+STATUS_CODE_DEBUG_LOG_HEADER  *mDebugLog          = NULL;
+EFI_EVENT                     mDebugLogTimerEvent = NULL;
+EFI_EVENT                     mDebugLogIdleEvent  = NULL;
+
+/**
+  Write the oldest text of the debug log that is not written yet to the serial port.
+
+  @param  DebugLog         The debug log.
+  @param  NumberOfBytes    The maximum number of bytes to write.
+
+**/
+VOID
+DebugLogDrain (
+  IN OUT STATUS_CODE_DEBUG_LOG_HEADER  *DebugLog,
+  IN     UINTN                         NumberOfBytes
+  )
+{
+  UINT8  *Ring;
+  UINTN  Offset;
+  UINTN  Count;
+
+  Ring          = (UINT8 *)(DebugLog + 1);
+  NumberOfBytes = (UINTN)MIN (NumberOfBytes, DebugLog->WriteCount - DebugLog->DrainCount);
+  while (NumberOfBytes > 0) {
+    Offset = (UINTN)ModU64x32 (DebugLog->DrainCount, DebugLog->Size);
+    Count  = MIN (NumberOfBytes, DebugLog->Size - Offset);
+    SerialPortWrite (&Ring[Offset], Count);
+    DebugLog->DrainCount += Count;
+    NumberOfBytes        -= Count;
+  }
+}
+
+/**
+  Append text to a debug log.
+
+  If the debug log is full, the oldest text is written to the serial port to
+  make room.
+
+  @param  DebugLog         The debug log.
+  @param  Buffer           The text.
+  @param  NumberOfBytes    The number of bytes of the text.
+
+**/
+VOID
+DebugLogAppend (
+  IN OUT STATUS_CODE_DEBUG_LOG_HEADER  *DebugLog,
+  IN     UINT8                         *Buffer,
+  IN     UINTN                         NumberOfBytes
+  )
+{
+  UINT8  *Ring;
+  UINTN  Offset;
+  UINTN  Count;
+
+  Ring = (UINT8 *)(DebugLog + 1);
+
+  if (DebugLog->WriteCount - DebugLog->DrainCount + NumberOfBytes > DebugLog->Size) {
+    DebugLogDrain (DebugLog, (UINTN)(DebugLog->WriteCount - DebugLog->DrainCount + NumberOfBytes - DebugLog->Size));
+  }
+
+  while (NumberOfBytes > 0) {
+    Offset = (UINTN)ModU64x32 (DebugLog->WriteCount, DebugLog->Size);
+    Count  = MIN (NumberOfBytes, DebugLog->Size - Offset);
+    CopyMem (&Ring[Offset], Buffer, Count);
+    DebugLog->WriteCount += Count;
+    Buffer               += Count;
+    NumberOfBytes        -= Count;
+  }
+}
+
+/**
+  Write as much of the debug log to the serial port as its transmit FIFO takes
+  without waiting.
+
+  The debug log is only written when the serial port reports that the transmit
+  FIFO is empty, and then DEBUG_LOG_DRAIN_CHUNK_SIZE bytes at most, so
+  SerialPortWrite() does not wait for the UART. A serial port that cannot report
+  its state is written one chunk per event.
+
+  @param  Event         Event whose notification function is being invoked.
+  @param  Context       Pointer to the notification function's context.
+
+**/
+VOID
+EFIAPI
+DebugLogDrainNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Control;
+  EFI_TPL     OldTpl;
+
+  if (mDebugLog == NULL) {
+    return;
+  }
+
+  while (mDebugLog->WriteCount != mDebugLog->DrainCount) {
+    Status = SerialPortGetControl (&Control);
+    if (!EFI_ERROR (Status) && ((Control & EFI_SERIAL_OUTPUT_BUFFER_EMPTY) == 0)) {
+      break;
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+    DebugLogDrain (mDebugLog, DEBUG_LOG_DRAIN_CHUNK_SIZE);
+    gBS->RestoreTPL (OldTpl);
+
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+}
+
+/**
+  Allocate the debug log and take over the text of the PEI debug log that is
+  still in the GUID'ed HOB, as initialization for debug log status code worker.
+
+  @retval EFI_SUCCESS           The debug log is successfully initialized.
+  @retval EFI_OUT_OF_RESOURCES  There is no memory for the debug log.
+  @retval others                Errors from gBS->InstallConfigurationTable() or gBS->CreateEvent().
+
+**/
+EFI_STATUS
+DebugLogStatusCodeInitializeWorker (
+  VOID
+  )
+{
+  EFI_STATUS                    Status;
+  EFI_HOB_GUID_TYPE             *GuidHob;
+  STATUS_CODE_DEBUG_LOG_HEADER  *PeiDebugLog;
+  UINT8                         *PeiRing;
+  UINT32                        Size;
+  UINT64                        Retained;
+  UINTN                         Offset;
+  UINTN                         Count;
+
+  Size      = PcdGet16 (PcdStatusCodeDebugLogSize) * 1024;
+  mDebugLog = AllocateRuntimePool (sizeof (STATUS_CODE_DEBUG_LOG_HEADER) + Size);
+  if (mDebugLog == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (mDebugLog, sizeof (STATUS_CODE_DEBUG_LOG_HEADER));
+  mDebugLog->Size = Size;
+
+  GuidHob = GetFirstGuidHob (&gStatusCodeDebugLogGuid);
+  if (GuidHob != NULL) {
+    PeiDebugLog = GET_GUID_HOB_DATA (GuidHob);
+    PeiRing     = (UINT8 *)(PeiDebugLog + 1);
+
+    //
+    // Write the PEI text that does not fit in the debug log to the serial port first.
+    //
+    if (PeiDebugLog->WriteCount - PeiDebugLog->DrainCount > Size) {
+      DebugLogDrain (PeiDebugLog, (UINTN)(PeiDebugLog->WriteCount - PeiDebugLog->DrainCount - Size));
+    }
+
+    //
+    // Keep the text counters of PEI phase, and copy as much of the PEI text as
+    // both ring buffers hold.
+    //
+    Retained              = MIN (PeiDebugLog->WriteCount, MIN (PeiDebugLog->Size, Size));
+    mDebugLog->WriteCount = PeiDebugLog->WriteCount - Retained;
+    mDebugLog->DrainCount = mDebugLog->WriteCount;
+    while (Retained > 0) {
+      Offset = (UINTN)ModU64x32 (mDebugLog->WriteCount, PeiDebugLog->Size);
+      Count  = (UINTN)MIN (Retained, PeiDebugLog->Size - Offset);
+      DebugLogAppend (mDebugLog, &PeiRing[Offset], Count);
+      Retained -= Count;
+    }
+
+    mDebugLog->DrainCount = PeiDebugLog->DrainCount;
+  }
+
+  Status = gBS->InstallConfigurationTable (&gStatusCodeDebugLogGuid, mDebugLog);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  DebugLogDrainNotify,
+                  NULL,
+                  &mDebugLogTimerEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->SetTimer (mDebugLogTimerEvent, TimerPeriodic, DEBUG_LOG_DRAIN_PERIOD);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return gBS->CreateEventEx (
+                EVT_NOTIFY_SIGNAL,
+                TPL_CALLBACK,
+                DebugLogDrainNotify,
+                NULL,
+                &gIdleLoopEventGuid,
+                &mDebugLogIdleEvent
+                );
+}
+
+/**
+  Write text to the debug log.
+
+  If the debug log is full, the oldest text is written to the serial port to
+  make room. If there is no debug log, the text is written to the serial port.
+
+  @param  Buffer           The text.
+  @param  NumberOfBytes    The number of bytes of the text.
+
+**/
+VOID
+DebugLogWrite (
+  IN UINT8  *Buffer,
+  IN UINTN  NumberOfBytes
+  )
+{
+  EFI_TPL  OldTpl;
+
+  if (mDebugLog == NULL) {
+    SerialPortWrite (Buffer, NumberOfBytes);
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  DebugLogAppend (mDebugLog, Buffer, NumberOfBytes);
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Write all text of the debug log to the serial port.
+
+**/
+VOID
+DebugLogFlush (
+  VOID
+  )
+{
+  EFI_TPL  OldTpl;
+
+  if (mDebugLog == NULL) {
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  DebugLogDrain (mDebugLog, (UINTN)(mDebugLog->WriteCount - mDebugLog->DrainCount));
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Write all text of the debug log to the serial port, and write any later text
+  to the serial port directly.
+
+  This is called when boot services are exiting, after the memory map is
+  terminated. It therefore calls no boot services. The drain events are left
+  in place; they do nothing once the debug log is stopped.
+
+**/
+VOID
+DebugLogStop (
+  VOID
+  )
+{
+  if (mDebugLog == NULL) {
+    return;
+  }
+
+  DebugLogDrain (mDebugLog, (UINTN)(mDebugLog->WriteCount - mDebugLog->DrainCount));
+  mDebugLog = NULL;
+}
@@ -46,7 +46,8 @@ SerialStatusCodeReportWorker (
   UINTN      CharCount;
   BASE_LIST  Marker;
 
-  Buffer[0] = '\0';
+  Buffer[0]  = '\0';
+  ErrorLevel = 0;
 
   if ((Data != NULL) &&
       ReportStatusCodeExtractAssertInfo (CodeType, Value, Data, &Filename, &Description, &LineNumber))
@@ -150,9 +151,21 @@ SerialStatusCodeReportWorker (
   }
 
   //
-  // Call SerialPort Lib function to do print.
+  // Call SerialPort Lib function to do print, or defer it through the debug log.
   //
-  SerialPortWrite ((UINT8 *)Buffer, CharCount);
+  if (PcdGet16 (PcdStatusCodeDebugLogSize) != 0) {
+    DebugLogWrite ((UINT8 *)Buffer, CharCount);
+
+    //
+    // Write the debug log out on errors and assertions, so that the text that
+    // leads up to a hang is not left in the ring.
+    //
+    if (((CodeType & EFI_STATUS_CODE_TYPE_MASK) == EFI_ERROR_CODE) || ((ErrorLevel & DEBUG_ERROR) != 0)) {
+      DebugLogFlush ();
+    }
+  } else {
+    SerialPortWrite ((UINT8 *)Buffer, CharCount);
+  }
 
   //
   // If register an unregister function of gEfiEventExitBootServicesGuid,
@@ -24,6 +24,10 @@ UnregisterSerialBootTimeHandlers (
   )
 {
   if (PcdGetBool (PcdStatusCodeUseSerial)) {
+    if (PcdGet16 (PcdStatusCodeDebugLogSize) != 0) {
+      DebugLogStop ();
+    }
+
     mRscHandlerProtocol->Unregister (SerialStatusCodeReportWorker);
   }
 }
@@ -71,7 +75,7 @@ InitializationDispatcherWorker (
   UINTN                            MaxRecordNumber;
 
   //
-  // If enable UseSerial, then initialize serial port.
+  // If enable UseSerial, then initialize serial port, and the debug log if it has a size.
   // if enable UseRuntimeMemory, then initialize runtime memory status code worker.
   //
   if (PcdGetBool (PcdStatusCodeUseSerial)) {
@@ -80,6 +84,10 @@ InitializationDispatcherWorker (
     //
     Status = SerialPortInitialize ();
     ASSERT_EFI_ERROR (Status);
+    if (PcdGet16 (PcdStatusCodeDebugLogSize) != 0) {
+      Status = DebugLogStatusCodeInitializeWorker ();
+      ASSERT_EFI_ERROR (Status);
+    }
   }
 
   if (PcdGetBool (PcdStatusCodeUseMemory)) {
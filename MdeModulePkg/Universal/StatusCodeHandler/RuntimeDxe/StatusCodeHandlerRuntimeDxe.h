@@ -16,6 +16,8 @@
 #include <Guid/StatusCodeDataTypeId.h>
 #include <Guid/StatusCodeDataTypeDebug.h>
 #include <Guid/EventGroup.h>
+#include <Guid/IdleLoopEvent.h>
+#include <Guid/StatusCodeDebugLog.h>
 
 #include <Library/SynchronizationLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -29,12 +31,26 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiRuntimeLib.h>
 #include <Library/SerialPortLib.h>
+#include <Library/BaseLib.h>
 
 //
 // Define the maximum message length
 //
 #define MAX_DEBUG_MESSAGE_LENGTH  0x100
 
+//
+// Define the number of bytes written to the serial port by one drain event,
+// which is the FIFO size of a 16550 UART. The bytes are only written when the
+// transmit FIFO is empty, so SerialPortWrite() takes them without waiting.
+//
+#define DEBUG_LOG_DRAIN_CHUNK_SIZE  16
+
+//
+// Define the period of the timer that writes the debug log, in 100ns units (1ms).
+// A 115200 baud UART sends one chunk in about 1.4ms.
+//
+#define DEBUG_LOG_DRAIN_PERIOD  10000
+
 extern RUNTIME_MEMORY_STATUSCODE_HEADER  *mRtMemoryStatusCodeTable;
 
 /**
@@ -117,6 +133,59 @@ RtMemoryStatusCodeReportWorker (
   IN EFI_STATUS_CODE_DATA   *Data OPTIONAL
   );
 
+/**
+  Allocate the debug log and take over the text of the PEI debug log that is
+  still in the GUID'ed HOB, as initialization for debug log status code worker.
+
+  @retval EFI_SUCCESS           The debug log is successfully initialized.
+  @retval EFI_OUT_OF_RESOURCES  There is no memory for the debug log.
+  @retval others                Errors from gBS->InstallConfigurationTable() or gBS->CreateEvent().
+
+**/
+EFI_STATUS
+DebugLogStatusCodeInitializeWorker (
+  VOID
+  );
+
+/**
+  Write text to the debug log.
+
+  If the debug log is full, the oldest text is written to the serial port to
+  make room. If there is no debug log, the text is written to the serial port.
+
+  @param  Buffer           The text.
+  @param  NumberOfBytes    The number of bytes of the text.
+
+**/
+VOID
+DebugLogWrite (
+  IN UINT8  *Buffer,
+  IN UINTN  NumberOfBytes
+  );
+
+/**
+  Write all text of the debug log to the serial port.
+
+**/
+VOID
+DebugLogFlush (
+  VOID
+  );
+
+/**
+  Write all text of the debug log to the serial port, and write any later text
+  to the serial port directly.
+
+  This is called when boot services are exiting, after the memory map is
+  terminated. It therefore calls no boot services. The drain events are left
+  in place; they do nothing once the debug log is stopped.
+
+**/
+VOID
+DebugLogStop (
+  VOID
+  );
+
 /**
   Unregister status code callback functions only available at boot time from
   report status code router when exiting boot services.
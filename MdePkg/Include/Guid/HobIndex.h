@@ -0,0 +1,60 @@
+/** @file
+  GUID and data structure of the index of the GUID HOBs in the HOB list.
+
+  The index lets the HOB libraries find a GUID HOB with a binary search instead
+  of walking the whole HOB list. In DXE, the DXE Core installs the index in the
+  EFI System Configuration Table. In PEI, the PEI Core builds the index after the
+  HOB list has been migrated to permanent memory and installs it as a PPI.
+
+  Only the HOBs between HobList and IndexedEnd are indexed. HOBs created later
+  are appended at IndexedEnd and must still be found by walking the list from
+  there. A HOB may also be marked EFI_HOB_TYPE_UNUSED after the index is built,
+  so the type of an indexed HOB must be checked before it is returned.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __HOB_INDEX_GUID_H__
+#define __HOB_INDEX_GUID_H__
+
+#define EDKII_HOB_INDEX_GUID \
+  { \
+    0x7a0da020, 0xe1e9, 0x42ef, {0xa0, 0xb0, 0x70, 0x69, 0x5c, 0xa8, 0x12, 0xc9 } \
+  }
+
+typedef struct {
+  ///
+  /// The GUID of the GUID HOB.
+  ///
+  EFI_GUID                Name;
+  ///
+  /// The address of the GUID HOB.
+  ///
+  EFI_PHYSICAL_ADDRESS    Hob;
+} EDKII_HOB_INDEX_ENTRY;
+
+typedef struct {
+  ///
+  /// The number of entries that follow this structure.
+  ///
+  UINT64                  EntryCount;
+  ///
+  /// The address of the HOB list that is indexed.
+  ///
+  EFI_PHYSICAL_ADDRESS    HobList;
+  ///
+  /// The address of the end of the indexed HOBs.
+  ///
+  EFI_PHYSICAL_ADDRESS    IndexedEnd;
+  ///
+  /// EDKII_HOB_INDEX_ENTRY  Entry[EntryCount];
+  ///
+  /// The entries are sorted by the bytes of Name, and then by Hob.
+  ///
+} EDKII_HOB_INDEX;
+
+extern EFI_GUID  gEdkiiHobIndexGuid;
+
+#endif
@@ -41,6 +41,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define PERF_CROSSMODULE_START_ID  0x50
 #define PERF_CROSSMODULE_END_ID    0x51
 
+//
+// Identifier of a counter record. The record is not paired with any other
+// record, and it carries the counter value as binary data.
+//
+#define PERF_COUNTER_ID  0x60
+
 //
 // Declare bits for PcdPerformanceLibraryPropertyMask and
 // also used as the Type parameter of LogPerformanceMeasurementEnabled().
@@ -514,6 +520,23 @@ LogPerformanceMeasurement (
     } \
   } while (FALSE)
 
+/**
+  Macro to record the value of a counter at the time of this macro execution.
+  CounterString names the counter, and Value is kept as a 64-bit binary value
+  in the record instead of being formatted into the string.
+
+  If the PERFORMANCE_LIBRARY_PROPERTY_MEASUREMENT_ENABLED bit of PcdPerformanceLibraryPropertyMask is set,
+  and the BIT6 (disable PERF_GENERAL_TYPE) of PcdPerformanceLibraryPropertyMask is not set,
+  then LogPerformanceMeasurement() is called.
+
+**/
+#define PERF_COUNTER(CounterString, Value) \
+  do { \
+    if (LogPerformanceMeasurementEnabled (PERF_GENERAL_TYPE)) { \
+      LogPerformanceMeasurement (&gEfiCallerIdGuid, NULL, CounterString, Value, PERF_COUNTER_ID); \
+    } \
+  } while (FALSE)
+
 /**
   Begin Macro to measure the performance of evnent signal behavior in any module.
   The event guid will be passed with this macro.
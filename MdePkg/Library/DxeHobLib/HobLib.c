@@ -9,13 +9,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <PiDxe.h>
 
 #include <Guid/HobList.h>
+#include <Guid/HobIndex.h>
 
 #include <Library/HobLib.h>
 #include <Library/UefiLib.h>
 #include <Library/DebugLib.h>
 #include <Library/BaseMemoryLib.h>
 
-VOID  *mHobList = NULL;
+VOID             *mHobList  = NULL;
+EDKII_HOB_INDEX  *mHobIndex = NULL;
 
 /**
   Returns the pointer to the HOB list.
@@ -56,6 +58,9 @@ GetHobList (
   The constructor function caches the pointer to HOB list by calling GetHobList()
   and will always return EFI_SUCCESS.
 
+  It also caches the index of the GUID HOBs if the DXE Core has installed one for
+  this HOB list.
+
   @param  ImageHandle   The firmware allocated handle for the EFI image.
   @param  SystemTable   A pointer to the EFI System Table.
 
@@ -69,8 +74,19 @@ HobLibConstructor (
   IN EFI_SYSTEM_TABLE  *SystemTable
   )
 {
+  EFI_STATUS       Status;
+  EDKII_HOB_INDEX  *HobIndex;
+
   GetHobList ();
 
+  //
+  // The HOB list is read-only in DXE, so the index stays valid.
+  //
+  Status = EfiGetSystemConfigurationTable (&gEdkiiHobIndexGuid, (VOID **)&HobIndex);
+  if (!EFI_ERROR (Status) && (HobIndex->HobList == (UINTN)mHobList)) {
+    mHobIndex = HobIndex;
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -142,6 +158,55 @@ GetFirstHob (
   return GetNextHob (Type, HobList);
 }
 
+/**
+  Returns the first GUID HOB with the GUID at or after HobStart in the index.
+
+  @param  Index         The index of the GUID HOBs.
+  @param  Guid          The GUID to match with in the HOB list.
+  @param  HobStart      A pointer to a HOB in the indexed part of the HOB list.
+
+  @return The first matched GUID HOB at or after HobStart among the indexed HOBs,
+          or NULL if there is none.
+
+**/
+STATIC
+VOID *
+FindIndexedGuidHob (
+  IN CONST EDKII_HOB_INDEX  *Index,
+  IN CONST EFI_GUID         *Guid,
+  IN CONST VOID             *HobStart
+  )
+{
+  CONST EDKII_HOB_INDEX_ENTRY  *Entry;
+  UINTN                        Low;
+  UINTN                        High;
+  UINTN                        Middle;
+  INTN                         Result;
+
+  Entry = (CONST EDKII_HOB_INDEX_ENTRY *)(Index + 1);
+  Low   = 0;
+  High  = (UINTN)Index->EntryCount;
+
+  //
+  // Find the first entry that does not sort before (Guid, HobStart).
+  //
+  while (Low < High) {
+    Middle = (Low + High) / 2;
+    Result = CompareMem (&Entry[Middle].Name, Guid, sizeof (EFI_GUID));
+    if ((Result < 0) || ((Result == 0) && (Entry[Middle].Hob < (UINTN)HobStart))) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low < Index->EntryCount) && CompareGuid (&Entry[Low].Name, Guid)) {
+    return (VOID *)(UINTN)Entry[Low].Hob;
+  }
+
+  return NULL;
+}
+
 /**
   Returns the next instance of the matched GUID HOB from the starting HOB.
 
@@ -174,6 +239,29 @@ GetNextGuidHob (
   EFI_PEI_HOB_POINTERS  GuidHob;
 
   GuidHob.Raw = (UINT8 *)HobStart;
+  if ((mHobIndex != NULL) &&
+      ((UINTN)HobStart >= mHobIndex->HobList) &&
+      ((UINTN)HobStart < mHobIndex->IndexedEnd))
+  {
+    GuidHob.Raw = FindIndexedGuidHob (mHobIndex, Guid, HobStart);
+    if (GuidHob.Raw != NULL) {
+      if (GuidHob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) {
+        return GuidHob.Raw;
+      }
+
+      //
+      // The HOB has been marked unused since the index was built, so walk the
+      // list from HobStart.
+      //
+      GuidHob.Raw = (UINT8 *)HobStart;
+    } else {
+      //
+      // Only the HOBs after the indexed ones are left to search.
+      //
+      GuidHob.Raw = (UINT8 *)(UINTN)mHobIndex->IndexedEnd;
+    }
+  }
+
   while ((GuidHob.Raw = GetNextHob (EFI_HOB_TYPE_GUID_EXTENSION, GuidHob.Raw)) != NULL) {
     if (CompareGuid (Guid, &GuidHob.Guid->Name)) {
       break;
@@ -9,12 +9,19 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <PiPei.h>
 
 #include <Guid/MemoryAllocationHob.h>
+#include <Guid/HobIndex.h>
 
 #include <Library/HobLib.h>
 #include <Library/DebugLib.h>
 #include <Library/PeiServicesLib.h>
 #include <Library/BaseMemoryLib.h>
 
+///
+/// The index of the GUID HOBs, cached only when the module runs from permanent
+/// memory, where its global variables are writable.
+///
+EDKII_HOB_INDEX  *mHobIndex = NULL;
+
 /**
   Returns the pointer to the HOB list.
 
@@ -115,6 +122,98 @@ GetFirstHob (
   return GetNextHob (Type, HobList);
 }
 
+/**
+  Returns the index of the GUID HOBs installed by the PEI Core.
+
+  @return The index of the GUID HOBs, or NULL if it is not installed yet or the
+          calling module does not run from permanent memory.
+
+**/
+EDKII_HOB_INDEX *
+GetHobIndex (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  EDKII_HOB_INDEX             *HobIndex;
+  EFI_HOB_HANDOFF_INFO_TABLE  *HandOffHob;
+
+  if (mHobIndex != NULL) {
+    return mHobIndex;
+  }
+
+  //
+  // The PEI Core installs the index after the HOB list is migrated to permanent
+  // memory. Before that the PHIT HOB describes the temporary memory, where no
+  // module runs from, so the callers before memory and the XIP modules skip the
+  // PPI lookup and walk the HOB list. The modules that run from permanent memory
+  // can write their global variable and look up the index once.
+  //
+  HandOffHob = (EFI_HOB_HANDOFF_INFO_TABLE *)GetHobList ();
+  if (((UINTN)&mHobIndex < HandOffHob->EfiMemoryBottom) ||
+      ((UINTN)&mHobIndex >= HandOffHob->EfiMemoryTop))
+  {
+    return NULL;
+  }
+
+  Status = PeiServicesLocatePpi (&gEdkiiHobIndexGuid, 0, NULL, (VOID **)&HobIndex);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  mHobIndex = HobIndex;
+  return mHobIndex;
+}
+
+/**
+  Returns the first GUID HOB with the GUID at or after HobStart in the index.
+
+  @param  Index         The index of the GUID HOBs.
+  @param  Guid          The GUID to match with in the HOB list.
+  @param  HobStart      A pointer to a HOB in the indexed part of the HOB list.
+
+  @return The first matched GUID HOB at or after HobStart among the indexed HOBs,
+          or NULL if there is none.
+
+**/
+STATIC
+VOID *
+FindIndexedGuidHob (
+  IN CONST EDKII_HOB_INDEX  *Index,
+  IN CONST EFI_GUID         *Guid,
+  IN CONST VOID             *HobStart
+  )
+{
+  CONST EDKII_HOB_INDEX_ENTRY  *Entry;
+  UINTN                        Low;
+  UINTN                        High;
+  UINTN                        Middle;
+  INTN                         Result;
+
+  Entry = (CONST EDKII_HOB_INDEX_ENTRY *)(Index + 1);
+  Low   = 0;
+  High  = (UINTN)Index->EntryCount;
+
+  //
+  // Find the first entry that does not sort before (Guid, HobStart).
+  //
+  while (Low < High) {
+    Middle = (Low + High) / 2;
+    Result = CompareMem (&Entry[Middle].Name, Guid, sizeof (EFI_GUID));
+    if ((Result < 0) || ((Result == 0) && (Entry[Middle].Hob < (UINTN)HobStart))) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low < Index->EntryCount) && CompareGuid (&Entry[Low].Name, Guid)) {
+    return (VOID *)(UINTN)Entry[Low].Hob;
+  }
+
+  return NULL;
+}
+
 /**
   Returns the next instance of the matched GUID HOB from the starting HOB.
 
@@ -145,8 +244,33 @@ GetNextGuidHob (
   )
 {
   EFI_PEI_HOB_POINTERS  GuidHob;
+  EDKII_HOB_INDEX       *HobIndex;
 
   GuidHob.Raw = (UINT8 *)HobStart;
+  HobIndex    = GetHobIndex ();
+  if ((HobIndex != NULL) &&
+      ((UINTN)HobStart >= HobIndex->HobList) &&
+      ((UINTN)HobStart < HobIndex->IndexedEnd))
+  {
+    GuidHob.Raw = FindIndexedGuidHob (HobIndex, Guid, HobStart);
+    if (GuidHob.Raw != NULL) {
+      if (GuidHob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) {
+        return GuidHob.Raw;
+      }
+
+      //
+      // The HOB has been marked unused since the index was built, so walk the
+      // list from HobStart.
+      //
+      GuidHob.Raw = (UINT8 *)HobStart;
+    } else {
+      //
+      // Only the HOBs created after the index was built are left to search.
+      //
+      GuidHob.Raw = (UINT8 *)(UINTN)HobIndex->IndexedEnd;
+    }
+  }
+
   while ((GuidHob.Raw = GetNextHob (EFI_HOB_TYPE_GUID_EXTENSION, GuidHob.Raw)) != NULL) {
     if (CompareGuid (Guid, &GuidHob.Guid->Name)) {
       break;
@@ -512,14 +512,18 @@ IScsiCHAPToSendReq (
     case ISCSI_AUTH_INITIAL:
       //
       // It's the initial Login Request. Fill in the key=value pairs mandatory
-      // for the initial Login Request.
+      // for the initial Login Request. SessionType is only sent on the leading
+      // connection of a session.
       //
       IScsiAddKeyValuePair (
         Pdu,
         ISCSI_KEY_INITIATOR_NAME,
         mPrivate->InitiatorName
         );
-      IScsiAddKeyValuePair (Pdu, ISCSI_KEY_SESSION_TYPE, "Normal");
+      if (Conn->Leading) {
+        IScsiAddKeyValuePair (Pdu, ISCSI_KEY_SESSION_TYPE, "Normal");
+      }
+
       IScsiAddKeyValuePair (
         Pdu,
         ISCSI_KEY_TARGET_NAME,
@@ -90,17 +90,23 @@ IScsiExtScsiPassThruFunction (
     return EFI_INVALID_PARAMETER;
   }
 
-  Status = IScsiExecuteScsiCommand (This, Target, Lun, Packet);
-  if ((Status != EFI_SUCCESS) && (Status != EFI_NOT_READY)) {
+  Status = IScsiExecuteScsiCommand (This, Target, Lun, Packet, Event);
+  if ((Status != EFI_SUCCESS) && (Status != EFI_NOT_READY) && (Status != EFI_BAD_BUFFER_SIZE)) {
     //
-    // Try to reinstate the session and re-execute the Scsi command.
+    // Try to reinstate the session and re-execute the Scsi command. The login
+    // cannot be done above TPL_CALLBACK, where non-blocking requests may come
+    // from the event notify functions of their callers.
     //
+    if (EfiGetCurrentTpl () > TPL_CALLBACK) {
+      return EFI_DEVICE_ERROR;
+    }
+
     Private = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (This);
     if (EFI_ERROR (IScsiSessionReinstatement (Private->Session))) {
       return EFI_DEVICE_ERROR;
     }
 
-    Status = IScsiExecuteScsiCommand (This, Target, Lun, Packet);
+    Status = IScsiExecuteScsiCommand (This, Target, Lun, Packet, Event);
   }
 
   return Status;
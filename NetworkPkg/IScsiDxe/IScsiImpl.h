@@ -107,6 +107,15 @@ struct _ISCSI_SESSION {
 
   LIST_ENTRY                     TcbList;
 
+  //
+  // Non-blocking commands waiting for room in the command window, and the timer
+  // that sends them and processes the PDUs received for them. Dispatching is set
+  // while a blocking request or the timer uses the connections.
+  //
+  LIST_ENTRY                     PendingTcbList;
+  EFI_EVENT                      DispatchEvent;
+  BOOLEAN                        Dispatching;
+
   //
   // Session-wide parameters
   //
@@ -131,8 +140,10 @@ struct _ISCSI_CONNECTION {
   LIST_ENTRY           Link;
 
   EFI_EVENT            TimeoutEvent;
+  EFI_EVENT            PollEvent;
 
   ISCSI_SESSION        *Session;
+  BOOLEAN              Leading;
 
   UINT8                State;
   UINT8                CurrentStage;
@@ -223,6 +223,11 @@ IScsiCreateConnection (
   Conn->Cid             = Session->NextCid++;
   Conn->Ipv6Flag        = NvData->IpMode == IP_MODE_IP6 || Session->ConfigData->AutoConfigureMode == IP_MODE_AUTOCONFIG_IP6;
 
+  //
+  // The first connection of the session carries the leading login.
+  //
+  Conn->Leading = IsListEmpty (&Session->Conns);
+
   Status = gBS->CreateEvent (
                   EVT_TIMER,
                   TPL_CALLBACK,
@@ -235,6 +240,23 @@ IScsiCreateConnection (
     return NULL;
   }
 
+  //
+  // The poll event is signaled before each non-blocking receive, so that the
+  // receive returns at once when no data has arrived.
+  //
+  Status = gBS->CreateEvent (
+                  EVT_TIMER,
+                  TPL_CALLBACK,
+                  NULL,
+                  NULL,
+                  &Conn->PollEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (Conn->TimeoutEvent);
+    FreePool (Conn);
+    return NULL;
+  }
+
   NetbufQueInit (&Conn->RspQue);
 
   //
@@ -256,6 +278,8 @@ IScsiCreateConnection (
 
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "The configuration of Target address or DNS server address is invalid!\n"));
+      gBS->CloseEvent (Conn->PollEvent);
+      gBS->CloseEvent (Conn->TimeoutEvent);
       FreePool (Conn);
       return NULL;
     }
@@ -292,6 +316,7 @@ IScsiCreateConnection (
              &Conn->TcpIo
              );
   if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (Conn->PollEvent);
     gBS->CloseEvent (Conn->TimeoutEvent);
     FreePool (Conn);
     Conn = NULL;
@@ -314,6 +339,7 @@ IScsiDestroyConnection (
   TcpIoDestroySocket (&Conn->TcpIo);
 
   NetbufQueFlush (&Conn->RspQue);
+  gBS->CloseEvent (Conn->PollEvent);
   gBS->CloseEvent (Conn->TimeoutEvent);
   FreePool (Conn);
 }
@@ -419,10 +445,8 @@ ON_EXIT:
 
 /**
   Re-set any stateful session-level authentication information that is used by
-  the leading login / leading connection.
-
-  (Note that this driver only supports a single connection per session -- see
-  ISCSI_MAX_CONNS_PER_SESSION.)
+  the login of a connection. The connections of a session log in one after the
+  other, so the state is reset before each of them.
 
   @param[in,out] Session  The iSCSI session.
 **/
@@ -437,6 +461,65 @@ IScsiSessionResetAuthData (
   }
 }
 
+/**
+  Add a connection to an iSCSI session that is logged in.
+
+  @param[in]  Session           The iSCSI session.
+
+  @retval EFI_SUCCESS           The new connection is logged in and attached to
+                                the session.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate memory.
+  @retval Others                Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiSessionAddConnection (
+  IN ISCSI_SESSION  *Session
+  )
+{
+  EFI_STATUS        Status;
+  ISCSI_CONNECTION  *Conn;
+  VOID              *Tcp;
+  EFI_GUID          *ProtocolGuid;
+
+  ASSERT (Session->State == SESSION_STATE_LOGGED_IN);
+
+  Conn = IScsiCreateConnection (Session);
+  if (Conn == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  IScsiAttatchConnection (Session, Conn);
+
+  IScsiSessionResetAuthData (Session);
+  Status = IScsiConnLogin (Conn, Session->ConfigData->SessionConfigData.ConnectTimeout);
+  if (EFI_ERROR (Status)) {
+    IScsiConnReset (Conn);
+    IScsiDetatchConnection (Conn);
+    IScsiDestroyConnection (Conn);
+    return Status;
+  }
+
+  if (!Conn->Ipv6Flag) {
+    ProtocolGuid = &gEfiTcp4ProtocolGuid;
+  } else {
+    ProtocolGuid = &gEfiTcp6ProtocolGuid;
+  }
+
+  Status = gBS->OpenProtocol (
+                  Conn->TcpIo.Handle,
+                  ProtocolGuid,
+                  (VOID **)&Tcp,
+                  Session->Private->Image,
+                  Session->Private->ExtScsiPassThruHandle,
+                  EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                  );
+
+  ASSERT_EFI_ERROR (Status);
+
+  return Status;
+}
+
 /**
   Login the iSCSI session.
 
@@ -459,6 +542,7 @@ IScsiSessionLogin (
   EFI_GUID          *ProtocolGuid;
   UINT8             RetryCount;
   EFI_STATUS        MediaStatus;
+  EFI_STATUS        ConnStatus;
 
   //
   // Check media status before session login.
@@ -530,6 +614,21 @@ IScsiSessionLogin (
     }
   }
 
+  if (!EFI_ERROR (Status)) {
+    //
+    // Add the other connections the target accepted for this session. The
+    // session works with the leading connection alone, so a connection that
+    // fails to login is only left out.
+    //
+    while (Session->NumConns < Session->MaxConnections) {
+      ConnStatus = IScsiSessionAddConnection (Session);
+      if (EFI_ERROR (ConnStatus)) {
+        DEBUG ((DEBUG_WARN, "iSCSI: Session continues with %d connection(s), %r\n", Session->NumConns, ConnStatus));
+        break;
+      }
+    }
+  }
+
   return Status;
 }
 
@@ -640,7 +739,7 @@ IScsiReceiveLoginRsp (
   //
   // Receive the iSCSI login response.
   //
-  Status = IScsiReceivePdu (Conn, &Pdu, NULL, FALSE, FALSE, NULL);
+  Status = IScsiReceivePdu (Conn, &Pdu, NULL, FALSE, FALSE, NULL, FALSE);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -916,7 +1015,11 @@ IScsiProcessLoginRsp (
       //
       // The target may be moved to a different address.
       //
-      if (DataSeg == NULL) {
+      if ((DataSeg == NULL) || !Conn->Leading) {
+        //
+        // Only the leading login follows a redirection. The target address of
+        // a session is not changed by the login of an added connection.
+        //
         return EFI_PROTOCOL_ERROR;
       }
 
@@ -987,11 +1090,16 @@ IScsiProcessLoginRsp (
 
     //
     // It's the initial Login Response, initialize the local ExpStatSN, MaxCmdSN
-    // and ExpCmdSN.
+    // and ExpCmdSN. A connection added to the session only updates the session
+    // sequence numbers.
     //
-    Conn->ExpStatSN   = LoginRsp->StatSN + 1;
-    Session->MaxCmdSN = LoginRsp->MaxCmdSN;
-    Session->ExpCmdSN = LoginRsp->ExpCmdSN;
+    Conn->ExpStatSN = LoginRsp->StatSN + 1;
+    if (Conn->Leading) {
+      Session->MaxCmdSN = LoginRsp->MaxCmdSN;
+      Session->ExpCmdSN = LoginRsp->ExpCmdSN;
+    } else {
+      IScsiUpdateCmdSN (Session, LoginRsp->MaxCmdSN, LoginRsp->ExpCmdSN);
+    }
   } else {
     //
     // Check the StatSN of this PDU.
@@ -1283,6 +1391,101 @@ IScsiNbufExtFree (
 {
 }
 
+/**
+  Find the task control block of an outstanding SCSI command by the initiator
+  task tag of a PDU received for it.
+
+  @param[in]  Conn              The connection on which the PDU is received.
+  @param[in]  InitiatorTaskTag  The initiator task tag in the PDU.
+
+  @return The task control block, or NULL if no command outstanding on this
+          connection has this initiator task tag.
+
+**/
+ISCSI_TCB *
+IScsiFindTcb (
+  IN ISCSI_CONNECTION  *Conn,
+  IN UINT32            InitiatorTaskTag
+  )
+{
+  LIST_ENTRY  *Entry;
+  ISCSI_TCB   *Tcb;
+
+  NET_LIST_FOR_EACH (Entry, &Conn->Session->TcbList) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, ISCSI_TCB, Link);
+    if ((Tcb->InitiatorTaskTag == InitiatorTaskTag) && (Tcb->Conn == Conn)) {
+      return Tcb;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Receive the header segment of an iSCSI PDU, only if the PDU has started to
+  arrive. The first byte is received without waiting, so nothing is taken from
+  the connection when no PDU is there.
+
+  @param[in]  Conn          The iSCSI connection to receive data from.
+  @param[out] Header        The buffer to receive the header segment.
+  @param[in]  Len           The length of the header segment.
+  @param[in]  TimeoutEvent  The timeout event for the rest of the header. It is
+                            optional.
+
+  @retval EFI_SUCCESS          The header segment is received.
+  @retval EFI_NOT_READY        No PDU has started to arrive.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiPollPduHeader (
+  IN  ISCSI_CONNECTION  *Conn,
+  OUT UINT8             *Header,
+  IN  UINT32            Len,
+  IN  EFI_EVENT         TimeoutEvent OPTIONAL
+  )
+{
+  NET_FRAGMENT  Fragment;
+  NET_BUF       *Nbuf;
+  EFI_STATUS    Status;
+
+  Fragment.Len  = 1;
+  Fragment.Bulk = Header;
+  Nbuf          = NetbufFromExt (&Fragment, 1, 0, 0, IScsiNbufExtFree, NULL);
+  if (Nbuf == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // With the poll event signaled, TcpIoReceive() only takes what the TCP
+  // instance has already received.
+  //
+  gBS->SignalEvent (Conn->PollEvent);
+  Status = TcpIoReceive (&Conn->TcpIo, Nbuf, FALSE, Conn->PollEvent);
+  NetbufFree (Nbuf);
+
+  if (Status == EFI_TIMEOUT) {
+    return EFI_NOT_READY;
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Fragment.Len  = Len - 1;
+  Fragment.Bulk = Header + 1;
+  Nbuf          = NetbufFromExt (&Fragment, 1, 0, 0, IScsiNbufExtFree, NULL);
+  if (Nbuf == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = TcpIoReceive (&Conn->TcpIo, Nbuf, FALSE, TimeoutEvent);
+  NetbufFree (Nbuf);
+
+  return Status;
+}
+
 /**
   Receive an iSCSI response PDU. An iSCSI response PDU contains an iSCSI PDU header and
   an optional data segment. The two parts will be put into two blocks of buffers in the
@@ -1296,8 +1499,10 @@ IScsiNbufExtFree (
   @param[in]  HeaderDigest Whether there will be header digest received.
   @param[in]  DataDigest   Whether there will be data digest.
   @param[in]  TimeoutEvent The timeout event. It is optional.
+  @param[in]  Poll         Return at once if no PDU has started to arrive.
 
   @retval EFI_SUCCESS          An iSCSI pdu is received.
+  @retval EFI_NOT_READY        Poll is TRUE and no PDU has started to arrive.
   @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
   @retval EFI_PROTOCOL_ERROR   Some kind of iSCSI protocol error occurred.
   @retval Others               Other errors as indicated.
@@ -1310,7 +1515,8 @@ IScsiReceivePdu (
   IN ISCSI_IN_BUFFER_CONTEXT  *Context  OPTIONAL,
   IN BOOLEAN                  HeaderDigest,
   IN BOOLEAN                  DataDigest,
-  IN EFI_EVENT                TimeoutEvent OPTIONAL
+  IN EFI_EVENT                TimeoutEvent OPTIONAL,
+  IN BOOLEAN                  Poll
   )
 {
   LIST_ENTRY    *NbufList;
@@ -1324,6 +1530,7 @@ IScsiReceivePdu (
   UINT32        FragmentCount;
   NET_BUF       *DataSeg;
   UINT32        PadAndCRC32[2];
+  ISCSI_TCB     *Tcb;
 
   NbufList = AllocatePool (sizeof (LIST_ENTRY));
   if (NbufList == NULL) {
@@ -1353,7 +1560,11 @@ IScsiReceivePdu (
   //
   // First step, receive the BHS of the PDU.
   //
-  Status = TcpIoReceive (&Conn->TcpIo, PduHdr, FALSE, TimeoutEvent);
+  if (!Poll) {
+    Status = TcpIoReceive (&Conn->TcpIo, PduHdr, FALSE, TimeoutEvent);
+  } else {
+    Status = IScsiPollPduHeader (Conn, Header, Len, TimeoutEvent);
+  }
 
   if (EFI_ERROR (Status)) {
     goto ON_EXIT;
@@ -1386,8 +1597,16 @@ IScsiReceivePdu (
     case ISCSI_OPCODE_SCSI_DATA_IN:
       //
       // To reduce memory copy overhead, try to use the buffer described by Context
-      // if the PDU is an iSCSI SCSI data.
+      // if the PDU is an iSCSI SCSI data. Without a Context, use the buffer of the
+      // outstanding command the PDU belongs to.
       //
+      if (Context == NULL) {
+        Tcb = IScsiFindTcb (Conn, NTOHL (((ISCSI_BASIC_HEADER *)Header)->InitiatorTaskTag));
+        if (Tcb != NULL) {
+          Context = &Tcb->InBufferContext;
+        }
+      }
+
       InDataOffset = ISCSI_GET_BUFFER_OFFSET (Header);
       if ((Context == NULL) || ((InDataOffset + Len) > Context->InDataLen)) {
         Status = EFI_PROTOCOL_ERROR;
@@ -1573,6 +1792,26 @@ IScsiCheckOpParams (
     goto ON_ERROR;
   }
 
+  //
+  // MaxRecvDataSegmentLength is declarative.
+  //
+  Value = IScsiGetValueByKeyFromList (KeyValueList, ISCSI_KEY_MAX_RECV_DATA_SEGMENT_LENGTH);
+  if (Value != NULL) {
+    NumericValue = IScsiNetNtoi (Value);
+    if ((NumericValue < MIN_RECV_DATA_SEG_LEN) || (NumericValue > MAX_RECV_DATA_SEG_LEN)) {
+      goto ON_ERROR;
+    }
+
+    Conn->MaxRecvDataSegmentLength = (UINT32)NumericValue;
+  }
+
+  if (!Conn->Leading) {
+    //
+    // The session-wide keys are negotiated by the leading login only.
+    //
+    goto ON_DECLARATIVE;
+  }
+
   //
   // ErrorRecoveryLevel: result function is Minimum.
   //
@@ -1610,14 +1849,6 @@ IScsiCheckOpParams (
 
   Session->ImmediateData = (BOOLEAN)(Session->ImmediateData && (BOOLEAN)(AsciiStrCmp (Value, "Yes") == 0));
 
-  //
-  // MaxRecvDataSegmentLength is declarative.
-  //
-  Value = IScsiGetValueByKeyFromList (KeyValueList, ISCSI_KEY_MAX_RECV_DATA_SEGMENT_LENGTH);
-  if (Value != NULL) {
-    Conn->MaxRecvDataSegmentLength = (UINT32)IScsiNetNtoi (Value);
-  }
-
   //
   // MaxBurstLength: result function is Minimum.
   //
@@ -1731,6 +1962,7 @@ IScsiCheckOpParams (
 
   Session->MaxOutstandingR2T = (UINT16)MIN (Session->MaxOutstandingR2T, NumericValue);
 
+ON_DECLARATIVE:
   //
   // Remove declarative key-value pairs, if any.
   //
@@ -1792,6 +2024,16 @@ IScsiFillOpParams (
   AsciiSPrint (Value, sizeof (Value), "%a", (Conn->DataDigest == IScsiDigestCRC32) ? "None,CRC32" : "None");
   IScsiAddKeyValuePair (Pdu, ISCSI_KEY_DATA_DIGEST, Value);
 
+  AsciiSPrint (Value, sizeof (Value), "%d", MAX_RECV_DATA_SEG_LEN_IN_FFP);
+  IScsiAddKeyValuePair (Pdu, ISCSI_KEY_MAX_RECV_DATA_SEGMENT_LENGTH, Value);
+
+  if (!Conn->Leading) {
+    //
+    // The leading-only keys must not be sent on a connection added to a session.
+    //
+    return;
+  }
+
   AsciiSPrint (Value, sizeof (Value), "%d", Session->ErrorRecoveryLevel);
   IScsiAddKeyValuePair (Pdu, ISCSI_KEY_ERROR_RECOVERY_LEVEL, Value);
 
@@ -1801,9 +2043,6 @@ IScsiFillOpParams (
   AsciiSPrint (Value, sizeof (Value), "%a", Session->ImmediateData ? "Yes" : "No");
   IScsiAddKeyValuePair (Pdu, ISCSI_KEY_IMMEDIATE_DATA, Value);
 
-  AsciiSPrint (Value, sizeof (Value), "%d", MAX_RECV_DATA_SEG_LEN_IN_FFP);
-  IScsiAddKeyValuePair (Pdu, ISCSI_KEY_MAX_RECV_DATA_SEGMENT_LENGTH, Value);
-
   AsciiSPrint (Value, sizeof (Value), "%d", Session->MaxBurstLength);
   IScsiAddKeyValuePair (Pdu, ISCSI_KEY_MAX_BURST_LENGTH, Value);
 
@@ -2044,60 +2283,52 @@ IScsiNormalizeName (
 }
 
 /**
-  Create an iSCSI task control block.
+  Create an iSCSI task control block for a SCSI request. The task is not
+  numbered nor linked into any list yet.
 
-  @param[in]   Conn           The connection on which the task control block will be created.
-  @param[out]  Tcb            The newly created task control block.
+  @param[in]  Packet  The EXT SCSI PASS THRU request packet.
+  @param[in]  Lun     The LUN.
+  @param[in]  Event   The event to signal when a non-blocking request completes,
+                      or NULL for a blocking request.
 
-  @retval EFI_SUCCESS          The task control block is created.
-  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
-  @retval EFI_NOT_READY        The target cannot accept new commands.
+  @return The newly created task control block, or NULL if failed to allocate
+          memory.
 
 **/
-EFI_STATUS
+ISCSI_TCB *
 IScsiNewTcb (
-  IN  ISCSI_CONNECTION  *Conn,
-  OUT ISCSI_TCB         **Tcb
+  IN EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN UINT64                                      Lun,
+  IN EFI_EVENT                                   Event  OPTIONAL
   )
 {
-  ISCSI_SESSION  *Session;
-  ISCSI_TCB      *NewTcb;
-
-  ASSERT (Tcb != NULL);
-
-  Session = Conn->Session;
-
-  if (ISCSI_SEQ_GT (Session->CmdSN, Session->MaxCmdSN)) {
-    return EFI_NOT_READY;
-  }
+  ISCSI_TCB  *NewTcb;
 
   NewTcb = AllocateZeroPool (sizeof (ISCSI_TCB));
   if (NewTcb == NULL) {
-    return EFI_OUT_OF_RESOURCES;
+    return NULL;
   }
 
   InitializeListHead (&NewTcb->Link);
 
-  NewTcb->SoFarInOrder     = TRUE;
-  NewTcb->InitiatorTaskTag = Session->InitiatorTaskTag;
-  NewTcb->CmdSN            = Session->CmdSN;
-  NewTcb->Conn             = Conn;
-
-  InsertTailList (&Session->TcbList, &NewTcb->Link);
+  NewTcb->SoFarInOrder = TRUE;
+  NewTcb->Packet       = Packet;
+  NewTcb->Lun          = Lun;
+  NewTcb->Event        = Event;
+  NewTcb->Status       = EFI_SUCCESS;
 
-  //
-  // Advance the initiator task tag.
-  //
-  Session->InitiatorTaskTag++;
-  Session->CmdSN++;
+  NewTcb->InBufferContext.InData    = (UINT8 *)Packet->InDataBuffer;
+  NewTcb->InBufferContext.InDataLen = Packet->InTransferLength;
 
-  *Tcb = NewTcb;
+  if (Packet->Timeout != 0) {
+    NewTcb->TimeoutRemain = MultU64x32 (Packet->Timeout, 4);
+  }
 
-  return EFI_SUCCESS;
+  return NewTcb;
 }
 
 /**
-  Delete the tcb from the connection and destroy it.
+  Delete the tcb from the list it is linked into and destroy it.
 
   @param[in]  Tcb The tcb to delete.
 
@@ -2112,6 +2343,28 @@ IScsiDelTcb (
   FreePool (Tcb);
 }
 
+/**
+  Finish a non-blocking SCSI request: destroy its task control block and signal
+  the event of the caller. The result is already in the request packet.
+
+  @param[in]  Tcb The tcb of the non-blocking request.
+
+**/
+VOID
+IScsiCompleteTcb (
+  IN ISCSI_TCB  *Tcb
+  )
+{
+  EFI_EVENT  Event;
+
+  ASSERT (Tcb->Event != NULL);
+
+  Event = Tcb->Event;
+  IScsiDelTcb (Tcb);
+
+  gBS->SignalEvent (Event);
+}
+
 /**
   Create a data segment, pad it, and calculate the CRC if needed.
 
@@ -2841,7 +3094,7 @@ IScsiOnScsiRspRcvd (
   Process the received NOP In PDU.
 
   @param[in]  Pdu            The NOP In PDU received.
-  @param[in]  Tcb            The task control block.
+  @param[in]  Conn           The connection on which the PDU is received.
 
   @retval EFI_SUCCESS        The NOP In PDU is processed and the related sequence
                              numbers are updated.
@@ -2850,8 +3103,8 @@ IScsiOnScsiRspRcvd (
 **/
 EFI_STATUS
 IScsiOnNopInRcvd (
-  IN NET_BUF    *Pdu,
-  IN ISCSI_TCB  *Tcb
+  IN NET_BUF           *Pdu,
+  IN ISCSI_CONNECTION  *Conn
   )
 {
   ISCSI_NOP_IN  *NopInHdr;
@@ -2867,103 +3120,62 @@ IScsiOnNopInRcvd (
   NopInHdr->MaxCmdSN = NTOHL (NopInHdr->MaxCmdSN);
 
   if (NopInHdr->InitiatorTaskTag == ISCSI_RESERVED_TAG) {
-    if (NopInHdr->StatSN != Tcb->Conn->ExpStatSN) {
+    if (NopInHdr->StatSN != Conn->ExpStatSN) {
       return EFI_PROTOCOL_ERROR;
     }
   } else {
-    Status = IScsiCheckSN (&Tcb->Conn->ExpStatSN, NopInHdr->StatSN);
+    Status = IScsiCheckSN (&Conn->ExpStatSN, NopInHdr->StatSN);
     if (EFI_ERROR (Status)) {
       return Status;
     }
   }
 
-  IScsiUpdateCmdSN (Tcb->Conn->Session, NopInHdr->MaxCmdSN, NopInHdr->ExpCmdSN);
+  IScsiUpdateCmdSN (Conn->Session, NopInHdr->MaxCmdSN, NopInHdr->ExpCmdSN);
 
   return EFI_SUCCESS;
 }
 
 /**
-  Execute the SCSI command issued through the EXT SCSI PASS THRU protocol.
+  Send the SCSI Command PDU of a task, and the unsolicited Data-Out PDUs that
+  may follow it, on the connection of the task.
 
-  @param[in]       PassThru  The EXT SCSI PASS THRU protocol.
-  @param[in]       Target    The target ID.
-  @param[in]       Lun       The LUN.
-  @param[in, out]  Packet    The request packet containing IO request, SCSI command
-                             buffer and buffers to read/write.
+  @param[in]  Tcb              The task control block.
 
-  @retval EFI_SUCCESS          The SCSI command is executed and the result is updated to
-                               the Packet.
-  @retval EFI_DEVICE_ERROR     Session state was not as required.
+  @retval EFI_SUCCESS          The SCSI command is sent.
   @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
   @retval EFI_PROTOCOL_ERROR   There is no such data in the net buffer.
-  @retval EFI_NOT_READY        The target can not accept new commands.
   @retval Others               Other errors as indicated.
 
 **/
 EFI_STATUS
-IScsiExecuteScsiCommand (
-  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL                 *PassThru,
-  IN UINT8                                           *Target,
-  IN UINT64                                          Lun,
-  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet
+IScsiSendScsiCmd (
+  IN ISCSI_TCB  *Tcb
   )
 {
-  EFI_STATUS               Status;
-  ISCSI_DRIVER_DATA        *Private;
-  ISCSI_SESSION            *Session;
-  EFI_EVENT                TimeoutEvent;
-  ISCSI_CONNECTION         *Conn;
-  ISCSI_TCB                *Tcb;
-  NET_BUF                  *Pdu;
-  ISCSI_XFER_CONTEXT       *XferContext;
-  UINT8                    *Data;
-  ISCSI_IN_BUFFER_CONTEXT  InBufferContext;
-  UINT64                   Timeout;
-  UINT8                    *PduHdr;
-
-  Private      = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (PassThru);
-  Session      = Private->Session;
-  Status       = EFI_SUCCESS;
-  Tcb          = NULL;
-  TimeoutEvent = NULL;
-  Timeout      = 0;
-
-  if (Session->State != SESSION_STATE_LOGGED_IN) {
-    Status = EFI_DEVICE_ERROR;
-    goto ON_EXIT;
-  }
-
-  Conn = NET_LIST_USER_STRUCT_S (
-           Session->Conns.ForwardLink,
-           ISCSI_CONNECTION,
-           Link,
-           ISCSI_CONNECTION_SIGNATURE
-           );
-
-  if (Packet->Timeout != 0) {
-    Timeout = MultU64x32 (Packet->Timeout, 4);
-  }
+  EFI_STATUS                                  Status;
+  ISCSI_SESSION                               *Session;
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet;
+  NET_BUF                                     *Pdu;
+  ISCSI_XFER_CONTEXT                          *XferContext;
+  UINT8                                       *Data;
+  UINT8                                       *PduHdr;
 
-  Status = IScsiNewTcb (Conn, &Tcb);
-  if (EFI_ERROR (Status)) {
-    goto ON_EXIT;
-  }
+  Session = Tcb->Conn->Session;
+  Packet  = Tcb->Packet;
 
   //
   // Encapsulate the SCSI request packet into an iSCSI SCSI Command PDU.
   //
-  Pdu = IScsiNewScsiCmdPdu (Packet, Lun, Tcb);
+  Pdu = IScsiNewScsiCmdPdu (Packet, Tcb->Lun, Tcb);
   if (Pdu == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ON_EXIT;
+    return EFI_OUT_OF_RESOURCES;
   }
 
   XferContext = &Tcb->XferContext;
   PduHdr      = NetbufGetByte (Pdu, 0, NULL);
   if (PduHdr == NULL) {
-    Status = EFI_PROTOCOL_ERROR;
     NetbufFree (Pdu);
-    goto ON_EXIT;
+    return EFI_PROTOCOL_ERROR;
   }
 
   XferContext->Offset = ISCSI_GET_DATASEG_LEN (PduHdr);
@@ -2971,12 +3183,12 @@ IScsiExecuteScsiCommand (
   //
   // Transmit the SCSI Command PDU.
   //
-  Status = TcpIoTransmit (&Conn->TcpIo, Pdu);
+  Status = TcpIoTransmit (&Tcb->Conn->TcpIo, Pdu);
 
   NetbufFree (Pdu);
 
   if (EFI_ERROR (Status)) {
-    goto ON_EXIT;
+    return Status;
   }
 
   if (!Session->InitialR2T &&
@@ -2995,78 +3207,543 @@ IScsiExecuteScsiCommand (
                                        );
 
     Data   = (UINT8 *)Packet->OutDataBuffer + XferContext->Offset;
-    Status = IScsiSendDataOutPduSequence (Data, Lun, Tcb);
-    if (EFI_ERROR (Status)) {
-      goto ON_EXIT;
-    }
+    Status = IScsiSendDataOutPduSequence (Data, Tcb->Lun, Tcb);
   }
 
-  InBufferContext.InData    = (UINT8 *)Packet->InDataBuffer;
-  InBufferContext.InDataLen = Packet->InTransferLength;
+  return Status;
+}
 
-  while (!Tcb->StatusXferd) {
-    //
-    // Start the timeout timer.
-    //
-    if (Timeout != 0) {
-      Status = gBS->SetTimer (Conn->TimeoutEvent, TimerRelative, Timeout);
-      if (EFI_ERROR (Status)) {
-        goto ON_EXIT;
-      }
+/**
+  Number a task with the next initiator task tag and CmdSN of the session, and
+  send its SCSI command. The connections of the session take the commands in
+  turn, and all the PDUs of a task use the connection it is sent on.
 
-      TimeoutEvent = Conn->TimeoutEvent;
-    }
+  @param[in]  Session          The iSCSI session.
+  @param[in]  Tcb              The task control block, not linked into any list.
 
+  @retval EFI_SUCCESS          The SCSI command is sent, and the task is linked into
+                               the outstanding task list of the session.
+  @retval EFI_NOT_READY        The command window of the target is closed. The task
+                               is left as it is.
+  @retval Others               Failed to send the SCSI command. The task is linked
+                               into the outstanding task list of the session.
+
+**/
+EFI_STATUS
+IScsiStartTcb (
+  IN ISCSI_SESSION  *Session,
+  IN ISCSI_TCB      *Tcb
+  )
+{
+  LIST_ENTRY  *Entry;
+  UINT32      Index;
+
+  //
+  // The target accepts the commands numbered up to MaxCmdSN.
+  //
+  if (ISCSI_SEQ_GT (Session->CmdSN, Session->MaxCmdSN)) {
+    return EFI_NOT_READY;
+  }
+
+  Entry = Session->Conns.ForwardLink;
+  for (Index = Session->CmdSN % Session->NumConns; Index > 0; Index--) {
+    Entry = Entry->ForwardLink;
+  }
+
+  Tcb->InitiatorTaskTag = Session->InitiatorTaskTag;
+  Tcb->CmdSN            = Session->CmdSN;
+  Tcb->Conn             = NET_LIST_USER_STRUCT_S (Entry, ISCSI_CONNECTION, Link, ISCSI_CONNECTION_SIGNATURE);
+
+  InsertTailList (&Session->TcbList, &Tcb->Link);
+
+  //
+  // Advance the initiator task tag.
+  //
+  Session->InitiatorTaskTag++;
+  Session->CmdSN++;
+
+  return IScsiSendScsiCmd (Tcb);
+}
+
+/**
+  Receive a PDU on a connection, and process it for the outstanding SCSI command
+  it belongs to. A non-blocking command is finished when its status arrives.
+
+  @param[in]  Conn             The iSCSI connection to receive the PDU from.
+  @param[in]  TimeoutEvent     The timeout event. It is optional.
+  @param[in]  Poll             Return at once if no PDU has started to arrive.
+
+  @retval EFI_SUCCESS          A PDU is received and processed.
+  @retval EFI_NOT_READY        Poll is TRUE and no PDU has started to arrive.
+  @retval EFI_PROTOCOL_ERROR   Some kind of iSCSI protocol error occurred.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiDispatchPdu (
+  IN ISCSI_CONNECTION  *Conn,
+  IN EFI_EVENT         TimeoutEvent OPTIONAL,
+  IN BOOLEAN           Poll
+  )
+{
+  EFI_STATUS  Status;
+  NET_BUF     *Pdu;
+  UINT8       *PduHdr;
+  UINT8       Opcode;
+  ISCSI_TCB   *Tcb;
+
+  Status = IScsiReceivePdu (Conn, &Pdu, NULL, FALSE, FALSE, TimeoutEvent, Poll);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  PduHdr = NetbufGetByte (Pdu, 0, NULL);
+  if (PduHdr == NULL) {
+    NetbufFree (Pdu);
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  Opcode = ISCSI_GET_OPCODE (PduHdr);
+  Tcb    = NULL;
+
+  if ((Opcode == ISCSI_OPCODE_SCSI_DATA_IN) ||
+      (Opcode == ISCSI_OPCODE_R2T) ||
+      (Opcode == ISCSI_OPCODE_SCSI_RSP)
+      )
+  {
+    Tcb = IScsiFindTcb (Conn, NTOHL (((ISCSI_BASIC_HEADER *)PduHdr)->InitiatorTaskTag));
+    if (Tcb == NULL) {
+      NetbufFree (Pdu);
+      return EFI_PROTOCOL_ERROR;
+    }
+  }
+
+  switch (Opcode) {
+    case ISCSI_OPCODE_SCSI_DATA_IN:
+      Status = IScsiOnDataInRcvd (Pdu, Tcb, Tcb->Packet);
+      break;
+
+    case ISCSI_OPCODE_R2T:
+      Status = IScsiOnR2TRcvd (Pdu, Tcb, Tcb->Lun, Tcb->Packet);
+      break;
+
+    case ISCSI_OPCODE_SCSI_RSP:
+      Status = IScsiOnScsiRspRcvd (Pdu, Tcb, Tcb->Packet);
+      break;
+
+    case ISCSI_OPCODE_NOP_IN:
+      Status = IScsiOnNopInRcvd (Pdu, Conn);
+      break;
+
+    case ISCSI_OPCODE_VENDOR_T0:
+    case ISCSI_OPCODE_VENDOR_T1:
+    case ISCSI_OPCODE_VENDOR_T2:
+      //
+      // These messages are vendor specific. Skip them.
+      //
+      break;
+
+    default:
+      Status = EFI_PROTOCOL_ERROR;
+      break;
+  }
+
+  NetbufFree (Pdu);
+
+  if ((Tcb == NULL) || !Tcb->StatusXferd) {
+    return Status;
+  }
+
+  //
+  // The status of the command has arrived. An overflow is the result of this
+  // command only; any other error fails the session.
+  //
+  if (Status == EFI_BAD_BUFFER_SIZE) {
+    Tcb->Status = Status;
+    Status      = EFI_SUCCESS;
+  }
+
+  if (!EFI_ERROR (Status) && (Tcb->Event != NULL)) {
+    IScsiCompleteTcb (Tcb);
+  }
+
+  return Status;
+}
+
+/**
+  Send the queued non-blocking SCSI commands, as many as the command window of
+  the target allows. It runs at TPL_CALLBACK.
+
+  @param[in]  Session          The iSCSI session.
+
+  @retval EFI_SUCCESS          The queued commands that fit in the window are sent.
+  @retval Others               Failed to send a command. The session has to be
+                               aborted.
+
+**/
+EFI_STATUS
+IScsiSubmitPendingTcbs (
+  IN ISCSI_SESSION  *Session
+  )
+{
+  EFI_STATUS  Status;
+  EFI_TPL     OldTpl;
+  ISCSI_TCB   *Tcb;
+
+  while (!ISCSI_SEQ_GT (Session->CmdSN, Session->MaxCmdSN)) {
     //
-    // Try to receive PDU from target.
+    // The queue is also appended to at TPL_NOTIFY.
     //
-    Status = IScsiReceivePdu (Conn, &Pdu, &InBufferContext, FALSE, FALSE, TimeoutEvent);
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (IsListEmpty (&Session->PendingTcbList)) {
+      gBS->RestoreTPL (OldTpl);
+      break;
+    }
+
+    Tcb = NET_LIST_HEAD (&Session->PendingTcbList, ISCSI_TCB, Link);
+    RemoveEntryList (&Tcb->Link);
+    gBS->RestoreTPL (OldTpl);
+
+    Status = IScsiStartTcb (Session, Tcb);
     if (EFI_ERROR (Status)) {
-      goto ON_EXIT;
+      return Status;
     }
+  }
 
-    PduHdr = NetbufGetByte (Pdu, 0, NULL);
-    if (PduHdr == NULL) {
-      Status = EFI_PROTOCOL_ERROR;
-      NetbufFree (Pdu);
-      goto ON_EXIT;
+  return EFI_SUCCESS;
+}
+
+/**
+  Process the PDUs that have arrived on the connections of a session, send the
+  queued non-blocking SCSI commands, and time out the non-blocking commands. It
+  runs at TPL_CALLBACK.
+
+  @param[in]  Session          The iSCSI session.
+
+  @retval EFI_SUCCESS          The session is polled.
+  @retval Others               The session failed, and has to be aborted.
+
+**/
+EFI_STATUS
+IScsiPollSession (
+  IN ISCSI_SESSION  *Session
+  )
+{
+  EFI_STATUS        Status;
+  EFI_TPL           OldTpl;
+  LIST_ENTRY        *Entry;
+  LIST_ENTRY        *NextEntry;
+  ISCSI_CONNECTION  *Conn;
+  ISCSI_TCB         *Tcb;
+
+  //
+  // Process what has arrived first, as it may open the command window.
+  //
+  NET_LIST_FOR_EACH (Entry, &Session->Conns) {
+    Conn = NET_LIST_USER_STRUCT_S (Entry, ISCSI_CONNECTION, Link, ISCSI_CONNECTION_SIGNATURE);
+
+    do {
+      gBS->SetTimer (Conn->TimeoutEvent, TimerRelative, ISCSI_POLL_PDU_TIMEOUT);
+      Status = IScsiDispatchPdu (Conn, Conn->TimeoutEvent, TRUE);
+    } while (Status == EFI_SUCCESS);
+
+    gBS->SetTimer (Conn->TimeoutEvent, TimerCancel, 0);
+
+    if (Status != EFI_NOT_READY) {
+      return Status;
     }
+  }
 
-    switch (ISCSI_GET_OPCODE (PduHdr)) {
-      case ISCSI_OPCODE_SCSI_DATA_IN:
-        Status = IScsiOnDataInRcvd (Pdu, Tcb, Packet);
-        break;
+  Status = IScsiSubmitPendingTcbs (Session);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
 
-      case ISCSI_OPCODE_R2T:
-        Status = IScsiOnR2TRcvd (Pdu, Tcb, Lun, Packet);
-        break;
+  //
+  // A queued command that times out is only finished. A command the target
+  // has received fails the session, as this driver does no task management.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &Session->PendingTcbList) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, ISCSI_TCB, Link);
+    if (Tcb->TimeoutRemain == 0) {
+      continue;
+    }
 
-      case ISCSI_OPCODE_SCSI_RSP:
-        Status = IScsiOnScsiRspRcvd (Pdu, Tcb, Packet);
-        break;
+    if (Tcb->TimeoutRemain > ISCSI_DISPATCH_POLL_INTERVAL) {
+      Tcb->TimeoutRemain -= ISCSI_DISPATCH_POLL_INTERVAL;
+      continue;
+    }
 
-      case ISCSI_OPCODE_NOP_IN:
-        Status = IScsiOnNopInRcvd (Pdu, Tcb);
-        break;
+    Tcb->Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_TIMEOUT_COMMAND;
+    IScsiCompleteTcb (Tcb);
+  }
 
-      case ISCSI_OPCODE_VENDOR_T0:
-      case ISCSI_OPCODE_VENDOR_T1:
-      case ISCSI_OPCODE_VENDOR_T2:
-        //
-        // These messages are vendor specific. Skip them.
-        //
-        break;
+  gBS->RestoreTPL (OldTpl);
 
-      default:
-        Status = EFI_PROTOCOL_ERROR;
-        break;
+  NET_LIST_FOR_EACH (Entry, &Session->TcbList) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, ISCSI_TCB, Link);
+    if ((Tcb->Event == NULL) || (Tcb->TimeoutRemain == 0)) {
+      continue;
     }
 
-    NetbufFree (Pdu);
+    if (Tcb->TimeoutRemain > ISCSI_DISPATCH_POLL_INTERVAL) {
+      Tcb->TimeoutRemain -= ISCSI_DISPATCH_POLL_INTERVAL;
+      continue;
+    }
+
+    Tcb->Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_TIMEOUT_COMMAND;
+    IScsiCompleteTcb (Tcb);
+    return EFI_TIMEOUT;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  The notify function of the dispatch timer of a session. It sends the queued
+  non-blocking SCSI commands and processes the PDUs received for them, unless a
+  blocking request is using the connections. The session is aborted on error;
+  the next request at TPL_CALLBACK or below reinstates it.
+
+  @param[in]  Event    The dispatch timer event.
+  @param[in]  Context  The iSCSI session.
+
+**/
+VOID
+EFIAPI
+IScsiOnDispatchTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  ISCSI_SESSION  *Session;
+  EFI_STATUS     Status;
+
+  Session = (ISCSI_SESSION *)Context;
+
+  if (Session->Dispatching ||
+      (IsListEmpty (&Session->TcbList) && IsListEmpty (&Session->PendingTcbList)))
+  {
+    return;
+  }
+
+  Session->Dispatching = TRUE;
+  Status               = IScsiPollSession (Session);
+  Session->Dispatching = FALSE;
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "iSCSI: Aborting the session, %r\n", Status));
+    IScsiSessionAbort (Session);
+  }
+}
+
+/**
+  Queue a non-blocking SCSI request on a session. The command is sent as soon as
+  the command window of the target allows: at once when called at TPL_CALLBACK
+  or below, otherwise by the dispatch timer of the session.
+
+  @param[in]       Session   The iSCSI session.
+  @param[in]       Lun       The LUN.
+  @param[in, out]  Packet    The request packet containing IO request, SCSI command
+                             buffer and buffers to read/write.
+  @param[in]       Event     The event to signal when the request completes.
+
+  @retval EFI_SUCCESS          The request is queued.
+  @retval EFI_DEVICE_ERROR     Session state was not as required.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval Others               Failed to start the dispatch timer.
+
+**/
+EFI_STATUS
+IScsiQueueScsiCommand (
+  IN ISCSI_SESSION                                   *Session,
+  IN UINT64                                          Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN EFI_EVENT                                       Event
+  )
+{
+  EFI_STATUS  Status;
+  EFI_TPL     OldTpl;
+  ISCSI_TCB   *Tcb;
+
+  Tcb = IScsiNewTcb (Packet, Lun, Event);
+  if (Tcb == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  if (Session->State != SESSION_STATE_LOGGED_IN) {
+    Status = EFI_DEVICE_ERROR;
+    goto ON_ERROR;
+  }
 
+  if (Session->DispatchEvent == NULL) {
+    Status = gBS->CreateEvent (
+                    EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    IScsiOnDispatchTimer,
+                    Session,
+                    &Session->DispatchEvent
+                    );
     if (EFI_ERROR (Status)) {
-      break;
+      goto ON_ERROR;
+    }
+
+    Status = gBS->SetTimer (Session->DispatchEvent, TimerPeriodic, ISCSI_DISPATCH_POLL_INTERVAL);
+    if (EFI_ERROR (Status)) {
+      gBS->CloseEvent (Session->DispatchEvent);
+      Session->DispatchEvent = NULL;
+      goto ON_ERROR;
+    }
+  }
+
+  InsertTailList (&Session->PendingTcbList, &Tcb->Link);
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (OldTpl <= TPL_CALLBACK) {
+    //
+    // Send the command now rather than on the next timer tick.
+    //
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    if (!Session->Dispatching) {
+      Session->Dispatching = TRUE;
+      Status               = IScsiSubmitPendingTcbs (Session);
+      Session->Dispatching = FALSE;
+
+      if (EFI_ERROR (Status)) {
+        //
+        // The request is finished with an error by the abort.
+        //
+        IScsiSessionAbort (Session);
+      }
+    }
+
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  gBS->RestoreTPL (OldTpl);
+  FreePool (Tcb);
+
+  return Status;
+}
+
+/**
+  Execute the SCSI command issued through the EXT SCSI PASS THRU protocol.
+
+  @param[in]       PassThru  The EXT SCSI PASS THRU protocol.
+  @param[in]       Target    The target ID.
+  @param[in]       Lun       The LUN.
+  @param[in, out]  Packet    The request packet containing IO request, SCSI command
+                             buffer and buffers to read/write.
+  @param[in]       Event     If not NULL, the command is queued and sent as soon as
+                             the command window of the target allows, and Event is
+                             signaled when it completes.
+
+  @retval EFI_SUCCESS          The SCSI command is executed and the result is updated to
+                               the Packet, or the non-blocking command is queued.
+  @retval EFI_DEVICE_ERROR     Session state was not as required.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval EFI_PROTOCOL_ERROR   There is no such data in the net buffer.
+  @retval EFI_NOT_READY        The target can not accept new commands.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiExecuteScsiCommand (
+  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL                 *PassThru,
+  IN UINT8                                           *Target,
+  IN UINT64                                          Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN EFI_EVENT                                       Event     OPTIONAL
+  )
+{
+  EFI_STATUS         Status;
+  ISCSI_DRIVER_DATA  *Private;
+  ISCSI_SESSION      *Session;
+  EFI_EVENT          TimeoutEvent;
+  ISCSI_TCB          *Tcb;
+  UINT64             Timeout;
+  EFI_TPL            OldTpl;
+  BOOLEAN            Dispatching;
+
+  Private      = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (PassThru);
+  Session      = Private->Session;
+  Status       = EFI_SUCCESS;
+  Tcb          = NULL;
+  TimeoutEvent = NULL;
+  Timeout      = 0;
+
+  if (Event != NULL) {
+    return IScsiQueueScsiCommand (Session, Lun, Packet, Event);
+  }
+
+  //
+  // Take the connections from the dispatch timer for the time of this command.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  if (Session->State != SESSION_STATE_LOGGED_IN) {
+    gBS->RestoreTPL (OldTpl);
+    return EFI_DEVICE_ERROR;
+  }
+
+  Dispatching          = Session->Dispatching;
+  Session->Dispatching = TRUE;
+  gBS->RestoreTPL (OldTpl);
+
+  if (Dispatching) {
+    //
+    // This is a blocking request from an event notify function that interrupted
+    // another one.
+    //
+    return EFI_NOT_READY;
+  }
+
+  if (Packet->Timeout != 0) {
+    Timeout = MultU64x32 (Packet->Timeout, 4);
+  }
+
+  Tcb = IScsiNewTcb (Packet, Lun, NULL);
+  if (Tcb == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  Status = IScsiStartTcb (Session, Tcb);
+  if (Status == EFI_NOT_READY) {
+    FreePool (Tcb);
+    Tcb = NULL;
+    goto ON_EXIT;
+  }
+
+  //
+  // Receive on the connection of this command until its status arrives. The
+  // PDUs of the other commands outstanding on the connection are processed as
+  // they come.
+  //
+  while (!EFI_ERROR (Status) && !Tcb->StatusXferd) {
+    //
+    // Start the timeout timer.
+    //
+    if (Timeout != 0) {
+      Status = gBS->SetTimer (Tcb->Conn->TimeoutEvent, TimerRelative, Timeout);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+
+      TimeoutEvent = Tcb->Conn->TimeoutEvent;
     }
+
+    Status = IScsiDispatchPdu (Tcb->Conn, TimeoutEvent, FALSE);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = Tcb->Status;
   }
 
 ON_EXIT:
@@ -3079,6 +3756,8 @@ ON_EXIT:
     IScsiDelTcb (Tcb);
   }
 
+  Session->Dispatching = FALSE;
+
   return Status;
 }
 
@@ -3133,6 +3812,7 @@ IScsiSessionInit (
 
     InitializeListHead (&Session->Conns);
     InitializeListHead (&Session->TcbList);
+    InitializeListHead (&Session->PendingTcbList);
   }
 
   Session->Tsih = 0;
@@ -3145,8 +3825,8 @@ IScsiSessionInit (
   Session->MaxConnections       = ISCSI_MAX_CONNS_PER_SESSION;
   Session->InitialR2T           = FALSE;
   Session->ImmediateData        = TRUE;
-  Session->MaxBurstLength       = 262144;
-  Session->FirstBurstLength     = MAX_RECV_DATA_SEG_LEN_IN_FFP;
+  Session->MaxBurstLength       = DEFAULT_MAX_BURST_LEN;
+  Session->FirstBurstLength     = DEFAULT_FIRST_BURST_LEN;
   Session->DefaultTime2Wait     = 2;
   Session->DefaultTime2Retain   = 20;
   Session->MaxOutstandingR2T    = DEFAULT_MAX_OUTSTANDING_R2T;
@@ -3169,13 +3849,53 @@ IScsiSessionAbort (
 {
   ISCSI_CONNECTION  *Conn;
   EFI_GUID          *ProtocolGuid;
+  ISCSI_TCB         *Tcb;
+  LIST_ENTRY        *Entry;
+  LIST_ENTRY        *NextEntry;
+  EFI_TPL           OldTpl;
+  EFI_TPL           NotifyTpl;
+
+  //
+  // Keep the dispatch timer out while the session is torn down.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
   if (Session->State != SESSION_STATE_LOGGED_IN) {
+    gBS->RestoreTPL (OldTpl);
     return;
   }
 
   ASSERT (!IsListEmpty (&Session->Conns));
 
+  //
+  // Stop the dispatch timer, and fail the non-blocking commands, both those
+  // queued and those outstanding. The session is marked failed first, so the
+  // callers that are signaled cannot queue a new command on it.
+  //
+  NotifyTpl      = gBS->RaiseTPL (TPL_NOTIFY);
+  Session->State = SESSION_STATE_FAILED;
+
+  if (Session->DispatchEvent != NULL) {
+    gBS->CloseEvent (Session->DispatchEvent);
+    Session->DispatchEvent = NULL;
+  }
+
+  while (!IsListEmpty (&Session->PendingTcbList)) {
+    Tcb                            = NET_LIST_HEAD (&Session->PendingTcbList, ISCSI_TCB, Link);
+    Tcb->Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_PHASE_ERROR;
+    IScsiCompleteTcb (Tcb);
+  }
+
+  NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &Session->TcbList) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, ISCSI_TCB, Link);
+    if (Tcb->Event != NULL) {
+      Tcb->Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_PHASE_ERROR;
+      IScsiCompleteTcb (Tcb);
+    }
+  }
+
+  gBS->RestoreTPL (NotifyTpl);
+
   while (!IsListEmpty (&Session->Conns)) {
     Conn = NET_LIST_USER_STRUCT_S (
              Session->Conns.ForwardLink,
@@ -3202,7 +3922,7 @@ IScsiSessionAbort (
     IScsiDestroyConnection (Conn);
   }
 
-  Session->State = SESSION_STATE_FAILED;
+  gBS->RestoreTPL (OldTpl);
 
   return;
 }
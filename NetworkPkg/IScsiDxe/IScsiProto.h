@@ -24,13 +24,42 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
       (((INT32) (s1) > (INT32) (s2)) && (s1 - s2) < ((UINT32) 1 << 31)) \
     )
 
-#define ISCSI_WELL_KNOWN_PORT        3260
-#define ISCSI_MAX_CONNS_PER_SESSION  1
+#define ISCSI_WELL_KNOWN_PORT  3260
+
+//
+// The number of connections offered per session. The SCSI commands are spread
+// over the connections the target accepts.
+//
+#define ISCSI_MAX_CONNS_PER_SESSION  2
+
+//
+// The period of the timer that sends the queued non-blocking SCSI commands and
+// processes the PDUs received for them, and how long the rest of a PDU may take
+// to arrive once its first byte has been received by that timer.
+//
+#define ISCSI_DISPATCH_POLL_INTERVAL  EFI_TIMER_PERIOD_MILLISECONDS (1)
+#define ISCSI_POLL_PDU_TIMEOUT        EFI_TIMER_PERIOD_SECONDS (5)
 
 #define DEFAULT_MAX_RECV_DATA_SEG_LEN  8192
-#define MAX_RECV_DATA_SEG_LEN_IN_FFP   65536
 #define DEFAULT_MAX_OUTSTANDING_R2T    1
 
+//
+// The values offered in the login negotiation. MaxRecvDataSegmentLength is
+// declared, and matches the default of the open-iscsi initiator. MaxBurstLength
+// and FirstBurstLength are negotiated to the minimum of both offers, so a
+// target with smaller limits is not affected. FirstBurstLength stays at the
+// RFC 7143 default.
+//
+#define MAX_RECV_DATA_SEG_LEN_IN_FFP  262144
+#define DEFAULT_MAX_BURST_LEN         1048576
+#define DEFAULT_FIRST_BURST_LEN       65536
+
+//
+// The legal range of a declared MaxRecvDataSegmentLength, RFC 7143 13.12.
+//
+#define MIN_RECV_DATA_SEG_LEN  512
+#define MAX_RECV_DATA_SEG_LEN  0xFFFFFF
+
 #define ISCSI_VERSION_MAX  0x00
 #define ISCSI_VERSION_MIN  0x00
 
@@ -595,22 +624,32 @@ typedef struct _ISCSI_IN_BUFFER_CONTEXT {
 } ISCSI_IN_BUFFER_CONTEXT;
 
 typedef struct _ISCSI_TCB {
-  LIST_ENTRY            Link;
-
-  BOOLEAN               SoFarInOrder;
-  UINT32                ExpDataSN;
-  BOOLEAN               FbitReceived;
-  BOOLEAN               StatusXferd;
-  UINT32                ActiveR2Ts;
-  UINT32                Response;
-  CHAR8                 *Reason;
-  UINT32                InitiatorTaskTag;
-  UINT32                CmdSN;
-  UINT32                SNACKTag;
-
-  ISCSI_XFER_CONTEXT    XferContext;
-
-  ISCSI_CONNECTION      *Conn;
+  LIST_ENTRY                                    Link;
+
+  BOOLEAN                                       SoFarInOrder;
+  UINT32                                        ExpDataSN;
+  BOOLEAN                                       FbitReceived;
+  BOOLEAN                                       StatusXferd;
+  UINT32                                        ActiveR2Ts;
+  UINT32                                        Response;
+  CHAR8                                         *Reason;
+  UINT32                                        InitiatorTaskTag;
+  UINT32                                        CmdSN;
+  UINT32                                        SNACKTag;
+
+  ISCSI_XFER_CONTEXT                            XferContext;
+
+  ISCSI_CONNECTION                              *Conn;
+
+  //
+  // The request carried out by this task. Event is NULL for a blocking request.
+  //
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet;
+  UINT64                                        Lun;
+  ISCSI_IN_BUFFER_CONTEXT                       InBufferContext;
+  EFI_EVENT                                     Event;
+  UINT64                                        TimeoutRemain;
+  EFI_STATUS                                    Status;
 } ISCSI_TCB;
 
 typedef struct _ISCSI_KEY_VALUE_PAIR {
@@ -848,8 +887,10 @@ IScsiFreeNbufList (
   @param[in]  HeaderDigest Whether there will be header digest received.
   @param[in]  DataDigest   Whether there will be data digest.
   @param[in]  TimeoutEvent The timeout event, it's optional.
+  @param[in]  Poll         Return at once if no PDU has started to arrive.
 
   @retval EFI_SUCCESS          An iSCSI pdu is received.
+  @retval EFI_NOT_READY        Poll is TRUE and no PDU has started to arrive.
   @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
   @retval EFI_PROTOCOL_ERROR   Some kind of iSCSI protocol error occurred.
   @retval Others               Other errors as indicated.
@@ -862,7 +903,8 @@ IScsiReceivePdu (
   IN ISCSI_IN_BUFFER_CONTEXT  *Context  OPTIONAL,
   IN BOOLEAN                  HeaderDigest,
   IN BOOLEAN                  DataDigest,
-  IN EFI_EVENT                TimeoutEvent OPTIONAL
+  IN EFI_EVENT                TimeoutEvent OPTIONAL,
+  IN BOOLEAN                  Poll
   );
 
 /**
@@ -977,9 +1019,12 @@ IScsiNormalizeName (
   @param[in]       Lun       The LUN.
   @param[in, out]  Packet    The request packet containing IO request, SCSI command
                              buffer and buffers to read/write.
+  @param[in]       Event     If not NULL, the command is queued and sent as soon as
+                             the command window of the target allows, and Event is
+                             signaled when it completes.
 
   @retval EFI_SUCCESS          The SCSI command is executed and the result is updated to
-                               the Packet.
+                               the Packet, or the non-blocking command is queued.
   @retval EFI_DEVICE_ERROR     Session state was not as required.
   @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
   @retval EFI_NOT_READY        The target can not accept new commands.
@@ -991,7 +1036,8 @@ IScsiExecuteScsiCommand (
   IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL                 *PassThru,
   IN UINT8                                           *Target,
   IN UINT64                                          Lun,
-  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN EFI_EVENT                                       Event     OPTIONAL
   );
 
 /**
@@ -972,6 +972,12 @@ TcpIoReceive (
         Tcp6->Cancel (Tcp6, &TcpIo->RxToken.Tcp6Token.CompletionToken);
       }
 
+      //
+      // The cancelled token is signaled as well. Clear the flag so that the
+      // next receive on this TCP_IO does not take it for its own completion.
+      //
+      TcpIo->IsRxDone = FALSE;
+
       Status = EFI_TIMEOUT;
       goto ON_EXIT;
     } else {
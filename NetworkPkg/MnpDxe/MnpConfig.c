@@ -560,6 +560,23 @@ MnpInitializeDeviceData (
     goto ERROR;
   }
 
+  //
+  // Create the event to report the system poll statistics at ExitBootServices.
+  //
+  Status = gBS->CreateEventEx (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  MnpNotifyExitBootServices,
+                  MnpDeviceData,
+                  &gEfiEventExitBootServicesGuid,
+                  &MnpDeviceData->ExitBootServicesEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "MnpInitializeDeviceData: CreateEventEx for ExitBootServices failed.\n"));
+
+    goto ERROR;
+  }
+
 ERROR:
   if (EFI_ERROR (Status)) {
     //
@@ -577,6 +594,10 @@ ERROR:
       gBS->CloseEvent (MnpDeviceData->MediaDetectTimer);
     }
 
+    if (MnpDeviceData->ExitBootServicesEvent != NULL) {
+      gBS->CloseEvent (MnpDeviceData->ExitBootServicesEvent);
+    }
+
     if (MnpDeviceData->PollTimer != NULL) {
       gBS->CloseEvent (MnpDeviceData->PollTimer);
     }
@@ -622,6 +643,12 @@ MnpDestroyDeviceData (
 
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
+  //
+  // The device goes away before ExitBootServices, report its statistics now.
+  //
+  gBS->CloseEvent (MnpDeviceData->ExitBootServicesEvent);
+  MnpReportPollStatistics (MnpDeviceData);
+
   //
   // Free Vlan Config variable name string
   //
@@ -1273,6 +1300,8 @@ MnpStart (
     }
 
     MnpDeviceData->EnableSystemPoll = EnableSystemPoll;
+    MnpDeviceData->ActivePoll       = FALSE;
+    MnpDeviceData->IdlePollCount    = 0;
   }
 
   //
@@ -1284,6 +1313,59 @@ ErrorExit:
   return Status;
 }
 
+/**
+  Report the system poll statistics of the MNP device.
+
+  The counters are logged as PERF_COUNTER records, which keep the values as
+  binary data in the FPDT. Each record is named after the MAC address string
+  of the device to tell the interfaces apart.
+
+  @param[in]  MnpDeviceData          Pointer to the mnp device context data.
+
+**/
+VOID
+MnpReportPollStatistics (
+  IN MNP_DEVICE_DATA  *MnpDeviceData
+  )
+{
+  CHAR8  Name[MNP_PERF_STRING_LENGTH];
+
+  DEBUG ((
+    DEBUG_INFO,
+    "MnpReportPollStatistics: %s polled %Lu times, received %Lu packets.\n",
+    MnpDeviceData->MacString,
+    MnpDeviceData->PollCount,
+    MnpDeviceData->RxPacketCount
+    ));
+
+  if (!LogPerformanceMeasurementEnabled (PERF_GENERAL_TYPE)) {
+    return;
+  }
+
+  AsciiSPrint (Name, sizeof (Name), "Poll:%s", MnpDeviceData->MacString);
+  PERF_COUNTER (Name, MnpDeviceData->PollCount);
+
+  AsciiSPrint (Name, sizeof (Name), "Rx:%s", MnpDeviceData->MacString);
+  PERF_COUNTER (Name, MnpDeviceData->RxPacketCount);
+}
+
+/**
+  Report the system poll statistics of the MNP device at ExitBootServices.
+
+  @param[in]  Event        The event this notify function registered to.
+  @param[in]  Context      Pointer to the context data registered to the event.
+
+**/
+VOID
+EFIAPI
+MnpNotifyExitBootServices (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  MnpReportPollStatistics ((MNP_DEVICE_DATA *)Context);
+}
+
 /**
   Stop the managed network.
 
@@ -1332,6 +1414,7 @@ MnpStop (
     //
     Status                          = gBS->SetTimer (MnpDeviceData->PollTimer, TimerCancel, 0);
     MnpDeviceData->EnableSystemPoll = FALSE;
+    MnpDeviceData->ActivePoll       = FALSE;
   }
 
   //
@@ -15,6 +15,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/SimpleNetwork.h>
 #include <Protocol/ServiceBinding.h>
 #include <Protocol/VlanConfig.h>
+#include <Guid/EventGroup.h>
 
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -27,6 +28,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/PrintLib.h>
+#include <Library/PerformanceLib.h>
 
 #include "ComponentName.h"
 
@@ -69,6 +71,19 @@ typedef struct {
 
   EFI_EVENT                      PollTimer;
   BOOLEAN                        EnableSystemPoll;
+  //
+  // The system poll runs at MNP_SYS_POLL_ACTIVE_INTERVAL while packets are
+  // received, and backs off to MNP_SYS_POLL_INTERVAL once the interface has
+  // been idle for MNP_SYS_POLL_IDLE_THRESHOLD polls.
+  //
+  BOOLEAN                        ActivePoll;
+  UINT32                         IdlePollCount;
+  //
+  // Statistics of the system poll.
+  //
+  UINT64                         PollCount;
+  UINT64                         RxPacketCount;
+  EFI_EVENT                      ExitBootServicesEvent;
 
   EFI_EVENT                      TimeoutCheckTimer;
   EFI_EVENT                      MediaDetectTimer;
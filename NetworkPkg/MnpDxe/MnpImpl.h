@@ -14,6 +14,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define NET_ETHER_FCS_SIZE  4
 
 #define MNP_SYS_POLL_INTERVAL        (10 * TICKS_PER_MS)    // 10 milliseconds
+#define MNP_SYS_POLL_ACTIVE_INTERVAL (1 * TICKS_PER_MS)     // 1 millisecond
+#define MNP_SYS_POLL_IDLE_THRESHOLD  50                     // Idle polls before backing off
+#define MNP_SYS_POLL_BUDGET          32                     // Packets received per poll
+#define MNP_PERF_STRING_LENGTH       24                     // FPDT counter record name length
 #define MNP_TIMEOUT_CHECK_INTERVAL   (50 * TICKS_PER_MS)    // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL    (500 * TICKS_PER_MS)   // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME          (500 * TICKS_PER_MS)   // 500 milliseconds
@@ -517,6 +521,31 @@ MnpCheckMediaStatus (
   IN VOID       *Context
   );
 
+/**
+  Report the system poll statistics of the MNP device.
+
+  @param[in]  MnpDeviceData          Pointer to the mnp device context data.
+
+**/
+VOID
+MnpReportPollStatistics (
+  IN MNP_DEVICE_DATA  *MnpDeviceData
+  );
+
+/**
+  Report the system poll statistics of the MNP device at ExitBootServices.
+
+  @param[in]  Event        The event this notify function registered to.
+  @param[in]  Context      Pointer to the context data registered to the event.
+
+**/
+VOID
+EFIAPI
+MnpNotifyExitBootServices (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
 /**
   Poll to receive the packets from Snp. This function is either called by upperlayer
   protocols/applications or the system poll timer notify mechanism.
@@ -1099,17 +1099,63 @@ MnpSystemPoll (
   )
 {
   MNP_DEVICE_DATA  *MnpDeviceData;
+  UINTN            Received;
+  UINT64           Interval;
 
   MnpDeviceData = (MNP_DEVICE_DATA *)Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
+  MnpDeviceData->PollCount++;
+
   //
-  // Try to receive packets from Snp.
+  // Try to receive packets from Snp. Drain up to MNP_SYS_POLL_BUDGET packets
+  // so that a burst is not received at one packet per poll interval.
   //
-  MnpReceivePacket (MnpDeviceData);
+  for (Received = 0; Received < MNP_SYS_POLL_BUDGET; Received++) {
+    if (EFI_ERROR (MnpReceivePacket (MnpDeviceData))) {
+      break;
+    }
+
+    //
+    // Dispatch the DPC queued by the NotifyFunction of rx token's events, so
+    // that the upper layers can recycle their rx tokens for the next packet.
+    //
+    DispatchDpc ();
+  }
+
+  if (Received == 0) {
+    //
+    // Dispatch the DPC queued by the NotifyFunction of rx token's events.
+    //
+    DispatchDpc ();
+  }
+
+  MnpDeviceData->RxPacketCount += Received;
+
+  if ((Event != MnpDeviceData->PollTimer) || !MnpDeviceData->EnableSystemPoll) {
+    return;
+  }
 
   //
-  // Dispatch the DPC queued by the NotifyFunction of rx token's events.
+  // Poll tightly while traffic is active and back off when the interface is idle.
   //
-  DispatchDpc ();
+  if (Received != 0) {
+    MnpDeviceData->IdlePollCount = 0;
+    if (MnpDeviceData->ActivePoll) {
+      return;
+    }
+
+    Interval = MNP_SYS_POLL_ACTIVE_INTERVAL;
+  } else {
+    MnpDeviceData->IdlePollCount++;
+    if (!MnpDeviceData->ActivePoll || (MnpDeviceData->IdlePollCount < MNP_SYS_POLL_IDLE_THRESHOLD)) {
+      return;
+    }
+
+    Interval = MNP_SYS_POLL_INTERVAL;
+  }
+
+  if (!EFI_ERROR (gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, Interval))) {
+    MnpDeviceData->ActivePoll = (BOOLEAN)(Interval == MNP_SYS_POLL_ACTIVE_INTERVAL);
+  }
 }
@@ -126,6 +126,12 @@ struct _MTFTP4_PROTOCOL {
   //
   UINT64                    AckedBlock;
 
+  //
+  // Set once the last in-order block has been acked because of a lost or
+  // reordered block in the current window.
+  //
+  BOOLEAN                   GapAcked;
+
   //
   // The server's communication end point: IP and two ports. one for
   // initial request, one for its selected port.
@@ -264,10 +264,26 @@ Mtftp4RrqHandleData (
   // expected one. If we are passive (Slave), save the block.
   //
   if (Instance->Master && (Expected != BlockNum)) {
+    //
+    // With a window larger than one block, the rest of the window keeps
+    // arriving after a lost or reordered block, and every ACK makes the
+    // server restart its window. So ACK the last in-order block only once
+    // (RFC 7440, section 4); the retransmission timer resends that ACK if
+    // it is lost.
+    //
+    if ((Instance->WindowSize > 1) && Instance->GapAcked) {
+      return EFI_SUCCESS;
+    }
+
     //
     // If Expected is 0, (UINT16) (Expected - 1) is also the expected Ack number (65535).
     //
-    return Mtftp4RrqSendAck (Instance, (UINT16)(Expected - 1));
+    Status = Mtftp4RrqSendAck (Instance, (UINT16)(Expected - 1));
+    if (!EFI_ERROR (Status)) {
+      Instance->GapAcked = TRUE;
+    }
+
+    return Status;
   }
 
   Status = Mtftp4RrqSaveBlock (Instance, Packet, Len);
@@ -276,6 +292,8 @@ Mtftp4RrqHandleData (
     return Status;
   }
 
+  Instance->GapAcked = FALSE;
+
   //
   // Record the total received and saved block number.
   //
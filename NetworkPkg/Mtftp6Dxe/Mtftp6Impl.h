@@ -86,6 +86,12 @@ struct _MTFTP6_INSTANCE {
   //
   UINT64                    AckedBlock;
 
+  //
+  // Set once the last in-order block has been acked because of a lost or
+  // reordered block in the current window.
+  //
+  BOOLEAN                   GapAcked;
+
   EFI_IPv6_ADDRESS          ServerIp;
   UINT16                    ServerCmdPort;
   UINT16                    ServerDataPort;
@@ -234,6 +234,17 @@ Mtftp6RrqHandleData (
   // expected one. If we are passive (Slave), save the block.
   //
   if (Instance->IsMaster && (Expected != BlockNum)) {
+    //
+    // With a window larger than one block, the rest of the window keeps
+    // arriving after a lost or reordered block, and every ACK makes the
+    // server restart its window. So ACK the last in-order block only once
+    // (RFC 7440, section 4); the retransmission timer resends that ACK if
+    // it is lost.
+    //
+    if ((Instance->WindowSize > 1) && Instance->GapAcked) {
+      return EFI_SUCCESS;
+    }
+
     //
     // Free the received packet before send new packet in ReceiveNotify,
     // since the udpio might need to be reconfigured.
@@ -244,7 +255,12 @@ Mtftp6RrqHandleData (
     //
     // If Expected is 0, (UINT16) (Expected - 1) is also the expected Ack number (65535).
     //
-    return Mtftp6RrqSendAck (Instance, (UINT16)(Expected - 1));
+    Status = Mtftp6RrqSendAck (Instance, (UINT16)(Expected - 1));
+    if (!EFI_ERROR (Status)) {
+      Instance->GapAcked = TRUE;
+    }
+
+    return Status;
   }
 
   Status = Mtftp6RrqSaveBlock (Instance, Packet, Len, UdpPacket);
@@ -253,6 +269,8 @@ Mtftp6RrqHandleData (
     return Status;
   }
 
+  Instance->GapAcked = FALSE;
+
   //
   // Record the total received and saved block number.
   //
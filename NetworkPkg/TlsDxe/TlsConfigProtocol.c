@@ -74,6 +74,13 @@ TlsConfigurationSetData (
       Status = EFI_UNSUPPORTED;
   }
 
+  if (!EFI_ERROR (Status)) {
+    //
+    // Sessions verified with another trust configuration must not be resumed.
+    //
+    Status = TlsSessionCacheUpdateTrust (Instance, DataType, Data, DataSize);
+  }
+
   gBS->RestoreTPL (OldTpl);
   return Status;
 }
@@ -27,9 +27,21 @@ TlsCleanInstance (
 {
   if (Instance != NULL) {
     if (Instance->TlsConn != NULL) {
+      //
+      // With TLS 1.3 the session tickets arrive after the handshake, so the
+      // session is saved again before the connection is released.
+      //
+      if (Instance->TlsSessionState == EfiTlsSessionDataTransferring) {
+        TlsSessionCacheSave (Instance);
+      }
+
       TlsFree (Instance->TlsConn);
     }
 
+    if (Instance->ServerName != NULL) {
+      FreePool (Instance->ServerName);
+    }
+
     FreePool (Instance);
   }
 }
@@ -86,6 +98,8 @@ TlsCleanService (
   )
 {
   if (Service != NULL) {
+    TlsSessionCacheFree (Service);
+
     if (Service->TlsCtx != NULL) {
       TlsCtxFree (Service->TlsCtx);
     }
@@ -26,6 +26,26 @@
 
 #define TLS_INSTANCE_SIGNATURE  SIGNATURE_32 ('T', 'L', 'S', 'I')
 
+//
+// Maximum number of resumable sessions kept by the TLS service.
+//
+#define TLS_SESSION_CACHE_SIZE  8
+
+///
+/// Resumable TLS session. A session is only resumed by a connection with the
+/// same server name, verification mode, host name check flags and trust
+/// configuration as the connection whose handshake verified the server.
+///
+typedef struct {
+  CHAR8     *ServerName;
+  UINT32    VerifyMethod;
+  UINT32    VerifyHostFlags;
+  UINT8     TrustDigest[SHA256_DIGEST_SIZE];
+  UINT8     *Data;
+  UINTN     DataSize;
+  UINT64    LastUsed;
+} TLS_SESSION_CACHE_ENTRY;
+
 ///
 /// TLS Service Data
 ///
@@ -55,6 +75,13 @@ struct _TLS_SERVICE {
   // created for the connections.
   //
   VOID                            *TlsCtx;
+
+  //
+  // Resumable sessions shared by all the TLS children, so that repeated
+  // connections to the same server skip the full handshake.
+  //
+  TLS_SESSION_CACHE_ENTRY         SessionCache[TLS_SESSION_CACHE_SIZE];
+  UINT64                          SessionCacheTick;
 };
 
 struct _TLS_INSTANCE {
@@ -71,6 +98,15 @@ struct _TLS_INSTANCE {
 
   EFI_TLS_SESSION_STATE             TlsSessionState;
 
+  //
+  // Server name and flags set through EfiTlsVerifyHost, and the digest of the
+  // certificates and keys set through the TLS configuration protocol. They
+  // are part of the session cache key.
+  //
+  CHAR8                             *ServerName;
+  UINT32                            VerifyHostFlags;
+  UINT8                             TrustDigest[SHA256_DIGEST_SIZE];
+
   //
   // Main SSL Connection which is created by a server or a client
   // per established connection.
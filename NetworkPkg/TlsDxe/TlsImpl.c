@@ -9,6 +9,73 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "TlsImpl.h"
 
+/**
+  Get a contiguous view of the TLS records listed in the fragment table.
+
+  A TLS record may span fragment boundaries, so multiple fragments are gathered
+  into a newly allocated buffer. A single fragment, which is what HttpDxe always
+  passes, is used in place and no copy is made.
+
+  @param[in]   FragmentTable  Pointer to a list of fragment.
+  @param[in]   FragmentCount  Number of fragment.
+  @param[out]  BufferSize     Total size of the TLS records.
+  @param[out]  Allocated      TRUE if the returned buffer was allocated by this
+                              function and must be freed by the caller.
+
+  @return  Pointer to the TLS records, or NULL if out of resources.
+**/
+STATIC
+UINT8 *
+TlsGetRecordBuffer (
+  IN     EFI_TLS_FRAGMENT_DATA  *FragmentTable,
+  IN     UINT32                 FragmentCount,
+  OUT    UINT32                 *BufferSize,
+  OUT    BOOLEAN                *Allocated
+  )
+{
+  UINTN   Index;
+  UINT32  BytesCopied;
+  UINT8   *Buffer;
+
+  *BufferSize = 0;
+  *Allocated  = FALSE;
+
+  //
+  // Calculate the size according to the fragment table.
+  //
+  for (Index = 0; Index < FragmentCount; Index++) {
+    *BufferSize += FragmentTable[Index].FragmentLength;
+  }
+
+  if (FragmentCount == 1) {
+    return FragmentTable[0].FragmentBuffer;
+  }
+
+  //
+  // Allocate buffer for processing data.
+  //
+  Buffer = AllocatePool (*BufferSize);
+  if (Buffer == NULL) {
+    return NULL;
+  }
+
+  //
+  // Copy all TLS record header and payload into Buffer.
+  //
+  BytesCopied = 0;
+  for (Index = 0; Index < FragmentCount; Index++) {
+    CopyMem (
+      (Buffer + BytesCopied),
+      FragmentTable[Index].FragmentBuffer,
+      FragmentTable[Index].FragmentLength
+      );
+    BytesCopied += FragmentTable[Index].FragmentLength;
+  }
+
+  *Allocated = TRUE;
+  return Buffer;
+}
+
 /**
   Encrypt the message listed in fragment.
 
@@ -33,10 +100,9 @@ TlsEncryptPacket (
   )
 {
   EFI_STATUS         Status;
-  UINTN              Index;
-  UINT32             BytesCopied;
   UINT32             BufferInSize;
   UINT8              *BufferIn;
+  BOOLEAN            BufferInAllocated;
   UINT8              *BufferInPtr;
   TLS_RECORD_HEADER  *RecordHeaderIn;
   UINT16             ThisPlainMessageSize;
@@ -47,46 +113,27 @@ TlsEncryptPacket (
   UINT32             RecordCount;
   INTN               Ret;
 
-  Status           = EFI_SUCCESS;
-  BytesCopied      = 0;
-  BufferInSize     = 0;
-  BufferIn         = NULL;
-  BufferInPtr      = NULL;
-  RecordHeaderIn   = NULL;
-  TempRecordHeader = NULL;
-  BufferOutSize    = 0;
-  BufferOut        = NULL;
-  RecordCount      = 0;
-  Ret              = 0;
-
-  //
-  // Calculate the size according to the fragment table.
-  //
-  for (Index = 0; Index < *FragmentCount; Index++) {
-    BufferInSize += (*FragmentTable)[Index].FragmentLength;
-  }
+  Status            = EFI_SUCCESS;
+  BufferInSize      = 0;
+  BufferIn          = NULL;
+  BufferInAllocated = FALSE;
+  BufferInPtr       = NULL;
+  RecordHeaderIn    = NULL;
+  TempRecordHeader  = NULL;
+  BufferOutSize     = 0;
+  BufferOut         = NULL;
+  RecordCount       = 0;
+  Ret               = 0;
 
   //
-  // Allocate buffer for processing data.
+  // Get all TLS plain record header and payload, in place if possible.
   //
-  BufferIn = AllocateZeroPool (BufferInSize);
+  BufferIn = TlsGetRecordBuffer (*FragmentTable, *FragmentCount, &BufferInSize, &BufferInAllocated);
   if (BufferIn == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     goto ERROR;
   }
 
-  //
-  // Copy all TLS plain record header and payload into BufferIn.
-  //
-  for (Index = 0; Index < *FragmentCount; Index++) {
-    CopyMem (
-      (BufferIn + BytesCopied),
-      (*FragmentTable)[Index].FragmentBuffer,
-      (*FragmentTable)[Index].FragmentLength
-      );
-    BytesCopied += (*FragmentTable)[Index].FragmentLength;
-  }
-
   //
   // Count TLS record number.
   //
@@ -103,9 +150,10 @@ TlsEncryptPacket (
   }
 
   //
-  // Allocate enough buffer to hold TLS Ciphertext.
+  // Allocate enough buffer to hold TLS Ciphertext. Every byte of it is written
+  // by TlsCtrlTrafficOut() before it is reported to the caller.
   //
-  BufferOut = AllocateZeroPool (RecordCount * (TLS_RECORD_HEADER_LENGTH + TLS_CIPHERTEXT_RECORD_MAX_PAYLOAD_LENGTH));
+  BufferOut = AllocatePool (RecordCount * (TLS_RECORD_HEADER_LENGTH + TLS_CIPHERTEXT_RECORD_MAX_PAYLOAD_LENGTH));
   if (BufferOut == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     goto ERROR;
@@ -142,7 +190,11 @@ TlsEncryptPacket (
     TempRecordHeader = (TLS_RECORD_HEADER *)((UINT8 *)TempRecordHeader + ThisMessageSize);
   }
 
-  FreePool (BufferIn);
+  if (BufferInAllocated) {
+    FreePool (BufferIn);
+    BufferInAllocated = FALSE;
+  }
+
   BufferIn = NULL;
 
   //
@@ -162,7 +214,7 @@ TlsEncryptPacket (
 
 ERROR:
 
-  if (BufferIn != NULL) {
+  if (BufferInAllocated) {
     FreePool (BufferIn);
     BufferIn = NULL;
   }
@@ -189,6 +241,7 @@ ERROR:
   @retval EFI_SUCCESS             The operation completed successfully.
   @retval EFI_OUT_OF_RESOURCES    Can't allocate memory resources.
   @retval EFI_ABORTED             TLS session state is incorrect.
+  @retval EFI_BUFFER_TOO_SMALL    The decrypted records do not fit in the output buffer.
   @retval Others                  Other errors as indicated.
 **/
 EFI_STATUS
@@ -199,10 +252,9 @@ TlsDecryptPacket (
   )
 {
   EFI_STATUS         Status;
-  UINTN              Index;
-  UINT32             BytesCopied;
   UINT8              *BufferIn;
   UINT32             BufferInSize;
+  BOOLEAN            BufferInAllocated;
   UINT8              *BufferInPtr;
   TLS_RECORD_HEADER  *RecordHeaderIn;
   UINT16             ThisCipherMessageSize;
@@ -213,46 +265,27 @@ TlsDecryptPacket (
   UINT32             RecordCount;
   INTN               Ret;
 
-  Status           = EFI_SUCCESS;
-  BytesCopied      = 0;
-  BufferIn         = NULL;
-  BufferInSize     = 0;
-  BufferInPtr      = NULL;
-  RecordHeaderIn   = NULL;
-  TempRecordHeader = NULL;
-  BufferOut        = NULL;
-  BufferOutSize    = 0;
-  RecordCount      = 0;
-  Ret              = 0;
-
-  //
-  // Calculate the size according to the fragment table.
-  //
-  for (Index = 0; Index < *FragmentCount; Index++) {
-    BufferInSize += (*FragmentTable)[Index].FragmentLength;
-  }
+  Status            = EFI_SUCCESS;
+  BufferIn          = NULL;
+  BufferInSize      = 0;
+  BufferInAllocated = FALSE;
+  BufferInPtr       = NULL;
+  RecordHeaderIn    = NULL;
+  TempRecordHeader  = NULL;
+  BufferOut         = NULL;
+  BufferOutSize     = 0;
+  RecordCount       = 0;
+  Ret               = 0;
 
   //
-  // Allocate buffer for processing data
+  // Get all TLS cipher record header and payload, in place if possible.
   //
-  BufferIn = AllocateZeroPool (BufferInSize);
+  BufferIn = TlsGetRecordBuffer (*FragmentTable, *FragmentCount, &BufferInSize, &BufferInAllocated);
   if (BufferIn == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     goto ERROR;
   }
 
-  //
-  // Copy all TLS plain record header and payload to BufferIn
-  //
-  for (Index = 0; Index < *FragmentCount; Index++) {
-    CopyMem (
-      (BufferIn + BytesCopied),
-      (*FragmentTable)[Index].FragmentBuffer,
-      (*FragmentTable)[Index].FragmentLength
-      );
-    BytesCopied += (*FragmentTable)[Index].FragmentLength;
-  }
-
   //
   // Count TLS record number.
   //
@@ -269,9 +302,11 @@ TlsDecryptPacket (
   }
 
   //
-  // Allocate enough buffer to hold TLS Plaintext.
+  // Allocate enough buffer to hold TLS Plaintext. The plain text payload of a
+  // record is never larger than its cipher text payload, so the size of the
+  // received records bounds the decrypted output.
   //
-  BufferOut = AllocateZeroPool (RecordCount * (TLS_RECORD_HEADER_LENGTH + TLS_PLAINTEXT_RECORD_MAX_PAYLOAD_LENGTH));
+  BufferOut = AllocatePool (BufferInSize);
   if (BufferOut == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     goto ERROR;
@@ -294,8 +329,20 @@ TlsDecryptPacket (
       goto ERROR;
     }
 
+    //
+    // The output buffer must have room for the record header and some payload.
+    //
+    if ((BufferOutSize >= BufferInSize) || (BufferInSize - BufferOutSize <= TLS_RECORD_HEADER_LENGTH)) {
+      Status = EFI_BUFFER_TOO_SMALL;
+      goto ERROR;
+    }
+
     Ret = 0;
-    Ret = TlsRead (TlsInstance->TlsConn, (UINT8 *)(TempRecordHeader + 1), TLS_PLAINTEXT_RECORD_MAX_PAYLOAD_LENGTH);
+    Ret = TlsRead (
+            TlsInstance->TlsConn,
+            (UINT8 *)(TempRecordHeader + 1),
+            MIN (TLS_PLAINTEXT_RECORD_MAX_PAYLOAD_LENGTH, BufferInSize - BufferOutSize - TLS_RECORD_HEADER_LENGTH)
+            );
 
     if (Ret > 0) {
       ThisPlainMessageSize = (UINT16)Ret;
@@ -316,7 +363,11 @@ TlsDecryptPacket (
     TempRecordHeader = (TLS_RECORD_HEADER *)((UINT8 *)TempRecordHeader + TLS_RECORD_HEADER_LENGTH + ThisPlainMessageSize);
   }
 
-  FreePool (BufferIn);
+  if (BufferInAllocated) {
+    FreePool (BufferIn);
+    BufferInAllocated = FALSE;
+  }
+
   BufferIn = NULL;
 
   //
@@ -336,7 +387,7 @@ TlsDecryptPacket (
 
 ERROR:
 
-  if (BufferIn != NULL) {
+  if (BufferInAllocated) {
     FreePool (BufferIn);
     BufferIn = NULL;
   }
@@ -348,3 +399,289 @@ ERROR:
 
   return Status;
 }
+
+/**
+  Find the session cache entry that the TLS instance may resume.
+
+  An entry only matches if it was saved by a connection with the same server
+  name, verification mode, host name check flags and trust configuration.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+  @param[in]  VerifyMethod   The verification mode of the TLS connection.
+
+  @return  The cache entry, or NULL if there is no matching session.
+**/
+STATIC
+TLS_SESSION_CACHE_ENTRY *
+TlsSessionCacheLookup (
+  IN TLS_INSTANCE  *TlsInstance,
+  IN UINT32        VerifyMethod
+  )
+{
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+  UINTN                    Index;
+
+  for (Index = 0; Index < TLS_SESSION_CACHE_SIZE; Index++) {
+    Entry = &TlsInstance->Service->SessionCache[Index];
+    if ((Entry->ServerName != NULL) &&
+        (AsciiStrCmp (Entry->ServerName, TlsInstance->ServerName) == 0) &&
+        (Entry->VerifyMethod == VerifyMethod) &&
+        (Entry->VerifyHostFlags == TlsInstance->VerifyHostFlags) &&
+        (CompareMem (Entry->TrustDigest, TlsInstance->TrustDigest, SHA256_DIGEST_SIZE) == 0))
+    {
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Release the resources of a session cache entry.
+
+  @param[in]  Entry          The cache entry.
+**/
+STATIC
+VOID
+TlsSessionCacheFreeEntry (
+  IN TLS_SESSION_CACHE_ENTRY  *Entry
+  )
+{
+  if (Entry->ServerName != NULL) {
+    FreePool (Entry->ServerName);
+  }
+
+  if (Entry->Data != NULL) {
+    ZeroMem (Entry->Data, Entry->DataSize);
+    FreePool (Entry->Data);
+  }
+
+  ZeroMem (Entry, sizeof (TLS_SESSION_CACHE_ENTRY));
+}
+
+/**
+  Fold a certificate or key set through the TLS configuration protocol into
+  the trust digest of the TLS instance, so that sessions verified with another
+  trust configuration are not resumed.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+  @param[in]  DataType       The configuration data type.
+  @param[in]  Data           Pointer to the configuration data.
+  @param[in]  DataSize       Size of the configuration data.
+
+  @retval EFI_SUCCESS            The trust digest is updated.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval EFI_ABORTED            The digest could not be computed.
+**/
+EFI_STATUS
+TlsSessionCacheUpdateTrust (
+  IN TLS_INSTANCE              *TlsInstance,
+  IN EFI_TLS_CONFIG_DATA_TYPE  DataType,
+  IN VOID                      *Data,
+  IN UINTN                     DataSize
+  )
+{
+  VOID        *HashContext;
+  UINT32      Type;
+  UINT64      Size;
+  EFI_STATUS  Status;
+
+  HashContext = AllocatePool (Sha256GetContextSize ());
+  if (HashContext == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Type   = (UINT32)DataType;
+  Size   = (UINT64)DataSize;
+  Status = EFI_ABORTED;
+  if (Sha256Init (HashContext) &&
+      Sha256Update (HashContext, TlsInstance->TrustDigest, SHA256_DIGEST_SIZE) &&
+      Sha256Update (HashContext, &Type, sizeof (Type)) &&
+      Sha256Update (HashContext, &Size, sizeof (Size)) &&
+      Sha256Update (HashContext, Data, DataSize) &&
+      Sha256Final (HashContext, TlsInstance->TrustDigest))
+  {
+    Status = EFI_SUCCESS;
+  }
+
+  FreePool (HashContext);
+  return Status;
+}
+
+/**
+  Offer the cached session for the server of the TLS instance, if any, so that
+  the handshake can resume it instead of performing a full handshake.
+
+  This must be called just before the ClientHello is built, once all the
+  verification settings of the connection are final. Only connections that
+  verify the server are offered a session.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsSessionCacheRestore (
+  IN TLS_INSTANCE  *TlsInstance
+  )
+{
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+  UINT32                   VerifyMethod;
+  EFI_STATUS               Status;
+
+  if ((TlsInstance->ServerName == NULL) || (TlsInstance->TlsConn == NULL)) {
+    return;
+  }
+
+  VerifyMethod = TlsGetVerify (TlsInstance->TlsConn);
+  if ((VerifyMethod & EFI_TLS_VERIFY_PEER) == 0) {
+    return;
+  }
+
+  Entry = TlsSessionCacheLookup (TlsInstance, VerifyMethod);
+  if (Entry == NULL) {
+    DEBUG ((DEBUG_INFO, "TlsSessionCacheRestore: No session for %a.\n", TlsInstance->ServerName));
+    return;
+  }
+
+  Status = TlsSetSession (TlsInstance->TlsConn, Entry->Data, Entry->DataSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "TlsSessionCacheRestore: Drop session for %a - %r.\n", TlsInstance->ServerName, Status));
+    TlsSessionCacheFreeEntry (Entry);
+    return;
+  }
+
+  DEBUG ((DEBUG_INFO, "TlsSessionCacheRestore: Resume session for %a.\n", TlsInstance->ServerName));
+  Entry->LastUsed = ++TlsInstance->Service->SessionCacheTick;
+}
+
+/**
+  Save the resumable session of the TLS instance in the session cache of its
+  TLS service, replacing the least recently used entry if the cache is full.
+
+  Only sessions whose handshake verified the server are saved: the connection
+  must use EFI_TLS_VERIFY_PEER, under which a handshake that fails certificate
+  or host name verification does not complete.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsSessionCacheSave (
+  IN TLS_INSTANCE  *TlsInstance
+  )
+{
+  TLS_SERVICE              *Service;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+  UINTN                    Index;
+  UINT8                    *Data;
+  UINTN                    DataSize;
+  UINT32                   VerifyMethod;
+  CHAR8                    *ServerName;
+  EFI_STATUS               Status;
+
+  if ((TlsInstance->ServerName == NULL) || (TlsInstance->TlsConn == NULL)) {
+    return;
+  }
+
+  VerifyMethod = TlsGetVerify (TlsInstance->TlsConn);
+  if ((VerifyMethod & EFI_TLS_VERIFY_PEER) == 0) {
+    return;
+  }
+
+  DataSize = 0;
+  Status   = TlsGetSession (TlsInstance->TlsConn, NULL, &DataSize);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    return;
+  }
+
+  Data = AllocatePool (DataSize);
+  if (Data == NULL) {
+    return;
+  }
+
+  Status = TlsGetSession (TlsInstance->TlsConn, Data, &DataSize);
+  if (EFI_ERROR (Status)) {
+    FreePool (Data);
+    return;
+  }
+
+  Service = TlsInstance->Service;
+  Entry   = TlsSessionCacheLookup (TlsInstance, VerifyMethod);
+  if (Entry == NULL) {
+    //
+    // Use a free entry, or evict the least recently used one.
+    //
+    Entry = &Service->SessionCache[0];
+    for (Index = 0; Index < TLS_SESSION_CACHE_SIZE; Index++) {
+      if (Service->SessionCache[Index].ServerName == NULL) {
+        Entry = &Service->SessionCache[Index];
+        break;
+      }
+
+      if (Service->SessionCache[Index].LastUsed < Entry->LastUsed) {
+        Entry = &Service->SessionCache[Index];
+      }
+    }
+
+    ServerName = AllocateCopyPool (AsciiStrSize (TlsInstance->ServerName), TlsInstance->ServerName);
+    if (ServerName == NULL) {
+      ZeroMem (Data, DataSize);
+      FreePool (Data);
+      return;
+    }
+
+    TlsSessionCacheFreeEntry (Entry);
+    Entry->ServerName      = ServerName;
+    Entry->VerifyMethod    = VerifyMethod;
+    Entry->VerifyHostFlags = TlsInstance->VerifyHostFlags;
+    CopyMem (Entry->TrustDigest, TlsInstance->TrustDigest, SHA256_DIGEST_SIZE);
+  } else if (Entry->Data != NULL) {
+    ZeroMem (Entry->Data, Entry->DataSize);
+    FreePool (Entry->Data);
+  }
+
+  Entry->Data     = Data;
+  Entry->DataSize = DataSize;
+  Entry->LastUsed = ++Service->SessionCacheTick;
+}
+
+/**
+  Remove the cached session for the server of the TLS instance.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsSessionCacheRemove (
+  IN TLS_INSTANCE  *TlsInstance
+  )
+{
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+
+  if ((TlsInstance->ServerName == NULL) || (TlsInstance->TlsConn == NULL)) {
+    return;
+  }
+
+  Entry = TlsSessionCacheLookup (TlsInstance, TlsGetVerify (TlsInstance->TlsConn));
+  if (Entry != NULL) {
+    TlsSessionCacheFreeEntry (Entry);
+  }
+}
+
+/**
+  Release all the sessions cached by the TLS service.
+
+  @param[in]  Service        The TLS service data.
+
+**/
+VOID
+TlsSessionCacheFree (
+  IN TLS_SERVICE  *Service
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < TLS_SESSION_CACHE_SIZE; Index++) {
+    TlsSessionCacheFreeEntry (&Service->SessionCache[Index]);
+  }
+}
@@ -77,6 +77,7 @@ TlsEncryptPacket (
   @retval EFI_SUCCESS             The operation completed successfully.
   @retval EFI_OUT_OF_RESOURCES    Can't allocate memory resources.
   @retval EFI_ABORTED             TLS session state is incorrect.
+  @retval EFI_BUFFER_TOO_SMALL    The decrypted records do not fit in the output buffer.
   @retval Others                  Other errors as indicated.
 **/
 EFI_STATUS
@@ -86,6 +87,80 @@ TlsDecryptPacket (
   IN     UINT32                 *FragmentCount
   );
 
+/**
+  Fold a certificate or key set through the TLS configuration protocol into
+  the trust digest of the TLS instance, so that sessions verified with another
+  trust configuration are not resumed.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+  @param[in]  DataType       The configuration data type.
+  @param[in]  Data           Pointer to the configuration data.
+  @param[in]  DataSize       Size of the configuration data.
+
+  @retval EFI_SUCCESS            The trust digest is updated.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval EFI_ABORTED            The digest could not be computed.
+**/
+EFI_STATUS
+TlsSessionCacheUpdateTrust (
+  IN TLS_INSTANCE              *TlsInstance,
+  IN EFI_TLS_CONFIG_DATA_TYPE  DataType,
+  IN VOID                      *Data,
+  IN UINTN                     DataSize
+  );
+
+/**
+  Offer the cached session for the server of the TLS instance, if any, so that
+  the handshake can resume it instead of performing a full handshake.
+
+  This must be called just before the ClientHello is built, once all the
+  verification settings of the connection are final. Only connections that
+  verify the server are offered a session.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsSessionCacheRestore (
+  IN TLS_INSTANCE  *TlsInstance
+  );
+
+/**
+  Save the resumable session of the TLS instance in the session cache of its
+  TLS service, replacing the least recently used entry if the cache is full.
+
+  Only sessions whose handshake verified the server are saved.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsSessionCacheSave (
+  IN TLS_INSTANCE  *TlsInstance
+  );
+
+/**
+  Remove the cached session for the server of the TLS instance.
+
+  @param[in]  TlsInstance    The pointer to the TLS instance.
+
+**/
+VOID
+TlsSessionCacheRemove (
+  IN TLS_INSTANCE  *TlsInstance
+  );
+
+/**
+  Release all the sessions cached by the TLS service.
+
+  @param[in]  Service        The TLS service data.
+
+**/
+VOID
+TlsSessionCacheFree (
+  IN TLS_SERVICE  *Service
+  );
+
 /**
   Set TLS session data.
 
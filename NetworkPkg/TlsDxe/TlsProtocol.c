@@ -187,7 +187,21 @@ TlsSetSessionData (
       }
 
       Status = TlsSetVerifyHost (Instance->TlsConn, TlsVerifyHost->Flags, TlsVerifyHost->HostName);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
 
+      if (Instance->ServerName != NULL) {
+        FreePool (Instance->ServerName);
+      }
+
+      Instance->ServerName = AllocateCopyPool (AsciiStrSize (TlsVerifyHost->HostName), TlsVerifyHost->HostName);
+      if (Instance->ServerName == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto ON_EXIT;
+      }
+
+      Instance->VerifyHostFlags = TlsVerifyHost->Flags;
       break;
     case EfiTlsSessionID:
       if (DataSize != sizeof (EFI_TLS_SESSION_ID)) {
@@ -485,8 +499,11 @@ TlsBuildResponsePacket (
     switch (Instance->TlsSessionState) {
       case EfiTlsSessionNotStarted:
         //
-        // ClientHello.
+        // ClientHello. The verification settings are final now, so offer the
+        // session cached for the server, if any.
         //
+        TlsSessionCacheRestore (Instance);
+
         Status = TlsDoHandshake (
                    Instance->TlsConn,
                    NULL,
@@ -570,11 +587,16 @@ TlsBuildResponsePacket (
                  BufferSize
                  );
       if (EFI_ERROR (Status)) {
+        if (Status != EFI_BUFFER_TOO_SMALL) {
+          TlsSessionCacheRemove (Instance);
+        }
+
         goto ON_EXIT;
       }
 
       if (!TlsInHandshake (Instance->TlsConn)) {
         Instance->TlsSessionState = EfiTlsSessionDataTransferring;
+        TlsSessionCacheSave (Instance);
       }
     } else {
       //
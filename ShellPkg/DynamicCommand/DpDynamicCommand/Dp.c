@@ -85,6 +85,7 @@ STATIC CONST SHELL_PARAM_ITEM  ParamList[] = {
   { L"-c", TypeValue }, // -c   Display cumulative data.
   { L"-n", TypeValue }, // -n # Number of records to display for A and R
   { L"-t", TypeValue }, // -t # Threshold of interest
+  { L"-o", TypeValue }, // -o   Output Chrome trace file
   { NULL,  TypeMax   }
 };
 
@@ -459,13 +460,17 @@ GetMeasurementInfo (
       }
 
       //
-      // Currently only "DB:Start:" end record with FPDT_GUID_QWORD_STRING_EVENT_TYPE.
+      // "DB:Start:" end records and counter records use FPDT_GUID_QWORD_STRING_EVENT_TYPE.
       //
       switch (Measurement->Identifier) {
         case MODULE_DB_END_ID:
           Measurement->Token  = ALit_DB_START;
           Measurement->Module = ALit_DB_START;
           break;
+        case PERF_COUNTER_ID:
+          Measurement->Token  = ((FPDT_GUID_QWORD_STRING_EVENT_RECORD *)RecordHeader)->String;
+          Measurement->Module = ((FPDT_GUID_QWORD_STRING_EVENT_RECORD *)RecordHeader)->String;
+          break;
         default:
           ASSERT (FALSE);
       }
@@ -580,11 +585,11 @@ BuildMeasurementList (
     StartProgressId  = ((FPDT_GUID_EVENT_RECORD *)StartRecordEvent)->ProgressID;
 
     //
-    // If the record with ProgressId 0, the record doesn't appear in pairs. The timestamp in the record is the EndTimeStamp, its StartTimeStamp is 0.
+    // If the record with ProgressId 0 or PERF_COUNTER_ID, the record doesn't appear in pairs. The timestamp in the record is the EndTimeStamp, its StartTimeStamp is 0.
     // If the record is the start record, fill the info to the measurement in the mMeasurementList.
     // If the record is the end record, find the related start measurement in the mMeasurementList and fill the EndTimeStamp.
     //
-    if (StartProgressId == 0) {
+    if ((StartProgressId == 0) || (StartProgressId == PERF_COUNTER_ID)) {
       GetMeasurementInfo (RecordHeader, FALSE, &(mMeasurementList[mMeasurementNum]));
       mMeasurementNum++;
     } else if ((((StartProgressId >= PERF_EVENTSIGNAL_START_ID) && ((StartProgressId & 0x000F) == 0)) ||
@@ -687,6 +692,7 @@ RunDp (
   BOOLEAN        ExcludeMode;
   BOOLEAN        CumulativeMode;
   CONST CHAR16   *CustomCumulativeToken;
+  CONST CHAR16   *TraceFileName;
   PERF_CUM_DATA  *CustomCumulativeData;
   UINTN          NameSize;
   SHELL_STATUS   ShellStatus;
@@ -701,6 +707,7 @@ RunDp (
   ExcludeMode          = FALSE;
   CumulativeMode       = FALSE;
   CustomCumulativeData = NULL;
+  TraceFileName        = NULL;
   ShellStatus          = SHELL_SUCCESS;
 
   //
@@ -810,6 +817,14 @@ RunDp (
     }
   }
 
+  if (ShellCommandLineGetFlag (ParamPackage, L"-o")) {
+    TraceFileName = ShellCommandLineGetValue (ParamPackage, L"-o");
+    if (TraceFileName == NULL) {
+      ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_TOO_FEW), mDpHiiHandle);
+      return SHELL_INVALID_PARAMETER;
+    }
+  }
+
   //
   // DP dump performance data by parsing FPDT table in ACPI table.
   // Folloing 3 steps are to get the measurement form the FPDT table.
@@ -910,13 +925,23 @@ RunDp (
   ****                      Default is 0 for All and Raw mode
   ****                      Default is DEFAULT_THRESHOLD for "Cooked" mode
   ****    n Number2Display  Used by All and Raw mode.  Otherwise ignored.
+  ****    o Output      --  All other modes are ignored
   ****    A All         --  R and S options are ignored
   ****    R Raw         --  S option is ignored
   ****    s Summary     --  Modifies "Cooked" output only
   ****    Cooked (Default)
   ****************************************************************************/
   GatherStatistics (CustomCumulativeData);
-  if (CumulativeMode) {
+  if (TraceFileName != NULL) {
+    Status = DumpChromeTrace (TraceFileName);
+    if (Status == EFI_ABORTED) {
+      ShellStatus = SHELL_ABORTED;
+      goto Done;
+    } else if (EFI_ERROR (Status)) {
+      ShellStatus = SHELL_DEVICE_ERROR;
+      goto Done;
+    }
+  } else if (CumulativeMode) {
     ProcessCumulative (CustomCumulativeData);
   } else if (AllMode) {
     Status = DumpAllTrace (Number2Display, ExcludeMode);
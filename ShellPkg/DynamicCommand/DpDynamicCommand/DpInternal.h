@@ -15,6 +15,7 @@
 #define _DP_INTELNAL_H_
 
 #define DP_GAUGE_STRING_LENGTH  36
+#define DP_TRACE_LINE_LENGTH    512
 
 //
 /// Module-Global Variables
@@ -244,6 +245,25 @@ DumpRawTrace (
   IN BOOLEAN  ExcludeFlag
   );
 
+/**
+  Write all Trace Records to a file in the Chrome trace event format.
+
+  Every complete record becomes a complete event whose time stamps are in
+  microseconds, so that the nested records of a phase or an image are shown on
+  one timeline by chrome://tracing or Perfetto. Records that only have one time
+  stamp become instant events.
+
+  @param[in]    FileName    The name of the file to write.
+
+  @retval EFI_SUCCESS           The operation was successful.
+  @retval EFI_ABORTED           The user aborts the operation.
+  @return Others                The file could not be written.
+**/
+EFI_STATUS
+DumpChromeTrace (
+  IN CONST CHAR16  *FileName
+  );
+
 /**
   Gather and print Major Phase metrics.
 
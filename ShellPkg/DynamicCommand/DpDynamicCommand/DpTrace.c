@@ -470,6 +470,195 @@ DumpRawTrace (
   return Status;
 }
 
+/**
+  Copy a string into an ASCII JSON string value.
+
+  The characters that would need an escape sequence in JSON are replaced by '_'.
+
+  @param[out]   Destination   The ASCII buffer to fill.
+  @param[in]    DestMax       The number of characters Destination can hold, including the terminator.
+  @param[in]    Source        The string to copy.
+**/
+VOID
+DpCopyJsonString (
+  OUT CHAR8         *Destination,
+  IN  UINTN         DestMax,
+  IN  CONST CHAR16  *Source
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; (Index + 1 < DestMax) && (Source[Index] != L'\0'); Index++) {
+    if ((Source[Index] < L' ') || (Source[Index] > L'~') || (Source[Index] == L'"') || (Source[Index] == L'\\')) {
+      Destination[Index] = '_';
+    } else {
+      Destination[Index] = (CHAR8)Source[Index];
+    }
+  }
+
+  Destination[Index] = '\0';
+}
+
+/**
+  Write all Trace Records to a file in the Chrome trace event format.
+
+  Every complete record becomes a complete event whose time stamps are in
+  microseconds, so that the nested records of a phase or an image are shown on
+  one timeline by chrome://tracing or Perfetto. Records that only have one time
+  stamp become instant events.
+
+  @param[in]    FileName    The name of the file to write.
+
+  @retval EFI_SUCCESS           The operation was successful.
+  @retval EFI_ABORTED           The user aborts the operation.
+  @return Others                The file could not be written.
+**/
+EFI_STATUS
+DumpChromeTrace (
+  IN CONST CHAR16  *FileName
+  )
+{
+  MEASUREMENT_RECORD  Measurement;
+  SHELL_FILE_HANDLE   FileHandle;
+  EFI_HANDLE          *HandleBuffer;
+  UINTN               HandleCount;
+  UINTN               LogEntryKey;
+  UINTN               Count;
+  UINTN               TIndex;
+  UINT64              TimeStamp;
+  UINT64              Duration;
+  UINT32              Remainder;
+  UINT32              DurRemainder;
+  CHAR8               Name[DP_GAUGE_STRING_LENGTH + 1];
+  CHAR8               Category[DXE_PERFORMANCE_STRING_SIZE];
+  CHAR8               Line[DP_TRACE_LINE_LENGTH];
+  UINTN               Size;
+  EFI_STATUS          Status;
+
+  if (!EFI_ERROR (ShellFileExists (FileName))) {
+    ShellDeleteFileByName (FileName);
+  }
+
+  Status = ShellOpenFileByName (
+             FileName,
+             &FileHandle,
+             EFI_FILE_MODE_CREATE | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ,
+             0
+             );
+  if (EFI_ERROR (Status)) {
+    ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_FILE_OPEN_ERROR), mDpHiiHandle, FileName, Status);
+    return Status;
+  }
+
+  Status = gBS->LocateHandleBuffer (AllHandles, NULL, NULL, &HandleCount, &HandleBuffer);
+  if (EFI_ERROR (Status)) {
+    HandleBuffer = NULL;
+    HandleCount  = 0;
+  }
+
+  Size   = AsciiSPrint (Line, sizeof (Line), "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  Status = ShellWriteFile (FileHandle, &Size, Line);
+
+  LogEntryKey = 0;
+  Count       = 0;
+  while (!EFI_ERROR (Status) &&
+         ((LogEntryKey = GetPerformanceMeasurementRecord (
+                           LogEntryKey,
+                           &Measurement.Handle,
+                           &Measurement.Token,
+                           &Measurement.Module,
+                           &Measurement.StartTimeStamp,
+                           &Measurement.EndTimeStamp,
+                           &Measurement.Identifier
+                           )) != 0)
+         )
+  {
+    //
+    // Name the event like the All mode does: driver name, PEIM GUID, then Module or Token.
+    //
+    AsciiStrToUnicodeStrS (Measurement.Module, mGaugeString, ARRAY_SIZE (mGaugeString));
+    AsciiStrToUnicodeStrS (Measurement.Token, mUnicodeToken, ARRAY_SIZE (mUnicodeToken));
+    if (Measurement.Handle != NULL) {
+      for (TIndex = 0; TIndex < HandleCount; TIndex++) {
+        if (Measurement.Handle == HandleBuffer[TIndex]) {
+          DpGetNameFromHandle (HandleBuffer[TIndex]);
+          break;
+        }
+      }
+    }
+
+    if (AsciiStrCmp (Measurement.Token, ALit_PEIM) == 0) {
+      UnicodeSPrint (mGaugeString, sizeof (mGaugeString), L"%g", Measurement.Handle);
+    }
+
+    mGaugeString[DP_GAUGE_STRING_LENGTH] = 0;
+    DpCopyJsonString (Name, sizeof (Name), (mGaugeString[0] != L'\0') ? mGaugeString : mUnicodeToken);
+    DpCopyJsonString (Category, sizeof (Category), mUnicodeToken);
+
+    //
+    // A record without start time stamp is logged once at its end, and an
+    // incomplete record has no end time stamp.
+    //
+    if ((Measurement.StartTimeStamp != 0) && (Measurement.EndTimeStamp != 0)) {
+      TimeStamp = DivU64x32Remainder (Measurement.StartTimeStamp, 1000, &Remainder);
+      Duration  = DivU64x32Remainder (GetDuration (&Measurement), 1000, &DurRemainder);
+      Size      = AsciiSPrint (
+                    Line,
+                    sizeof (Line),
+                    "%a{\"name\":\"%a\",\"cat\":\"%a\",\"ph\":\"X\",\"ts\":%Lu.%03d,\"dur\":%Lu.%03d,\"pid\":0,\"tid\":0,\"args\":{\"id\":%d}}",
+                    (Count == 0) ? "" : ",\n",
+                    Name,
+                    Category,
+                    TimeStamp,
+                    Remainder,
+                    Duration,
+                    DurRemainder,
+                    Measurement.Identifier
+                    );
+    } else {
+      TimeStamp = (Measurement.StartTimeStamp != 0) ? Measurement.StartTimeStamp : Measurement.EndTimeStamp;
+      TimeStamp = DivU64x32Remainder (TimeStamp, 1000, &Remainder);
+      Size      = AsciiSPrint (
+                    Line,
+                    sizeof (Line),
+                    "%a{\"name\":\"%a\",\"cat\":\"%a\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%Lu.%03d,\"pid\":0,\"tid\":0,\"args\":{\"id\":%d}}",
+                    (Count == 0) ? "" : ",\n",
+                    Name,
+                    Category,
+                    TimeStamp,
+                    Remainder,
+                    Measurement.Identifier
+                    );
+    }
+
+    Status = ShellWriteFile (FileHandle, &Size, Line);
+    Count++;
+
+    if (ShellGetExecutionBreakFlag ()) {
+      Status = EFI_ABORTED;
+    }
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Size   = AsciiSPrint (Line, sizeof (Line), "\n]}\n");
+    Status = ShellWriteFile (FileHandle, &Size, Line);
+  }
+
+  ShellCloseFile (&FileHandle);
+
+  if (HandleBuffer != NULL) {
+    FreePool (HandleBuffer);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_TRACE_WRITTEN), mDpHiiHandle, Count, FileName);
+  } else if (Status != EFI_ABORTED) {
+    ShellPrintHiiEx (-1, -1, NULL, STRING_TOKEN (STR_DP_FILE_WRITE_ERROR), mDpHiiHandle, FileName, Status);
+  }
+
+  return Status;
+}
+
 /**
   Gather and print Major Phase metrics.
 
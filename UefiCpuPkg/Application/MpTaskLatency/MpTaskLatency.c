@@ -0,0 +1,169 @@
+/** @file
+  UEFI Application to measure the dispatch latency of MpTaskLib.
+
+  The application times an empty job dispatched to all enabled processors through
+  EFI_MP_SERVICES_PROTOCOL.StartupAllAPs(), through MpTaskParallelFor(), and through
+  MpTaskParallelFor() with the APs parked.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/MpTaskLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Protocol/MpService.h>
+
+#define MP_TASK_LATENCY_ITERATIONS  1000
+
+/**
+  The empty AP procedure timed with StartupAllAPs().
+
+  @param[in, out]  Buffer  Unused.
+
+**/
+VOID
+EFIAPI
+EmptyApProcedure (
+  IN OUT VOID  *Buffer
+  )
+{
+}
+
+/**
+  The loop body timed with MpTaskParallelFor(). It counts the iterations run.
+
+  @param[in]  Index      Unused.
+  @param[in]  Context    The counter.
+
+**/
+VOID
+EFIAPI
+CountingBody (
+  IN UINTN  Index,
+  IN VOID   *Context
+  )
+{
+  InterlockedIncrement ((volatile UINT32 *)Context);
+}
+
+/**
+  Print the average time of one dispatch.
+
+  @param[in]  Name       The name of the dispatch method.
+  @param[in]  Start      The performance counter before the first dispatch.
+  @param[in]  End        The performance counter after the last dispatch.
+
+**/
+VOID
+PrintAverage (
+  IN CHAR16  *Name,
+  IN UINT64  Start,
+  IN UINT64  End
+  )
+{
+  UINT64  Nanoseconds;
+
+  Nanoseconds = GetTimeInNanoSecond (End - Start);
+  Print (L"%-28s: %8Ld ns per dispatch\n", Name, DivU64x32 (Nanoseconds, MP_TASK_LATENCY_ITERATIONS));
+}
+
+/**
+  Time MpTaskParallelFor() with one iteration per worker.
+
+  @param[in]  Name         The name of the dispatch method.
+  @param[in]  WorkerCount  The number of workers.
+
+**/
+VOID
+TimeParallelFor (
+  IN CHAR16  *Name,
+  IN UINTN   WorkerCount
+  )
+{
+  volatile UINT32  Counter;
+  UINTN            Iteration;
+  UINT64           Start;
+  UINT64           End;
+
+  Counter = 0;
+  Start   = GetPerformanceCounter ();
+  for (Iteration = 0; Iteration < MP_TASK_LATENCY_ITERATIONS; Iteration++) {
+    MpTaskParallelFor (0, WorkerCount, 1, CountingBody, (VOID *)&Counter);
+  }
+
+  End = GetPerformanceCounter ();
+
+  PrintAverage (Name, Start, End);
+  if (Counter != WorkerCount * MP_TASK_LATENCY_ITERATIONS) {
+    Print (L"  %u of %u iterations ran!\n", Counter, (UINT32)(WorkerCount * MP_TASK_LATENCY_ITERATIONS));
+  }
+}
+
+/**
+  The user Entry Point for Application. The user code starts with this function
+  as the real entry point for the application.
+
+  @param[in] ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in] SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS       The entry point is executed successfully.
+  @retval other             Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+UefiMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  UINTN                     WorkerCount;
+  UINTN                     Iteration;
+  UINT64                    Start;
+  UINT64                    End;
+
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    Print (L"MP services not found: %r\n", Status);
+    return Status;
+  }
+
+  WorkerCount = MpTaskGetWorkerCount ();
+  Print (L"%d processors, %d iterations\n", (UINT32)WorkerCount, MP_TASK_LATENCY_ITERATIONS);
+  if (WorkerCount <= 1) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Start = GetPerformanceCounter ();
+  for (Iteration = 0; Iteration < MP_TASK_LATENCY_ITERATIONS; Iteration++) {
+    Status = MpServices->StartupAllAPs (MpServices, EmptyApProcedure, FALSE, NULL, 0, NULL, NULL);
+    if (EFI_ERROR (Status)) {
+      Print (L"StartupAllAPs: %r\n", Status);
+      return Status;
+    }
+  }
+
+  End = GetPerformanceCounter ();
+  PrintAverage (L"StartupAllAPs", Start, End);
+
+  TimeParallelFor (L"MpTaskParallelFor", WorkerCount);
+
+  Status = MpTaskParkAps ();
+  if (EFI_ERROR (Status)) {
+    Print (L"MpTaskParkAps: %r\n", Status);
+    return Status;
+  }
+
+  TimeParallelFor (L"MpTaskParallelFor (parked)", WorkerCount);
+  MpTaskReleaseAps ();
+
+  return EFI_SUCCESS;
+}
@@ -1029,6 +1029,8 @@ InitializeCpu (
                   &mCpuHandle,
                   &gEfiCpuArchProtocolGuid,
                   &gCpu,
+                  &gEdkiiMemoryAttributeBatchProtocolGuid,
+                  &mMemoryAttributeBatch,
                   NULL
                   );
   ASSERT_EFI_ERROR (Status);
@@ -59,6 +59,7 @@
 #define PAGING_1G_ADDRESS_MASK_64  0x000FFFFFC0000000ull
 
 #define MAX_PF_ENTRY_COUNT        10
+#define MAX_PENDING_PAGE_TABLES   64
 #define MAX_DEBUG_MESSAGE_LENGTH  0x100
 #define IA32_PF_EC_ID             BIT4
 
@@ -98,6 +99,28 @@ EFI_SMM_BASE2_PROTOCOL         *mSmmBase2 = NULL;
 UINTN  *mPFEntryCount;
 UINT64                    *(*mLastPFEntryPointer)[MAX_PF_ENTRY_COUNT];
 
+//
+// Memory attribute batch. While a batch is open, TLB flushes that only take away
+// access rights are deferred to the end of the batch, and the range touched by
+// the batch is recorded so that its page tables can be merged back into large
+// pages when the batch is committed.
+//
+UINTN             mPageTableBatchDepth        = 0;
+BOOLEAN           mPageTableBatchFlushPending = FALSE;
+PHYSICAL_ADDRESS  mPageTableBatchStart        = MAX_UINT64;
+PHYSICAL_ADDRESS  mPageTableBatchEnd          = 0;
+
+//
+// Page tables freed by merges. The TLB and the paging structure caches may still
+// reference a freed page table until the TLB is flushed, so it is kept in
+// mPendingPageTables, and is only put on mFreePageTableList, linked through its
+// first entry, after the flush.
+//
+VOID                                     *mPendingPageTables[MAX_PENDING_PAGE_TABLES];
+UINTN                                    mPendingPageTableCount = 0;
+VOID                                     *mFreePageTableList    = NULL;
+EDKII_MEMORY_ATTRIBUTE_BATCH_STATISTICS  mPageTableStatistics;
+
 /**
  Check if current execution environment is in SMM mode or not, via
  EFI_SMM_BASE2_PROTOCOL.
@@ -271,28 +294,45 @@ PageAttributeToMask (
 }
 
 /**
-  Return page table entry to match the address.
+  Return the mask of the bits used for memory encryption in page entries.
+
+  @return The address encryption mask.
+**/
+UINT64
+GetPageTableAddressEncMask (
+  VOID
+  )
+{
+  UINT64  AddressEncMask;
+
+  // Make sure AddressEncMask is contained to smallest supported address field.
+  //
+  AddressEncMask = PcdGet64 (PcdPteMemoryEncryptionAddressOrMask) & PAGING_1G_ADDRESS_MASK_64;
+  if (AddressEncMask == 0) {
+    AddressEncMask = PcdGet64 (PcdTdxSharedBitMask) & PAGING_1G_ADDRESS_MASK_64;
+  }
+
+  return AddressEncMask;
+}
+
+/**
+  Return the page directory pointer table entry to match the address.
 
   @param[in]  PagingContext     The paging context.
   @param[in]  Address           The address to be checked.
-  @param[out] PageAttributes    The page attribute of the page entry.
 
-  @return The page entry.
+  @return The page directory pointer table entry, or NULL if the upper level
+          page tables do not map the address.
 **/
-VOID *
-GetPageTableEntry (
+UINT64 *
+GetPageDirectoryPointerEntry (
   IN  PAGE_TABLE_LIB_PAGING_CONTEXT  *PagingContext,
-  IN  PHYSICAL_ADDRESS               Address,
-  OUT PAGE_ATTRIBUTE                 *PageAttribute
+  IN  PHYSICAL_ADDRESS               Address
   )
 {
-  UINTN   Index1;
-  UINTN   Index2;
   UINTN   Index3;
   UINTN   Index4;
   UINTN   Index5;
-  UINT64  *L1PageTable;
-  UINT64  *L2PageTable;
   UINT64  *L3PageTable;
   UINT64  *L4PageTable;
   UINT64  *L5PageTable;
@@ -303,21 +343,13 @@ GetPageTableEntry (
   Index5 = ((UINTN)RShiftU64 (Address, 48)) & PAGING_PAE_INDEX_MASK;
   Index4 = ((UINTN)RShiftU64 (Address, 39)) & PAGING_PAE_INDEX_MASK;
   Index3 = ((UINTN)Address >> 30) & PAGING_PAE_INDEX_MASK;
-  Index2 = ((UINTN)Address >> 21) & PAGING_PAE_INDEX_MASK;
-  Index1 = ((UINTN)Address >> 12) & PAGING_PAE_INDEX_MASK;
 
-  // Make sure AddressEncMask is contained to smallest supported address field.
-  //
-  AddressEncMask = PcdGet64 (PcdPteMemoryEncryptionAddressOrMask) & PAGING_1G_ADDRESS_MASK_64;
-  if (AddressEncMask == 0) {
-    AddressEncMask = PcdGet64 (PcdTdxSharedBitMask) & PAGING_1G_ADDRESS_MASK_64;
-  }
+  AddressEncMask = GetPageTableAddressEncMask ();
 
   if (PagingContext->MachineType == IMAGE_FILE_MACHINE_X64) {
     if ((PagingContext->ContextData.X64.Attributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_5_LEVEL) != 0) {
       L5PageTable = (UINT64 *)(UINTN)PagingContext->ContextData.X64.PageTableBase;
       if (L5PageTable[Index5] == 0) {
-        *PageAttribute = PageNone;
         return NULL;
       }
 
@@ -327,7 +359,6 @@ GetPageTableEntry (
     }
 
     if (L4PageTable[Index4] == 0) {
-      *PageAttribute = PageNone;
       return NULL;
     }
 
@@ -337,18 +368,50 @@ GetPageTableEntry (
     L3PageTable = (UINT64 *)(UINTN)PagingContext->ContextData.Ia32.PageTableBase;
   }
 
-  if (L3PageTable[Index3] == 0) {
+  return &L3PageTable[Index3];
+}
+
+/**
+  Return page table entry to match the address.
+
+  @param[in]  PagingContext     The paging context.
+  @param[in]  Address           The address to be checked.
+  @param[out] PageAttributes    The page attribute of the page entry.
+
+  @return The page entry.
+**/
+VOID *
+GetPageTableEntry (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT  *PagingContext,
+  IN  PHYSICAL_ADDRESS               Address,
+  OUT PAGE_ATTRIBUTE                 *PageAttribute
+  )
+{
+  UINTN   Index1;
+  UINTN   Index2;
+  UINT64  *L1PageTable;
+  UINT64  *L2PageTable;
+  UINT64  *L3Entry;
+  UINT64  AddressEncMask;
+
+  Index2 = ((UINTN)Address >> 21) & PAGING_PAE_INDEX_MASK;
+  Index1 = ((UINTN)Address >> 12) & PAGING_PAE_INDEX_MASK;
+
+  AddressEncMask = GetPageTableAddressEncMask ();
+
+  L3Entry = GetPageDirectoryPointerEntry (PagingContext, Address);
+  if ((L3Entry == NULL) || (*L3Entry == 0)) {
     *PageAttribute = PageNone;
     return NULL;
   }
 
-  if ((L3PageTable[Index3] & IA32_PG_PS) != 0) {
+  if ((*L3Entry & IA32_PG_PS) != 0) {
     // 1G
     *PageAttribute = Page1G;
-    return &L3PageTable[Index3];
+    return L3Entry;
   }
 
-  L2PageTable = (UINT64 *)(UINTN)(L3PageTable[Index3] & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
+  L2PageTable = (UINT64 *)(UINTN)(*L3Entry & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
   if (L2PageTable[Index2] == 0) {
     *PageAttribute = PageNone;
     return NULL;
@@ -701,6 +764,8 @@ EnableReadOnlyPageWriteProtect (
                                 NULL mean page split is unsupported.
   @param[out] IsSplitted        TRUE means page table splitted. FALSE means page table not splitted.
   @param[out] IsModified        TRUE means page table modified. FALSE means page table not modified.
+  @param[out] IsRelaxed         TRUE means access rights were granted to some page, which must be
+                                made visible with a TLB flush before the memory is accessed.
 
   @retval RETURN_SUCCESS           The attributes were modified for the memory region.
   @retval RETURN_ACCESS_DENIED     The attributes for the memory resource range specified by
@@ -724,11 +789,13 @@ ConvertMemoryPageAttributes (
   IN  PAGE_ACTION                    PageAction,
   IN  PAGE_TABLE_LIB_ALLOCATE_PAGES  AllocatePagesFunc OPTIONAL,
   OUT BOOLEAN                        *IsSplitted   OPTIONAL,
-  OUT BOOLEAN                        *IsModified   OPTIONAL
+  OUT BOOLEAN                        *IsModified   OPTIONAL,
+  OUT BOOLEAN                        *IsRelaxed    OPTIONAL
   )
 {
   PAGE_TABLE_LIB_PAGING_CONTEXT  CurrentPagingContext;
   UINT64                         *PageEntry;
+  UINT64                         OldPageEntry;
   PAGE_ATTRIBUTE                 PageAttribute;
   UINTN                          PageEntryLength;
   PAGE_ATTRIBUTE                 SplitAttribute;
@@ -803,6 +870,10 @@ ConvertMemoryPageAttributes (
     *IsModified = FALSE;
   }
 
+  if (IsRelaxed != NULL) {
+    *IsRelaxed = FALSE;
+  }
+
   if (AllocatePagesFunc == NULL) {
     AllocatePagesFunc = AllocatePageTableMemory;
   }
@@ -829,11 +900,23 @@ ConvertMemoryPageAttributes (
     PageEntryLength = PageAttributeToLength (PageAttribute);
     SplitAttribute  = NeedSplitPage (BaseAddress, Length, PageEntry, PageAttribute);
     if (SplitAttribute == PageNone) {
+      OldPageEntry = *PageEntry;
       ConvertPageEntryAttribute (&CurrentPagingContext, PageEntry, Attributes, PageAction, &IsEntryModified);
       if (IsEntryModified) {
         if (IsModified != NULL) {
           *IsModified = TRUE;
         }
+
+        //
+        // Stale TLB entries with less access rights than the new entry would
+        // fault on the next access.
+        //
+        if ((IsRelaxed != NULL) &&
+            ((((*PageEntry & ~OldPageEntry) & (IA32_PG_P | IA32_PG_RW)) != 0) ||
+             (((OldPageEntry & ~*PageEntry) & IA32_PG_NX) != 0)))
+        {
+          *IsRelaxed = TRUE;
+        }
       }
 
       //
@@ -853,6 +936,8 @@ ConvertMemoryPageAttributes (
         goto Done;
       }
 
+      mPageTableStatistics.PageSplits++;
+
       if (IsSplitted != NULL) {
         *IsSplitted = TRUE;
       }
@@ -920,25 +1005,354 @@ AssignMemoryPageAttributes (
   RETURN_STATUS  Status;
   BOOLEAN        IsModified;
   BOOLEAN        IsSplitted;
+  BOOLEAN        IsRelaxed;
+  UINT64         StartTick;
+
+  StartTick = GetPerformanceCounter ();
 
   //  DEBUG((DEBUG_INFO, "AssignMemoryPageAttributes: 0x%lx - 0x%lx (0x%lx)\n", BaseAddress, Length, Attributes));
-  Status = ConvertMemoryPageAttributes (PagingContext, BaseAddress, Length, Attributes, PageActionAssign, AllocatePagesFunc, &IsSplitted, &IsModified);
+  Status = ConvertMemoryPageAttributes (PagingContext, BaseAddress, Length, Attributes, PageActionAssign, AllocatePagesFunc, &IsSplitted, &IsModified, &IsRelaxed);
   if (!EFI_ERROR (Status)) {
     if ((PagingContext == NULL) && IsModified) {
-      //
-      // Flush TLB as last step.
-      //
-      // Note: Since APs will always init CR3 register in HLT loop mode or do
-      // TLB flush in MWAIT loop mode, there's no need to flush TLB for them
-      // here.
-      //
-      CpuFlushTlb ();
+      if (mPageTableBatchDepth > 0) {
+        mPageTableBatchStart = MIN (mPageTableBatchStart, BaseAddress);
+        mPageTableBatchEnd   = MAX (mPageTableBatchEnd, BaseAddress + Length);
+      }
+
+      if ((mPageTableBatchDepth > 0) && !IsRelaxed) {
+        //
+        // Only access rights were taken away, so the stale TLB entries cannot
+        // fault. Leave the flush to the end of the batch.
+        //
+        mPageTableBatchFlushPending = TRUE;
+        mPageTableStatistics.DeferredTlbFlushes++;
+      } else {
+        //
+        // Flush TLB as last step.
+        //
+        // Note: Since APs will always init CR3 register in HLT loop mode or do
+        // TLB flush in MWAIT loop mode, there's no need to flush TLB for them
+        // here.
+        //
+        CpuFlushTlb ();
+        mPageTableBatchFlushPending = FALSE;
+        mPageTableStatistics.TlbFlushes++;
+      }
+    }
+
+    if (IsModified) {
+      mPageTableStatistics.SetAttributeCalls++;
+      mPageTableStatistics.UpdateTimeInNs += GetTimeInNanoSecond (GetPerformanceCounter () - StartTick);
     }
   }
 
   return Status;
 }
 
+/**
+  Flush the TLB, and put the page tables freed by merges on the free list.
+
+  The caller must disable write protection.
+
+**/
+VOID
+FlushTlbAndFreePageTables (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  CpuFlushTlb ();
+  mPageTableBatchFlushPending = FALSE;
+  mPageTableStatistics.TlbFlushes++;
+
+  for (Index = 0; Index < mPendingPageTableCount; Index++) {
+    *(VOID **)mPendingPageTables[Index] = mFreePageTableList;
+    mFreePageTableList                  = mPendingPageTables[Index];
+  }
+
+  mPageTableStatistics.FreePageTablePages += mPendingPageTableCount;
+  mPendingPageTableCount                   = 0;
+}
+
+/**
+  Merge the page table referenced by an entry into one large page, if all entries
+  of the page table map contiguous memory with the same attributes.
+
+  The freed page table is left untouched until FlushTlbAndFreePageTables() is
+  called. If too many page tables are freed, the TLB is flushed here. The caller
+  must disable write protection.
+
+  @param[in, out] ParentEntry      The entry that references the page table.
+  @param[in]      ChildAttribute   The page size mapped by each entry of the page table.
+
+  @retval TRUE    The page table is merged into ParentEntry.
+  @retval FALSE   The page table cannot be merged.
+**/
+BOOLEAN
+MergePageTable (
+  IN OUT UINT64          *ParentEntry,
+  IN     PAGE_ATTRIBUTE  ChildAttribute
+  )
+{
+  UINT64  *PageTable;
+  UINT64  AddressMask;
+  UINT64  ChildLength;
+  UINT64  FirstAddress;
+  UINT64  Attributes;
+  UINT64  AccessedDirty;
+  UINT64  NewEntry;
+  UINTN   Index;
+
+  //
+  // The parent must reference a page table and must not take any access rights
+  // away from its entries, as those would be lost in the merged entry.
+  //
+  if (((*ParentEntry & IA32_PG_P) == 0) || ((*ParentEntry & IA32_PG_PS) != 0) ||
+      ((*ParentEntry & IA32_PG_RW) == 0) || ((*ParentEntry & IA32_PG_NX) != 0))
+  {
+    return FALSE;
+  }
+
+  PageTable    = (UINT64 *)(UINTN)(*ParentEntry & ~GetPageTableAddressEncMask () & PAGING_4K_ADDRESS_MASK_64);
+  AddressMask  = PageAttributeToMask (ChildAttribute);
+  ChildLength  = PageAttributeToLength (ChildAttribute);
+  FirstAddress = PageTable[0] & AddressMask;
+  Attributes   = PageTable[0] & ~AddressMask & ~(UINT64)(IA32_PG_A | IA32_PG_D);
+
+  if ((ChildAttribute == Page2M) && ((Attributes & IA32_PG_PS) == 0)) {
+    return FALSE;
+  }
+
+  if (((FirstAddress & ~GetPageTableAddressEncMask ()) & (ChildLength * (PAGING_PAE_INDEX_MASK + 1) - 1)) != 0) {
+    return FALSE;
+  }
+
+  AccessedDirty = 0;
+  for (Index = 0; Index <= PAGING_PAE_INDEX_MASK; Index++) {
+    if (((PageTable[Index] & AddressMask) != FirstAddress + ChildLength * Index) ||
+        ((PageTable[Index] & ~AddressMask & ~(UINT64)(IA32_PG_A | IA32_PG_D)) != Attributes))
+    {
+      return FALSE;
+    }
+
+    AccessedDirty |= PageTable[Index] & (IA32_PG_A | IA32_PG_D);
+  }
+
+  if (ChildAttribute == Page4K) {
+    //
+    // The PAT bit moves from bit 7 in a 4K entry to bit 12 in a 2M entry.
+    //
+    NewEntry = FirstAddress | (Attributes & ~(UINT64)IA32_PG_PAT_4K) | IA32_PG_PS;
+    if ((Attributes & IA32_PG_PAT_4K) != 0) {
+      NewEntry |= IA32_PG_PAT_2M;
+    }
+  } else {
+    NewEntry = FirstAddress | Attributes;
+  }
+
+  NewEntry |= AccessedDirty;
+  if ((*ParentEntry & IA32_PG_U) == 0) {
+    NewEntry &= ~(UINT64)IA32_PG_U;
+  }
+
+  if (mPendingPageTableCount == MAX_PENDING_PAGE_TABLES) {
+    FlushTlbAndFreePageTables ();
+  }
+
+  *ParentEntry = NewEntry;
+
+  mPendingPageTables[mPendingPageTableCount++] = PageTable;
+  mPageTableStatistics.PageMerges++;
+  return TRUE;
+}
+
+/**
+  Merge the page tables mapping a memory range back into large pages where possible.
+
+  The caller must call FlushTlbAndFreePageTables() if any page table is merged,
+  and must disable write protection.
+
+  @param[in]  PagingContext     The paging context.
+  @param[in]  BaseAddress       The start address of the memory range.
+  @param[in]  EndAddress        The end address of the memory range.
+
+  @retval TRUE    Some page tables are merged.
+  @retval FALSE   No page table is merged.
+**/
+BOOLEAN
+CompactPageTable (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT  *PagingContext,
+  IN  PHYSICAL_ADDRESS               BaseAddress,
+  IN  PHYSICAL_ADDRESS               EndAddress
+  )
+{
+  PHYSICAL_ADDRESS  Address;
+  UINT64            *L3Entry;
+  UINT64            *L2PageTable;
+  UINTN             Index;
+  BOOLEAN           IsMerged;
+  UINT32            *Attributes;
+
+  GetPagingDetails (&PagingContext->ContextData, NULL, &Attributes);
+
+  IsMerged = FALSE;
+  for (Address = BaseAddress & ~(UINT64)PAGING_1G_MASK; Address < EndAddress; Address += SIZE_1GB) {
+    L3Entry = GetPageDirectoryPointerEntry (PagingContext, Address);
+    if ((L3Entry == NULL) || ((*L3Entry & IA32_PG_P) == 0) || ((*L3Entry & IA32_PG_PS) != 0)) {
+      continue;
+    }
+
+    L2PageTable = (UINT64 *)(UINTN)(*L3Entry & ~GetPageTableAddressEncMask () & PAGING_4K_ADDRESS_MASK_64);
+    for (Index = 0; Index <= PAGING_PAE_INDEX_MASK; Index++) {
+      if (((L2PageTable[Index] & IA32_PG_P) != 0) && ((L2PageTable[Index] & IA32_PG_PS) == 0)) {
+        IsMerged |= MergePageTable (&L2PageTable[Index], Page4K);
+      }
+    }
+
+    //
+    // A PAE page directory pointer table entry cannot map a 1G page.
+    //
+    if ((PagingContext->MachineType == IMAGE_FILE_MACHINE_X64) &&
+        ((*Attributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_PAGE_1G_SUPPORT) != 0))
+    {
+      IsMerged |= MergePageTable (L3Entry, Page2M);
+    }
+  }
+
+  return IsMerged;
+}
+
+/**
+  Start a batch of memory attribute updates.
+
+  @param  This              The EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL instance.
+
+  @retval EFI_SUCCESS       The batch is started.
+
+**/
+EFI_STATUS
+EFIAPI
+MemoryAttributeBatchBegin (
+  IN  EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL  *This
+  )
+{
+  mPageTableBatchDepth++;
+  return EFI_SUCCESS;
+}
+
+/**
+  End a batch of memory attribute updates. When the outermost batch ends, the
+  page tables touched by the batch are merged into large pages where possible,
+  and the TLB is flushed once if any update was deferred.
+
+  @param  This              The EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL instance.
+
+  @retval EFI_SUCCESS       The batch is committed.
+  @retval EFI_NOT_STARTED   No batch is in progress.
+
+**/
+EFI_STATUS
+EFIAPI
+MemoryAttributeBatchCommit (
+  IN  EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL  *This
+  )
+{
+  PAGE_TABLE_LIB_PAGING_CONTEXT  CurrentPagingContext;
+  UINTN                          *PageTableBase;
+  UINT32                         *Attributes;
+  BOOLEAN                        IsWpEnabled;
+  EFI_TPL                        OldTpl;
+
+  if (mPageTableBatchDepth == 0) {
+    return EFI_NOT_STARTED;
+  }
+
+  mPageTableBatchDepth--;
+  if (mPageTableBatchDepth > 0) {
+    return EFI_SUCCESS;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+
+  if ((mPageTableBatchStart < mPageTableBatchEnd) && !IsInSmm ()) {
+    GetCurrentPagingContext (&CurrentPagingContext);
+    GetPagingDetails (&CurrentPagingContext.ContextData, &PageTableBase, &Attributes);
+    if ((*PageTableBase != 0) &&
+        ((*Attributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_PAE) != 0))
+    {
+      IsWpEnabled = IsReadOnlyPageWriteProtected ();
+      if (IsWpEnabled) {
+        DisableReadOnlyPageWriteProtect ();
+      }
+
+      if (CompactPageTable (&CurrentPagingContext, mPageTableBatchStart, mPageTableBatchEnd)) {
+        FlushTlbAndFreePageTables ();
+      }
+
+      if (IsWpEnabled) {
+        EnableReadOnlyPageWriteProtect ();
+      }
+    }
+  }
+
+  if (mPageTableBatchFlushPending) {
+    CpuFlushTlb ();
+    mPageTableBatchFlushPending = FALSE;
+    mPageTableStatistics.TlbFlushes++;
+  }
+
+  mPageTableBatchStart = MAX_UINT64;
+  mPageTableBatchEnd   = 0;
+
+  gBS->RestoreTPL (OldTpl);
+
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: %ld updates in %ld us, %ld TLB flushes (%ld deferred), %ld splits, %ld merges\n",
+    __func__,
+    mPageTableStatistics.SetAttributeCalls,
+    DivU64x32 (mPageTableStatistics.UpdateTimeInNs, 1000),
+    mPageTableStatistics.TlbFlushes,
+    mPageTableStatistics.DeferredTlbFlushes,
+    mPageTableStatistics.PageSplits,
+    mPageTableStatistics.PageMerges
+    ));
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the page table update counters.
+
+  @param  This              The EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL instance.
+  @param  Statistics        Returns the counters.
+
+  @retval EFI_SUCCESS           The counters are returned.
+  @retval EFI_INVALID_PARAMETER Statistics is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+MemoryAttributeBatchGetStatistics (
+  IN  EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL    *This,
+  OUT EDKII_MEMORY_ATTRIBUTE_BATCH_STATISTICS  *Statistics
+  )
+{
+  if (Statistics == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CopyMem (Statistics, &mPageTableStatistics, sizeof (*Statistics));
+  return EFI_SUCCESS;
+}
+
+EDKII_MEMORY_ATTRIBUTE_BATCH_PROTOCOL  mMemoryAttributeBatch = {
+  MemoryAttributeBatchBegin,
+  MemoryAttributeBatchCommit,
+  MemoryAttributeBatchGetStatistics
+};
+
 /**
  Check if Execute Disable feature is enabled or not.
 **/
@@ -1179,7 +1593,8 @@ InitializePageTablePool (
     PageActionSet,
     AllocatePageTableMemory,
     NULL,
-    &IsModified
+    &IsModified,
+    NULL
     );
   ASSERT (IsModified == TRUE);
 
@@ -1217,6 +1632,16 @@ AllocatePageTableMemory (
     return NULL;
   }
 
+  //
+  // Reuse a page table freed by a merge first.
+  //
+  if ((Pages == 1) && (mFreePageTableList != NULL)) {
+    Buffer             = mFreePageTableList;
+    mFreePageTableList = *(VOID **)Buffer;
+    mPageTableStatistics.FreePageTablePages--;
+    return Buffer;
+  }
+
   //
   // Renew the pool if necessary.
   //
@@ -1233,6 +1658,8 @@ AllocatePageTableMemory (
   mPageTablePool->Offset    += EFI_PAGES_TO_SIZE (Pages);
   mPageTablePool->FreePages -= Pages;
 
+  mPageTableStatistics.PageTablePages += Pages;
+
   return Buffer;
 }
 
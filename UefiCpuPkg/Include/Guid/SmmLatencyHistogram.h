@@ -0,0 +1,114 @@
+/** @file
+  This file defines the MM communicate interface to read the SMI latency histograms
+  collected by the SMM CPU driver.
+
+  The driver measures every SMI on every processor in four phases and keeps one
+  log2 histogram per phase and processor. The latencies are in performance counter
+  ticks, so that the OS can convert them with TickFrequency and match
+  LastSmiEntryTick against its own time stamps.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef SMM_LATENCY_HISTOGRAM_H_
+#define SMM_LATENCY_HISTOGRAM_H_
+
+///
+/// The GUID of the MMI handler that returns the SMI latency histograms.
+///
+#define SMM_LATENCY_HISTOGRAM_GUID \
+  { \
+    0x8a251c7e, 0xa53b, 0x4bc0, {0x85, 0xe6, 0xf8, 0xf0, 0x99, 0x66, 0x95, 0xf3}  \
+  }
+
+typedef enum {
+  ///
+  /// From the SMI rendezvous entry until the processor has checked in.
+  /// Recorded on every processor.
+  ///
+  SmmLatencyPhaseEntry,
+  ///
+  /// From the start of the BSP handler until the MMI handlers are dispatched,
+  /// including the wait for the APs. Recorded on the BSP.
+  ///
+  SmmLatencyPhaseRendezvous,
+  ///
+  /// The MMI handler dispatch by the MM core. Recorded on the BSP.
+  ///
+  SmmLatencyPhaseDispatch,
+  ///
+  /// From the end of the dispatch (BSP) or of the AP handler (AP) until the
+  /// processor leaves the SMI rendezvous. Recorded on every processor.
+  ///
+  SmmLatencyPhaseExit,
+  SmmLatencyPhaseMax
+} SMM_LATENCY_PHASE;
+
+///
+/// Bucket[0] counts the latencies of 0 tick. Bucket[N] counts the latencies in
+/// [2^(N-1), 2^N) ticks, and the last bucket also counts all longer latencies.
+///
+#define SMM_LATENCY_HISTOGRAM_BUCKET_COUNT  64
+
+typedef struct {
+  UINT64    Count;
+  UINT64    TotalTicks;
+  UINT64    MinTicks;
+  UINT64    MaxTicks;
+  UINT64    Bucket[SMM_LATENCY_HISTOGRAM_BUCKET_COUNT];
+} SMM_LATENCY_HISTOGRAM;
+
+///
+/// Return the histograms in Histogram[].
+///
+#define SMM_LATENCY_HISTOGRAM_FUNCTION_GET  1
+///
+/// Clear all histograms.
+///
+#define SMM_LATENCY_HISTOGRAM_FUNCTION_RESET  2
+
+///
+/// CpuIndex value to merge the histograms of all processors.
+///
+#define SMM_LATENCY_HISTOGRAM_ALL_CPUS  MAX_UINT32
+
+///
+/// The data that follows EFI_MM_COMMUNICATE_HEADER.
+///
+typedef struct {
+  ///
+  /// IN: SMM_LATENCY_HISTOGRAM_FUNCTION_GET or SMM_LATENCY_HISTOGRAM_FUNCTION_RESET.
+  ///
+  UINT64                   Function;
+  ///
+  /// OUT: The EFI_STATUS of the function.
+  ///
+  UINT64                   ReturnStatus;
+  ///
+  /// IN: The index of the processor, or SMM_LATENCY_HISTOGRAM_ALL_CPUS.
+  ///
+  UINT32                   CpuIndex;
+  ///
+  /// OUT: The number of processors.
+  ///
+  UINT32                   NumberOfCpus;
+  ///
+  /// OUT: The frequency of the performance counter, in Hz.
+  ///
+  UINT64                   TickFrequency;
+  ///
+  /// OUT: The performance counter value when the last SMI was entered.
+  ///
+  UINT64                   LastSmiEntryTick;
+  ///
+  /// OUT: The histogram of every phase.
+  ///
+  SMM_LATENCY_HISTOGRAM    Histogram[SmmLatencyPhaseMax];
+} SMM_LATENCY_HISTOGRAM_PARAMETER;
+
+extern EFI_GUID  gSmmLatencyHistogramGuid;
+
+#endif
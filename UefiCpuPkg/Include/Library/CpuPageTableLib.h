@@ -141,4 +141,53 @@ PageTableParse (
   IN OUT UINTN           *MapCount
   );
 
+/**
+  Create or update page table to map multiple linear address ranges, each with its own attribute.
+
+  Compared with calling PageTableMap() for every range, the buffer size required by all ranges is
+  returned at once, so the caller can allocate the page table buffer in one shot, and adjacent ranges
+  that map contiguous physical addresses with the same attributes are mapped together, so that they
+  use 2M and 1G pages whenever the paging mode and the alignment allow it.
+
+  @param[in, out] PageTable      The pointer to the page table to update, or pointer to NULL if a new page table is to be created.
+                                 If not pointer to NULL, the value it points to won't be changed in this function.
+  @param[in]      PagingMode     The paging mode.
+  @param[in]      Buffer         The free buffer to be used for page table creation/updating.
+  @param[in, out] BufferSize     The buffer size.
+                                 On return, the remaining buffer size.
+                                 The free buffer is used from the end so caller can supply the same Buffer pointer with an updated
+                                 BufferSize in the second call to this API.
+  @param[in]      Map            The linear address ranges and their attributes. The ranges are sorted by LinearAddress
+                                 and do not overlap. The PageTableBaseAddress of an attribute is the physical address
+                                 that the start of the range maps to.
+  @param[in]      MapCount       The number of ranges in Map.
+  @param[in]      Mask           The mask used for the attributes of all ranges. The corresponding field in an attribute is
+                                 ignored if that in Mask is 0.
+  @param[out]     IsModified     TRUE means page table is modified by software or hardware. FALSE means page table is not modified by software.
+                                 If the output IsModified is FALSE, there is possibility that the page table is changed by hardware. It is ok
+                                 because page table can be changed by hardware anytime, and caller don't need to Flush TLB.
+
+  @retval RETURN_UNSUPPORTED        PagingMode is not supported.
+  @retval RETURN_INVALID_PARAMETER  PageTable, BufferSize or Mask is NULL, or Map is NULL while MapCount is not 0.
+  @retval RETURN_INVALID_PARAMETER  The ranges in Map are not sorted, or overlap.
+  @retval RETURN_INVALID_PARAMETER  A range or attribute in Map is invalid, as it would be for PageTableMap().
+  @retval RETURN_INVALID_PARAMETER  *BufferSize is not multiple of 4KB.
+  @retval RETURN_BUFFER_TOO_SMALL   The buffer is too small for page table creation/updating.
+                                    BufferSize is updated to indicate the expected buffer size, which is enough to map all
+                                    the ranges but may be larger than what is finally used. The page table is not modified.
+  @retval RETURN_SUCCESS            PageTable is created/updated successfully or MapCount is 0.
+**/
+RETURN_STATUS
+EFIAPI
+PageTableMapRanges (
+  IN OUT UINTN               *PageTable  OPTIONAL,
+  IN     PAGING_MODE         PagingMode,
+  IN     VOID                *Buffer,
+  IN OUT UINTN               *BufferSize,
+  IN     IA32_MAP_ENTRY      *Map,
+  IN     UINTN               MapCount,
+  IN     IA32_MAP_ATTRIBUTE  *Mask,
+  OUT    BOOLEAN             *IsModified   OPTIONAL
+  );
+
 #endif
@@ -0,0 +1,161 @@
+/** @file
+  Library that runs data-parallel loops and task groups on all enabled processors.
+
+  The lib provides 2 sets of APIs:
+  1. ParallelFor/RunGroup:
+
+    MpTaskParallelFor() calls a loop body once for each index in a range. The range is cut
+    into chunks that are spread over the BSP and the enabled APs. Every processor owns a
+    deque of chunks; a processor that runs out of work steals half of the remaining chunks
+    of another processor, so the load is balanced even when the cost of the indexes differs.
+    MpTaskRunGroup() runs an array of independent tasks the same way.
+
+  2. ParkAps/ReleaseAps:
+
+    Without parking, every MpTaskParallelFor() call wakes up the APs through the MP services.
+    MpTaskParkAps() leaves the APs spinning on a shared mailbox, so that the following calls
+    only have to post the job. MpTaskReleaseAps() returns the APs to the MP services. While
+    the APs are parked, they are not available to other users of the MP services. Parking is
+    only supported by the DXE instance.
+
+  The loop bodies and tasks run on the APs, so they must be MP safe and must not call the
+  UEFI or PEI services. With the DXE instance, a nested call from a loop body runs on the
+  calling processor only; with the PEI instance, loop bodies must not call this library.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef MP_TASK_LIB_H_
+#define MP_TASK_LIB_H_
+
+#include <Uefi/UefiBaseType.h>
+
+/**
+  The loop body of MpTaskParallelFor().
+
+  @param[in]  Index      The index of the loop iteration.
+  @param[in]  Context    The context passed to MpTaskParallelFor().
+
+**/
+typedef
+VOID
+(EFIAPI *MP_TASK_FOR_BODY)(
+  IN UINTN  Index,
+  IN VOID   *Context OPTIONAL
+  );
+
+/**
+  A task of MpTaskRunGroup().
+
+  @param[in]  Context    The context of the task.
+
+**/
+typedef
+VOID
+(EFIAPI *MP_TASK_PROCEDURE)(
+  IN VOID  *Context OPTIONAL
+  );
+
+typedef struct {
+  MP_TASK_PROCEDURE    Procedure;
+  VOID                 *Context;
+} MP_TASK;
+
+/**
+  Call Body once for each index in the range [Start, End), in parallel on all enabled
+  processors. The function returns when all iterations have completed.
+
+  If no MP services are available, or the processors are busy, the loop runs on the
+  calling processor only.
+
+  @param[in]  Start      The first index.
+  @param[in]  End        One past the last index.
+  @param[in]  Grain      The number of consecutive indexes handed out as one unit of work.
+                         0 lets the library pick a grain from the range and CPU count.
+  @param[in]  Body       The loop body.
+  @param[in]  Context    The context passed to every call of Body.
+
+  @retval EFI_SUCCESS            All iterations have completed.
+  @retval EFI_INVALID_PARAMETER  Body is NULL.
+  @retval EFI_OUT_OF_RESOURCES   There are not enough resources to schedule the loop.
+                                 No iteration was run.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskParallelFor (
+  IN UINTN             Start,
+  IN UINTN             End,
+  IN UINTN             Grain,
+  IN MP_TASK_FOR_BODY  Body,
+  IN VOID              *Context OPTIONAL
+  );
+
+/**
+  Run a group of independent tasks in parallel on all enabled processors. The function
+  returns when all tasks have completed.
+
+  @param[in]  Tasks      The array of tasks.
+  @param[in]  TaskCount  The number of tasks in the array.
+
+  @retval EFI_SUCCESS            All tasks have completed.
+  @retval EFI_INVALID_PARAMETER  Tasks is NULL and TaskCount is not 0.
+  @retval EFI_OUT_OF_RESOURCES   There are not enough resources to schedule the tasks.
+                                 No task was run.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskRunGroup (
+  IN MP_TASK  *Tasks,
+  IN UINTN    TaskCount
+  );
+
+/**
+  Keep all enabled APs spinning on a mailbox so that the following MpTaskParallelFor()
+  and MpTaskRunGroup() calls are dispatched with low latency.
+
+  The APs stay parked until MpTaskReleaseAps() is called, which must happen before
+  anyone else needs the MP services.
+
+  @retval EFI_SUCCESS            The APs are parked.
+  @retval EFI_ALREADY_STARTED    The APs are already parked.
+  @retval EFI_UNSUPPORTED        Parking is not supported, or there is no AP.
+  @retval Others                 The APs could not be started.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskParkAps (
+  VOID
+  );
+
+/**
+  Return the APs parked by MpTaskParkAps() to the MP services.
+
+  @retval EFI_SUCCESS            The APs are released.
+  @retval EFI_NOT_STARTED        The APs are not parked, or a parallel loop is running.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskReleaseAps (
+  VOID
+  );
+
+/**
+  Get the number of processors that take part in MpTaskParallelFor(), including the
+  calling processor.
+
+  @return The number of worker processors. It is at least 1.
+
+**/
+UINTN
+EFIAPI
+MpTaskGetWorkerCount (
+  VOID
+  );
+
+#endif
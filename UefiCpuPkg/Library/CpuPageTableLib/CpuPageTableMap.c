@@ -648,51 +648,62 @@ PageTableLibMapInLevel (
 }
 
 /**
-  Create or update page table to map [LinearAddress, LinearAddress + Length) with specified attribute.
+  Check whether the next range can be mapped together with the current one:
+  it starts where the current one ends, maps the physical addresses that follow,
+  and has the same attributes.
+
+  @param[in] Current     The current range.
+  @param[in] Next        The next range.
+
+  @retval TRUE   The two ranges can be mapped as one.
+  @retval FALSE  The two ranges must be mapped separately.
+**/
+BOOLEAN
+PageTableLibIsMapEntryContiguous (
+  IN CONST IA32_MAP_ENTRY  *Current,
+  IN CONST IA32_MAP_ENTRY  *Next
+  )
+{
+  return (BOOLEAN)(
+                   (Current->LinearAddress + Current->Length == Next->LinearAddress) &&
+                   (IA32_MAP_ATTRIBUTE_PAGE_TABLE_BASE_ADDRESS (&Current->Attribute) + Current->Length ==
+                    IA32_MAP_ATTRIBUTE_PAGE_TABLE_BASE_ADDRESS (&Next->Attribute)) &&
+                   (IA32_MAP_ATTRIBUTE_ATTRIBUTES (&Current->Attribute) == IA32_MAP_ATTRIBUTE_ATTRIBUTES (&Next->Attribute))
+                   );
+}
+
+/**
+  Create or update page table to map the linear address ranges in Map with their attributes.
+
+  Adjacent ranges that map contiguous physical addresses with the same attributes are mapped as one
+  range, so that they can use 2M and 1G pages.
 
   @param[in, out] PageTable      The pointer to the page table to update, or pointer to NULL if a new page table is to be created.
-                                 If not pointer to NULL, the value it points to won't be changed in this function.
   @param[in]      PagingMode     The paging mode.
   @param[in]      Buffer         The free buffer to be used for page table creation/updating.
   @param[in, out] BufferSize     The buffer size.
                                  On return, the remaining buffer size.
-                                 The free buffer is used from the end so caller can supply the same Buffer pointer with an updated
-                                 BufferSize in the second call to this API.
-  @param[in]      LinearAddress  The start of the linear address range.
-  @param[in]      Length         The length of the linear address range.
-  @param[in]      Attribute      The attribute of the linear address range.
-                                 All non-reserved fields in IA32_MAP_ATTRIBUTE are supported to set in the page table.
-                                 Page table entries that map the linear address range are reset to 0 before set to the new attribute
-                                 when a new physical base address is set.
-  @param[in]      Mask           The mask used for attribute. The corresponding field in Attribute is ignored if that in Mask is 0.
-  @param[out]     IsModified     TRUE means page table is modified by software or hardware. FALSE means page table is not modified by software.
-                                 If the output IsModified is FALSE, there is possibility that the page table is changed by hardware. It is ok
-                                 because page table can be changed by hardware anytime, and caller don't need to Flush TLB.
+  @param[in]      Map            The linear address ranges, sorted by LinearAddress and not overlapping.
+  @param[in]      MapCount       The number of ranges in Map.
+  @param[in]      Mask           The mask used for attribute.
+  @param[out]     IsModified     TRUE means page table is modified by software or hardware.
 
   @retval RETURN_UNSUPPORTED        PagingMode is not supported.
-  @retval RETURN_INVALID_PARAMETER  PageTable, BufferSize, Attribute or Mask is NULL.
-  @retval RETURN_INVALID_PARAMETER  For non-present range, Mask->Bits.Present is 0 but some other attributes are provided.
-  @retval RETURN_INVALID_PARAMETER  For non-present range, Mask->Bits.Present is 1, Attribute->Bits.Present is 1 but some other attributes are not provided.
-  @retval RETURN_INVALID_PARAMETER  For non-present range, Mask->Bits.Present is 1, Attribute->Bits.Present is 0 but some other attributes are provided.
-  @retval RETURN_INVALID_PARAMETER  For present range, Mask->Bits.Present is 1, Attribute->Bits.Present is 0 but some other attributes are provided.
-  @retval RETURN_INVALID_PARAMETER  *BufferSize is not multiple of 4KB.
+  @retval RETURN_INVALID_PARAMETER  A parameter is invalid.
   @retval RETURN_BUFFER_TOO_SMALL   The buffer is too small for page table creation/updating.
                                     BufferSize is updated to indicate the expected buffer size.
-                                    Caller may still get RETURN_BUFFER_TOO_SMALL with the new BufferSize.
-  @retval RETURN_SUCCESS            PageTable is created/updated successfully or the input Length is 0.
+  @retval RETURN_SUCCESS            PageTable is created/updated successfully.
 **/
 RETURN_STATUS
-EFIAPI
-PageTableMap (
-  IN OUT UINTN               *PageTable  OPTIONAL,
-  IN     PAGING_MODE         PagingMode,
-  IN     VOID                *Buffer,
-  IN OUT UINTN               *BufferSize,
-  IN     UINT64              LinearAddress,
-  IN     UINT64              Length,
-  IN     IA32_MAP_ATTRIBUTE  *Attribute,
-  IN     IA32_MAP_ATTRIBUTE  *Mask,
-  OUT    BOOLEAN             *IsModified   OPTIONAL
+PageTableLibMap (
+  IN OUT UINTN                 *PageTable,
+  IN     PAGING_MODE           PagingMode,
+  IN     VOID                  *Buffer,
+  IN OUT UINTN                 *BufferSize,
+  IN     CONST IA32_MAP_ENTRY  *Map,
+  IN     UINTN                 MapCount,
+  IN     IA32_MAP_ATTRIBUTE    *Mask,
+  OUT    BOOLEAN               *IsModified
   )
 {
   RETURN_STATUS       Status;
@@ -702,15 +713,13 @@ PageTableMap (
   IA32_PAGE_LEVEL     MaxLevel;
   IA32_PAGE_LEVEL     MaxLeafLevel;
   IA32_MAP_ATTRIBUTE  ParentAttribute;
-  BOOLEAN             LocalIsModified;
   UINTN               Index;
+  UINTN               MapIndex;
+  IA32_MAP_ENTRY      Range;
+  BOOLEAN             Modify;
   IA32_PAGING_ENTRY   *PagingEntry;
   UINT8               BufferInStack[SIZE_4KB - 1 + MAX_PAE_PDPTE_NUM * sizeof (IA32_PAGING_ENTRY)];
 
-  if (Length == 0) {
-    return RETURN_SUCCESS;
-  }
-
   if ((PagingMode == Paging32bit) || (PagingMode >= PagingModeMax)) {
     //
     // 32bit paging is never supported.
@@ -718,7 +727,7 @@ PageTableMap (
     return RETURN_UNSUPPORTED;
   }
 
-  if ((PageTable == NULL) || (BufferSize == NULL) || (Attribute == NULL) || (Mask == NULL)) {
+  if ((PageTable == NULL) || (BufferSize == NULL) || (Mask == NULL)) {
     return RETURN_INVALID_PARAMETER;
   }
 
@@ -729,34 +738,43 @@ PageTableMap (
     return RETURN_INVALID_PARAMETER;
   }
 
-  if (((UINTN)LinearAddress % SIZE_4KB != 0) || ((UINTN)Length % SIZE_4KB != 0)) {
-    //
-    // LinearAddress and Length should be multiple of 4K.
-    //
-    return RETURN_INVALID_PARAMETER;
-  }
-
   if ((*BufferSize != 0) && (Buffer == NULL)) {
     return RETURN_INVALID_PARAMETER;
   }
 
-  //
-  // If to map [LinearAddress, LinearAddress + Length] as non-present,
-  // all attributes except Present should not be provided.
-  //
-  if ((Attribute->Bits.Present == 0) && (Mask->Bits.Present == 1) && (Mask->Uint64 > 1)) {
-    return RETURN_INVALID_PARAMETER;
-  }
-
   MaxLeafLevel     = (IA32_PAGE_LEVEL)(UINT8)PagingMode;
   MaxLevel         = (IA32_PAGE_LEVEL)(UINT8)(PagingMode >> 8);
   MaxLinearAddress = (PagingMode == PagingPae) ? LShiftU64 (1, 32) : LShiftU64 (1, 12 + MaxLevel * 9);
 
-  if ((LinearAddress > MaxLinearAddress) || (Length > MaxLinearAddress - LinearAddress)) {
+  for (MapIndex = 0; MapIndex < MapCount; MapIndex++) {
+    if (((UINTN)Map[MapIndex].LinearAddress % SIZE_4KB != 0) || ((UINTN)Map[MapIndex].Length % SIZE_4KB != 0)) {
+      //
+      // LinearAddress and Length should be multiple of 4K.
+      //
+      return RETURN_INVALID_PARAMETER;
+    }
+
     //
-    // Maximum linear address is (1 << 32), (1 << 48) or (1 << 57)
+    // If to map [LinearAddress, LinearAddress + Length] as non-present,
+    // all attributes except Present should not be provided.
     //
-    return RETURN_INVALID_PARAMETER;
+    if ((Map[MapIndex].Attribute.Bits.Present == 0) && (Mask->Bits.Present == 1) && (Mask->Uint64 > 1)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    if ((Map[MapIndex].LinearAddress > MaxLinearAddress) || (Map[MapIndex].Length > MaxLinearAddress - Map[MapIndex].LinearAddress)) {
+      //
+      // Maximum linear address is (1 << 32), (1 << 48) or (1 << 57)
+      //
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    if ((MapIndex != 0) && (Map[MapIndex].LinearAddress < Map[MapIndex - 1].LinearAddress + Map[MapIndex - 1].Length)) {
+      //
+      // The ranges should be sorted and should not overlap.
+      //
+      return RETURN_INVALID_PARAMETER;
+    }
   }
 
   TopPagingEntry.Uintn = *PageTable;
@@ -782,10 +800,6 @@ PageTableMap (
     TopPagingEntry.Pce.Nx             = 0;
   }
 
-  if (IsModified == NULL) {
-    IsModified = &LocalIsModified;
-  }
-
   *IsModified = FALSE;
 
   ParentAttribute.Uint64                       = 0;
@@ -796,60 +810,62 @@ PageTableMap (
   ParentAttribute.Bits.Nx                      = 0;
 
   //
-  // Query the required buffer size without modifying the page table.
+  // The first pass queries the required buffer size of all ranges without modifying the page table.
+  // A new page table shared by two ranges is counted for both, so the size is an upper bound when
+  // there is more than one range.
+  // The second pass updates the page table when the supplied buffer is sufficient.
   //
   RequiredSize = 0;
-  Status       = PageTableLibMapInLevel (
-                   &TopPagingEntry,
-                   &ParentAttribute,
-                   FALSE,
-                   NULL,
-                   &RequiredSize,
-                   MaxLevel,
-                   MaxLeafLevel,
-                   LinearAddress,
-                   Length,
-                   0,
-                   Attribute,
-                   Mask,
-                   IsModified
-                   );
-  ASSERT (*IsModified == FALSE);
-  if (RETURN_ERROR (Status)) {
-    return Status;
-  }
+  for (Modify = FALSE; ; Modify = TRUE) {
+    for (MapIndex = 0; MapIndex < MapCount; MapIndex++) {
+      CopyMem (&Range, &Map[MapIndex], sizeof (Range));
+      while ((MapIndex + 1 < MapCount) && PageTableLibIsMapEntryContiguous (&Range, &Map[MapIndex + 1])) {
+        Range.Length += Map[++MapIndex].Length;
+      }
 
-  RequiredSize = -RequiredSize;
+      if (Range.Length == 0) {
+        continue;
+      }
 
-  if ((UINTN)RequiredSize > *BufferSize) {
-    *BufferSize = RequiredSize;
-    return RETURN_BUFFER_TOO_SMALL;
-  }
+      Status = PageTableLibMapInLevel (
+                 &TopPagingEntry,
+                 &ParentAttribute,
+                 Modify,
+                 Modify ? Buffer : NULL,
+                 Modify ? (INTN *)BufferSize : &RequiredSize,
+                 MaxLevel,
+                 MaxLeafLevel,
+                 Range.LinearAddress,
+                 Range.Length,
+                 0,
+                 &Range.Attribute,
+                 Mask,
+                 IsModified
+                 );
+      if (RETURN_ERROR (Status)) {
+        ASSERT (!Modify);
+        return Status;
+      }
+    }
 
-  if ((RequiredSize != 0) && (Buffer == NULL)) {
-    return RETURN_INVALID_PARAMETER;
+    if (Modify) {
+      break;
+    }
+
+    ASSERT (*IsModified == FALSE);
+    RequiredSize = -RequiredSize;
+
+    if ((UINTN)RequiredSize > *BufferSize) {
+      *BufferSize = RequiredSize;
+      return RETURN_BUFFER_TOO_SMALL;
+    }
+
+    if ((RequiredSize != 0) && (Buffer == NULL)) {
+      return RETURN_INVALID_PARAMETER;
+    }
   }
 
-  //
-  // Update the page table when the supplied buffer is sufficient.
-  //
-  Status = PageTableLibMapInLevel (
-             &TopPagingEntry,
-             &ParentAttribute,
-             TRUE,
-             Buffer,
-             (INTN *)BufferSize,
-             MaxLevel,
-             MaxLeafLevel,
-             LinearAddress,
-             Length,
-             0,
-             Attribute,
-             Mask,
-             IsModified
-             );
-
-  if (!RETURN_ERROR (Status)) {
+  if (TopPagingEntry.Uintn != 0) {
     PagingEntry = (IA32_PAGING_ENTRY *)(UINTN)(TopPagingEntry.Uintn & IA32_PE_BASE_ADDRESS_MASK_40);
 
     if (PagingMode == PagingPae) {
@@ -879,5 +895,140 @@ PageTableMap (
     }
   }
 
-  return Status;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Create or update page table to map [LinearAddress, LinearAddress + Length) with specified attribute.
+
+  @param[in, out] PageTable      The pointer to the page table to update, or pointer to NULL if a new page table is to be created.
+                                 If not pointer to NULL, the value it points to won't be changed in this function.
+  @param[in]      PagingMode     The paging mode.
+  @param[in]      Buffer         The free buffer to be used for page table creation/updating.
+  @param[in, out] BufferSize     The buffer size.
+                                 On return, the remaining buffer size.
+                                 The free buffer is used from the end so caller can supply the same Buffer pointer with an updated
+                                 BufferSize in the second call to this API.
+  @param[in]      LinearAddress  The start of the linear address range.
+  @param[in]      Length         The length of the linear address range.
+  @param[in]      Attribute      The attribute of the linear address range.
+                                 All non-reserved fields in IA32_MAP_ATTRIBUTE are supported to set in the page table.
+                                 Page table entries that map the linear address range are reset to 0 before set to the new attribute
+                                 when a new physical base address is set.
+  @param[in]      Mask           The mask used for attribute. The corresponding field in Attribute is ignored if that in Mask is 0.
+  @param[out]     IsModified     TRUE means page table is modified by software or hardware. FALSE means page table is not modified by software.
+                                 If the output IsModified is FALSE, there is possibility that the page table is changed by hardware. It is ok
+                                 because page table can be changed by hardware anytime, and caller don't need to Flush TLB.
+
+  @retval RETURN_UNSUPPORTED        PagingMode is not supported.
+  @retval RETURN_INVALID_PARAMETER  PageTable, BufferSize, Attribute or Mask is NULL.
+  @retval RETURN_INVALID_PARAMETER  For non-present range, Mask->Bits.Present is 0 but some other attributes are provided.
+  @retval RETURN_INVALID_PARAMETER  For non-present range, Mask->Bits.Present is 1, Attribute->Bits.Present is 1 but some other attributes are not provided.
+  @retval RETURN_INVALID_PARAMETER  For non-present range, Mask->Bits.Present is 1, Attribute->Bits.Present is 0 but some other attributes are provided.
+  @retval RETURN_INVALID_PARAMETER  For present range, Mask->Bits.Present is 1, Attribute->Bits.Present is 0 but some other attributes are provided.
+  @retval RETURN_INVALID_PARAMETER  *BufferSize is not multiple of 4KB.
+  @retval RETURN_BUFFER_TOO_SMALL   The buffer is too small for page table creation/updating.
+                                    BufferSize is updated to indicate the expected buffer size.
+                                    Caller may still get RETURN_BUFFER_TOO_SMALL with the new BufferSize.
+  @retval RETURN_SUCCESS            PageTable is created/updated successfully or the input Length is 0.
+**/
+RETURN_STATUS
+EFIAPI
+PageTableMap (
+  IN OUT UINTN               *PageTable  OPTIONAL,
+  IN     PAGING_MODE         PagingMode,
+  IN     VOID                *Buffer,
+  IN OUT UINTN               *BufferSize,
+  IN     UINT64              LinearAddress,
+  IN     UINT64              Length,
+  IN     IA32_MAP_ATTRIBUTE  *Attribute,
+  IN     IA32_MAP_ATTRIBUTE  *Mask,
+  OUT    BOOLEAN             *IsModified   OPTIONAL
+  )
+{
+  IA32_MAP_ENTRY  Map;
+  BOOLEAN         LocalIsModified;
+
+  if (Length == 0) {
+    return RETURN_SUCCESS;
+  }
+
+  if (Attribute == NULL) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (IsModified == NULL) {
+    IsModified = &LocalIsModified;
+  }
+
+  Map.LinearAddress = LinearAddress;
+  Map.Length        = Length;
+  Map.Attribute     = *Attribute;
+  return PageTableLibMap (PageTable, PagingMode, Buffer, BufferSize, &Map, 1, Mask, IsModified);
+}
+
+/**
+  Create or update page table to map multiple linear address ranges, each with its own attribute.
+
+  Compared with calling PageTableMap() for every range, the buffer size required by all ranges is
+  returned at once, so the caller can allocate the page table buffer in one shot, and adjacent ranges
+  that map contiguous physical addresses with the same attributes are mapped together, so that they
+  use 2M and 1G pages whenever the paging mode and the alignment allow it.
+
+  @param[in, out] PageTable      The pointer to the page table to update, or pointer to NULL if a new page table is to be created.
+                                 If not pointer to NULL, the value it points to won't be changed in this function.
+  @param[in]      PagingMode     The paging mode.
+  @param[in]      Buffer         The free buffer to be used for page table creation/updating.
+  @param[in, out] BufferSize     The buffer size.
+                                 On return, the remaining buffer size.
+                                 The free buffer is used from the end so caller can supply the same Buffer pointer with an updated
+                                 BufferSize in the second call to this API.
+  @param[in]      Map            The linear address ranges and their attributes. The ranges are sorted by LinearAddress
+                                 and do not overlap. The PageTableBaseAddress of an attribute is the physical address
+                                 that the start of the range maps to.
+  @param[in]      MapCount       The number of ranges in Map.
+  @param[in]      Mask           The mask used for the attributes of all ranges. The corresponding field in an attribute is
+                                 ignored if that in Mask is 0.
+  @param[out]     IsModified     TRUE means page table is modified by software or hardware. FALSE means page table is not modified by software.
+                                 If the output IsModified is FALSE, there is possibility that the page table is changed by hardware. It is ok
+                                 because page table can be changed by hardware anytime, and caller don't need to Flush TLB.
+
+  @retval RETURN_UNSUPPORTED        PagingMode is not supported.
+  @retval RETURN_INVALID_PARAMETER  PageTable, BufferSize or Mask is NULL, or Map is NULL while MapCount is not 0.
+  @retval RETURN_INVALID_PARAMETER  The ranges in Map are not sorted, or overlap.
+  @retval RETURN_INVALID_PARAMETER  A range or attribute in Map is invalid, as it would be for PageTableMap().
+  @retval RETURN_INVALID_PARAMETER  *BufferSize is not multiple of 4KB.
+  @retval RETURN_BUFFER_TOO_SMALL   The buffer is too small for page table creation/updating.
+                                    BufferSize is updated to indicate the expected buffer size, which is enough to map all
+                                    the ranges but may be larger than what is finally used. The page table is not modified.
+  @retval RETURN_SUCCESS            PageTable is created/updated successfully or MapCount is 0.
+**/
+RETURN_STATUS
+EFIAPI
+PageTableMapRanges (
+  IN OUT UINTN               *PageTable  OPTIONAL,
+  IN     PAGING_MODE         PagingMode,
+  IN     VOID                *Buffer,
+  IN OUT UINTN               *BufferSize,
+  IN     IA32_MAP_ENTRY      *Map,
+  IN     UINTN               MapCount,
+  IN     IA32_MAP_ATTRIBUTE  *Mask,
+  OUT    BOOLEAN             *IsModified   OPTIONAL
+  )
+{
+  BOOLEAN  LocalIsModified;
+
+  if (MapCount == 0) {
+    return RETURN_SUCCESS;
+  }
+
+  if (Map == NULL) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (IsModified == NULL) {
+    IsModified = &LocalIsModified;
+  }
+
+  return PageTableLibMap (PageTable, PagingMode, Buffer, BufferSize, Map, MapCount, Mask, IsModified);
 }
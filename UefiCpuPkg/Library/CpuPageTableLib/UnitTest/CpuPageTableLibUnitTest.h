@@ -78,6 +78,27 @@ TestCaseforRandomTest (
   IN UNIT_TEST_CONTEXT  Context
   );
 
+/**
+  Performance mode of the random test.
+
+  Map the same sorted random ranges once range by range with PageTableMap() and once at once with
+  PageTableMapRanges(), check that both page tables map the same, and print the time and the page
+  table memory that both ways took.
+
+  @param[in]  PagingMode     The paging mode.
+  @param[in]  RangeCount     The maximum number of ranges in a page table.
+  @param[in]  Iteration      The number of page tables to build.
+
+  @retval  UNIT_TEST_PASSED             Both ways produce the same mapping.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The mappings differ or a page table cannot be built.
+**/
+UNIT_TEST_STATUS
+RandomTestPerformance (
+  IN PAGING_MODE  PagingMode,
+  IN UINTN        RangeCount,
+  IN UINTN        Iteration
+  );
+
 /**
   Init global data
 
@@ -821,6 +821,103 @@ TestCaseToCheckMapMaskAndAttr (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Check that PageTableMapRanges() validates the ranges, returns the buffer size of all ranges
+  at once, and maps adjacent ranges with the same attributes by large pages.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestCaseMapRanges (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN               PageTable;
+  PAGING_MODE         PagingMode;
+  VOID                *Buffer;
+  UINTN               PageTableBufferSize;
+  UINTN               RequiredSize;
+  IA32_MAP_ATTRIBUTE  MapMask;
+  IA32_MAP_ENTRY      Ranges[3];
+  IA32_MAP_ENTRY      Map[3];
+  UINTN               MapCount;
+  RETURN_STATUS       Status;
+
+  PagingMode          = Paging4Level1GB;
+  PageTable           = 0;
+  PageTableBufferSize = 0;
+  MapMask.Uint64      = MAX_UINT64;
+
+  //
+  // [0, 512M) and [512M, 1G) are RW with the same attributes, [1G, 1G + 4K) is read-only.
+  //
+  Ranges[0].LinearAddress            = 0;
+  Ranges[0].Length                   = SIZE_512MB;
+  Ranges[0].Attribute.Uint64         = 0;
+  Ranges[0].Attribute.Bits.Present   = 1;
+  Ranges[0].Attribute.Bits.ReadWrite = 1;
+  Ranges[1].LinearAddress            = SIZE_512MB;
+  Ranges[1].Length                   = SIZE_512MB;
+  Ranges[1].Attribute.Uint64         = SIZE_512MB;
+  Ranges[1].Attribute.Bits.Present   = 1;
+  Ranges[1].Attribute.Bits.ReadWrite = 1;
+  Ranges[2].LinearAddress            = SIZE_1GB;
+  Ranges[2].Length                   = SIZE_4KB;
+  Ranges[2].Attribute.Uint64         = SIZE_1GB;
+  Ranges[2].Attribute.Bits.Present   = 1;
+
+  //
+  // Unsorted or overlapping ranges are rejected.
+  //
+  UT_ASSERT_EQUAL (PageTableMapRanges (&PageTable, PagingMode, NULL, &PageTableBufferSize, NULL, 1, &MapMask, NULL), RETURN_INVALID_PARAMETER);
+  Ranges[1].LinearAddress = SIZE_512MB - SIZE_4KB;
+  UT_ASSERT_EQUAL (PageTableMapRanges (&PageTable, PagingMode, NULL, &PageTableBufferSize, Ranges, 3, &MapMask, NULL), RETURN_INVALID_PARAMETER);
+  Ranges[1].LinearAddress = SIZE_512MB;
+
+  //
+  // One query returns the buffer size of all ranges.
+  //
+  Status = PageTableMapRanges (&PageTable, PagingMode, NULL, &PageTableBufferSize, Ranges, 3, &MapMask, NULL);
+  UT_ASSERT_EQUAL (Status, RETURN_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (PageTable, 0);
+  RequiredSize = PageTableBufferSize;
+  Buffer       = AllocatePages (EFI_SIZE_TO_PAGES (RequiredSize));
+  Status       = PageTableMapRanges (&PageTable, PagingMode, Buffer, &PageTableBufferSize, Ranges, 3, &MapMask, NULL);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  UT_ASSERT_EQUAL (IsPageTableValid (PageTable, PagingMode), UNIT_TEST_PASSED);
+
+  //
+  // [0, 1G) is mapped by one 1G page. So only the PML4, the PDPT, and the PD and PT of [1G, 1G + 4K) are used.
+  // Mapping the ranges one by one with PageTableMap() would use one more page for the PD of [0, 1G).
+  //
+  UT_ASSERT_EQUAL (RequiredSize - PageTableBufferSize, 4 * SIZE_4KB);
+
+  MapCount = ARRAY_SIZE (Map);
+  Status   = PageTableParse (PageTable, PagingMode, Map, &MapCount);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  UT_ASSERT_EQUAL (MapCount, 2);
+  UT_ASSERT_EQUAL (Map[0].LinearAddress, 0);
+  UT_ASSERT_EQUAL (Map[0].Length, SIZE_1GB);
+  UT_ASSERT_EQUAL (Map[0].Attribute.Uint64, Ranges[0].Attribute.Uint64);
+  UT_ASSERT_EQUAL (Map[1].LinearAddress, SIZE_1GB);
+  UT_ASSERT_EQUAL (Map[1].Length, SIZE_4KB);
+  UT_ASSERT_EQUAL (Map[1].Attribute.Uint64, Ranges[2].Attribute.Uint64);
+
+  FreePages (Buffer, EFI_SIZE_TO_PAGES (RequiredSize));
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Initialize the unit test framework, suite, and unit tests for the
   sample unit tests and run the unit tests.
@@ -872,6 +969,7 @@ UefiTestMain (
   AddTestCase (ManualTestCase, "Check if the parent entry has different Nx attribute", "Manual Test Case6", TestCaseManualChangeNx, NULL, NULL, NULL);
   AddTestCase (ManualTestCase, "Check if the needed size is expected", "Manual Test Case7", TestCaseManualSizeNotMatch, NULL, NULL, NULL);
   AddTestCase (ManualTestCase, "Check MapMask when creating new page table or mapping not-present range", "Manual Test Case8", TestCaseToCheckMapMaskAndAttr, NULL, NULL, NULL);
+  AddTestCase (ManualTestCase, "Check mapping multiple ranges at once", "Manual Test Case9", TestCaseMapRanges, NULL, NULL, NULL);
   //
   // Populate the Random Test Cases.
   //
@@ -915,6 +1013,28 @@ main (
   CHAR8  *Argv[]
   )
 {
+  STATIC CONST PAGING_MODE  PagingModes[] = { Paging4Level, Paging4Level1GB, Paging5Level, Paging5Level1GB, PagingPae };
+  UINTN                     RangeCount;
+  UINTN                     Iteration;
+  UINTN                     Index;
+
   InitGlobalData (52);
+
+  //
+  // CpuPageTableLibUnitTestHost performance [<range count> [<iterations>]]
+  //   Default <range count> is 100 and default <iterations> is 100.
+  //
+  if ((Argc >= 2) && (Argc <= 4) && (AsciiStriCmp ("performance", Argv[1]) == 0)) {
+    RangeCount = (Argc >= 3) ? atoi (Argv[2]) : 100;
+    Iteration  = (Argc == 4) ? atoi (Argv[3]) : 100;
+    for (Index = 0; Index < ARRAY_SIZE (PagingModes); Index++) {
+      if (RandomTestPerformance (PagingModes[Index], RangeCount, Iteration) != UNIT_TEST_PASSED) {
+        return 1;
+      }
+    }
+
+    return 0;
+  }
+
   return UefiTestMain ();
 }
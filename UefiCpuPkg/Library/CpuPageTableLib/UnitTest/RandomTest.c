@@ -1082,3 +1082,237 @@ TestCaseforRandomTest (
 
   return UNIT_TEST_PASSED;
 }
+
+/**
+  Generate sorted random ranges that map linear addresses to the same physical addresses.
+
+  The ranges are 4K, 2M or 1G granular and some of them are adjacent, so that both small
+  pages and large pages are needed.
+
+  @param[in]   PagingMode     The paging mode.
+  @param[out]  Map            Return the ranges.
+  @param[in]   MaxCount       The maximum number of entries that Map can hold.
+
+  @return The number of ranges in Map.
+**/
+UINTN
+GenerateSortedRandomRanges (
+  IN  PAGING_MODE     PagingMode,
+  OUT IA32_MAP_ENTRY  *Map,
+  IN  UINTN           MaxCount
+  )
+{
+  STATIC CONST UINT64  Granularity[] = { SIZE_4KB, SIZE_2MB, SIZE_1GB };
+  UINT64               MaxAddress;
+  UINT64               Address;
+  UINT64               Length;
+  UINT64               Gap;
+  UINTN                Count;
+
+  MaxAddress = GetMaxAddress (PagingMode);
+  Address    = 0;
+  for (Count = 0; Count < MaxCount; Count++) {
+    Gap    = Granularity[Random32 (0, 2)] * Random64 (0, 2);
+    Length = Granularity[Random32 (0, 2)] * Random64 (1, 8);
+    if ((Gap > MaxAddress - Address) || (Length > MaxAddress - Address - Gap)) {
+      break;
+    }
+
+    Address                                 += Gap;
+    Map[Count].LinearAddress                 = Address;
+    Map[Count].Length                        = Length;
+    Map[Count].Attribute.Uint64              = Address;
+    Map[Count].Attribute.Bits.Present        = 1;
+    Map[Count].Attribute.Bits.ReadWrite      = RandomBoolean (50) ? 1 : 0;
+    Map[Count].Attribute.Bits.UserSupervisor = 1;
+    Address                                 += Length;
+  }
+
+  return Count;
+}
+
+/**
+  Performance mode of the random test.
+
+  Map the same sorted random ranges once range by range with PageTableMap() and once at once with
+  PageTableMapRanges(), check that both page tables map the same, and print the time and the page
+  table memory that both ways took.
+
+  @param[in]  PagingMode     The paging mode.
+  @param[in]  RangeCount     The maximum number of ranges in a page table.
+  @param[in]  Iteration      The number of page tables to build.
+
+  @retval  UNIT_TEST_PASSED             Both ways produce the same mapping.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The mappings differ or a page table cannot be built.
+**/
+UNIT_TEST_STATUS
+RandomTestPerformance (
+  IN PAGING_MODE  PagingMode,
+  IN UINTN        RangeCount,
+  IN UINTN        Iteration
+  )
+{
+  UNIT_TEST_STATUS       TestStatus;
+  RETURN_STATUS          Status;
+  IA32_MAP_ENTRY         *Map;
+  UINTN                  MapCount;
+  IA32_MAP_ENTRY         *ParsedMap[2];
+  UINTN                  ParsedMapCount[2];
+  UINTN                  ParsedMapMaxCount;
+  IA32_MAP_ATTRIBUTE     Mask;
+  ALLOCATE_PAGE_RECORDS  *PagesRecord;
+  UINTN                  PageTable[2];
+  VOID                   *Buffer;
+  UINTN                  BufferSize;
+  UINTN                  BufferPages;
+  UINTN                  Index;
+  UINTN                  MapIndex;
+  clock_t                Start;
+  UINT64                 SingleTime;
+  UINT64                 BatchTime;
+  UINT64                 SinglePages;
+  UINT64                 BatchPages;
+  UINT64                 TotalRangeCount;
+
+  mRandomOption     = USE_RANDOM_ARRAY;
+  mNumberIndex      = 0;
+  Mask.Uint64       = MAX_UINT64;
+  ParsedMapMaxCount = 2 * RangeCount + 1;
+  Map               = AllocatePool (RangeCount * sizeof (IA32_MAP_ENTRY));
+  ParsedMap[0]      = AllocatePool (ParsedMapMaxCount * sizeof (IA32_MAP_ENTRY));
+  ParsedMap[1]      = AllocatePool (ParsedMapMaxCount * sizeof (IA32_MAP_ENTRY));
+  PagesRecord       = AllocatePool (RangeCount * sizeof (ALLOCATE_PAGE_RECORD) + sizeof (ALLOCATE_PAGE_RECORDS));
+  if ((Map == NULL) || (ParsedMap[0] == NULL) || (ParsedMap[1] == NULL) || (PagesRecord == NULL)) {
+    return UNIT_TEST_ERROR_TEST_FAILED;
+  }
+
+  TestStatus      = UNIT_TEST_PASSED;
+  SingleTime      = 0;
+  BatchTime       = 0;
+  SinglePages     = 0;
+  BatchPages      = 0;
+  TotalRangeCount = 0;
+  for (Index = 0; Index < Iteration; Index++) {
+    MapCount         = GenerateSortedRandomRanges (PagingMode, Map, RangeCount);
+    TotalRangeCount += MapCount;
+
+    //
+    // Range by range: query the size and allocate the page table buffer for every range.
+    //
+    PagesRecord->Count    = 0;
+    PagesRecord->MaxCount = RangeCount;
+    PageTable[0]          = 0;
+    Start                 = clock ();
+    for (MapIndex = 0; MapIndex < MapCount; MapIndex++) {
+      BufferSize = 0;
+      Status     = PageTableMap (
+                     &PageTable[0],
+                     PagingMode,
+                     NULL,
+                     &BufferSize,
+                     Map[MapIndex].LinearAddress,
+                     Map[MapIndex].Length,
+                     &Map[MapIndex].Attribute,
+                     &Mask,
+                     NULL
+                     );
+      if (Status == RETURN_BUFFER_TOO_SMALL) {
+        Buffer = RecordAllocatePages (PagesRecord, EFI_SIZE_TO_PAGES (BufferSize));
+        Status = PageTableMap (
+                   &PageTable[0],
+                   PagingMode,
+                   Buffer,
+                   &BufferSize,
+                   Map[MapIndex].LinearAddress,
+                   Map[MapIndex].Length,
+                   &Map[MapIndex].Attribute,
+                   &Mask,
+                   NULL
+                   );
+        SinglePages += PagesRecord->Records[PagesRecord->Count - 1].Pages;
+      }
+
+      if (RETURN_ERROR (Status)) {
+        TestStatus = UNIT_TEST_ERROR_TEST_FAILED;
+        break;
+      }
+    }
+
+    SingleTime += clock () - Start;
+
+    //
+    // At once: query the size of all ranges and allocate the page table buffer once.
+    //
+    PageTable[1] = 0;
+    Buffer       = NULL;
+    BufferPages  = 0;
+    Start        = clock ();
+    BufferSize   = 0;
+    Status       = PageTableMapRanges (&PageTable[1], PagingMode, NULL, &BufferSize, Map, MapCount, &Mask, NULL);
+    if (Status == RETURN_BUFFER_TOO_SMALL) {
+      BufferPages = EFI_SIZE_TO_PAGES (BufferSize);
+      Buffer      = AllocatePages (BufferPages);
+      Status      = PageTableMapRanges (&PageTable[1], PagingMode, Buffer, &BufferSize, Map, MapCount, &Mask, NULL);
+      BatchPages += BufferPages - EFI_SIZE_TO_PAGES (BufferSize);
+    }
+
+    BatchTime += clock () - Start;
+    if (RETURN_ERROR (Status)) {
+      TestStatus = UNIT_TEST_ERROR_TEST_FAILED;
+    }
+
+    //
+    // Both page tables should map the same.
+    //
+    for (MapIndex = 0; (TestStatus == UNIT_TEST_PASSED) && (MapIndex < ARRAY_SIZE (PageTable)); MapIndex++) {
+      ParsedMapCount[MapIndex] = ParsedMapMaxCount;
+      if ((PageTable[MapIndex] != 0) &&
+          RETURN_ERROR (PageTableParse (PageTable[MapIndex], PagingMode, ParsedMap[MapIndex], &ParsedMapCount[MapIndex])))
+      {
+        TestStatus = UNIT_TEST_ERROR_TEST_FAILED;
+      }
+
+      if (PageTable[MapIndex] == 0) {
+        ParsedMapCount[MapIndex] = 0;
+      }
+    }
+
+    if ((TestStatus == UNIT_TEST_PASSED) &&
+        ((ParsedMapCount[0] != ParsedMapCount[1]) ||
+         (CompareMem (ParsedMap[0], ParsedMap[1], ParsedMapCount[0] * sizeof (IA32_MAP_ENTRY)) != 0)))
+    {
+      DEBUG ((DEBUG_ERROR, "PageTableMapRanges() maps differently from PageTableMap()\n"));
+      TestStatus = UNIT_TEST_ERROR_TEST_FAILED;
+    }
+
+    for (MapIndex = 0; MapIndex < PagesRecord->Count; MapIndex++) {
+      FreePages (PagesRecord->Records[MapIndex].Buffer, PagesRecord->Records[MapIndex].Pages);
+    }
+
+    if (Buffer != NULL) {
+      FreePages (Buffer, BufferPages);
+    }
+
+    if (TestStatus != UNIT_TEST_PASSED) {
+      break;
+    }
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "Paging mode 0x%x: %d page tables, %ld ranges, %ld us and %ld pages range by range, %ld us and %ld pages at once\n",
+    PagingMode,
+    Index,
+    TotalRangeCount,
+    DivU64x32 (MultU64x32 (SingleTime, 1000000), CLOCKS_PER_SEC),
+    SinglePages,
+    DivU64x32 (MultU64x32 (BatchTime, 1000000), CLOCKS_PER_SEC),
+    BatchPages
+    ));
+
+  FreePool (Map);
+  FreePool (ParsedMap[0]);
+  FreePool (ParsedMap[1]);
+  FreePool (PagesRecord);
+  return TestStatus;
+}
@@ -8,6 +8,140 @@
 
 #include "MpLib.h"
 
+/**
+  Search the microcode patch region for the latest patch of the processor.
+
+  @param[in]  CpuMpData        The pointer to CPU MP Data structure.
+  @param[in]  MicrocodeCpuId   The CPU ID of the processor.
+
+  @return The latest matching microcode patch, or NULL if there is none.
+**/
+STATIC
+CPU_MICROCODE_HEADER *
+MicrocodeSearch (
+  IN CPU_MP_DATA                 *CpuMpData,
+  IN EDKII_PEI_MICROCODE_CPU_ID  *MicrocodeCpuId
+  )
+{
+  CPU_MICROCODE_HEADER  *Microcode;
+  UINTN                 MicrocodeEnd;
+  UINT32                LatestRevision;
+  CPU_MICROCODE_HEADER  *LatestMicrocode;
+
+  //
+  // Use 0 as the starting revision to search for microcode because MicrocodePatchInfo HOB needs
+  // the latest microcode location even it's loaded to the processor.
+  //
+  LatestRevision  = 0;
+  LatestMicrocode = NULL;
+  Microcode       = (CPU_MICROCODE_HEADER *)(UINTN)CpuMpData->MicrocodePatchAddress;
+  MicrocodeEnd    = (UINTN)Microcode + (UINTN)CpuMpData->MicrocodePatchRegionSize;
+
+  do {
+    if (!IsValidMicrocode (Microcode, MicrocodeEnd - (UINTN)Microcode, LatestRevision, MicrocodeCpuId, 1, TRUE)) {
+      //
+      // It is the padding data between the microcode patches for microcode patches alignment.
+      // Because the microcode patch is the multiple of 1-KByte, the padding data should not
+      // exist if the microcode patch alignment value is not larger than 1-KByte. So, the microcode
+      // alignment value should be larger than 1-KByte. We could skip SIZE_1KB padding data to
+      // find the next possible microcode patch header.
+      //
+      Microcode = (CPU_MICROCODE_HEADER *)((UINTN)Microcode + SIZE_1KB);
+      continue;
+    }
+
+    LatestMicrocode = Microcode;
+    LatestRevision  = LatestMicrocode->UpdateRevision;
+
+    Microcode = (CPU_MICROCODE_HEADER *)(((UINTN)Microcode) + GetMicrocodeLength (Microcode));
+  } while ((UINTN)Microcode < MicrocodeEnd);
+
+  return LatestMicrocode;
+}
+
+/**
+  Find the latest microcode patch of the processor.
+
+  The patch region is searched, and the checksums verified, only once for all
+  processors with the same signature and platform ID, no matter in which order
+  or how concurrently the processors call this function.
+
+  @param[in]  CpuMpData        The pointer to CPU MP Data structure.
+  @param[in]  MicrocodeCpuId   The CPU ID of the processor.
+
+  @return The latest matching microcode patch, or NULL if there is none.
+**/
+STATIC
+CPU_MICROCODE_HEADER *
+MicrocodeLookup (
+  IN CPU_MP_DATA                 *CpuMpData,
+  IN EDKII_PEI_MICROCODE_CPU_ID  *MicrocodeCpuId
+  )
+{
+  MICROCODE_LOOKUP_ENTRY  *Entry;
+  UINT32                  Index;
+  BOOLEAN                 Owner;
+  CPU_MICROCODE_HEADER    *Microcode;
+
+  Entry = NULL;
+  Owner = FALSE;
+
+  AcquireSpinLock (&CpuMpData->MicrocodeLookupLock);
+  for (Index = 0; Index < CpuMpData->MicrocodeLookupCount; Index++) {
+    if ((CpuMpData->MicrocodeLookup[Index].ProcessorSignature == MicrocodeCpuId->ProcessorSignature) &&
+        (CpuMpData->MicrocodeLookup[Index].PlatformId == MicrocodeCpuId->PlatformId))
+    {
+      Entry = &CpuMpData->MicrocodeLookup[Index];
+      break;
+    }
+  }
+
+  if ((Entry == NULL) && (CpuMpData->MicrocodeLookupCount < MICROCODE_LOOKUP_CACHE_SIZE)) {
+    Entry                     = &CpuMpData->MicrocodeLookup[CpuMpData->MicrocodeLookupCount++];
+    Entry->ProcessorSignature = MicrocodeCpuId->ProcessorSignature;
+    Entry->PlatformId         = MicrocodeCpuId->PlatformId;
+    Entry->MicrocodeEntryAddr = 0;
+    Entry->Done               = FALSE;
+    Owner                     = TRUE;
+  }
+
+  ReleaseSpinLock (&CpuMpData->MicrocodeLookupLock);
+
+  if (Entry == NULL) {
+    return MicrocodeSearch (CpuMpData, MicrocodeCpuId);
+  }
+
+  if (Owner) {
+    Microcode                 = MicrocodeSearch (CpuMpData, MicrocodeCpuId);
+    Entry->MicrocodeEntryAddr = (UINTN)Microcode;
+    MemoryFence ();
+    Entry->Done = TRUE;
+    return Microcode;
+  }
+
+  while (!Entry->Done) {
+    CpuPause ();
+  }
+
+  MemoryFence ();
+  return (CPU_MICROCODE_HEADER *)(UINTN)Entry->MicrocodeEntryAddr;
+}
+
+/**
+  Reset the microcode patch lookups shared by the processors. It must be called
+  before the BSP and APs call MicrocodeDetect().
+
+  @param[in, out]  CpuMpData    The pointer to CPU MP Data structure.
+**/
+VOID
+MicrocodeLookupReset (
+  IN OUT CPU_MP_DATA  *CpuMpData
+  )
+{
+  InitializeSpinLock (&CpuMpData->MicrocodeLookupLock);
+  CpuMpData->MicrocodeLookupCount = 0;
+}
+
 /**
   Detect whether specified processor can find matching microcode patch and load it.
 
@@ -22,9 +156,6 @@ MicrocodeDetect (
   IN UINTN        ProcessorNumber
   )
 {
-  CPU_MICROCODE_HEADER        *Microcode;
-  UINTN                       MicrocodeEnd;
-  CPU_AP_DATA                 *BspData;
   UINT32                      LatestRevision;
   CPU_MICROCODE_HEADER        *LatestMicrocode;
   UINT32                      ThreadId;
@@ -47,52 +178,13 @@ MicrocodeDetect (
 
   GetProcessorMicrocodeCpuId (&MicrocodeCpuId);
 
-  if (ProcessorNumber != (UINTN)CpuMpData->BspNumber) {
-    //
-    // Direct use microcode of BSP if AP is the same as BSP.
-    // Assume BSP calls this routine() before AP.
-    //
-    BspData = &(CpuMpData->CpuData[CpuMpData->BspNumber]);
-    if ((BspData->ProcessorSignature == MicrocodeCpuId.ProcessorSignature) &&
-        (BspData->PlatformId == MicrocodeCpuId.PlatformId) &&
-        (BspData->MicrocodeEntryAddr != 0))
-    {
-      LatestMicrocode = (CPU_MICROCODE_HEADER *)(UINTN)BspData->MicrocodeEntryAddr;
-      LatestRevision  = LatestMicrocode->UpdateRevision;
-      goto LoadMicrocode;
-    }
-  }
-
   //
-  // BSP or AP which is different from BSP runs here
-  // Use 0 as the starting revision to search for microcode because MicrocodePatchInfo HOB needs
-  // the latest microcode location even it's loaded to the processor.
+  // The first thread of every core gets here concurrently. Only the first core
+  // of each signature searches the patch region.
   //
-  LatestRevision  = 0;
-  LatestMicrocode = NULL;
-  Microcode       = (CPU_MICROCODE_HEADER *)(UINTN)CpuMpData->MicrocodePatchAddress;
-  MicrocodeEnd    = (UINTN)Microcode + (UINTN)CpuMpData->MicrocodePatchRegionSize;
-
-  do {
-    if (!IsValidMicrocode (Microcode, MicrocodeEnd - (UINTN)Microcode, LatestRevision, &MicrocodeCpuId, 1, TRUE)) {
-      //
-      // It is the padding data between the microcode patches for microcode patches alignment.
-      // Because the microcode patch is the multiple of 1-KByte, the padding data should not
-      // exist if the microcode patch alignment value is not larger than 1-KByte. So, the microcode
-      // alignment value should be larger than 1-KByte. We could skip SIZE_1KB padding data to
-      // find the next possible microcode patch header.
-      //
-      Microcode = (CPU_MICROCODE_HEADER *)((UINTN)Microcode + SIZE_1KB);
-      continue;
-    }
-
-    LatestMicrocode = Microcode;
-    LatestRevision  = LatestMicrocode->UpdateRevision;
-
-    Microcode = (CPU_MICROCODE_HEADER *)(((UINTN)Microcode) + GetMicrocodeLength (Microcode));
-  } while ((UINTN)Microcode < MicrocodeEnd);
+  LatestMicrocode = MicrocodeLookup (CpuMpData, &MicrocodeCpuId);
+  LatestRevision  = (LatestMicrocode == NULL) ? 0 : LatestMicrocode->UpdateRevision;
 
-LoadMicrocode:
   if (LatestRevision != 0) {
     //
     // Save the detected microcode patch entry address (including the microcode
@@ -305,7 +305,8 @@ IsMwaitSupport (
 /**
   Get AP loop mode.
 
-  @param[out] MonitorFilterSize  Returns the largest monitor-line size in bytes.
+  @param[out] MonitorFilterSize  Returns the size in bytes of the start-up signal
+                                 buffer of each AP.
 
   @return The AP loop mode.
 **/
@@ -316,6 +317,7 @@ GetApLoopMode (
 {
   UINT8                    ApLoopMode;
   CPUID_MONITOR_MWAIT_EBX  MonitorMwaitEbx;
+  CPUID_VERSION_INFO_EBX   VersionInfoEbx;
 
   ASSERT (MonitorFilterSize != NULL);
 
@@ -341,15 +343,25 @@ GetApLoopMode (
     }
   }
 
-  if (ApLoopMode != ApInMwaitLoop) {
+  if (ApLoopMode == ApInHltLoop) {
     *MonitorFilterSize = sizeof (UINT32);
   } else {
     //
-    // CPUID.[EAX=05H]:EBX.BIT0-15: Largest monitor-line size in bytes
-    // CPUID.[EAX=05H].EDX: C-states supported using MWAIT
+    // APs in Mwait or Run loop keep reading their start-up signal. Give each AP
+    // its own cache line, so that waking up one AP does not invalidate the line
+    // that the other APs are monitoring or polling.
+    // CPUID.[EAX=01H]:EBX.BIT8-15: CLFLUSH line size in 8-byte units
     //
-    AsmCpuid (CPUID_MONITOR_MWAIT, NULL, &MonitorMwaitEbx.Uint32, NULL, NULL);
-    *MonitorFilterSize = MonitorMwaitEbx.Bits.LargestMonitorLineSize;
+    AsmCpuid (CPUID_VERSION_INFO, NULL, &VersionInfoEbx.Uint32, NULL, NULL);
+    *MonitorFilterSize = MAX (VersionInfoEbx.Bits.CacheLineSize * 8, (UINT32)sizeof (UINT32));
+    if (ApLoopMode == ApInMwaitLoop) {
+      //
+      // CPUID.[EAX=05H]:EBX.BIT0-15: Largest monitor-line size in bytes
+      // CPUID.[EAX=05H].EDX: C-states supported using MWAIT
+      //
+      AsmCpuid (CPUID_MONITOR_MWAIT, NULL, &MonitorMwaitEbx.Uint32, NULL, NULL);
+      *MonitorFilterSize = MAX (*MonitorFilterSize, MonitorMwaitEbx.Bits.LargestMonitorLineSize);
+    }
   }
 
   return ApLoopMode;
@@ -743,6 +755,9 @@ ApWakeupFunction (
   UINTN             CurrentApicMode;
   AP_STACK_DATA     *ApStackData;
   UINT32            OriginalValue;
+  BOOLEAN           InApLoop;
+
+  InApLoop = FALSE;
 
   //
   // AP's local APIC settings will be lost after received INIT IPI
@@ -784,7 +799,19 @@ ApWakeupFunction (
       //
       // Execute AP function if AP is ready
       //
-      GetProcessorNumber (CpuMpData, &ProcessorNumber);
+      if (!InApLoop ||
+          (CpuMpData->CpuData[ProcessorNumber].StartupApSignal != ApStartupSignalBuffer))
+      {
+        //
+        // AP waken up from Mwait or Run loop keeps its processor number, as long as
+        // its CPU_AP_DATA still owns the start-up signal buffer AP waited on. The
+        // entries are moved together with their buffers when SortApicId() sorts
+        // the processors, so look it up again in that case. The lookup reads the
+        // APIC ID and searches all processors.
+        //
+        GetProcessorNumber (CpuMpData, &ProcessorNumber);
+      }
+
       //
       // Clear AP start-up signal when AP waken up
       //
@@ -882,6 +909,7 @@ ApWakeupFunction (
       // Never run here
       //
     } else {
+      InApLoop = TRUE;
       PlaceAPInMwaitLoopOrRunLoop (CpuMpData->ApLoopMode, ApStartupSignalBuffer, CpuMpData->ApTargetCState);
     }
   }
@@ -932,14 +960,11 @@ WaitApWakeup (
 {
   //
   // If AP is waken up, StartupApSignal should be cleared.
-  // Otherwise, write StartupApSignal again till AP waken up.
+  // Only read the signal here. A locked write would take the cache line away
+  // from the AP that is trying to clear it. The AP checks the signal after
+  // arming MONITOR, so the first write is enough to wake it up.
   //
-  while (InterlockedCompareExchange32 (
-           (UINT32 *)ApStartupSignalBuffer,
-           WAKEUP_AP_SIGNAL,
-           WAKEUP_AP_SIGNAL
-           ) != 0)
-  {
+  while (*ApStartupSignalBuffer != 0) {
     CpuPause ();
   }
 }
@@ -2383,13 +2408,18 @@ MpInitLibInitialize (
     // The microcode patch information cache HOB does not exist, which means
     // the microcode patches data has not been loaded into memory yet
     //
+    PERF_INMODULE_BEGIN ("ShadowMicrocode");
     ShadowMicrocodeUpdatePatch (CpuMpData);
+    PERF_INMODULE_END ("ShadowMicrocode");
   }
 
   //
   // Detect and apply Microcode on BSP
   //
+  PERF_INMODULE_BEGIN ("BspMicrocode");
+  MicrocodeLookupReset (CpuMpData);
   MicrocodeDetect (CpuMpData, CpuMpData->BspNumber);
+  PERF_INMODULE_END ("BspMicrocode");
   //
   // Store BSP's MTRR setting
   //
@@ -2399,6 +2429,7 @@ MpInitLibInitialize (
   // Wakeup APs to do some AP initialize sync (Microcode & MTRR)
   //
   if (CpuMpData->CpuCount > 1) {
+    PERF_INMODULE_BEGIN ("ApMicrocodeAndMtrr");
     WakeUpAP (CpuMpData, TRUE, 0, ApInitializeSync, CpuMpData, TRUE);
     //
     // Wait for all APs finished initialization
@@ -2407,6 +2438,8 @@ MpInitLibInitialize (
       CpuPause ();
     }
 
+    PERF_INMODULE_END ("ApMicrocodeAndMtrr");
+
     for (Index = 0; Index < CpuMpData->CpuCount; Index++) {
       SetApState (&CpuMpData->CpuData[Index], CpuStateIdle);
     }
@@ -35,6 +35,7 @@
 #include <Library/MicrocodeLib.h>
 #include <Library/CpuPageTableLib.h>
 #include <Library/SafeIntLib.h>
+#include <Library/PerformanceLib.h>
 #include <ConfidentialComputingGuestAttr.h>
 
 #include <Register/Amd/SevSnpMsr.h>
@@ -164,6 +165,24 @@ typedef struct {
   SEV_ES_SAVE_AREA          *SevEsSaveArea;
 } CPU_AP_DATA;
 
+//
+// Number of different processor signatures whose microcode patch lookups are
+// shared. Processors beyond that search the patch region on their own.
+//
+#define MICROCODE_LOOKUP_CACHE_SIZE  8
+
+//
+// The microcode patch found for one processor signature and platform ID. The
+// first processor of that signature searches the patch region, and the other
+// processors wait for Done and reuse MicrocodeEntryAddr.
+//
+typedef struct {
+  UINT32              ProcessorSignature;
+  UINT32              PlatformId;
+  UINT64              MicrocodeEntryAddr;
+  volatile BOOLEAN    Done;
+} MICROCODE_LOOKUP_ENTRY;
+
 //
 // Basic CPU information saved in Guided HOB.
 // Because the contents will be shard between PEI and DXE,
@@ -326,6 +345,13 @@ struct _CPU_MP_DATA {
   CPU_MP_DATA    *NewCpuMpData;
 
   UINT64         GhcbBase;
+
+  //
+  // Microcode patch lookups shared by the processors of the same signature.
+  //
+  SPIN_LOCK                 MicrocodeLookupLock;
+  UINT32                    MicrocodeLookupCount;
+  MICROCODE_LOOKUP_ENTRY    MicrocodeLookup[MICROCODE_LOOKUP_CACHE_SIZE];
 };
 
 //
@@ -765,6 +791,17 @@ MicrocodeDetect (
   IN UINTN        ProcessorNumber
   );
 
+/**
+  Reset the microcode patch lookups shared by the processors. It must be called
+  before the BSP and APs call MicrocodeDetect().
+
+  @param[in, out]  CpuMpData    The pointer to CPU MP Data structure.
+**/
+VOID
+MicrocodeLookupReset (
+  IN OUT CPU_MP_DATA  *CpuMpData
+  );
+
 /**
   Shadow the required microcode patches data into memory.
 
@@ -0,0 +1,371 @@
+/** @file
+  DXE instance of MpTaskLib on top of EFI_MP_SERVICES_PROTOCOL.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiDxe.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Protocol/MpService.h>
+
+#include "MpTaskLibInternal.h"
+
+//
+// The mailbox the parked APs spin on. The BSP posts a job by storing it in Job and
+// then bumping Generation; every parked AP bumps Acked when it is done with the job.
+//
+typedef struct {
+  BOOLEAN                   Parked;
+  UINT32                    ParkedAps;
+  EFI_EVENT                 Event;
+  MP_TASK_JOB *volatile     Job;
+  volatile UINT32           Generation;
+  volatile UINT32           Acked;
+  volatile BOOLEAN          Exit;
+} MP_TASK_PARK_MAILBOX;
+
+EFI_MP_SERVICES_PROTOCOL  *mMpTaskMpServices = NULL;
+UINTN                     mMpTaskCpuCount    = 1;
+BOOLEAN                   mMpTaskBusy        = FALSE;
+MP_TASK_PARK_MAILBOX      mMpTaskPark;
+
+/**
+  Locate the MP services and count the enabled processors.
+
+  @retval EFI_SUCCESS   The MP services are available.
+  @retval Others        The MP services are not available.
+
+**/
+STATIC
+EFI_STATUS
+MpTaskInitialize (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       NumberOfProcessors;
+  UINTN       NumberOfEnabledProcessors;
+
+  if (mMpTaskMpServices == NULL) {
+    Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&mMpTaskMpServices);
+    if (EFI_ERROR (Status)) {
+      mMpTaskMpServices = NULL;
+      return Status;
+    }
+  }
+
+  //
+  // APs may have been enabled or disabled since the last call.
+  //
+  Status = mMpTaskMpServices->GetNumberOfProcessors (
+                                mMpTaskMpServices,
+                                &NumberOfProcessors,
+                                &NumberOfEnabledProcessors
+                                );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  mMpTaskCpuCount = NumberOfEnabledProcessors;
+  return EFI_SUCCESS;
+}
+
+/**
+  Check whether the caller runs at a TPL that lets the MP services report the end of a
+  non-blocking dispatch. DxeMpInitLib checks the APs from a TPL_NOTIFY timer.
+
+  @retval TRUE   The APs can be dispatched.
+  @retval FALSE  The TPL is too high.
+
+**/
+STATIC
+BOOLEAN
+MpTaskTplAllowsDispatch (
+  VOID
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  gBS->RestoreTPL (OldTpl);
+
+  return (BOOLEAN)(OldTpl < TPL_NOTIFY);
+}
+
+/**
+  Wait until the MP services signal the end of a non-blocking dispatch.
+
+  @param[in]  Event      The event passed to StartupAllAPs().
+
+**/
+STATIC
+VOID
+MpTaskWaitForAps (
+  IN EFI_EVENT  Event
+  )
+{
+  while (gBS->CheckEvent (Event) == EFI_NOT_READY) {
+    CpuPause ();
+  }
+}
+
+/**
+  The procedure the parked APs run until MpTaskReleaseAps() is called.
+
+  @param[in, out]  Buffer  Unused.
+
+**/
+STATIC
+VOID
+EFIAPI
+MpTaskParkLoop (
+  IN OUT VOID  *Buffer
+  )
+{
+  UINT32  Seen;
+
+  Seen = 0;
+  while (TRUE) {
+    while ((mMpTaskPark.Generation == Seen) && !mMpTaskPark.Exit) {
+      CpuPause ();
+    }
+
+    if (mMpTaskPark.Exit) {
+      break;
+    }
+
+    Seen = mMpTaskPark.Generation;
+    MpTaskRunWorker (mMpTaskPark.Job);
+    InterlockedIncrement (&mMpTaskPark.Acked);
+  }
+}
+
+/**
+  Call Body once for each index in the range [Start, End), in parallel on all enabled
+  processors. The function returns when all iterations have completed.
+
+  If no MP services are available, or the processors are busy, the loop runs on the
+  calling processor only.
+
+  @param[in]  Start      The first index.
+  @param[in]  End        One past the last index.
+  @param[in]  Grain      The number of consecutive indexes handed out as one unit of work.
+                         0 lets the library pick a grain from the range and CPU count.
+  @param[in]  Body       The loop body.
+  @param[in]  Context    The context passed to every call of Body.
+
+  @retval EFI_SUCCESS            All iterations have completed.
+  @retval EFI_INVALID_PARAMETER  Body is NULL.
+  @retval EFI_OUT_OF_RESOURCES   There are not enough resources to schedule the loop.
+                                 No iteration was run.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskParallelFor (
+  IN UINTN             Start,
+  IN UINTN             End,
+  IN UINTN             Grain,
+  IN MP_TASK_FOR_BODY  Body,
+  IN VOID              *Context OPTIONAL
+  )
+{
+  EFI_STATUS   Status;
+  MP_TASK_JOB  Job;
+  EFI_EVENT    Event;
+
+  if (Body == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Start >= End) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // A nested call from a loop body, whether on the BSP or on an AP, runs serially.
+  //
+  if (mMpTaskBusy) {
+    MpTaskRunSerial (Start, End, Body, Context);
+    return EFI_SUCCESS;
+  }
+
+  if (mMpTaskPark.Parked) {
+    Status = MpTaskJobInit (&Job, Start, End, Grain, Body, Context, mMpTaskPark.ParkedAps + 1, NULL);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    mMpTaskBusy       = TRUE;
+    mMpTaskPark.Job   = &Job;
+    mMpTaskPark.Acked = 0;
+    InterlockedIncrement (&mMpTaskPark.Generation);
+
+    MpTaskRunWorker (&Job);
+    while (mMpTaskPark.Acked < mMpTaskPark.ParkedAps) {
+      CpuPause ();
+    }
+
+    mMpTaskPark.Job = NULL;
+    mMpTaskBusy     = FALSE;
+    MpTaskJobFree (&Job);
+    return EFI_SUCCESS;
+  }
+
+  if (EFI_ERROR (MpTaskInitialize ()) || (mMpTaskCpuCount <= 1) ||
+      ((End - Start) == 1) || !MpTaskTplAllowsDispatch ())
+  {
+    MpTaskRunSerial (Start, End, Body, Context);
+    return EFI_SUCCESS;
+  }
+
+  Status = gBS->CreateEvent (0, TPL_NOTIFY, NULL, NULL, &Event);
+  if (EFI_ERROR (Status)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = MpTaskJobInit (&Job, Start, End, Grain, Body, Context, mMpTaskCpuCount, NULL);
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (Event);
+    return Status;
+  }
+
+  mMpTaskBusy = TRUE;
+
+  //
+  // The BSP works on the job as well. If the APs cannot be started, it steals all
+  // chunks from their deques.
+  //
+  Status = mMpTaskMpServices->StartupAllAPs (
+                                mMpTaskMpServices,
+                                MpTaskApWorker,
+                                FALSE,
+                                Event,
+                                0,
+                                &Job,
+                                NULL
+                                );
+  MpTaskRunWorker (&Job);
+  if (!EFI_ERROR (Status)) {
+    MpTaskWaitForAps (Event);
+  }
+
+  mMpTaskBusy = FALSE;
+  MpTaskJobFree (&Job);
+  gBS->CloseEvent (Event);
+  return EFI_SUCCESS;
+}
+
+/**
+  Keep all enabled APs spinning on a mailbox so that the following MpTaskParallelFor()
+  and MpTaskRunGroup() calls are dispatched with low latency.
+
+  The APs stay parked until MpTaskReleaseAps() is called, which must happen before
+  anyone else needs the MP services.
+
+  @retval EFI_SUCCESS            The APs are parked.
+  @retval EFI_ALREADY_STARTED    The APs are already parked.
+  @retval EFI_UNSUPPORTED        Parking is not supported, or there is no AP.
+  @retval Others                 The APs could not be started.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskParkAps (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  if (mMpTaskPark.Parked) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  if (mMpTaskBusy || !MpTaskTplAllowsDispatch ()) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = MpTaskInitialize ();
+  if (EFI_ERROR (Status) || (mMpTaskCpuCount <= 1)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = gBS->CreateEvent (0, TPL_NOTIFY, NULL, NULL, &mMpTaskPark.Event);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  mMpTaskPark.ParkedAps  = (UINT32)(mMpTaskCpuCount - 1);
+  mMpTaskPark.Job        = NULL;
+  mMpTaskPark.Generation = 0;
+  mMpTaskPark.Acked      = 0;
+  mMpTaskPark.Exit       = FALSE;
+
+  Status = mMpTaskMpServices->StartupAllAPs (
+                                mMpTaskMpServices,
+                                MpTaskParkLoop,
+                                FALSE,
+                                mMpTaskPark.Event,
+                                0,
+                                NULL,
+                                NULL
+                                );
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (mMpTaskPark.Event);
+    return Status;
+  }
+
+  mMpTaskPark.Parked = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Return the APs parked by MpTaskParkAps() to the MP services.
+
+  @retval EFI_SUCCESS            The APs are released.
+  @retval EFI_NOT_STARTED        The APs are not parked, or a parallel loop is running.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskReleaseAps (
+  VOID
+  )
+{
+  if (!mMpTaskPark.Parked || mMpTaskBusy) {
+    return EFI_NOT_STARTED;
+  }
+
+  mMpTaskPark.Exit = TRUE;
+  MpTaskWaitForAps (mMpTaskPark.Event);
+
+  gBS->CloseEvent (mMpTaskPark.Event);
+  mMpTaskPark.Parked = FALSE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the number of processors that take part in MpTaskParallelFor(), including the
+  calling processor.
+
+  @return The number of worker processors. It is at least 1.
+
+**/
+UINTN
+EFIAPI
+MpTaskGetWorkerCount (
+  VOID
+  )
+{
+  if (mMpTaskPark.Parked) {
+    return mMpTaskPark.ParkedAps + 1;
+  }
+
+  if (EFI_ERROR (MpTaskInitialize ())) {
+    return 1;
+  }
+
+  return MAX (mMpTaskCpuCount, 1);
+}
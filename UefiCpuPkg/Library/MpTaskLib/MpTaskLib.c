@@ -0,0 +1,394 @@
+/** @file
+  Work-stealing scheduler shared by the instances of MpTaskLib.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "MpTaskLibInternal.h"
+
+/**
+  Atomically read the range of a deque. A plain 64-bit read may tear on IA32.
+
+  @param[in]  Deque      The deque.
+
+  @return The range of the deque.
+
+**/
+STATIC
+UINT64
+MpTaskReadRange (
+  IN MP_TASK_DEQUE  *Deque
+  )
+{
+  return InterlockedCompareExchange64 (&Deque->Range, 0, 0);
+}
+
+/**
+  Pop the first chunk from the deque owned by the calling processor.
+
+  @param[in]  Deque      The deque.
+  @param[out] Chunk      The chunk popped.
+
+  @retval TRUE   A chunk was popped.
+  @retval FALSE  The deque is empty.
+
+**/
+BOOLEAN
+MpTaskPop (
+  IN  MP_TASK_DEQUE  *Deque,
+  OUT UINT32         *Chunk
+  )
+{
+  UINT64  Range;
+  UINT32  Begin;
+  UINT32  End;
+
+  do {
+    Range = MpTaskReadRange (Deque);
+    Begin = MP_TASK_RANGE_BEGIN (Range);
+    End   = MP_TASK_RANGE_END (Range);
+    if (Begin >= End) {
+      return FALSE;
+    }
+  } while (InterlockedCompareExchange64 (&Deque->Range, Range, MP_TASK_RANGE (Begin + 1, End)) != Range);
+
+  *Chunk = Begin;
+  return TRUE;
+}
+
+/**
+  Steal the back half of the chunks of another processor's deque. A single chunk left
+  in the deque is stolen as well.
+
+  @param[in]  Deque      The deque of the victim.
+  @param[out] Begin      The first chunk stolen.
+  @param[out] End        One past the last chunk stolen.
+
+  @retval TRUE   Chunks were stolen.
+  @retval FALSE  The deque is empty.
+
+**/
+BOOLEAN
+MpTaskSteal (
+  IN  MP_TASK_DEQUE  *Deque,
+  OUT UINT32         *Begin,
+  OUT UINT32         *End
+  )
+{
+  UINT64  Range;
+  UINT32  VictimBegin;
+  UINT32  VictimEnd;
+  UINT32  Middle;
+
+  do {
+    Range       = MpTaskReadRange (Deque);
+    VictimBegin = MP_TASK_RANGE_BEGIN (Range);
+    VictimEnd   = MP_TASK_RANGE_END (Range);
+    if (VictimBegin >= VictimEnd) {
+      return FALSE;
+    }
+
+    Middle = VictimEnd - (VictimEnd - VictimBegin + 1) / 2;
+  } while (InterlockedCompareExchange64 (&Deque->Range, Range, MP_TASK_RANGE (VictimBegin, Middle)) != Range);
+
+  *Begin = Middle;
+  *End   = VictimEnd;
+  return TRUE;
+}
+
+/**
+  Run the loop body for all indexes of one chunk.
+
+  @param[in]  Job        The job.
+  @param[in]  Chunk      The chunk.
+
+**/
+STATIC
+VOID
+MpTaskRunChunk (
+  IN MP_TASK_JOB  *Job,
+  IN UINT32       Chunk
+  )
+{
+  UINTN  Index;
+  UINTN  Last;
+
+  Index = Job->Start + Chunk * Job->Grain;
+  if (Job->End - Index > Job->Grain) {
+    Last = Index + Job->Grain;
+  } else {
+    Last = Job->End;
+  }
+
+  for ( ; Index < Last; Index++) {
+    Job->Body (Index, Job->Context);
+  }
+}
+
+/**
+  Initialize a job and spread its chunks evenly over the deques of the workers.
+
+  @param[out] Job          The job to initialize.
+  @param[in]  Start        The first index.
+  @param[in]  End          One past the last index. It is larger than Start.
+  @param[in]  Grain        The number of indexes per chunk, or 0 to pick one.
+  @param[in]  Body         The loop body.
+  @param[in]  Context      The context passed to Body.
+  @param[in]  WorkerCount  The number of processors that may run the job.
+  @param[in]  Deques       The WorkerCount deques of the job, aligned to a cache line,
+                           or NULL to allocate them.
+
+  @retval EFI_SUCCESS           The job is initialized.
+  @retval EFI_OUT_OF_RESOURCES  The deques could not be allocated.
+
+**/
+EFI_STATUS
+MpTaskJobInit (
+  OUT MP_TASK_JOB       *Job,
+  IN  UINTN             Start,
+  IN  UINTN             End,
+  IN  UINTN             Grain,
+  IN  MP_TASK_FOR_BODY  Body,
+  IN  VOID              *Context,
+  IN  UINTN             WorkerCount,
+  IN  MP_TASK_DEQUE     *Deques OPTIONAL
+  )
+{
+  UINTN   Count;
+  UINTN   ChunkCount;
+  UINT32  Worker;
+  UINT32  Begin;
+  UINT32  Finish;
+
+  ASSERT (End > Start);
+  ASSERT (WorkerCount > 0);
+
+  WorkerCount = MIN (WorkerCount, MAX_UINT32);
+  Count       = End - Start;
+
+  if (Grain == 0) {
+    Grain = MAX (1, Count / (WorkerCount * MP_TASK_CHUNKS_PER_WORKER));
+  }
+
+  //
+  // Chunk numbers must fit in half of a deque word.
+  //
+  if (Count / Grain >= MAX_UINT32) {
+    Grain = Count / (MAX_UINT32 - 1) + 1;
+  }
+
+  ChunkCount = Count / Grain + ((Count % Grain != 0) ? 1 : 0);
+
+  if (Deques != NULL) {
+    ASSERT (((UINTN)Deques & (MP_TASK_CACHE_LINE_SIZE - 1)) == 0);
+    Job->Deques      = ZeroMem (Deques, WorkerCount * sizeof (MP_TASK_DEQUE));
+    Job->DequeBuffer = NULL;
+  } else {
+    //
+    // The pool is not aligned to a cache line, so allocate one more deque to leave
+    // room for the alignment.
+    //
+    Job->DequeBuffer = AllocateZeroPool ((WorkerCount + 1) * sizeof (MP_TASK_DEQUE));
+    if (Job->DequeBuffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Job->Deques = ALIGN_POINTER (Job->DequeBuffer, MP_TASK_CACHE_LINE_SIZE);
+  }
+
+  Job->Body            = Body;
+  Job->Context         = Context;
+  Job->Start           = Start;
+  Job->End             = End;
+  Job->Grain           = Grain;
+  Job->WorkerCount     = (UINT32)WorkerCount;
+  Job->NextWorker      = 0;
+  Job->FinishedWorkers = 0;
+
+  for (Worker = 0; Worker < Job->WorkerCount; Worker++) {
+    Begin                     = (UINT32)DivU64x32 (MultU64x32 (ChunkCount, Worker), Job->WorkerCount);
+    Finish                    = (UINT32)DivU64x32 (MultU64x32 (ChunkCount, Worker + 1), Job->WorkerCount);
+    Job->Deques[Worker].Range = MP_TASK_RANGE (Begin, Finish);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Free the resources of a job initialized by MpTaskJobInit().
+
+  @param[in]  Job          The job.
+
+**/
+VOID
+MpTaskJobFree (
+  IN MP_TASK_JOB  *Job
+  )
+{
+  if (Job->DequeBuffer != NULL) {
+    FreePool (Job->DequeBuffer);
+  }
+
+  Job->Deques      = NULL;
+  Job->DequeBuffer = NULL;
+}
+
+/**
+  Run chunks of a job on the calling processor until no chunk is left in any deque.
+
+  All chunks of the job have been run once every processor that entered this function
+  has returned from it.
+
+  @param[in]  Job          The job.
+
+**/
+VOID
+MpTaskRunWorker (
+  IN MP_TASK_JOB  *Job
+  )
+{
+  UINT32         Worker;
+  UINT32         Offset;
+  UINT32         Chunk;
+  UINT32         Begin;
+  UINT32         End;
+  UINT64         Range;
+  MP_TASK_DEQUE  *Own;
+  BOOLEAN        Stolen;
+
+  Worker = InterlockedIncrement (&Job->NextWorker) - 1;
+  if (Worker >= Job->WorkerCount) {
+    //
+    // More processors showed up than the job was sized for. The others will run
+    // all chunks.
+    //
+    InterlockedIncrement (&Job->FinishedWorkers);
+    return;
+  }
+
+  Own = &Job->Deques[Worker];
+
+  while (TRUE) {
+    while (MpTaskPop (Own, &Chunk)) {
+      MpTaskRunChunk (Job, Chunk);
+    }
+
+    Stolen = FALSE;
+    for (Offset = 1; Offset < Job->WorkerCount; Offset++) {
+      if (MpTaskSteal (&Job->Deques[(Worker + Offset) % Job->WorkerCount], &Begin, &End)) {
+        Stolen = TRUE;
+        break;
+      }
+    }
+
+    if (!Stolen) {
+      //
+      // Chunks in flight between a victim and a thief are run by the thief, so no
+      // work is lost when this processor leaves now.
+      //
+      break;
+    }
+
+    //
+    // Nobody else writes an empty deque, so publishing the stolen chunks here cannot
+    // race. They stay visible to other thieves while this processor works on them.
+    //
+    Range = MpTaskReadRange (Own);
+    ASSERT (MP_TASK_RANGE_BEGIN (Range) >= MP_TASK_RANGE_END (Range));
+    InterlockedCompareExchange64 (&Own->Range, Range, MP_TASK_RANGE (Begin, End));
+  }
+
+  InterlockedIncrement (&Job->FinishedWorkers);
+}
+
+/**
+  The EFI_AP_PROCEDURE wrapper of MpTaskRunWorker().
+
+  @param[in, out]  Buffer  The MP_TASK_JOB to work on.
+
+**/
+VOID
+EFIAPI
+MpTaskApWorker (
+  IN OUT VOID  *Buffer
+  )
+{
+  MpTaskRunWorker ((MP_TASK_JOB *)Buffer);
+}
+
+/**
+  Run the loop body for all indexes on the calling processor.
+
+  @param[in]  Start      The first index.
+  @param[in]  End        One past the last index.
+  @param[in]  Body       The loop body.
+  @param[in]  Context    The context passed to Body.
+
+**/
+VOID
+MpTaskRunSerial (
+  IN UINTN             Start,
+  IN UINTN             End,
+  IN MP_TASK_FOR_BODY  Body,
+  IN VOID              *Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = Start; Index < End; Index++) {
+    Body (Index, Context);
+  }
+}
+
+/**
+  The loop body used by MpTaskRunGroup().
+
+  @param[in]  Index      The index of the task.
+  @param[in]  Context    The array of tasks.
+
+**/
+STATIC
+VOID
+EFIAPI
+MpTaskRunGroupBody (
+  IN UINTN  Index,
+  IN VOID   *Context
+  )
+{
+  MP_TASK  *Tasks;
+
+  Tasks = (MP_TASK *)Context;
+  Tasks[Index].Procedure (Tasks[Index].Context);
+}
+
+/**
+  Run a group of independent tasks in parallel on all enabled processors. The function
+  returns when all tasks have completed.
+
+  @param[in]  Tasks      The array of tasks.
+  @param[in]  TaskCount  The number of tasks in the array.
+
+  @retval EFI_SUCCESS            All tasks have completed.
+  @retval EFI_INVALID_PARAMETER  Tasks is NULL and TaskCount is not 0.
+  @retval EFI_OUT_OF_RESOURCES   There are not enough resources to schedule the tasks.
+                                 No task was run.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskRunGroup (
+  IN MP_TASK  *Tasks,
+  IN UINTN    TaskCount
+  )
+{
+  if ((Tasks == NULL) && (TaskCount != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Tasks are usually few and coarse, so hand them out one by one.
+  //
+  return MpTaskParallelFor (0, TaskCount, 1, MpTaskRunGroupBody, Tasks);
+}
@@ -0,0 +1,183 @@
+/** @file
+  Internal definitions shared by the instances of MpTaskLib.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef MP_TASK_LIB_INTERNAL_H_
+#define MP_TASK_LIB_INTERNAL_H_
+
+#include <Uefi/UefiBaseType.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/MpTaskLib.h>
+#include <Library/SynchronizationLib.h>
+
+//
+// Deques are padded and aligned to a cache line so that workers popping their own
+// chunks do not bounce each other's lines.
+//
+#define MP_TASK_CACHE_LINE_SIZE  64
+
+//
+// When the caller lets the library pick the grain, the range is cut into that many
+// chunks per worker, which leaves enough chunks to steal.
+//
+#define MP_TASK_CHUNKS_PER_WORKER  16
+
+//
+// A deque holds the chunk range [Begin, End) in a single 64-bit word, so that the owner
+// popping from the front and the thieves splitting off the back half can both update it
+// with one compare-exchange.
+//
+#define MP_TASK_RANGE(Begin, End)  (LShiftU64 ((UINT64)(End), 32) | (UINT32)(Begin))
+#define MP_TASK_RANGE_BEGIN(Range)  ((UINT32)(Range))
+#define MP_TASK_RANGE_END(Range)    ((UINT32)RShiftU64 ((Range), 32))
+
+typedef struct {
+  volatile UINT64    Range;
+  UINT8              Reserved[MP_TASK_CACHE_LINE_SIZE - sizeof (UINT64)];
+} MP_TASK_DEQUE;
+
+typedef struct {
+  MP_TASK_FOR_BODY    Body;
+  VOID                *Context;
+  UINTN               Start;
+  UINTN               End;
+  UINTN               Grain;
+  UINT32              WorkerCount;
+  //
+  // Every processor entering MpTaskRunWorker() takes the next free deque.
+  //
+  volatile UINT32     NextWorker;
+  volatile UINT32     FinishedWorkers;
+  MP_TASK_DEQUE       *Deques;
+  //
+  // The allocation the deques are aligned in, or NULL if the caller provided them.
+  //
+  VOID                *DequeBuffer;
+} MP_TASK_JOB;
+
+/**
+  Pop the first chunk from the deque owned by the calling processor.
+
+  @param[in]  Deque      The deque.
+  @param[out] Chunk      The chunk popped.
+
+  @retval TRUE   A chunk was popped.
+  @retval FALSE  The deque is empty.
+
+**/
+BOOLEAN
+MpTaskPop (
+  IN  MP_TASK_DEQUE  *Deque,
+  OUT UINT32         *Chunk
+  );
+
+/**
+  Steal the back half of the chunks of another processor's deque. A single chunk left
+  in the deque is stolen as well.
+
+  @param[in]  Deque      The deque of the victim.
+  @param[out] Begin      The first chunk stolen.
+  @param[out] End        One past the last chunk stolen.
+
+  @retval TRUE   Chunks were stolen.
+  @retval FALSE  The deque is empty.
+
+**/
+BOOLEAN
+MpTaskSteal (
+  IN  MP_TASK_DEQUE  *Deque,
+  OUT UINT32         *Begin,
+  OUT UINT32         *End
+  );
+
+/**
+  Initialize a job and spread its chunks evenly over the deques of the workers.
+
+  @param[out] Job          The job to initialize.
+  @param[in]  Start        The first index.
+  @param[in]  End          One past the last index. It is larger than Start.
+  @param[in]  Grain        The number of indexes per chunk, or 0 to pick one.
+  @param[in]  Body         The loop body.
+  @param[in]  Context      The context passed to Body.
+  @param[in]  WorkerCount  The number of processors that may run the job.
+  @param[in]  Deques       The WorkerCount deques of the job, aligned to a cache line,
+                           or NULL to allocate them.
+
+  @retval EFI_SUCCESS           The job is initialized.
+  @retval EFI_OUT_OF_RESOURCES  The deques could not be allocated.
+
+**/
+EFI_STATUS
+MpTaskJobInit (
+  OUT MP_TASK_JOB       *Job,
+  IN  UINTN             Start,
+  IN  UINTN             End,
+  IN  UINTN             Grain,
+  IN  MP_TASK_FOR_BODY  Body,
+  IN  VOID              *Context,
+  IN  UINTN             WorkerCount,
+  IN  MP_TASK_DEQUE     *Deques OPTIONAL
+  );
+
+/**
+  Free the resources of a job initialized by MpTaskJobInit().
+
+  @param[in]  Job          The job.
+
+**/
+VOID
+MpTaskJobFree (
+  IN MP_TASK_JOB  *Job
+  );
+
+/**
+  Run chunks of a job on the calling processor until no chunk is left in any deque.
+
+  All chunks of the job have been run once every processor that entered this function
+  has returned from it.
+
+  @param[in]  Job          The job.
+
+**/
+VOID
+MpTaskRunWorker (
+  IN MP_TASK_JOB  *Job
+  );
+
+/**
+  The EFI_AP_PROCEDURE wrapper of MpTaskRunWorker().
+
+  @param[in, out]  Buffer  The MP_TASK_JOB to work on.
+
+**/
+VOID
+EFIAPI
+MpTaskApWorker (
+  IN OUT VOID  *Buffer
+  );
+
+/**
+  Run the loop body for all indexes on the calling processor.
+
+  @param[in]  Start      The first index.
+  @param[in]  End        One past the last index.
+  @param[in]  Body       The loop body.
+  @param[in]  Context    The context passed to Body.
+
+**/
+VOID
+MpTaskRunSerial (
+  IN UINTN             Start,
+  IN UINTN             End,
+  IN MP_TASK_FOR_BODY  Body,
+  IN VOID              *Context
+  );
+
+#endif
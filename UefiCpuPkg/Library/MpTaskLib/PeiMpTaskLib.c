@@ -0,0 +1,191 @@
+/** @file
+  PEI instance of MpTaskLib on top of EDKII_PEI_MP_SERVICES2_PPI.
+
+  PEIMs may run in place from flash, so this instance keeps no writable global state:
+  every call dispatches its job to all processors with StartupAllCPUs(), and the APs
+  cannot be parked. FreePool() does not return memory in PEI, so the deques of a job
+  live on the stack of the caller.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiPei.h>
+#include <Library/PeiServicesLib.h>
+#include <Ppi/MpServices2.h>
+
+#include "MpTaskLibInternal.h"
+
+//
+// The maximum number of processors working on one job. More processors only find the
+// job already split, and return at once.
+//
+#define MP_TASK_PEI_MAX_WORKERS  32
+
+/**
+  Locate the MP services and count the enabled processors.
+
+  @param[out] MpServices      The MP services PPI.
+  @param[out] CpuCount        The number of enabled processors.
+
+  @retval EFI_SUCCESS   The MP services are available.
+  @retval Others        The MP services are not available.
+
+**/
+STATIC
+EFI_STATUS
+MpTaskGetMpServices (
+  OUT EDKII_PEI_MP_SERVICES2_PPI  **MpServices,
+  OUT UINTN                       *CpuCount
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       NumberOfProcessors;
+
+  Status = PeiServicesLocatePpi (&gEdkiiPeiMpServices2PpiGuid, 0, NULL, (VOID **)MpServices);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return (*MpServices)->GetNumberOfProcessors (*MpServices, &NumberOfProcessors, CpuCount);
+}
+
+/**
+  Call Body once for each index in the range [Start, End), in parallel on all enabled
+  processors. The function returns when all iterations have completed.
+
+  If no MP services are available, or the processors are busy, the loop runs on the
+  calling processor only.
+
+  @param[in]  Start      The first index.
+  @param[in]  End        One past the last index.
+  @param[in]  Grain      The number of consecutive indexes handed out as one unit of work.
+                         0 lets the library pick a grain from the range and CPU count.
+  @param[in]  Body       The loop body.
+  @param[in]  Context    The context passed to every call of Body.
+
+  @retval EFI_SUCCESS            All iterations have completed.
+  @retval EFI_INVALID_PARAMETER  Body is NULL.
+  @retval EFI_OUT_OF_RESOURCES   There are not enough resources to schedule the loop.
+                                 No iteration was run.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskParallelFor (
+  IN UINTN             Start,
+  IN UINTN             End,
+  IN UINTN             Grain,
+  IN MP_TASK_FOR_BODY  Body,
+  IN VOID              *Context OPTIONAL
+  )
+{
+  EFI_STATUS                  Status;
+  EDKII_PEI_MP_SERVICES2_PPI  *MpServices;
+  UINTN                       CpuCount;
+  MP_TASK_JOB                 Job;
+  UINT8                       DequeBuffer[(MP_TASK_PEI_MAX_WORKERS + 1) * sizeof (MP_TASK_DEQUE)];
+
+  if (Body == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Start >= End) {
+    return EFI_SUCCESS;
+  }
+
+  Status = MpTaskGetMpServices (&MpServices, &CpuCount);
+  if (EFI_ERROR (Status) || (CpuCount <= 1) || ((End - Start) == 1)) {
+    MpTaskRunSerial (Start, End, Body, Context);
+    return EFI_SUCCESS;
+  }
+
+  //
+  // One spare deque in the buffer leaves room to align the deques to cache lines.
+  //
+  Status = MpTaskJobInit (
+             &Job,
+             Start,
+             End,
+             Grain,
+             Body,
+             Context,
+             MIN (CpuCount, MP_TASK_PEI_MAX_WORKERS),
+             ALIGN_POINTER (DequeBuffer, MP_TASK_CACHE_LINE_SIZE)
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // StartupAllCPUs() runs the worker on the BSP too. It fails on a nested call or when
+  // called from an AP; the calling processor then steals all chunks by itself.
+  //
+  Status = MpServices->StartupAllCPUs (MpServices, MpTaskApWorker, 0, &Job);
+  if (EFI_ERROR (Status)) {
+    MpTaskRunWorker (&Job);
+  }
+
+  MpTaskJobFree (&Job);
+  return EFI_SUCCESS;
+}
+
+/**
+  Keep all enabled APs spinning on a mailbox so that the following MpTaskParallelFor()
+  and MpTaskRunGroup() calls are dispatched with low latency.
+
+  The PEI MP services have no non-blocking dispatch, so the APs cannot be parked.
+
+  @retval EFI_UNSUPPORTED        Parking is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskParkAps (
+  VOID
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Return the APs parked by MpTaskParkAps() to the MP services.
+
+  @retval EFI_NOT_STARTED        The APs are not parked.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskReleaseAps (
+  VOID
+  )
+{
+  return EFI_NOT_STARTED;
+}
+
+/**
+  Get the number of processors that take part in MpTaskParallelFor(), including the
+  calling processor.
+
+  @return The number of worker processors. It is at least 1.
+
+**/
+UINTN
+EFIAPI
+MpTaskGetWorkerCount (
+  VOID
+  )
+{
+  EDKII_PEI_MP_SERVICES2_PPI  *MpServices;
+  UINTN                       CpuCount;
+
+  if (EFI_ERROR (MpTaskGetMpServices (&MpServices, &CpuCount))) {
+    return 1;
+  }
+
+  //
+  // MpTaskParallelFor() runs at most MP_TASK_PEI_MAX_WORKERS workers.
+  //
+  return MAX (MIN (CpuCount, MP_TASK_PEI_MAX_WORKERS), 1);
+}
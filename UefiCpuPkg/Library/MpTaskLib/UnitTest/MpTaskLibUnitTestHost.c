@@ -0,0 +1,484 @@
+/** @file
+  Unit tests of the work-stealing scheduler of MpTaskLib
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UnitTestLib.h>
+#include "../MpTaskLibInternal.h"
+
+#define UNIT_TEST_APP_NAME     "MpTaskLib Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+//
+// The number of workers of the jobs run by MpTaskParallelFor() in the tests.
+//
+#define TEST_WORKER_COUNT  4
+
+//
+// The number of indexes of the loops in the tests.
+//
+#define TEST_INDEX_COUNT  1005
+
+/**
+  Run a loop the way the instances do, except that the workers of the job enter
+  MpTaskRunWorker() one after the other on the calling processor.
+
+  @param[in]  Start      The first index.
+  @param[in]  End        One past the last index.
+  @param[in]  Grain      The number of consecutive indexes handed out as one unit of work.
+  @param[in]  Body       The loop body.
+  @param[in]  Context    The context passed to every call of Body.
+
+  @retval EFI_SUCCESS            All iterations have completed.
+  @retval EFI_INVALID_PARAMETER  Body is NULL.
+  @retval EFI_OUT_OF_RESOURCES   There are not enough resources to schedule the loop.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskParallelFor (
+  IN UINTN             Start,
+  IN UINTN             End,
+  IN UINTN             Grain,
+  IN MP_TASK_FOR_BODY  Body,
+  IN VOID              *Context OPTIONAL
+  )
+{
+  EFI_STATUS   Status;
+  MP_TASK_JOB  Job;
+  UINTN        Worker;
+
+  if (Body == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Start >= End) {
+    return EFI_SUCCESS;
+  }
+
+  Status = MpTaskJobInit (&Job, Start, End, Grain, Body, Context, TEST_WORKER_COUNT, NULL);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Worker = 0; Worker < TEST_WORKER_COUNT; Worker++) {
+    MpTaskRunWorker (&Job);
+  }
+
+  ASSERT (Job.FinishedWorkers == TEST_WORKER_COUNT);
+  MpTaskJobFree (&Job);
+  return EFI_SUCCESS;
+}
+
+/**
+  Count the calls of the loop body for each index.
+
+  @param[in]  Index      The index of the loop iteration.
+  @param[in]  Context    The array of TEST_INDEX_COUNT counters.
+
+**/
+VOID
+EFIAPI
+CountIndex (
+  IN UINTN  Index,
+  IN VOID   *Context
+  )
+{
+  ((UINT8 *)Context)[Index]++;
+}
+
+/**
+  Count the calls of a task of MpTaskRunGroup().
+
+  @param[in]  Context    The counter of the task.
+
+**/
+VOID
+EFIAPI
+CountTask (
+  IN VOID  *Context
+  )
+{
+  (*(UINT8 *)Context)++;
+}
+
+/**
+  Check that the chunk range of a deque is packed into one word and back.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestCaseRange (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64  Range;
+
+  Range = MP_TASK_RANGE (3, 10);
+  UT_ASSERT_EQUAL (MP_TASK_RANGE_BEGIN (Range), 3);
+  UT_ASSERT_EQUAL (MP_TASK_RANGE_END (Range), 10);
+
+  Range = MP_TASK_RANGE (MAX_UINT32 - 1, MAX_UINT32);
+  UT_ASSERT_EQUAL (MP_TASK_RANGE_BEGIN (Range), MAX_UINT32 - 1);
+  UT_ASSERT_EQUAL (MP_TASK_RANGE_END (Range), MAX_UINT32);
+
+  Range = MP_TASK_RANGE (0, 0);
+  UT_ASSERT_EQUAL (Range, 0);
+
+  UT_ASSERT_EQUAL (sizeof (MP_TASK_DEQUE), MP_TASK_CACHE_LINE_SIZE);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that a thief splits off the back half of a deque, that a single chunk is
+  stolen as well, and that the owner keeps popping the front half.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestCaseStealAndPop (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MP_TASK_DEQUE  Deque;
+  UINT32         Begin;
+  UINT32         End;
+  UINT32         Chunk;
+
+  ZeroMem (&Deque, sizeof (Deque));
+
+  //
+  // An even range is split in two equal halves.
+  //
+  Deque.Range = MP_TASK_RANGE (0, 10);
+  UT_ASSERT_TRUE (MpTaskSteal (&Deque, &Begin, &End));
+  UT_ASSERT_EQUAL (Begin, 5);
+  UT_ASSERT_EQUAL (End, 10);
+  UT_ASSERT_EQUAL (Deque.Range, MP_TASK_RANGE (0, 5));
+
+  //
+  // The thief takes the larger half of an odd range.
+  //
+  Deque.Range = MP_TASK_RANGE (3, 6);
+  UT_ASSERT_TRUE (MpTaskSteal (&Deque, &Begin, &End));
+  UT_ASSERT_EQUAL (Begin, 4);
+  UT_ASSERT_EQUAL (End, 6);
+  UT_ASSERT_EQUAL (Deque.Range, MP_TASK_RANGE (3, 4));
+
+  //
+  // The owner pops the chunk left in front, and then finds the deque empty.
+  //
+  UT_ASSERT_TRUE (MpTaskPop (&Deque, &Chunk));
+  UT_ASSERT_EQUAL (Chunk, 3);
+  UT_ASSERT_FALSE (MpTaskPop (&Deque, &Chunk));
+  UT_ASSERT_FALSE (MpTaskSteal (&Deque, &Begin, &End));
+
+  //
+  // A single chunk is stolen and leaves the deque empty.
+  //
+  Deque.Range = MP_TASK_RANGE (7, 8);
+  UT_ASSERT_TRUE (MpTaskSteal (&Deque, &Begin, &End));
+  UT_ASSERT_EQUAL (Begin, 7);
+  UT_ASSERT_EQUAL (End, 8);
+  UT_ASSERT_FALSE (MpTaskPop (&Deque, &Chunk));
+
+  //
+  // Repeated steals never hand out a chunk twice.
+  //
+  Deque.Range = MP_TASK_RANGE (0, 100);
+  Chunk       = 100;
+  while (MpTaskSteal (&Deque, &Begin, &End)) {
+    UT_ASSERT_EQUAL (End, Chunk);
+    UT_ASSERT_TRUE (Begin < End);
+    Chunk = Begin;
+  }
+
+  UT_ASSERT_EQUAL (Chunk, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check the grain, the spread of the chunks over the deques and the alignment of
+  the deques of a job.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestCaseJobInit (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS     Status;
+  MP_TASK_JOB    Job;
+  UINT8          DequeBuffer[4 * sizeof (MP_TASK_DEQUE)];
+  MP_TASK_DEQUE  *Deques;
+
+  Status = MpTaskJobInit (&Job, 0, 10, 1, CountIndex, NULL, 3, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL ((UINTN)Job.Deques & (MP_TASK_CACHE_LINE_SIZE - 1), 0);
+  UT_ASSERT_EQUAL (Job.Deques[0].Range, MP_TASK_RANGE (0, 3));
+  UT_ASSERT_EQUAL (Job.Deques[1].Range, MP_TASK_RANGE (3, 6));
+  UT_ASSERT_EQUAL (Job.Deques[2].Range, MP_TASK_RANGE (6, 10));
+  MpTaskJobFree (&Job);
+  UT_ASSERT_TRUE (Job.Deques == NULL);
+
+  //
+  // The last chunk holds the indexes left over by the grain.
+  //
+  Status = MpTaskJobInit (&Job, 0, 10, 3, CountIndex, NULL, 2, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Job.Deques[0].Range, MP_TASK_RANGE (0, 2));
+  UT_ASSERT_EQUAL (Job.Deques[1].Range, MP_TASK_RANGE (2, 4));
+  MpTaskJobFree (&Job);
+
+  //
+  // A grain of 0 leaves MP_TASK_CHUNKS_PER_WORKER chunks per worker.
+  //
+  Status = MpTaskJobInit (&Job, 0, 1000, 0, CountIndex, NULL, TEST_WORKER_COUNT, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Job.Grain, 1000 / (TEST_WORKER_COUNT * MP_TASK_CHUNKS_PER_WORKER));
+  MpTaskJobFree (&Job);
+
+  //
+  // The deques provided by the caller are used in place.
+  //
+  Deques = ALIGN_POINTER (DequeBuffer, MP_TASK_CACHE_LINE_SIZE);
+  Status = MpTaskJobInit (&Job, 0, 2, 1, CountIndex, NULL, 2, Deques);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_TRUE (Job.Deques == Deques);
+  UT_ASSERT_TRUE (Job.DequeBuffer == NULL);
+  UT_ASSERT_EQUAL (Deques[0].Range, MP_TASK_RANGE (0, 1));
+  UT_ASSERT_EQUAL (Deques[1].Range, MP_TASK_RANGE (1, 2));
+  MpTaskJobFree (&Job);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that the first worker runs every index once by stealing the chunks of
+  the other deques, and that the workers entering later find nothing to run.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestCaseRunWorker (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS   Status;
+  MP_TASK_JOB  Job;
+  UINT8        Count[TEST_INDEX_COUNT];
+  UINTN        Index;
+  UINT32       Worker;
+
+  ZeroMem (Count, sizeof (Count));
+  Status = MpTaskJobInit (&Job, 5, TEST_INDEX_COUNT, 7, CountIndex, Count, TEST_WORKER_COUNT, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  MpTaskRunWorker (&Job);
+  for (Worker = 0; Worker < TEST_WORKER_COUNT; Worker++) {
+    UT_ASSERT_TRUE (MP_TASK_RANGE_BEGIN (Job.Deques[Worker].Range) >= MP_TASK_RANGE_END (Job.Deques[Worker].Range));
+  }
+
+  for (Index = 0; Index < TEST_INDEX_COUNT; Index++) {
+    UT_ASSERT_EQUAL (Count[Index], (Index < 5) ? 0 : 1);
+  }
+
+  //
+  // The other workers, and one more than the job was sized for, only check in.
+  //
+  for (Worker = 0; Worker < TEST_WORKER_COUNT; Worker++) {
+    MpTaskRunWorker (&Job);
+  }
+
+  UT_ASSERT_EQUAL (Job.FinishedWorkers, TEST_WORKER_COUNT + 1);
+  for (Index = 5; Index < TEST_INDEX_COUNT; Index++) {
+    UT_ASSERT_EQUAL (Count[Index], 1);
+  }
+
+  MpTaskJobFree (&Job);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that MpTaskRunGroup() runs every task once.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestCaseRunGroup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+  MP_TASK     Tasks[10];
+  UINT8       Count[10];
+  UINTN       Index;
+
+  ZeroMem (Count, sizeof (Count));
+  for (Index = 0; Index < ARRAY_SIZE (Tasks); Index++) {
+    Tasks[Index].Procedure = CountTask;
+    Tasks[Index].Context   = &Count[Index];
+  }
+
+  Status = MpTaskRunGroup (Tasks, ARRAY_SIZE (Tasks));
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  for (Index = 0; Index < ARRAY_SIZE (Count); Index++) {
+    UT_ASSERT_EQUAL (Count[Index], 1);
+  }
+
+  UT_ASSERT_STATUS_EQUAL (MpTaskRunGroup (NULL, 1), EFI_INVALID_PARAMETER);
+  UT_ASSERT_NOT_EFI_ERROR (MpTaskRunGroup (NULL, 0));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  scheduler of MpTaskLib and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      ManualTestCase;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the Manual Test Cases.
+  //
+  Status = CreateUnitTestSuite (&ManualTestCase, Framework, "Manual Test Cases", "MpTaskLib.Manual", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Manual Test Cases\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (ManualTestCase, "Check the packing of the chunk range", "Manual Test Case1", TestCaseRange, NULL, NULL, NULL);
+  AddTestCase (ManualTestCase, "Check the split of a deque by steal and pop", "Manual Test Case2", TestCaseStealAndPop, NULL, NULL, NULL);
+  AddTestCase (ManualTestCase, "Check the grain, spread and alignment of the deques", "Manual Test Case3", TestCaseJobInit, NULL, NULL, NULL);
+  AddTestCase (ManualTestCase, "Check that a worker steals all chunks once", "Manual Test Case4", TestCaseRunWorker, NULL, NULL, NULL);
+  AddTestCase (ManualTestCase, "Check that a task group runs every task once", "Manual Test Case5", TestCaseRunGroup, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param Argc  Number of arguments.
+  @param Argv  Array of arguments.
+
+  @return Test application exit code.
+**/
+INT32
+main (
+  INT32  Argc,
+  CHAR8  *Argv[]
+  )
+{
+  return UefiTestMain ();
+}
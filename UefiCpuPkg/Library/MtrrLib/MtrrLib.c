@@ -1181,12 +1181,31 @@ MtrrLibGetNumberOfTypes (
   )
 {
   UINTN  Index;
+  UINTN  Low;
+  UINTN  High;
   UINT8  TypeCount;
   UINT8  LocalTypes;
 
   TypeCount  = 0;
   LocalTypes = 0;
-  for (Index = 0; Index < RangeCount; Index++) {
+
+  //
+  // Ranges are sorted and do not overlap. The solver calls this for every pair
+  // of vertices, so binary search the first range that ends above BaseAddress
+  // instead of scanning from the first range.
+  //
+  Low  = 0;
+  High = RangeCount;
+  while (Low < High) {
+    Index = Low + (High - Low) / 2;
+    if (Ranges[Index].BaseAddress + Ranges[Index].Length <= BaseAddress) {
+      Low = Index + 1;
+    } else {
+      High = Index;
+    }
+  }
+
+  for (Index = Low; Index < RangeCount; Index++) {
     if ((Ranges[Index].BaseAddress <= BaseAddress) &&
         (BaseAddress < Ranges[Index].BaseAddress + Ranges[Index].Length)
         )
@@ -2085,6 +2104,100 @@ MtrrLibMergeVariableMtrr (
   }
 }
 
+/**
+  Calculate the variable MTRR settings for all memory ranges without the graph
+  solver, when one MTRR for each range not in the default type is known to be
+  the least.
+
+  That is the case when all ranges not in the default type are naturally
+  aligned power-of-two ranges of one same type, and no two of them are
+  adjacent: an MTRR covering two such ranges needs at least one more MTRR to
+  restore the default type of the gap between them, so combining ranges never
+  saves an MTRR.
+
+  The memory below FixedMtrrMemoryLimit is covered by the fixed MTRRs, so the
+  range starting at FixedMtrrMemoryLimit may be extended down to 0 to become
+  aligned.
+
+  @param DefaultType          Default memory type.
+  @param FixedMtrrMemoryLimit The memory limit covered by the fixed MTRRs.
+  @param Ranges               Memory range array holding the memory type
+                              settings for all memory address.
+  @param RangeCount           Count of memory ranges.
+  @param VariableMtrr         Array holding all MTRR settings.
+  @param VariableMtrrCapacity Capacity of the MTRR array.
+  @param VariableMtrrCount    The count of MTRR settings in array.
+
+  @retval RETURN_SUCCESS          Variable MTRRs are allocated successfully.
+  @retval RETURN_OUT_OF_RESOURCES Count of variable MTRRs exceeds capacity.
+  @retval RETURN_UNSUPPORTED      The memory ranges need the graph solver.
+**/
+RETURN_STATUS
+MtrrLibSetAlignedMemoryRanges (
+  IN MTRR_MEMORY_CACHE_TYPE   DefaultType,
+  IN UINT64                   FixedMtrrMemoryLimit,
+  IN CONST MTRR_MEMORY_RANGE  *Ranges,
+  IN UINTN                    RangeCount,
+  OUT MTRR_MEMORY_RANGE       *VariableMtrr,
+  IN UINT32                   VariableMtrrCapacity,
+  OUT UINT32                  *VariableMtrrCount
+  )
+{
+  RETURN_STATUS  Status;
+  UINTN          Index;
+  UINT8          Types;
+  BOOLEAN        Adjacent;
+  UINT64         Base;
+  UINT64         Length;
+
+  *VariableMtrrCount = 0;
+  Types              = 0;
+  Adjacent           = FALSE;
+
+  for (Index = 0; Index < RangeCount; Index++) {
+    Base   = Ranges[Index].BaseAddress;
+    Length = Ranges[Index].Length;
+    if (Base + Length <= FixedMtrrMemoryLimit) {
+      continue;
+    }
+
+    if (Ranges[Index].Type == DefaultType) {
+      Adjacent = FALSE;
+      continue;
+    }
+
+    Types |= (UINT8)(1 << Ranges[Index].Type);
+    if (Adjacent || !IS_POW2 (Types)) {
+      return RETURN_UNSUPPORTED;
+    }
+
+    Adjacent = TRUE;
+
+    if ((Base <= FixedMtrrMemoryLimit) && (!IS_POW2 (Length) || ((Base & (Length - 1)) != 0))) {
+      Length += Base;
+      Base    = 0;
+    }
+
+    if (!IS_POW2 (Length) || ((Base & (Length - 1)) != 0)) {
+      return RETURN_UNSUPPORTED;
+    }
+
+    Status = MtrrLibAppendVariableMtrr (
+               VariableMtrr,
+               VariableMtrrCapacity,
+               VariableMtrrCount,
+               Base,
+               Length,
+               Ranges[Index].Type
+               );
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
+
 /**
   Calculate the variable MTRR settings for all memory ranges.
 
@@ -2538,19 +2651,32 @@ MtrrSetMemoryAttributesInMtrrSettings (
     if (Modified) {
       //
       // 2.4. Calculate the Variable MTRR settings based on the Ranges.
-      //      Buffer Too Small may be returned if the scratch buffer size is insufficient.
+      //      Already aligned ranges are set directly. Otherwise the graph solver runs,
+      //      and Buffer Too Small may be returned if the scratch buffer size is insufficient.
       //
-      Status = MtrrLibSetMemoryRanges (
+      Status = MtrrLibSetAlignedMemoryRanges (
                  DefaultType,
-                 LShiftU64 (1, (UINTN)HighBitSet64 (MtrrValidBitsMask)),
+                 FixedMtrrMemoryLimit,
                  WorkingRanges,
                  WorkingRangeCount,
-                 Scratch,
-                 ScratchSize,
                  WorkingVariableMtrr,
                  FirmwareVariableMtrrCount + 1,
                  &WorkingVariableMtrrCount
                  );
+      if (Status == RETURN_UNSUPPORTED) {
+        Status = MtrrLibSetMemoryRanges (
+                   DefaultType,
+                   LShiftU64 (1, (UINTN)HighBitSet64 (MtrrValidBitsMask)),
+                   WorkingRanges,
+                   WorkingRangeCount,
+                   Scratch,
+                   ScratchSize,
+                   WorkingVariableMtrr,
+                   FirmwareVariableMtrrCount + 1,
+                   &WorkingVariableMtrrCount
+                   );
+      }
+
       if (RETURN_ERROR (Status)) {
         goto Exit;
       }
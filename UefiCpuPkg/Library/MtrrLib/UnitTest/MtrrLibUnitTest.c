@@ -1167,6 +1167,88 @@ UnitTestMtrrSetMemoryAttributeAndGetMemoryAttributesInMtrrSettings (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Unit test of MtrrLib service MtrrSetMemoryAttributesInMtrrSettings() with
+  naturally aligned memory ranges, which are programmed without the MTRR
+  calculation.
+
+  @param[in]  Context    Ignored
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+UnitTestMtrrSetAlignedMemoryAttributesInMtrrSettings (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MTRR_LIB_TEST_CONTEXT      *LocalContext;
+  MTRR_LIB_SYSTEM_PARAMETER  SystemParameter;
+  RETURN_STATUS              Status;
+  UINT8                      Scratch[SCRATCH_BUFFER_SIZE];
+  UINTN                      ScratchSize;
+  MTRR_SETTINGS              LocalMtrrs;
+  MTRR_MEMORY_RANGE          ActualMemoryRanges[MTRR_NUMBER_OF_FIXED_MTRR * sizeof (UINT64) + 2 * MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  UINTN                      ActualMemoryRangesCount;
+  UINT32                     ActualVariableMtrrUsage;
+  MTRR_MEMORY_RANGE          ReturnedMemoryRanges[MTRR_NUMBER_OF_FIXED_MTRR * sizeof (UINT64) + 2 * MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  UINTN                      ReturnedMemoryRangesCount;
+  MTRR_MEMORY_RANGE          Ranges[] = {
+    { 0,          SIZE_2GB, CacheWriteBack },
+    { BASE_4GB,   SIZE_4GB, CacheWriteBack },
+    { BASE_16GB,  SIZE_1GB, CacheWriteBack },
+  };
+  MTRR_MEMORY_RANGE          ExpectedMemoryRanges[] = {
+    { 0,                    SIZE_2GB,                        CacheWriteBack   },
+    { BASE_2GB,             SIZE_2GB,                        CacheUncacheable },
+    { BASE_4GB,             SIZE_4GB,                        CacheWriteBack   },
+    { BASE_8GB,             SIZE_8GB,                        CacheUncacheable },
+    { BASE_16GB,            SIZE_1GB,                        CacheWriteBack   },
+    { BASE_16GB + SIZE_1GB, SIZE_4TB - BASE_16GB - SIZE_1GB, CacheUncacheable },
+  };
+
+  LocalContext = (MTRR_LIB_TEST_CONTEXT *)Context;
+  CopyMem (&SystemParameter, LocalContext->SystemParameter, sizeof (SystemParameter));
+  SystemParameter.PhysicalAddressBits = 42;
+  SystemParameter.DefaultCacheType    = CacheUncacheable;
+  InitializeMtrrRegs (&SystemParameter);
+
+  ZeroMem (&LocalMtrrs, sizeof (LocalMtrrs));
+  LocalMtrrs.MtrrDefType = MtrrGetDefaultMemoryType ();
+  ScratchSize            = sizeof (Scratch);
+  Status                 = MtrrSetMemoryAttributesInMtrrSettings (&LocalMtrrs, Scratch, &ScratchSize, Ranges, ARRAY_SIZE (Ranges));
+  UT_ASSERT_STATUS_EQUAL (Status, RETURN_SUCCESS);
+
+  //
+  // One variable MTRR for each range is the least.
+  //
+  ActualMemoryRangesCount = ARRAY_SIZE (ActualMemoryRanges);
+  CollectTestResult (
+    SystemParameter.DefaultCacheType,
+    SystemParameter.PhysicalAddressBits - SystemParameter.MkTmeKeyidBits,
+    SystemParameter.VariableMtrrCount,
+    &LocalMtrrs,
+    ActualMemoryRanges,
+    &ActualMemoryRangesCount,
+    &ActualVariableMtrrUsage
+    );
+  UT_ASSERT_EQUAL (ActualVariableMtrrUsage, ARRAY_SIZE (Ranges));
+
+  ReturnedMemoryRangesCount = ARRAY_SIZE (ReturnedMemoryRanges);
+  Status                    = MtrrGetMemoryAttributesInMtrrSettings (
+                                &LocalMtrrs,
+                                ReturnedMemoryRanges,
+                                &ReturnedMemoryRangesCount
+                                );
+  UT_ASSERT_STATUS_EQUAL (Status, RETURN_SUCCESS);
+  UT_LOG_INFO ("--- Returned Memory Ranges [%d] ---\n", ReturnedMemoryRangesCount);
+  DumpMemoryRanges (ReturnedMemoryRanges, ReturnedMemoryRangesCount);
+  return VerifyMemoryRanges (ExpectedMemoryRanges, ARRAY_SIZE (ExpectedMemoryRanges), ReturnedMemoryRanges, ReturnedMemoryRangesCount);
+}
+
 /**
   Prep routine for UnitTestGetFirmwareVariableMtrrCount().
 
@@ -1265,6 +1347,7 @@ UnitTestingEntry (
   AddTestCase (MtrrApiTests, "Test MtrrGetMemoryAttributeInVariableMtrr", "MtrrGetMemoryAttributeInVariableMtrr", UnitTestMtrrGetMemoryAttributeInVariableMtrr, NULL, NULL, &Context);
   AddTestCase (MtrrApiTests, "Test MtrrDebugPrintAllMtrrs", "MtrrDebugPrintAllMtrrs", UnitTestMtrrDebugPrintAllMtrrs, NULL, NULL, &Context);
   AddTestCase (MtrrApiTests, "Test MtrrGetDefaultMemoryType", "MtrrGetDefaultMemoryType", UnitTestMtrrGetDefaultMemoryType, NULL, NULL, &Context);
+  AddTestCase (MtrrApiTests, "Test MtrrSetMemoryAttributesInMtrrSettings with aligned ranges", "MtrrSetAlignedMemoryAttributesInMtrrSettings", UnitTestMtrrSetAlignedMemoryAttributesInMtrrSettings, NULL, NULL, &Context);
 
   for (SystemIndex = 0; SystemIndex < ARRAY_SIZE (mSystemParameters); SystemIndex++) {
     for (Index = 0; Index < Iteration; Index++) {
@@ -1287,6 +1370,153 @@ EXIT:
   return Status;
 }
 
+/**
+  Measure how long MtrrSetMemoryAttributesInMtrrSettings() and
+  MtrrSetMemoryAttributeInMtrrSettings() take to program random memory layouts.
+
+  @param Iteration  Count of random memory layouts for each system parameter.
+**/
+STATIC
+VOID
+RunBenchmark (
+  IN UINTN  Iteration
+  )
+{
+  RETURN_STATUS              Status;
+  UINTN                      SystemIndex;
+  MTRR_LIB_SYSTEM_PARAMETER  *SystemParameter;
+  UINTN                      Index;
+  UINTN                      RangeIndex;
+  UINT32                     UcCount;
+  UINT32                     WtCount;
+  UINT32                     WbCount;
+  UINT32                     WpCount;
+  UINT32                     WcCount;
+  MTRR_MEMORY_RANGE          RawMtrrRange[MTRR_NUMBER_OF_VARIABLE_MTRR];
+  MTRR_MEMORY_RANGE          Ranges[MTRR_NUMBER_OF_FIXED_MTRR * sizeof (UINT64) + 2 * MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  UINTN                      RangeCount;
+  MTRR_MEMORY_RANGE          ActualMemoryRanges[MTRR_NUMBER_OF_FIXED_MTRR * sizeof (UINT64) + 2 * MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  UINTN                      ActualMemoryRangesCount;
+  UINT32                     ActualVariableMtrrUsage;
+  MTRR_SETTINGS              LocalMtrrs;
+  UINT8                      *Scratch;
+  UINTN                      ScratchSize;
+  clock_t                    Start;
+  clock_t                    Elapsed;
+  UINT64                     BatchTime;
+  UINT64                     SingleTime;
+  UINT64                     TotalRangeCount;
+  UINT64                     TotalMtrrCount;
+
+  ScratchSize = SCRATCH_BUFFER_SIZE;
+  Scratch     = malloc (ScratchSize);
+  if (Scratch == NULL) {
+    return;
+  }
+
+  for (SystemIndex = 0; SystemIndex < ARRAY_SIZE (mSystemParameters); SystemIndex++) {
+    SystemParameter = &mSystemParameters[SystemIndex];
+    InitializeMtrrRegs (SystemParameter);
+
+    BatchTime       = 0;
+    SingleTime      = 0;
+    TotalRangeCount = 0;
+    TotalMtrrCount  = 0;
+    for (Index = 0; Index < Iteration; Index++) {
+      GenerateRandomMemoryTypeCombination (
+        SystemParameter->VariableMtrrCount - PatchPcdGet32 (PcdCpuNumberOfReservedVariableMtrrs),
+        &UcCount,
+        &WtCount,
+        &WbCount,
+        &WpCount,
+        &WcCount
+        );
+      GenerateValidAndConfigurableMtrrPairs (
+        SystemParameter->PhysicalAddressBits - SystemParameter->MkTmeKeyidBits,
+        RawMtrrRange,
+        UcCount,
+        WtCount,
+        WbCount,
+        WpCount,
+        WcCount
+        );
+      RangeCount = ARRAY_SIZE (Ranges);
+      GetEffectiveMemoryRanges (
+        SystemParameter->DefaultCacheType,
+        SystemParameter->PhysicalAddressBits - SystemParameter->MkTmeKeyidBits,
+        RawMtrrRange,
+        UcCount + WtCount + WbCount + WpCount + WcCount,
+        Ranges,
+        &RangeCount
+        );
+      TotalRangeCount += RangeCount;
+
+      //
+      // All ranges in one call. The first call may only report the scratch size needed.
+      //
+      do {
+        ZeroMem (&LocalMtrrs, sizeof (LocalMtrrs));
+        LocalMtrrs.MtrrDefType = MtrrGetDefaultMemoryType ();
+        Start                  = clock ();
+        Status                 = MtrrSetMemoryAttributesInMtrrSettings (&LocalMtrrs, Scratch, &ScratchSize, Ranges, RangeCount);
+        Elapsed                = clock () - Start;
+        if (Status == RETURN_BUFFER_TOO_SMALL) {
+          Scratch = realloc (Scratch, ScratchSize);
+          ASSERT (Scratch != NULL);
+        }
+      } while (Status == RETURN_BUFFER_TOO_SMALL);
+
+      BatchTime += Elapsed;
+
+      ActualMemoryRangesCount = ARRAY_SIZE (ActualMemoryRanges);
+      CollectTestResult (
+        SystemParameter->DefaultCacheType,
+        SystemParameter->PhysicalAddressBits - SystemParameter->MkTmeKeyidBits,
+        SystemParameter->VariableMtrrCount,
+        &LocalMtrrs,
+        ActualMemoryRanges,
+        &ActualMemoryRangesCount,
+        &ActualVariableMtrrUsage
+        );
+      TotalMtrrCount += ActualVariableMtrrUsage;
+
+      //
+      // One range per call.
+      //
+      ZeroMem (&LocalMtrrs, sizeof (LocalMtrrs));
+      LocalMtrrs.MtrrDefType = MtrrGetDefaultMemoryType ();
+      Start                  = clock ();
+      for (RangeIndex = 0; RangeIndex < RangeCount; RangeIndex++) {
+        Status = MtrrSetMemoryAttributeInMtrrSettings (
+                   &LocalMtrrs,
+                   Ranges[RangeIndex].BaseAddress,
+                   Ranges[RangeIndex].Length,
+                   Ranges[RangeIndex].Type
+                   );
+        if (RETURN_ERROR (Status)) {
+          break;
+        }
+      }
+
+      SingleTime += clock () - Start;
+    }
+
+    DEBUG ((
+      DEBUG_INFO,
+      "%d-bit %a: %d layouts, %ld ranges, %ld MTRRs, %ld us batched, %ld us range by range\n",
+      SystemParameter->PhysicalAddressBits - SystemParameter->MkTmeKeyidBits,
+      mCacheDescription[SystemParameter->DefaultCacheType],
+      Iteration,
+      TotalRangeCount,
+      TotalMtrrCount,
+      DivU64x32 (MultU64x32 (BatchTime, 1000000), CLOCKS_PER_SEC),
+      DivU64x32 (MultU64x32 (SingleTime, 1000000), CLOCKS_PER_SEC)
+      ));
+  }
+
+  free (Scratch);
+}
+
 /**
   Standard POSIX C entry point for host based unit test execution.
 
@@ -1316,6 +1546,19 @@ main (
     return 0;
   }
 
+  //
+  // MtrrLibUnitTest benchmark [<iterations>]
+  //   Default <iterations> is 1000.
+  //   Always uses random inputs.
+  //
+  if (((Argc == 2) || (Argc == 3)) && (AsciiStriCmp ("benchmark", Argv[1]) == 0)) {
+    Count        = (Argc == 3) ? atoi (Argv[2]) : 1000;
+    mRandomInput = TRUE;
+    DEBUG ((DEBUG_INFO, "Benchmark %d random memory layouts.\n", Count));
+    RunBenchmark (Count);
+    return 0;
+  }
+
   //
   // MtrrLibUnitTest [<iterations>]
   //                 <iterations> [fixed|random]
@@ -0,0 +1,802 @@
+/** @file
+  SMM CPU Sync lib implementation with per-package counters.
+
+  SmmCpuSyncLib.c counts the checked-in CPUs, and the APs releasing the BSP, on two
+  shared semaphores that every CPU in the system updates. On large multi-socket systems
+  these two cache lines bounce between all packages on every SMI.
+
+  This instance splits both counters into one pair per package, so that a CPU only ever
+  updates a line shared with the threads of its own package. The BSP sits at the root of
+  the two-level tree: it sums the package counters to get the arrived CPU count, locks the
+  door package by package, and collects the AP releases from all package counters. The
+  per-AP Run semaphores are unchanged, since they are already private to each CPU.
+
+  The package of a CPU is taken from its APIC ID the first time the CPU checks in. Packages
+  are folded into at most SMM_CPU_SYNC_MAX_GROUPS groups, so two packages may share a
+  group on very large systems; the counting stays correct, only the locality is reduced.
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/LocalApicLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/SafeIntLib.h>
+#include <Library/SmmCpuSyncLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Uefi.h>
+
+#define SMM_CPU_SYNC_MAX_GROUPS    16
+#define SMM_CPU_SYNC_GROUP_UNKNOWN  MAX_UINT32
+
+///
+/// The implementation shall place one semaphore on exclusive cache line for good performance.
+///
+typedef volatile UINT32 SMM_CPU_SYNC_SEMAPHORE;
+
+typedef struct {
+  ///
+  /// Used for control each CPU continue run or wait for signal
+  ///
+  SMM_CPU_SYNC_SEMAPHORE    *Run;
+  ///
+  /// The group of the CPU, or SMM_CPU_SYNC_GROUP_UNKNOWN before its first check-in.
+  ///
+  UINT32                    Group;
+} SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_CPU;
+
+typedef struct {
+  ///
+  /// Indicate CPUs of the group entered SMM before lock door.
+  ///
+  SMM_CPU_SYNC_SEMAPHORE    *CpuCount;
+  ///
+  /// Releases of the BSP by the APs of the group, not yet collected by the BSP.
+  ///
+  SMM_CPU_SYNC_SEMAPHORE    *BspRun;
+} SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_GROUP;
+
+struct SMM_CPU_SYNC_CONTEXT  {
+  ///
+  /// Indicate all CPUs in the system.
+  ///
+  UINTN                                    NumberOfCpus;
+  ///
+  /// Address of semaphores.
+  ///
+  VOID                                     *SemBuffer;
+  ///
+  /// Size of semaphores.
+  ///
+  UINTN                                    SemBufferPages;
+  ///
+  /// Before the door is locked, the arrived CPU count is the sum of the group CpuCount.
+  /// After the door is locked, every group CpuCount is set to -1 and DoorLocked is TRUE.
+  /// ArrivedCpuCountUponLock stores the arrived CPU count then.
+  ///
+  UINTN                                    ArrivedCpuCountUponLock;
+  BOOLEAN                                  DoorLocked;
+  ///
+  /// Number of groups.
+  ///
+  UINTN                                    NumberOfGroups;
+  SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_GROUP    *GroupSem;
+  ///
+  /// Define an array of structure for each CPU semaphore due to the size alignment
+  /// requirement. With the array of structure for each CPU semaphore, it's easy to
+  /// reach the specific CPU with CPU Index for its own semaphore access: CpuSem[CpuIndex].
+  ///
+  SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_CPU      CpuSem[];
+};
+
+/**
+  Performs an atomic compare exchange operation to get semaphore.
+  The compare exchange operation must be performed using MP safe
+  mechanisms.
+
+  @param[in,out]  Sem    IN:  32-bit unsigned integer
+                         OUT: original integer - 1 if Sem is not locked.
+                         OUT: MAX_UINT32 if Sem is locked.
+
+  @retval     Original integer - 1 if Sem is not locked.
+              MAX_UINT32 if Sem is locked.
+
+**/
+STATIC
+UINT32
+InternalWaitForSemaphore (
+  IN OUT  volatile UINT32  *Sem
+  )
+{
+  UINT32  Value;
+
+  for ( ; ;) {
+    Value = *Sem;
+    if (Value == MAX_UINT32) {
+      return Value;
+    }
+
+    if ((Value != 0) &&
+        (InterlockedCompareExchange32 (
+           (UINT32 *)Sem,
+           Value,
+           Value - 1
+           ) == Value))
+    {
+      break;
+    }
+
+    CpuPause ();
+  }
+
+  return Value - 1;
+}
+
+/**
+  Performs an atomic compare exchange operation to take up to MaxCount from a
+  semaphore without waiting.
+
+  @param[in,out]  Sem       The semaphore.
+  @param[in]      MaxCount  The maximum count to take.
+
+  @return The count taken from the semaphore.
+
+**/
+STATIC
+UINT32
+InternalTakeSemaphore (
+  IN OUT  volatile UINT32  *Sem,
+  IN      UINT32           MaxCount
+  )
+{
+  UINT32  Value;
+  UINT32  Count;
+
+  do {
+    Value = *Sem;
+    if (Value == 0) {
+      return 0;
+    }
+
+    Count = MIN (Value, MaxCount);
+  } while (InterlockedCompareExchange32 (
+             (UINT32 *)Sem,
+             Value,
+             Value - Count
+             ) != Value);
+
+  return Count;
+}
+
+/**
+  Performs an atomic compare exchange operation to release semaphore.
+  The compare exchange operation must be performed using MP safe
+  mechanisms.
+
+  @param[in,out]  Sem    IN:  32-bit unsigned integer
+                         OUT: original integer + 1 if Sem is not locked.
+                         OUT: MAX_UINT32 if Sem is locked.
+
+  @retval    Original integer + 1 if Sem is not locked.
+             MAX_UINT32 if Sem is locked.
+
+**/
+STATIC
+UINT32
+InternalReleaseSemaphore (
+  IN OUT  volatile UINT32  *Sem
+  )
+{
+  UINT32  Value;
+
+  do {
+    Value = *Sem;
+  } while (Value + 1 != 0 &&
+           InterlockedCompareExchange32 (
+             (UINT32 *)Sem,
+             Value,
+             Value + 1
+             ) != Value);
+
+  if (Value == MAX_UINT32) {
+    return Value;
+  }
+
+  return Value + 1;
+}
+
+/**
+  Performs an atomic compare exchange operation to lock semaphore.
+  The compare exchange operation must be performed using MP safe
+  mechanisms.
+
+  @param[in,out]  Sem    IN:  32-bit unsigned integer
+                         OUT: -1
+
+  @retval    Original integer
+
+**/
+STATIC
+UINT32
+InternalLockdownSemaphore (
+  IN OUT  volatile UINT32  *Sem
+  )
+{
+  UINT32  Value;
+
+  do {
+    Value = *Sem;
+  } while (InterlockedCompareExchange32 (
+             (UINT32 *)Sem,
+             Value,
+             (UINT32)-1
+             ) != Value);
+
+  return Value;
+}
+
+/**
+  Get the group of the calling CPU. The group is derived from the package of the CPU
+  the first time it is needed, and cached afterwards.
+
+  @param[in,out]  Context     Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex    The index of the calling CPU.
+
+  @return The group of the CPU.
+
+**/
+STATIC
+UINT32
+InternalGetCpuGroup (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex
+  )
+{
+  UINT32  Package;
+
+  if (Context->CpuSem[CpuIndex].Group == SMM_CPU_SYNC_GROUP_UNKNOWN) {
+    GetProcessorLocationByApicId (GetApicId (), &Package, NULL, NULL);
+    Context->CpuSem[CpuIndex].Group = (UINT32)(Package % Context->NumberOfGroups);
+  }
+
+  return Context->CpuSem[CpuIndex].Group;
+}
+
+/**
+  Create and initialize the SMM CPU Sync context. It is to allocate and initialize the
+  SMM CPU Sync context.
+
+  If Context is NULL, then ASSERT().
+
+  @param[in]  NumberOfCpus          The number of Logical Processors in the system.
+  @param[out] Context               Pointer to the new created and initialized SMM CPU Sync context object.
+                                    NULL will be returned if any error happen during init.
+
+  @retval RETURN_SUCCESS            The SMM CPU Sync context was successful created and initialized.
+  @retval RETURN_OUT_OF_RESOURCES   There are not enough resources available to create and initialize SMM CPU Sync context.
+  @retval RETURN_BUFFER_TOO_SMALL   Overflow happen
+
+**/
+RETURN_STATUS
+EFIAPI
+SmmCpuSyncContextInit (
+  IN   UINTN                 NumberOfCpus,
+  OUT  SMM_CPU_SYNC_CONTEXT  **Context
+  )
+{
+  RETURN_STATUS                          Status;
+  UINTN                                  ContextSize;
+  UINTN                                  OneSemSize;
+  UINTN                                  NumberOfGroups;
+  UINTN                                  NumSem;
+  UINTN                                  TotalSemSize;
+  UINTN                                  SemAddr;
+  UINTN                                  Index;
+  SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_CPU    *CpuSem;
+  SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_GROUP  *GroupSem;
+
+  ASSERT (Context != NULL);
+
+  NumberOfGroups = MAX (1, MIN (NumberOfCpus, SMM_CPU_SYNC_MAX_GROUPS));
+
+  //
+  // Calculate ContextSize: the CPU semaphores follow the context, the group
+  // semaphores follow the CPU semaphores.
+  //
+  Status = SafeUintnMult (NumberOfCpus, sizeof (SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_CPU), &ContextSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SafeUintnAdd (ContextSize, sizeof (SMM_CPU_SYNC_CONTEXT), &ContextSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SafeUintnAdd (ContextSize, NumberOfGroups * sizeof (SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_GROUP), &ContextSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Allocate Buffer for Context
+  //
+  *Context = AllocatePool (ContextSize);
+  if (*Context == NULL) {
+    return RETURN_OUT_OF_RESOURCES;
+  }
+
+  (*Context)->ArrivedCpuCountUponLock = 0;
+  (*Context)->DoorLocked              = FALSE;
+
+  //
+  // Save NumberOfCpus and NumberOfGroups
+  //
+  (*Context)->NumberOfCpus   = NumberOfCpus;
+  (*Context)->NumberOfGroups = NumberOfGroups;
+  (*Context)->GroupSem       = (SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_GROUP *)&(*Context)->CpuSem[NumberOfCpus];
+
+  //
+  // Calculate total semaphore size: one Run semaphore per CPU, and a CpuCount and
+  // a BspRun semaphore per group.
+  //
+  OneSemSize = GetSpinLockProperties ();
+  ASSERT (sizeof (SMM_CPU_SYNC_SEMAPHORE) <= OneSemSize);
+
+  Status = SafeUintnAdd (NumberOfCpus, 2 * NumberOfGroups, &NumSem);
+  if (RETURN_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = SafeUintnMult (NumSem, OneSemSize, &TotalSemSize);
+  if (RETURN_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Allocate for Semaphores in the *Context
+  //
+  (*Context)->SemBufferPages = EFI_SIZE_TO_PAGES (TotalSemSize);
+  (*Context)->SemBuffer      = AllocatePages ((*Context)->SemBufferPages);
+  if ((*Context)->SemBuffer == NULL) {
+    Status = RETURN_OUT_OF_RESOURCES;
+    goto ON_ERROR;
+  }
+
+  SemAddr = (UINTN)(*Context)->SemBuffer;
+
+  //
+  // Assign Group Semaphore pointer
+  //
+  GroupSem = (*Context)->GroupSem;
+  for (Index = 0; Index < NumberOfGroups; Index++) {
+    GroupSem->CpuCount  = (SMM_CPU_SYNC_SEMAPHORE *)SemAddr;
+    *GroupSem->CpuCount = 0;
+    SemAddr            += OneSemSize;
+
+    GroupSem->BspRun  = (SMM_CPU_SYNC_SEMAPHORE *)SemAddr;
+    *GroupSem->BspRun = 0;
+    SemAddr          += OneSemSize;
+
+    GroupSem++;
+  }
+
+  //
+  // Assign CPU Semaphore pointer
+  //
+  CpuSem = (*Context)->CpuSem;
+  for (Index = 0; Index < NumberOfCpus; Index++) {
+    CpuSem->Run   = (SMM_CPU_SYNC_SEMAPHORE *)SemAddr;
+    *CpuSem->Run  = 0;
+    CpuSem->Group = SMM_CPU_SYNC_GROUP_UNKNOWN;
+
+    CpuSem++;
+    SemAddr += OneSemSize;
+  }
+
+  return RETURN_SUCCESS;
+
+ON_ERROR:
+  FreePool (*Context);
+  return Status;
+}
+
+/**
+  Deinit an allocated SMM CPU Sync context. The resources allocated in SmmCpuSyncContextInit() will
+  be freed.
+
+  If Context is NULL, then ASSERT().
+
+  @param[in,out]  Context     Pointer to the SMM CPU Sync context object to be deinitialized.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncContextDeinit (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context
+  )
+{
+  ASSERT (Context != NULL);
+
+  FreePages (Context->SemBuffer, Context->SemBufferPages);
+
+  FreePool (Context);
+}
+
+/**
+  Reset SMM CPU Sync context. SMM CPU Sync context will be reset to the initialized state.
+
+  This function is called by one of CPUs after all CPUs are ready to exit SMI, which allows CPU to
+  check into the next SMI from this point.
+
+  If Context is NULL, then ASSERT().
+
+  @param[in,out]  Context     Pointer to the SMM CPU Sync context object to be reset.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncContextReset (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context
+  )
+{
+  UINTN  Index;
+
+  ASSERT (Context != NULL);
+
+  Context->ArrivedCpuCountUponLock = 0;
+  Context->DoorLocked              = FALSE;
+
+  for (Index = 0; Index < Context->NumberOfGroups; Index++) {
+    *Context->GroupSem[Index].CpuCount = 0;
+  }
+}
+
+/**
+  Get current number of arrived CPU in SMI.
+
+  BSP might need to know the current number of arrived CPU in SMI to make sure all APs
+  in SMI. This API can be for that purpose.
+
+  If Context is NULL, then ASSERT().
+
+  @param[in]      Context     Pointer to the SMM CPU Sync context object.
+
+  @retval    Current number of arrived CPU in SMI.
+
+**/
+UINTN
+EFIAPI
+SmmCpuSyncGetArrivedCpuCount (
+  IN  SMM_CPU_SYNC_CONTEXT  *Context
+  )
+{
+  UINTN   Index;
+  UINTN   Arrived;
+  UINT32  Value;
+
+  ASSERT (Context != NULL);
+
+  if (Context->DoorLocked) {
+    return Context->ArrivedCpuCountUponLock;
+  }
+
+  Arrived = 0;
+  for (Index = 0; Index < Context->NumberOfGroups; Index++) {
+    Value = *Context->GroupSem[Index].CpuCount;
+    if (Value == (UINT32)-1) {
+      //
+      // The door is being locked.
+      //
+      return Context->ArrivedCpuCountUponLock;
+    }
+
+    Arrived += Value;
+  }
+
+  return Arrived;
+}
+
+/**
+  Performs an atomic operation to check in CPU.
+
+  When SMI happens, all processors including BSP enter to SMM mode by calling SmmCpuSyncCheckInCpu().
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex exceeds the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Check in CPU index.
+
+  @retval RETURN_SUCCESS            Check in CPU (CpuIndex) successfully.
+  @retval RETURN_ABORTED            Check in CPU failed due to SmmCpuSyncLockDoor() has been called by one elected CPU.
+
+**/
+RETURN_STATUS
+EFIAPI
+SmmCpuSyncCheckInCpu (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex
+  )
+{
+  UINT32  Group;
+
+  ASSERT (Context != NULL);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  Group = InternalGetCpuGroup (Context, CpuIndex);
+
+  //
+  // Check to return if the CpuCount of the group has already been locked.
+  //
+  if (InternalReleaseSemaphore (Context->GroupSem[Group].CpuCount) == MAX_UINT32) {
+    return RETURN_ABORTED;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Performs an atomic operation to check out CPU.
+
+  This function can be called in error handling flow for the CPU who calls CheckInCpu() earlier.
+  The caller shall make sure the CPU specified by CpuIndex has already checked-in.
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex exceeds the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Check out CPU index.
+
+  @retval RETURN_SUCCESS            Check out CPU (CpuIndex) successfully.
+  @retval RETURN_ABORTED            Check out CPU failed due to SmmCpuSyncLockDoor() has been called by one elected CPU.
+
+**/
+RETURN_STATUS
+EFIAPI
+SmmCpuSyncCheckOutCpu (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex
+  )
+{
+  UINT32  Group;
+
+  ASSERT (Context != NULL);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  Group = InternalGetCpuGroup (Context, CpuIndex);
+
+  if (InternalWaitForSemaphore (Context->GroupSem[Group].CpuCount) == MAX_UINT32) {
+    return RETURN_ABORTED;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Performs an atomic operation lock door for CPU checkin and checkout. After this function:
+  CPU can not check in via SmmCpuSyncCheckInCpu().
+  CPU can not check out via SmmCpuSyncCheckOutCpu().
+
+  The CPU specified by CpuIndex is elected to lock door. The caller shall make sure the CpuIndex
+  is the actual CPU calling this function to avoid the undefined behavior.
+
+  If Context is NULL, then ASSERT().
+  If CpuCount is NULL, then ASSERT().
+  If CpuIndex exceeds the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Indicate which CPU to lock door.
+  @param[out]     CpuCount          Number of arrived CPU in SMI after look door.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncLockDoor (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex,
+  OUT UINTN                    *CpuCount
+  )
+{
+  UINTN  Index;
+  UINTN  Arrived;
+
+  ASSERT (Context != NULL);
+
+  ASSERT (CpuCount != NULL);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  //
+  // Temporarily record the arrived CPU count into the ArrivedCpuCountUponLock before
+  // lock door, so that SmmCpuSyncGetArrivedCpuCount() has a value to return while the
+  // groups are being locked.
+  //
+  Context->ArrivedCpuCountUponLock = SmmCpuSyncGetArrivedCpuCount (Context);
+
+  //
+  // Lock door operation. A CPU checks in successfully if its group is locked after
+  // it, in which case it is counted here.
+  //
+  Arrived = 0;
+  for (Index = 0; Index < Context->NumberOfGroups; Index++) {
+    Arrived += InternalLockdownSemaphore (Context->GroupSem[Index].CpuCount);
+  }
+
+  //
+  // Update the ArrivedCpuCountUponLock
+  //
+  Context->ArrivedCpuCountUponLock = Arrived;
+  Context->DoorLocked              = TRUE;
+  *CpuCount                        = Arrived;
+}
+
+/**
+  Used by the BSP to wait for APs.
+
+  The number of APs need to be waited is specified by NumberOfAPs. The BSP is specified by BspIndex.
+  The caller shall make sure the BspIndex is the actual CPU calling this function to avoid the undefined behavior.
+  The caller shall make sure the NumberOfAPs have already checked-in to avoid the undefined behavior.
+
+  If Context is NULL, then ASSERT().
+  If NumberOfAPs >= All CPUs in system, then ASSERT().
+  If BspIndex exceeds the range of all CPUs in the system, then ASSERT().
+
+  Note:
+  This function is blocking mode, and it will return only after the number of APs released by
+  calling SmmCpuSyncReleaseBsp():
+  BSP: WaitForAPs    <--  AP: ReleaseBsp
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      NumberOfAPs       Number of APs need to be waited by BSP.
+  @param[in]      BspIndex          The BSP Index to wait for APs.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncWaitForAPs (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 NumberOfAPs,
+  IN     UINTN                 BspIndex
+  )
+{
+  UINTN  Index;
+  UINTN  Remaining;
+
+  ASSERT (Context != NULL);
+
+  ASSERT (NumberOfAPs < Context->NumberOfCpus);
+
+  ASSERT (BspIndex < Context->NumberOfCpus);
+
+  //
+  // Collect the releases from the group semaphores until NumberOfAPs are gathered.
+  //
+  Remaining = NumberOfAPs;
+  while (Remaining > 0) {
+    for (Index = 0; (Index < Context->NumberOfGroups) && (Remaining > 0); Index++) {
+      Remaining -= InternalTakeSemaphore (Context->GroupSem[Index].BspRun, (UINT32)Remaining);
+    }
+
+    if (Remaining > 0) {
+      CpuPause ();
+    }
+  }
+}
+
+/**
+  Used by the BSP to release one AP.
+
+  The AP is specified by CpuIndex. The BSP is specified by BspIndex.
+  The caller shall make sure the BspIndex is the actual CPU calling this function to avoid the undefined behavior.
+  The caller shall make sure the CpuIndex has already checked-in to avoid the undefined behavior.
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex == BspIndex, then ASSERT().
+  If BspIndex or CpuIndex exceed the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Indicate which AP need to be released.
+  @param[in]      BspIndex          The BSP Index to release AP.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncReleaseOneAp   (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex,
+  IN     UINTN                 BspIndex
+  )
+{
+  ASSERT (Context != NULL);
+
+  ASSERT (BspIndex != CpuIndex);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  ASSERT (BspIndex < Context->NumberOfCpus);
+
+  InternalReleaseSemaphore (Context->CpuSem[CpuIndex].Run);
+}
+
+/**
+  Used by the AP to wait BSP.
+
+  The AP is specified by CpuIndex.
+  The caller shall make sure the CpuIndex is the actual CPU calling this function to avoid the undefined behavior.
+  The BSP is specified by BspIndex.
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex == BspIndex, then ASSERT().
+  If BspIndex or CpuIndex exceed the range of all CPUs in the system, then ASSERT().
+
+  Note:
+  This function is blocking mode, and it will return only after the AP released by
+  calling SmmCpuSyncReleaseOneAp():
+  BSP: ReleaseOneAp  -->  AP: WaitForBsp
+
+  @param[in,out]  Context          Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex         Indicate which AP wait BSP.
+  @param[in]      BspIndex         The BSP Index to be waited.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncWaitForBsp (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex,
+  IN     UINTN                 BspIndex
+  )
+{
+  ASSERT (Context != NULL);
+
+  ASSERT (BspIndex != CpuIndex);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  ASSERT (BspIndex < Context->NumberOfCpus);
+
+  InternalWaitForSemaphore (Context->CpuSem[CpuIndex].Run);
+}
+
+/**
+  Used by the AP to release BSP.
+
+  The AP is specified by CpuIndex.
+  The caller shall make sure the CpuIndex is the actual CPU calling this function to avoid the undefined behavior.
+  The BSP is specified by BspIndex.
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex == BspIndex, then ASSERT().
+  If BspIndex or CpuIndex exceed the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Indicate which AP release BSP.
+  @param[in]      BspIndex          The BSP Index to be released.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncReleaseBsp (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex,
+  IN     UINTN                 BspIndex
+  )
+{
+  UINT32  Group;
+
+  ASSERT (Context != NULL);
+
+  ASSERT (BspIndex != CpuIndex);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  ASSERT (BspIndex < Context->NumberOfCpus);
+
+  Group = InternalGetCpuGroup (Context, CpuIndex);
+  InternalReleaseSemaphore (Context->GroupSem[Group].BspRun);
+}
@@ -470,6 +470,7 @@ BSPHandler (
   ApCount  = 0;
 
   PERF_FUNCTION_BEGIN ();
+  SmmLatencyBegin (CpuIndex, SmmLatencyPhaseRendezvous);
 
   //
   // Flag BSP's presence
@@ -508,6 +509,9 @@ BSPHandler (
     //
     // Wait for APs to arrive
     //
+    PERF_CODE (
+      MpPerfBegin (CpuIndex, SMM_MP_PERF_PROCEDURE_ID (SmmWaitForApArrival));
+      );
     SmmWaitForApArrival ();
 
     //
@@ -523,6 +527,9 @@ BSPHandler (
     // Wait for all APs of arrival at this point
     //
     SmmCpuSyncWaitForAPs (mSmmMpSyncData->SyncContext, ApCount, CpuIndex); /// #1: Wait APs
+    PERF_CODE (
+      MpPerfEnd (CpuIndex, SMM_MP_PERF_PROCEDURE_ID (SmmWaitForApArrival));
+      );
 
     //
     // Signal all APs it's time for:
@@ -585,7 +592,11 @@ BSPHandler (
   //
   // Invoke SMM Foundation EntryPoint with the processor information context.
   //
+  SmmLatencyEnd (CpuIndex, SmmLatencyPhaseRendezvous);
+  SmmLatencyBegin (CpuIndex, SmmLatencyPhaseDispatch);
   gSmmCpuPrivate->SmmCoreEntry (&gSmmCpuPrivate->SmmCoreEntryContext);
+  SmmLatencyEnd (CpuIndex, SmmLatencyPhaseDispatch);
+  SmmLatencyBegin (CpuIndex, SmmLatencyPhaseExit);
 
   //
   // Make sure all APs have completed their pending none-block tasks
@@ -687,7 +698,13 @@ BSPHandler (
   // Gather APs to exit SMM synchronously. Note the Present flag is cleared by now but
   // WaitForAllAps does not depend on the Present flag.
   //
+  PERF_CODE (
+    MpPerfBegin (CpuIndex, SMM_MP_PERF_PROCEDURE_ID (SmmWaitForApExit));
+    );
   SmmCpuSyncWaitForAPs (mSmmMpSyncData->SyncContext, ApCount, CpuIndex); /// #11: Wait APs
+  PERF_CODE (
+    MpPerfEnd (CpuIndex, SMM_MP_PERF_PROCEDURE_ID (SmmWaitForApExit));
+    );
 
   //
   // At this point, all APs should have exited from APHandler().
@@ -1563,6 +1580,8 @@ SmiRendezvous (
     return;
   }
 
+  SmmLatencyBegin (CpuIndex, SmmLatencyPhaseEntry);
+
   //
   // Call the user register Startup function first.
   //
@@ -1614,7 +1633,14 @@ SmiRendezvous (
     // "SmmCpuSyncCheckInCpu (mSmmMpSyncData->SyncContext, CpuIndex)" return error means failed
     // to check in CPU. BSP has already ended the synchronization.
     //
-    if (RETURN_ERROR (SmmCpuSyncCheckInCpu (mSmmMpSyncData->SyncContext, CpuIndex))) {
+    PERF_CODE (
+      MpPerfBegin (CpuIndex, SMM_MP_PERF_PROCEDURE_ID (SmmCpuCheckIn));
+      );
+    Status = SmmCpuSyncCheckInCpu (mSmmMpSyncData->SyncContext, CpuIndex);
+    PERF_CODE (
+      MpPerfEnd (CpuIndex, SMM_MP_PERF_PROCEDURE_ID (SmmCpuCheckIn));
+      );
+    if (RETURN_ERROR (Status)) {
       //
       // BSP has already ended the synchronization, so QUIT!!!
       // Existing AP is too late now to enter SMI since BSP has already ended the synchronization!!!
@@ -1638,6 +1664,8 @@ SmiRendezvous (
       InitializeSpinLock (mSmmMpSyncData->CpuData[CpuIndex].Busy);
     }
 
+    SmmLatencyEnd (CpuIndex, SmmLatencyPhaseEntry);
+
     if (mSmmProfileEnabled) {
       ActivateSmmProfile (CpuIndex);
     }
@@ -1648,6 +1676,7 @@ SmiRendezvous (
       // as BSP may have cleared the SMI status
       //
       APHandler (CpuIndex, ValidSmi, mSmmMpSyncData->EffectiveSyncMode);
+      SmmLatencyBegin (CpuIndex, SmmLatencyPhaseExit);
     } else {
       //
       // We have a valid SMI
@@ -1709,6 +1738,7 @@ SmiRendezvous (
         BSPHandler (CpuIndex, mSmmMpSyncData->EffectiveSyncMode);
       } else {
         APHandler (CpuIndex, ValidSmi, mSmmMpSyncData->EffectiveSyncMode);
+        SmmLatencyBegin (CpuIndex, SmmLatencyPhaseExit);
       }
     }
 
@@ -1735,6 +1765,7 @@ Exit:
   PERF_CODE (
     MpPerfEnd (CpuIndex, SMM_MP_PERF_PROCEDURE_ID (SmmRendezvousExit));
     );
+  SmmLatencyEnd (CpuIndex, SmmLatencyPhaseExit);
 
   //
   // Restore Cr2
@@ -809,6 +809,7 @@ PiSmmCpuEntryCommon (
   PERF_CODE (
     InitializeMpPerf (gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus);
     );
+  InitializeSmmLatency (gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus);
 
   //
   // The CPU save state and code for the SMI entry point are tiled within an SMRAM
@@ -67,6 +67,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "CpuService.h"
 #include "SmmProfile.h"
 #include "SmmMpPerf.h"
+#include "SmmLatency.h"
 
 //
 // CET definition
@@ -840,6 +841,21 @@ IsSmmProfileEnabled (
   VOID
   );
 
+/**
+  Check if the MM communicate buffer passed to an MMI handler is valid.
+
+  @param Buffer The buffer start address to be checked.
+  @param Length The buffer length to be checked.
+
+  @retval TRUE  This buffer is valid.
+  @retval FALSE This buffer is not valid.
+**/
+BOOLEAN
+SmmCpuIsPrimaryBufferValid (
+  IN EFI_PHYSICAL_ADDRESS  Buffer,
+  IN UINT64                Length
+  );
+
 /**
   Perform the remaining tasks.
 
@@ -11,6 +11,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "PiSmmCpuCommon.h"
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/SmmMemLib.h>
 
 //
 // TRUE to indicate it's the MM_STANDALONE MM CPU driver.
@@ -38,6 +39,24 @@ IsSmmProfileEnabled (
   return FeaturePcdGet (PcdCpuSmmProfileEnable);
 }
 
+/**
+  Check if the MM communicate buffer passed to an MMI handler is valid.
+
+  @param Buffer The buffer start address to be checked.
+  @param Length The buffer length to be checked.
+
+  @retval TRUE  This buffer is valid.
+  @retval FALSE This buffer is not valid.
+**/
+BOOLEAN
+SmmCpuIsPrimaryBufferValid (
+  IN EFI_PHYSICAL_ADDRESS  Buffer,
+  IN UINT64                Length
+  )
+{
+  return SmmIsBufferOutsideSmmValid (Buffer, Length);
+}
+
 /**
   Perform the remaining tasks.
 
@@ -42,6 +42,27 @@ IsSmmProfileEnabled (
   return TRUE;
 }
 
+/**
+  Check if the MM communicate buffer passed to an MMI handler is valid.
+
+  @param Buffer The buffer start address to be checked.
+  @param Length The buffer length to be checked.
+
+  @retval TRUE  This buffer is valid.
+  @retval FALSE This buffer is not valid.
+**/
+BOOLEAN
+SmmCpuIsPrimaryBufferValid (
+  IN EFI_PHYSICAL_ADDRESS  Buffer,
+  IN UINT64                Length
+  )
+{
+  //
+  // The MM core copies the communicate buffer into MMRAM before calling the handler.
+  //
+  return TRUE;
+}
+
 /**
   Perform the remaining tasks.
 
@@ -0,0 +1,201 @@
+/** @file
+SMI latency histogram collection and MM communicate interface.
+
+Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "PiSmmCpuCommon.h"
+
+//
+// Each element holds the latency data for one processor.
+//
+SMM_LATENCY_CPU_DATA  *mSmmLatencyCpuData   = NULL;
+UINTN                 mSmmLatencyCpuCount   = 0;
+UINT64                mSmmLatencyFrequency  = 0;
+BOOLEAN               mSmmLatencyCountDown  = FALSE;
+UINT32                mSmmLatencyGeneration = 1;
+
+/**
+  Return the SMI latency histograms to the caller of MM communicate.
+
+  @param[in]     DispatchHandle  The unique handle assigned to this handler by MmiHandlerRegister().
+  @param[in]     Context         Points to an optional handler context which was specified when the
+                                 handler was registered.
+  @param[in,out] CommBuffer      A pointer to a collection of data in memory that will
+                                 be conveyed from a non-MM environment into an MM environment.
+  @param[in,out] CommBufferSize  The size of the CommBuffer.
+
+  @retval EFI_SUCCESS            The interrupt was handled and quiesced. No other handlers
+                                 should still be called.
+**/
+EFI_STATUS
+EFIAPI
+SmmLatencyHistogramHandler (
+  IN     EFI_HANDLE  DispatchHandle,
+  IN     CONST VOID  *Context         OPTIONAL,
+  IN OUT VOID        *CommBuffer      OPTIONAL,
+  IN OUT UINTN       *CommBufferSize  OPTIONAL
+  )
+{
+  SMM_LATENCY_HISTOGRAM_PARAMETER  *Parameter;
+  UINTN                            TempCommBufferSize;
+  UINT64                           Function;
+  UINT32                           CpuIndex;
+  UINTN                            Index;
+  EFI_STATUS                       Status;
+
+  //
+  // If input is invalid, stop processing this SMI
+  //
+  if ((CommBuffer == NULL) || (CommBufferSize == NULL)) {
+    return EFI_SUCCESS;
+  }
+
+  TempCommBufferSize = *CommBufferSize;
+  if (TempCommBufferSize < sizeof (SMM_LATENCY_HISTOGRAM_PARAMETER)) {
+    DEBUG ((DEBUG_ERROR, "SmmLatencyHistogramHandler: MM communication buffer size invalid!\n"));
+    return EFI_SUCCESS;
+  }
+
+  if (!SmmCpuIsPrimaryBufferValid ((EFI_PHYSICAL_ADDRESS)(UINTN)CommBuffer, TempCommBufferSize)) {
+    DEBUG ((DEBUG_ERROR, "SmmLatencyHistogramHandler: MM communication buffer in MMRAM or overflow!\n"));
+    return EFI_SUCCESS;
+  }
+
+  Parameter = (SMM_LATENCY_HISTOGRAM_PARAMETER *)CommBuffer;
+  Function  = Parameter->Function;
+  CpuIndex  = Parameter->CpuIndex;
+
+  switch (Function) {
+    case SMM_LATENCY_HISTOGRAM_FUNCTION_GET:
+      if ((CpuIndex != SMM_LATENCY_HISTOGRAM_ALL_CPUS) && (CpuIndex >= mSmmLatencyCpuCount)) {
+        Status = EFI_INVALID_PARAMETER;
+        break;
+      }
+
+      Parameter->NumberOfCpus     = (UINT32)mSmmLatencyCpuCount;
+      Parameter->TickFrequency    = mSmmLatencyFrequency;
+      Parameter->LastSmiEntryTick = 0;
+      ZeroMem (Parameter->Histogram, sizeof (Parameter->Histogram));
+      for (Index = 0; Index < mSmmLatencyCpuCount; Index++) {
+        if ((CpuIndex == SMM_LATENCY_HISTOGRAM_ALL_CPUS) || (CpuIndex == Index)) {
+          SmmLatencyCpuCollect (
+            &mSmmLatencyCpuData[Index],
+            mSmmLatencyGeneration,
+            Parameter->Histogram,
+            &Parameter->LastSmiEntryTick
+            );
+        }
+      }
+
+      Status = EFI_SUCCESS;
+      break;
+
+    case SMM_LATENCY_HISTOGRAM_FUNCTION_RESET:
+      //
+      // Every processor clears its own histograms when it records the next latency.
+      //
+      mSmmLatencyGeneration++;
+      Status = EFI_SUCCESS;
+      break;
+
+    default:
+      Status = EFI_UNSUPPORTED;
+      break;
+  }
+
+  Parameter->ReturnStatus = (UINT64)Status;
+  return EFI_SUCCESS;
+}
+
+/**
+  Initialize the SMI latency histograms.
+
+  @param NumberofCpus    Number of processors in the platform.
+**/
+VOID
+InitializeSmmLatency (
+  IN UINTN  NumberofCpus
+  )
+{
+  EFI_STATUS  Status;
+  EFI_HANDLE  DispatchHandle;
+  UINT64      StartValue;
+  UINT64      EndValue;
+
+  if (!FeaturePcdGet (PcdSmmLatencyHistogramEnable)) {
+    return;
+  }
+
+  mSmmLatencyCpuData = AllocateZeroPool (NumberofCpus * sizeof (*mSmmLatencyCpuData));
+  ASSERT (mSmmLatencyCpuData != NULL);
+  if (mSmmLatencyCpuData == NULL) {
+    return;
+  }
+
+  mSmmLatencyCpuCount  = NumberofCpus;
+  mSmmLatencyFrequency = GetPerformanceCounterProperties (&StartValue, &EndValue);
+  mSmmLatencyCountDown = (BOOLEAN)(StartValue > EndValue);
+
+  Status = gMmst->MmiHandlerRegister (SmmLatencyHistogramHandler, &gSmmLatencyHistogramGuid, &DispatchHandle);
+  ASSERT_EFI_ERROR (Status);
+}
+
+/**
+  Save the performance counter value at the start of an SMI phase.
+
+  @param CpuIndex        The index of the CPU.
+  @param Phase           The phase.
+**/
+VOID
+SmmLatencyBegin (
+  IN UINTN              CpuIndex,
+  IN SMM_LATENCY_PHASE  Phase
+  )
+{
+  if (mSmmLatencyCpuData != NULL) {
+    mSmmLatencyCpuData[CpuIndex].Begin[Phase] = GetPerformanceCounter ();
+  }
+}
+
+/**
+  Record the latency of an SMI phase started by SmmLatencyBegin().
+
+  Nothing is recorded if the phase was not started in this SMI.
+
+  @param CpuIndex        The index of the CPU.
+  @param Phase           The phase.
+**/
+VOID
+SmmLatencyEnd (
+  IN UINTN              CpuIndex,
+  IN SMM_LATENCY_PHASE  Phase
+  )
+{
+  SMM_LATENCY_CPU_DATA  *CpuData;
+  UINT64                BeginTick;
+  UINT64                EndTick;
+
+  if (mSmmLatencyCpuData == NULL) {
+    return;
+  }
+
+  EndTick   = GetPerformanceCounter ();
+  CpuData   = &mSmmLatencyCpuData[CpuIndex];
+  BeginTick = CpuData->Begin[Phase];
+  if (BeginTick == 0) {
+    return;
+  }
+
+  CpuData->Begin[Phase] = 0;
+  SmmLatencyCpuRecord (
+    CpuData,
+    mSmmLatencyGeneration,
+    Phase,
+    BeginTick,
+    mSmmLatencyCountDown ? BeginTick - EndTick : EndTick - BeginTick
+    );
+}
@@ -0,0 +1,131 @@
+/** @file
+SMI latency histogram definitions.
+
+Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef SMM_LATENCY_H_
+#define SMM_LATENCY_H_
+
+#include <Guid/SmmLatencyHistogram.h>
+
+//
+// The latency data of one processor. Only the processor itself writes it, so no lock
+// is needed. The reader takes a consistent copy by checking that Sequence is even and
+// has not changed while it copied.
+//
+typedef struct {
+  volatile UINT32          Sequence;
+  //
+  // The histograms are cleared by the processor itself when Generation differs from
+  // the global reset generation.
+  //
+  UINT32                   Generation;
+  UINT64                   LastSmiEntryTick;
+  SMM_LATENCY_HISTOGRAM    Histogram[SmmLatencyPhaseMax];
+  //
+  // The start of every phase in progress, or 0. It is not read by others.
+  //
+  UINT64                   Begin[SmmLatencyPhaseMax];
+} SMM_LATENCY_CPU_DATA;
+
+/**
+  Add one latency to a histogram.
+
+  @param[in, out] Histogram     The histogram.
+  @param[in]      Ticks         The latency in performance counter ticks.
+**/
+VOID
+SmmLatencyHistogramAdd (
+  IN OUT SMM_LATENCY_HISTOGRAM  *Histogram,
+  IN     UINT64                 Ticks
+  );
+
+/**
+  Add all latencies of a histogram to another one.
+
+  @param[in, out] Target        The histogram to add to.
+  @param[in]      Source        The histogram to add.
+**/
+VOID
+SmmLatencyHistogramMerge (
+  IN OUT SMM_LATENCY_HISTOGRAM        *Target,
+  IN     CONST SMM_LATENCY_HISTOGRAM  *Source
+  );
+
+/**
+  Record the latency of a phase in the data of the calling processor.
+
+  @param[in, out] CpuData       The data of the calling processor.
+  @param[in]      Generation    The current reset generation.
+  @param[in]      Phase         The phase.
+  @param[in]      BeginTick     The performance counter value at the start of the phase.
+  @param[in]      Ticks         The latency in performance counter ticks.
+**/
+VOID
+SmmLatencyCpuRecord (
+  IN OUT SMM_LATENCY_CPU_DATA  *CpuData,
+  IN     UINT32                Generation,
+  IN     SMM_LATENCY_PHASE     Phase,
+  IN     UINT64                BeginTick,
+  IN     UINT64                Ticks
+  );
+
+/**
+  Add a consistent copy of the histograms of a processor to the histograms of the caller.
+
+  The processor may record new latencies at the same time.
+
+  @param[in]      CpuData           The data of the processor.
+  @param[in]      Generation        The current reset generation.
+  @param[in, out] Histogram         The histograms of all phases to add to.
+  @param[in, out] LastSmiEntryTick  Updated if the processor entered an SMI later.
+**/
+VOID
+SmmLatencyCpuCollect (
+  IN     CONST SMM_LATENCY_CPU_DATA  *CpuData,
+  IN     UINT32                      Generation,
+  IN OUT SMM_LATENCY_HISTOGRAM       *Histogram,
+  IN OUT UINT64                      *LastSmiEntryTick
+  );
+
+/**
+  Initialize the SMI latency histograms.
+
+  @param NumberofCpus    Number of processors in the platform.
+**/
+VOID
+InitializeSmmLatency (
+  IN UINTN  NumberofCpus
+  );
+
+/**
+  Save the performance counter value at the start of an SMI phase.
+
+  @param CpuIndex        The index of the CPU.
+  @param Phase           The phase.
+**/
+VOID
+SmmLatencyBegin (
+  IN UINTN              CpuIndex,
+  IN SMM_LATENCY_PHASE  Phase
+  );
+
+/**
+  Record the latency of an SMI phase started by SmmLatencyBegin().
+
+  Nothing is recorded if the phase was not started in this SMI.
+
+  @param CpuIndex        The index of the CPU.
+  @param Phase           The phase.
+**/
+VOID
+SmmLatencyEnd (
+  IN UINTN              CpuIndex,
+  IN SMM_LATENCY_PHASE  Phase
+  );
+
+#endif
@@ -0,0 +1,176 @@
+/** @file
+SMI latency histogram data structure.
+
+The functions in this file do not depend on the SMM environment, so that they can be
+tested on the host.
+
+Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi/UefiBaseType.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+
+#include "SmmLatency.h"
+
+/**
+  Add one latency to a histogram.
+
+  @param[in, out] Histogram     The histogram.
+  @param[in]      Ticks         The latency in performance counter ticks.
+**/
+VOID
+SmmLatencyHistogramAdd (
+  IN OUT SMM_LATENCY_HISTOGRAM  *Histogram,
+  IN     UINT64                 Ticks
+  )
+{
+  if ((Histogram->Count == 0) || (Ticks < Histogram->MinTicks)) {
+    Histogram->MinTicks = Ticks;
+  }
+
+  if (Ticks > Histogram->MaxTicks) {
+    Histogram->MaxTicks = Ticks;
+  }
+
+  Histogram->Count++;
+  Histogram->TotalTicks += Ticks;
+
+  //
+  // HighBitSet64() returns -1 for 0, which lands in Bucket[0].
+  //
+  Histogram->Bucket[MIN (HighBitSet64 (Ticks) + 1, SMM_LATENCY_HISTOGRAM_BUCKET_COUNT - 1)]++;
+}
+
+/**
+  Add all latencies of a histogram to another one.
+
+  @param[in, out] Target        The histogram to add to.
+  @param[in]      Source        The histogram to add.
+**/
+VOID
+SmmLatencyHistogramMerge (
+  IN OUT SMM_LATENCY_HISTOGRAM        *Target,
+  IN     CONST SMM_LATENCY_HISTOGRAM  *Source
+  )
+{
+  UINTN  Index;
+
+  if (Source->Count == 0) {
+    return;
+  }
+
+  if ((Target->Count == 0) || (Source->MinTicks < Target->MinTicks)) {
+    Target->MinTicks = Source->MinTicks;
+  }
+
+  if (Source->MaxTicks > Target->MaxTicks) {
+    Target->MaxTicks = Source->MaxTicks;
+  }
+
+  Target->Count      += Source->Count;
+  Target->TotalTicks += Source->TotalTicks;
+  for (Index = 0; Index < SMM_LATENCY_HISTOGRAM_BUCKET_COUNT; Index++) {
+    Target->Bucket[Index] += Source->Bucket[Index];
+  }
+}
+
+/**
+  Record the latency of a phase in the data of the calling processor.
+
+  @param[in, out] CpuData       The data of the calling processor.
+  @param[in]      Generation    The current reset generation.
+  @param[in]      Phase         The phase.
+  @param[in]      BeginTick     The performance counter value at the start of the phase.
+  @param[in]      Ticks         The latency in performance counter ticks.
+**/
+VOID
+SmmLatencyCpuRecord (
+  IN OUT SMM_LATENCY_CPU_DATA  *CpuData,
+  IN     UINT32                Generation,
+  IN     SMM_LATENCY_PHASE     Phase,
+  IN     UINT64                BeginTick,
+  IN     UINT64                Ticks
+  )
+{
+  //
+  // An odd Sequence tells the readers that the data is being updated.
+  //
+  CpuData->Sequence++;
+  MemoryFence ();
+
+  if (CpuData->Generation != Generation) {
+    ZeroMem (CpuData->Histogram, sizeof (CpuData->Histogram));
+    CpuData->LastSmiEntryTick = 0;
+    CpuData->Generation       = Generation;
+  }
+
+  if (Phase == SmmLatencyPhaseEntry) {
+    CpuData->LastSmiEntryTick = BeginTick;
+  }
+
+  SmmLatencyHistogramAdd (&CpuData->Histogram[Phase], Ticks);
+
+  MemoryFence ();
+  CpuData->Sequence++;
+}
+
+/**
+  Add a consistent copy of the histograms of a processor to the histograms of the caller.
+
+  The processor may record new latencies at the same time.
+
+  @param[in]      CpuData           The data of the processor.
+  @param[in]      Generation        The current reset generation.
+  @param[in, out] Histogram         The histograms of all phases to add to.
+  @param[in, out] LastSmiEntryTick  Updated if the processor entered an SMI later.
+**/
+VOID
+SmmLatencyCpuCollect (
+  IN     CONST SMM_LATENCY_CPU_DATA  *CpuData,
+  IN     UINT32                      Generation,
+  IN OUT SMM_LATENCY_HISTOGRAM       *Histogram,
+  IN OUT UINT64                      *LastSmiEntryTick
+  )
+{
+  SMM_LATENCY_HISTOGRAM  Copy;
+  UINT64                 EntryTick;
+  UINT32                 Sequence;
+  BOOLEAN                Stale;
+  UINTN                  Phase;
+
+  for (Phase = 0; Phase < SmmLatencyPhaseMax; Phase++) {
+    while (TRUE) {
+      Sequence = CpuData->Sequence;
+      if ((Sequence & BIT0) != 0) {
+        CpuPause ();
+        continue;
+      }
+
+      MemoryFence ();
+      Stale     = (BOOLEAN)(CpuData->Generation != Generation);
+      EntryTick = CpuData->LastSmiEntryTick;
+      CopyMem (&Copy, &CpuData->Histogram[Phase], sizeof (Copy));
+      MemoryFence ();
+
+      if (CpuData->Sequence == Sequence) {
+        break;
+      }
+    }
+
+    //
+    // Histograms of an older generation are cleared at the next record.
+    //
+    if (Stale) {
+      return;
+    }
+
+    SmmLatencyHistogramMerge (&Histogram[Phase], &Copy);
+    if (EntryTick > *LastSmiEntryTick) {
+      *LastSmiEntryTick = EntryTick;
+    }
+  }
+}
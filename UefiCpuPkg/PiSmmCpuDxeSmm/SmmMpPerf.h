@@ -18,6 +18,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
   _(SmmRendezvousEntry), \
   _(PlatformValidSmi), \
   _(SmmRendezvousExit), \
+  _(SmmCpuCheckIn), \
+  _(SmmWaitForApArrival), \
+  _(SmmWaitForApExit), \
   _(SmmMpProcedureMax) // Add new entries above this line
 
 //
@@ -0,0 +1,379 @@
+/** @file
+  Unit tests of the SMI latency histogram of PiSmmCpuDxeSmm
+
+  Copyright (c) 2026, The TianoCore Project Authors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <time.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UnitTestLib.h>
+#include "../SmmLatency.h"
+
+#define UNIT_TEST_APP_NAME     "SMI Latency Histogram Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+/**
+  Check that every latency lands in its log2 bucket.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestCaseBucket (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SMM_LATENCY_HISTOGRAM  Histogram;
+  UINTN                  Index;
+
+  ZeroMem (&Histogram, sizeof (Histogram));
+
+  SmmLatencyHistogramAdd (&Histogram, 0);
+  SmmLatencyHistogramAdd (&Histogram, 1);
+  SmmLatencyHistogramAdd (&Histogram, 2);
+  SmmLatencyHistogramAdd (&Histogram, 3);
+  SmmLatencyHistogramAdd (&Histogram, 4);
+  SmmLatencyHistogramAdd (&Histogram, 1000);
+  SmmLatencyHistogramAdd (&Histogram, MAX_UINT64);
+
+  UT_ASSERT_EQUAL (Histogram.Bucket[0], 1);
+  UT_ASSERT_EQUAL (Histogram.Bucket[1], 1);
+  UT_ASSERT_EQUAL (Histogram.Bucket[2], 2);
+  UT_ASSERT_EQUAL (Histogram.Bucket[3], 1);
+  UT_ASSERT_EQUAL (Histogram.Bucket[10], 1);
+
+  //
+  // The last bucket also counts all longer latencies.
+  //
+  UT_ASSERT_EQUAL (Histogram.Bucket[SMM_LATENCY_HISTOGRAM_BUCKET_COUNT - 1], 1);
+
+  for (Index = 4; Index < SMM_LATENCY_HISTOGRAM_BUCKET_COUNT - 1; Index++) {
+    if (Index != 10) {
+      UT_ASSERT_EQUAL (Histogram.Bucket[Index], 0);
+    }
+  }
+
+  UT_ASSERT_EQUAL (Histogram.Count, 7);
+  UT_ASSERT_EQUAL (Histogram.MinTicks, 0);
+  UT_ASSERT_EQUAL (Histogram.MaxTicks, MAX_UINT64);
+  UT_ASSERT_EQUAL (Histogram.TotalTicks, 0 + 1 + 2 + 3 + 4 + 1000 + MAX_UINT64);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check the merge of two histograms, including empty ones.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestCaseMerge (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SMM_LATENCY_HISTOGRAM  Target;
+  SMM_LATENCY_HISTOGRAM  Source;
+  SMM_LATENCY_HISTOGRAM  Empty;
+
+  ZeroMem (&Target, sizeof (Target));
+  ZeroMem (&Source, sizeof (Source));
+  ZeroMem (&Empty, sizeof (Empty));
+
+  //
+  // An empty source does not change the minimum of the target.
+  //
+  SmmLatencyHistogramAdd (&Target, 100);
+  SmmLatencyHistogramAdd (&Target, 200);
+  SmmLatencyHistogramMerge (&Target, &Empty);
+  UT_ASSERT_EQUAL (Target.Count, 2);
+  UT_ASSERT_EQUAL (Target.MinTicks, 100);
+
+  SmmLatencyHistogramAdd (&Source, 50);
+  SmmLatencyHistogramAdd (&Source, 5000);
+  SmmLatencyHistogramMerge (&Target, &Source);
+  UT_ASSERT_EQUAL (Target.Count, 4);
+  UT_ASSERT_EQUAL (Target.TotalTicks, 5350);
+  UT_ASSERT_EQUAL (Target.MinTicks, 50);
+  UT_ASSERT_EQUAL (Target.MaxTicks, 5000);
+  UT_ASSERT_EQUAL (Target.Bucket[6], 1);
+  UT_ASSERT_EQUAL (Target.Bucket[7], 1);
+  UT_ASSERT_EQUAL (Target.Bucket[8], 1);
+  UT_ASSERT_EQUAL (Target.Bucket[13], 1);
+
+  //
+  // An empty target takes the minimum of the source.
+  //
+  SmmLatencyHistogramMerge (&Empty, &Source);
+  UT_ASSERT_MEM_EQUAL (&Empty, &Source, sizeof (Source));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check the record and collect of the per-processor data, including the reset
+  by a new generation.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestCaseCpuRecordAndCollect (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SMM_LATENCY_CPU_DATA   CpuData[2];
+  SMM_LATENCY_HISTOGRAM  Histogram[SmmLatencyPhaseMax];
+  UINT64                 LastSmiEntryTick;
+
+  ZeroMem (CpuData, sizeof (CpuData));
+
+  SmmLatencyCpuRecord (&CpuData[0], 1, SmmLatencyPhaseEntry, 1000, 10);
+  SmmLatencyCpuRecord (&CpuData[0], 1, SmmLatencyPhaseDispatch, 1010, 300);
+  SmmLatencyCpuRecord (&CpuData[0], 1, SmmLatencyPhaseExit, 1310, 20);
+  SmmLatencyCpuRecord (&CpuData[1], 1, SmmLatencyPhaseEntry, 1005, 5);
+  SmmLatencyCpuRecord (&CpuData[1], 1, SmmLatencyPhaseExit, 1315, 15);
+
+  //
+  // Every record leaves Sequence even for the readers.
+  //
+  UT_ASSERT_EQUAL (CpuData[0].Sequence, 6);
+  UT_ASSERT_EQUAL (CpuData[1].Sequence, 4);
+
+  ZeroMem (Histogram, sizeof (Histogram));
+  LastSmiEntryTick = 0;
+  SmmLatencyCpuCollect (&CpuData[0], 1, Histogram, &LastSmiEntryTick);
+  SmmLatencyCpuCollect (&CpuData[1], 1, Histogram, &LastSmiEntryTick);
+  UT_ASSERT_EQUAL (LastSmiEntryTick, 1005);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseEntry].Count, 2);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseEntry].MinTicks, 5);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseEntry].MaxTicks, 10);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseRendezvous].Count, 0);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseDispatch].Count, 1);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseDispatch].TotalTicks, 300);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseExit].Count, 2);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseExit].TotalTicks, 35);
+
+  //
+  // After a reset, the data of the old generation is not collected.
+  //
+  ZeroMem (Histogram, sizeof (Histogram));
+  LastSmiEntryTick = 0;
+  SmmLatencyCpuCollect (&CpuData[0], 2, Histogram, &LastSmiEntryTick);
+  UT_ASSERT_EQUAL (LastSmiEntryTick, 0);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseEntry].Count, 0);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseDispatch].Count, 0);
+
+  //
+  // The next record of the processor clears the data of the old generation.
+  //
+  SmmLatencyCpuRecord (&CpuData[0], 2, SmmLatencyPhaseExit, 2000, 7);
+  SmmLatencyCpuCollect (&CpuData[0], 2, Histogram, &LastSmiEntryTick);
+  UT_ASSERT_EQUAL (CpuData[0].Generation, 2);
+  UT_ASSERT_EQUAL (LastSmiEntryTick, 0);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseEntry].Count, 0);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseDispatch].Count, 0);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseExit].Count, 1);
+  UT_ASSERT_EQUAL (Histogram[SmmLatencyPhaseExit].TotalTicks, 7);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measure the cost of recording and collecting the latencies.
+
+  @param[in] RecordCount  The number of latencies to record.
+  @param[in] CpuCount     The number of processors to collect from.
+**/
+VOID
+MeasureOverhead (
+  IN UINTN  RecordCount,
+  IN UINTN  CpuCount
+  )
+{
+  SMM_LATENCY_CPU_DATA   *CpuData;
+  SMM_LATENCY_HISTOGRAM  Histogram[SmmLatencyPhaseMax];
+  UINT64                 LastSmiEntryTick;
+  UINT64                 Seed;
+  UINTN                  Index;
+  clock_t                Start;
+  UINT64                 RecordTime;
+  UINT64                 CollectTime;
+
+  if ((CpuCount == 0) || (RecordCount < CpuCount)) {
+    return;
+  }
+
+  CpuData = calloc (CpuCount, sizeof (*CpuData));
+  if (CpuData == NULL) {
+    return;
+  }
+
+  //
+  // Spread the latencies over many buckets with a simple LCG.
+  //
+  Seed  = 1;
+  Start = clock ();
+  for (Index = 0; Index < RecordCount; Index++) {
+    Seed = Seed * 6364136223846793005ull + 1442695040888963407ull;
+    SmmLatencyCpuRecord (&CpuData[Index % CpuCount], 1, (SMM_LATENCY_PHASE)(Index % SmmLatencyPhaseMax), Index, Seed >> (Seed >> 58));
+  }
+
+  RecordTime = clock () - Start;
+
+  Start = clock ();
+  for (Index = 0; Index < RecordCount / CpuCount; Index++) {
+    ZeroMem (Histogram, sizeof (Histogram));
+    LastSmiEntryTick = 0;
+    SmmLatencyCpuCollect (&CpuData[Index % CpuCount], 1, Histogram, &LastSmiEntryTick);
+  }
+
+  CollectTime = clock () - Start;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "Record: %ld records in %ld us (%ld ns per record)\n",
+    (UINT64)RecordCount,
+    DivU64x32 (MultU64x32 (RecordTime, 1000000), CLOCKS_PER_SEC),
+    DivU64x64Remainder (MultU64x32 (RecordTime, 1000000000), MultU64x32 (RecordCount, CLOCKS_PER_SEC), NULL)
+    ));
+  DEBUG ((
+    DEBUG_INFO,
+    "Collect: %ld collects in %ld us (%ld ns per processor)\n",
+    (UINT64)(RecordCount / CpuCount),
+    DivU64x32 (MultU64x32 (CollectTime, 1000000), CLOCKS_PER_SEC),
+    DivU64x64Remainder (MultU64x32 (CollectTime, 1000000000), MultU64x32 (RecordCount / CpuCount, CLOCKS_PER_SEC), NULL)
+    ));
+
+  free (CpuData);
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  SMI latency histogram and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      ManualTestCase;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the Manual Test Cases.
+  //
+  Status = CreateUnitTestSuite (&ManualTestCase, Framework, "Manual Test Cases", "SmmLatencyHistogram.Manual", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Manual Test Cases\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (ManualTestCase, "Check the log2 bucket of latencies", "Manual Test Case1", TestCaseBucket, NULL, NULL, NULL);
+  AddTestCase (ManualTestCase, "Check the merge of histograms", "Manual Test Case2", TestCaseMerge, NULL, NULL, NULL);
+  AddTestCase (ManualTestCase, "Check the record, collect and reset of processor data", "Manual Test Case3", TestCaseCpuRecordAndCollect, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param Argc  Number of arguments.
+  @param Argv  Array of arguments.
+
+  @return Test application exit code.
+**/
+INT32
+main (
+  INT32  Argc,
+  CHAR8  *Argv[]
+  )
+{
+  //
+  // SmmLatencyHistogramUnitTestHost performance [<record count> [<cpu count>]]
+  //   Default <record count> is 10000000 and default <cpu count> is 64.
+  //
+  if ((Argc >= 2) && (Argc <= 4) && (AsciiStriCmp ("performance", Argv[1]) == 0)) {
+    MeasureOverhead (
+      (Argc >= 3) ? atoi (Argv[2]) : 10000000,
+      (Argc == 4) ? atoi (Argv[3]) : 64
+      );
+    return 0;
+  }
+
+  return UefiTestMain ();
+}